@@ -328,15 +328,67 @@ void AsyncQuery::AddQuery(const char * format, ...)
     queries.push_back(res);
 }
 
+void AsyncQuery::AddQueryStr(const std::string& str)
+{
+    AsyncQueryResult res;
+    size_t len = str.size();
+    ASSERT(len);
+    res.query = new char[len+1];
+    memcpy(res.query, str.c_str(), len + 1);
+    res.result = NULL;
+    queries.push_back(res);
+}
+
 void AsyncQuery::Perform()
 {
     DatabaseConnection * conn = db->GetFreeConnection();
-    for(std::vector<AsyncQueryResult>::iterator itr = queries.begin(); itr != queries.end(); ++itr)
+    PerformQueries(conn);
+    conn->Busy.Release();
+    Finish();
+}
+
+void AsyncQuery::PerformQueries(DatabaseConnection * conn)
+{
+    std::vector<AsyncQueryResult>::iterator itr = queries.begin();
+    // Multi statements are only switched on for the length of the batch so nothing else on this connection can stack queries
+    if(batched && queries.size() > 1 && mysql_set_server_option(conn->conn, MYSQL_OPTION_MULTI_STATEMENTS_ON) == 0)
+    {
+        // Send the whole batch as one multi statement round trip
+        std::string batch;
+        for(; itr != queries.end(); ++itr)
+        {
+            batch.append(itr->query);
+            while(!batch.empty() && (batch[batch.length()-1] == ';' || batch[batch.length()-1] == ' '))
+                batch.erase(batch.length()-1);
+            batch.append(";");
+        }
+
+        itr = queries.begin();
+        if(db->_SendQuery(conn, batch.c_str(), false))
+        {
+            do
+            {
+                itr->result = db->_StoreQueryResult(conn);
+                ++itr;
+            }while(itr != queries.end() && mysql_next_result(conn->conn) == 0);
+
+            // Drain anything left over so the connection is usable again
+            while(mysql_more_results(conn->conn) && mysql_next_result(conn->conn) == 0)
+                if(MYSQL_RES *res = mysql_store_result(conn->conn))
+                    mysql_free_result(res);
+        }
+
+        mysql_set_server_option(conn->conn, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
+    }
+
+    // Whatever the batch didn't answer gets sent one by one
+    for(; itr != queries.end(); ++itr)
         itr->result = db->FQuery(itr->query, conn);
+}
 
-    conn->Busy.Release();
+void AsyncQuery::Finish()
+{
     func->run(queries);
-
     delete this;
 }
 
@@ -358,6 +410,10 @@ void DirectDatabase::EndThreads()
     ThreadRunning = false;
     Update();
     thread_proc_query();
+
+    // Nobody is left to run deferred callbacks at this point
+    while(AsyncQuery * query = deferred_callbacks.pop_nowait())
+        delete query;
 }
 
 void QueryThread::Update()
@@ -373,6 +429,14 @@ QueryThread::~QueryThread()
 void DirectDatabase::thread_proc_query()
 {
     DatabaseConnection * con = GetFreeConnection();
+    while(AsyncQuery * aq = async_queue.pop_nowait())
+    {
+        aq->PerformQueries(con);
+        if(aq->deferred)
+            deferred_callbacks.push(aq);
+        else aq->Finish();
+    }
+
     QueryBuffer * q = query_buffer.pop_nowait();
     while(q != NULL)
     {
@@ -390,6 +454,29 @@ void DirectDatabase::QueueAsyncQuery(AsyncQuery * query)
     query->Perform();
 }
 
+void DirectDatabase::QueueThreadedAsyncQuery(AsyncQuery * query)
+{
+    query->db = this;
+    if( qt != NULL )
+        async_queue.push( query );
+    else query->Perform();
+}
+
+void DirectDatabase::QueueDeferredAsyncQuery(AsyncQuery * query)
+{
+    query->db = this;
+    query->deferred = true;
+    if( qt != NULL )
+        async_queue.push( query );
+    else query->Perform();
+}
+
+void DirectDatabase::ProcessDeferredCallbacks()
+{
+    while(AsyncQuery * query = deferred_callbacks.pop_nowait())
+        query->Finish();
+}
+
 void DirectDatabase::AddQueryBuffer(QueryBuffer * b)
 {
     if( qt != NULL )
@@ -43,12 +43,23 @@ class SERVER_DECL AsyncQuery
     SQLCallbackBase * func;
     std::vector<AsyncQueryResult> queries;
     DirectDatabase * db;
+    bool deferred;
+    bool batched;
 public:
-    AsyncQuery(SQLCallbackBase * f) : func(f) {}
+    AsyncQuery(SQLCallbackBase * f) : func(f), db(NULL), deferred(false), batched(false) {}
     ~AsyncQuery();
     void AddQuery(const char * format, ...);
+    void AddQueryStr(const std::string& str);
     void Perform();
     RONIN_INLINE void SetDB(DirectDatabase * dbb) { db = dbb; }
+    // Send every query as one multi statement round trip, only for queries built from trusted values
+    RONIN_INLINE void SetBatched() { batched = true; }
+
+protected:
+    // Sends every query over one connection, results are stored in order
+    void PerformQueries(DatabaseConnection * conn);
+    // Runs the callback and deletes the query
+    void Finish();
 };
 
 class SERVER_DECL QueryBuffer
@@ -103,6 +114,11 @@ public:
     std::string EscapeString(const char * esc, DatabaseConnection *con);
 
     void QueueAsyncQuery(AsyncQuery * query);
+    // Queries and callback are both run on the query thread
+    void QueueThreadedAsyncQuery(AsyncQuery * query);
+    // Queries are run on the query thread, the callback waits for ProcessDeferredCallbacks
+    void QueueDeferredAsyncQuery(AsyncQuery * query);
+    void ProcessDeferredCallbacks();
     void EndThreads();
     
     void thread_proc_query();
@@ -129,6 +145,7 @@ protected:
 
     ////////////////////////////////
     FQueue<QueryBuffer*> query_buffer;
+    FQueue<AsyncQuery*> async_queue, deferred_callbacks;
 
     ////////////////////////////////
     FQueue<char*> queries_queue;
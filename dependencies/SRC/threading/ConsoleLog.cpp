@@ -34,6 +34,46 @@ static const char* colorstrings[TPURPLE+1] = {
 };
 #endif
 
+// Hands the thread's ring back to the log on thread exit so the next new thread can reuse it
+struct LogThreadRing
+{
+    LogThreadRing() : ring(NULL) {}
+    ~LogThreadRing()
+    {
+        if(ring && consoleLog::getSingletonPtr())
+            sLog._ReleaseThreadRing(ring);
+        ring = NULL;
+    }
+
+    LogRingBuffer *ring;
+};
+
+static thread_local LogThreadRing t_logRing;
+
+consoleLog::consoleLog() : m_logLevel(0), m_clogLevel(0), m_fileLevel(-1), m_delayPrint(false), m_recordSequence(0), m_drainSequence(0), m_logFile(NULL), m_logFileSize(0), m_logFileRotateSize(0)
+{
+
+}
+
+consoleLog::~consoleLog()
+{
+    if(m_logFile)
+        fclose(m_logFile);
+    m_logFile = NULL;
+
+    for(std::vector<LogRingBuffer*>::iterator itr = m_threadRings.begin(); itr != m_threadRings.end(); ++itr)
+    {
+        while(LogRecord *record = (*itr)->Peek())
+        {
+            LogReleaseRecord(record);
+            (*itr)->FinishRead();
+        }
+        delete *itr;
+    }
+    m_threadRings.clear();
+    m_freeRings.clear();
+}
+
 void consoleLog::Init(int log_Level)
 {
     m_logLevel = log_Level;
@@ -46,10 +86,35 @@ void consoleLog::Init(int log_Level)
 #endif
 }
 
+void consoleLog::SetFileLogging(int fileLevel, const char *fileName, uint32 rotateSize)
+{
+    AcquireLock();
+    if(m_logFile && (fileLevel < 0 || m_logFileName.compare(fileName)))
+    {
+        fclose(m_logFile);
+        m_logFile = NULL;
+    }
+
+    m_fileLevel = fileLevel;
+    m_logFileName = fileName;
+    m_logFileRotateSize = rotateSize;
+    if(m_fileLevel >= 0 && m_logFile == NULL)
+    {
+        if((m_logFile = fopen(m_logFileName.c_str(), "a")) != NULL)
+        {
+            fseek(m_logFile, 0, SEEK_END);
+            m_logFileSize = ftell(m_logFile);
+        }
+    }
+    ReleaseLock();
+}
+
 unsigned int consoleLog::Update(int targetTime)
 {
     if(m_delayPrint == false)
     {
+        // Flush anything queued before delayed printing was turned off
+        _DrainRings();
         Sleep(targetTime);
         return targetTime;
     }
@@ -57,54 +122,220 @@ unsigned int consoleLog::Update(int targetTime)
     unsigned int counter = 0, now, start = getMSTime();
     while(counter < targetTime)
     {
-        AcquireLock();
-        while(!m_delayedMessages.empty())
-        {
-            int color = m_delayedMessages.begin()->first.first;
-            time_t printTimer = m_delayedMessages.begin()->first.second;
-            std::string header = m_delayedMessages.begin()->second.first;
-            std::string message = m_delayedMessages.begin()->second.second;
-            m_delayedMessages.erase(m_delayedMessages.begin());
-            ReleaseLock();
-
-            if(printTimer)
-            {
-                PrintTime(printTimer);
-                std::printf("N ");
-            }
-
-            if(!header.empty())
-            {
-                SetColor(TWHITE);
-                std::printf("%s", header.c_str());
-                SetColor(TNORMAL);
-            }
-
-            if(color) SetColor(color);
-            std::printf("%s", message.c_str());
-            SetColor(TNORMAL);
-
-            // Update counter inside loop
-            if((now = getMSTime()) != start)
-            {
-                counter += getMSTimeDiff(now, start);
-                start = now;
-            }
-            AcquireLock();
-        }
-        ReleaseLock();
+        _DrainRings();
         Sleep(1);
 
         // Update counter
         if((now = getMSTime()) != start)
         {
-            counter += now-start;
+            counter += getMSTimeDiff(now, start);
             start = now;
         }
     }
     return counter;
 }
 
+LogRingBuffer *consoleLog::_GetThreadRing()
+{
+    if(t_logRing.ring == NULL)
+    {
+        AcquireLock();
+        if(!m_freeRings.empty())
+        {
+            t_logRing.ring = m_freeRings.back();
+            m_freeRings.pop_back();
+        }
+        else
+        {
+            t_logRing.ring = new LogRingBuffer();
+            m_threadRings.push_back(t_logRing.ring);
+        }
+        ReleaseLock();
+    }
+    return t_logRing.ring;
+}
+
+void consoleLog::_ReleaseThreadRing(LogRingBuffer *ring)
+{
+    // The ring stays registered so whatever it still holds gets drained, it's only handed to the next thread
+    AcquireLock();
+    m_freeRings.push_back(ring);
+    ReleaseLock();
+}
+
+uint32 consoleLog::_DrainRings()
+{
+    static char formatBuffer[32768];
+
+    AcquireLock();
+    std::vector<LogRingBuffer*> rings(m_threadRings);
+    ReleaseLock();
+
+    uint32 count = 0, dropped = 0;
+    for(std::vector<LogRingBuffer*>::iterator itr = rings.begin(); itr != rings.end(); ++itr)
+        dropped += (*itr)->TakeDropped();
+    if(dropped)
+    {
+        snprintf(formatBuffer, sizeof(formatBuffer), "%u log messages dropped, log rings were full\n", dropped);
+        AcquireLock();
+        _WriteMessage(1, TRED, LOGRECORD_FLAG_NONE, GetTime(), "Log", formatBuffer);
+        ReleaseLock();
+    }
+
+    while(true)
+    {
+        // Pick the oldest pending record across all threads
+        LogRingBuffer *ring = NULL;
+        LogRecord *record = NULL;
+        for(std::vector<LogRingBuffer*>::iterator itr = rings.begin(); itr != rings.end(); ++itr)
+        {
+            LogRecord *pending = (*itr)->Peek();
+            if(pending && (record == NULL || pending->sequence < record->sequence))
+                ring = *itr, record = pending;
+        }
+
+        // A thread holding an earlier sequence hasn't published it yet, wait for it instead of printing out of order
+        if(record == NULL || record->sequence != m_drainSequence)
+            break;
+        ++m_drainSequence;
+
+        size_t len = LogFormatRecord(record, formatBuffer, sizeof(formatBuffer)-2), pos;
+        if((record->flags & LOGRECORD_FLAG_NEWLINE) && (len == 0 || (pos = std::string(formatBuffer, len).rfind("\n")) == std::string::npos || pos+5 < len))
+            formatBuffer[len++] = '\n', formatBuffer[len] = 0;
+
+        AcquireLock();
+        _WriteMessage(record->level, record->color, record->flags, record->type == LOGRECORD_NOTICE ? record->timeStamp : 0, record->GetSource(), formatBuffer);
+        ReleaseLock();
+
+        LogReleaseRecord(record);
+        ring->FinishRead();
+        ++count;
+    }
+    return count;
+}
+
+void consoleLog::_Log(uint8 type, int level, int color, uint8 flags, const char *source, const char *format, va_list ap)
+{
+    if(m_delayPrint)
+    {
+        LogRingBuffer *ring = _GetThreadRing();
+        LogRecord *record = ring->BeginWrite();
+        if(record == NULL)
+            return;
+
+        record->timeStamp = type == LOGRECORD_NOTICE ? GetTime() : 0;
+        record->type = type;
+        record->flags = flags;
+        record->color = uint8(color);
+        record->level = int8(level);
+
+        va_list capture;
+        va_copy(capture, ap);
+        bool captured = LogCaptureRecord(record, source, format, capture);
+        va_end(capture);
+        if(captured == false)
+        {   // Fall back to formatting here, it's rare enough
+            char buf[32768];
+            vsnprintf(buf, 32768, format, ap);
+            LogCaptureRawRecord(record, source, buf);
+        }
+
+        // Sequences are handed out as records are published so the drain never waits on a slow capture
+        record->sequence = m_recordSequence++;
+        ring->FinishWrite();
+        return;
+    }
+
+    char buf[32768];
+    vsnprintf(buf, 32768, format, ap);
+
+    size_t pos = 0;
+    std::string message = buf;
+    if(message.empty())
+        return;
+
+    if((flags & LOGRECORD_FLAG_NEWLINE) && ((pos = message.rfind("\n")) == std::string::npos || (pos+5 < message.size())))
+        message.append("\n");
+
+    AcquireLock();
+    _WriteMessage(level, color, flags, type == LOGRECORD_NOTICE ? GetTime() : 0, source, message.c_str());
+    ReleaseLock();
+}
+
+void consoleLog::_LogArgs(uint8 type, int level, int color, uint8 flags, const char *source, const char *format, ...)
+{
+    va_list ap;
+    va_start(ap, format);
+    _Log(type, level, color, flags, source, format, ap);
+    va_end(ap);
+}
+
+void consoleLog::_WriteMessage(int level, int color, uint8 flags, time_t timeStamp, const char *source, const char *message)
+{
+    if(m_logFile && level <= m_fileLevel)
+        _WriteFile(timeStamp, source, message);
+    if(flags & LOGRECORD_FLAG_FILEONLY)
+        return;
+
+    if(timeStamp)
+    {
+        PrintTime(timeStamp);
+        std::printf("N ");
+    }
+
+    if(source && *source)
+    {
+        SetColor(TWHITE);
+        std::printf("%s: ", source);
+        SetColor(TNORMAL);
+    }
+
+    if(color) SetColor(color);
+    std::printf("%s", message);
+    if(color) SetColor(TNORMAL);
+}
+
+void consoleLog::_WriteFile(time_t timeStamp, const char *source, const char *message)
+{
+    int written = 0;
+    if(timeStamp)
+    {
+        tm local = *localtime(&timeStamp);
+        written += fprintf(m_logFile, "%02u:%02u:%02u N ", local.tm_hour, local.tm_min, local.tm_sec);
+    }
+
+    if(source && *source)
+        written += fprintf(m_logFile, "%s: ", source);
+    written += fprintf(m_logFile, "%s", message);
+    if(written > 0)
+        m_logFileSize += written;
+
+    if(m_logFileRotateSize && m_logFileSize >= m_logFileRotateSize)
+        _RotateFile();
+}
+
+void consoleLog::_RotateFile()
+{
+    fclose(m_logFile);
+    m_logFile = NULL;
+
+    char oldName[MAX_PATH], newName[MAX_PATH];
+    snprintf(oldName, MAX_PATH, "%s.%u", m_logFileName.c_str(), LOG_FILE_BACKUPS);
+    remove(oldName);
+    for(uint32 i = LOG_FILE_BACKUPS; i > 1; --i)
+    {
+        snprintf(oldName, MAX_PATH, "%s.%u", m_logFileName.c_str(), i-1);
+        snprintf(newName, MAX_PATH, "%s.%u", m_logFileName.c_str(), i);
+        rename(oldName, newName);
+    }
+
+    snprintf(newName, MAX_PATH, "%s.1", m_logFileName.c_str());
+    rename(m_logFileName.c_str(), newName);
+
+    m_logFile = fopen(m_logFileName.c_str(), "w");
+    m_logFileSize = 0;
+}
+
 void consoleLog::PrintTime(time_t t_override)
 {
     time_t now = t_override ? t_override : GetTime();
@@ -129,293 +360,143 @@ void consoleLog::SetColor(int color)
 void consoleLog::printf( const char *format, ... )
 {
     va_list ap;
-    char buf[32768];
     va_start(ap, format);
-    vsnprintf(buf, 32768, format, ap);
+    _Log(LOGRECORD_PLAIN, 0, 0, LOGRECORD_FLAG_NEWLINE, NULL, format, ap);
     va_end(ap);
-
-    std::string message = buf;
-    if(message.empty())
-        return;
-
-    if(message.find("\n") == std::string::npos)
-        message.append("\n");
-
-    AcquireLock();
-    if(m_delayPrint)
-        m_delayedMessages.push_back(std::make_pair(std::make_pair(0, 0), std::make_pair("", message)));
-    else std::printf(message.c_str());
-    ReleaseLock();
 }
 
 void consoleLog::outString( const char * str, ... )
 {
-    if(m_logLevel < 0)
+    if(m_logLevel < 0 && m_fileLevel < 0)
         return;
 
     va_list ap;
-    char buf[32768];
     va_start(ap, str);
-    vsnprintf(buf, 32768, str, ap);
+    _Log(LOGRECORD_PLAIN, 0, 0, LOGRECORD_FLAG_NEWLINE | (m_logLevel < 0 ? LOGRECORD_FLAG_FILEONLY : 0), NULL, str, ap);
     va_end(ap);
-
-    size_t pos = 0;
-    std::string message = buf;
-    if(message.empty())
-        return;
-
-    if((pos = message.rfind("\n")) == std::string::npos || (pos+5 < message.size()))
-        message.append("\n");
-
-    AcquireLock();
-    if(m_delayPrint)
-        m_delayedMessages.push_back(std::make_pair(std::make_pair(0, 0), std::make_pair("", message)));
-    else std::printf(message.c_str());
-    ReleaseLock();
 }
 
 void consoleLog::outError( const char * err, ... )
 {
-    if(m_logLevel < 1)
+    if(m_logLevel < 1 && m_fileLevel < 1)
         return;
 
     va_list ap;
-    char buf[32768];
     va_start(ap, err);
-    vsnprintf(buf, 32768, err, ap);
+    _Log(LOGRECORD_PLAIN, 1, TRED, LOGRECORD_FLAG_NEWLINE | (m_logLevel < 1 ? LOGRECORD_FLAG_FILEONLY : 0), NULL, err, ap);
     va_end(ap);
-
-    size_t pos = 0;
-    std::string message = buf;
-    if(message.empty())
-        return;
-
-    if((pos = message.rfind("\n")) == std::string::npos || (pos+5 < message.size()))
-        message.append("\n");
-
-    AcquireLock();
-    if(m_delayPrint)
-        m_delayedMessages.push_back(std::make_pair(std::make_pair(TRED, 0), std::make_pair("", message)));
-    else
-    {
-        SetColor(TRED);
-        std::printf(message.c_str());
-        SetColor(TNORMAL);
-    }
-    ReleaseLock();
 }
 
 void consoleLog::outDetail( const char * str, ... )
 {
-    if(m_logLevel < 2)
+    if(m_logLevel < 2 && m_fileLevel < 2)
         return;
 
     va_list ap;
-    char buf[32768];
     va_start(ap, str);
-    vsnprintf(buf, 32768, str, ap);
+    _Log(LOGRECORD_PLAIN, 2, 0, LOGRECORD_FLAG_NEWLINE | (m_logLevel < 2 ? LOGRECORD_FLAG_FILEONLY : 0), NULL, str, ap);
     va_end(ap);
-
-    size_t pos = 0;
-    std::string message = buf;
-    if(message.empty())
-        return;
-
-    if((pos = message.rfind("\n")) == std::string::npos || (pos+5 < message.size()))
-        message.append("\n");
-
-    AcquireLock();
-    if(m_delayPrint)
-        m_delayedMessages.push_back(std::make_pair(std::make_pair(0, 0), std::make_pair("", std::string(buf))));
-    else std::printf(message.c_str());
-    ReleaseLock();
 }
 
 void consoleLog::outDebug( const char * str, ... )
 {
-    if(m_logLevel < 3)
+    if(m_logLevel < 3 && m_fileLevel < 3)
         return;
 
     va_list ap;
-    char buf[32768];
     va_start(ap, str);
-    vsnprintf(buf, 32768, str, ap);
+    _Log(LOGRECORD_PLAIN, 3, 0, LOGRECORD_FLAG_NEWLINE | (m_logLevel < 3 ? LOGRECORD_FLAG_FILEONLY : 0), NULL, str, ap);
     va_end(ap);
-
-    size_t pos = 0;
-    std::string message = buf;
-    if(message.empty())
-        return;
-
-    if((pos = message.rfind("\n")) == std::string::npos || (pos+5 < message.size()))
-        message.append("\n");
-
-    AcquireLock();
-    if(m_delayPrint)
-        m_delayedMessages.push_back(std::make_pair(std::make_pair(0, 0), std::make_pair("", message)));
-    else std::printf(message.c_str());
-    ReleaseLock();
 }
 
 void consoleLog::outDebugInLine(const char * str, ...)
 {
-    if(m_logLevel < 3)
+    if(m_logLevel < 3 && m_fileLevel < 3)
         return;
 
     va_list ap;
-    char buf[32768];
     va_start(ap, str);
-    vsnprintf(buf, 32768, str, ap);
+    _Log(LOGRECORD_PLAIN, 3, 0, (m_logLevel < 3 ? LOGRECORD_FLAG_FILEONLY : LOGRECORD_FLAG_NONE), NULL, str, ap);
     va_end(ap);
-
-    std::string message = buf;
-    if(message.empty())
-        return;
-
-    AcquireLock();
-    if(m_delayPrint)
-        m_delayedMessages.push_back(std::make_pair(std::make_pair(0, 0), std::make_pair("", message)));
-    else std::printf(message.c_str());
-    ReleaseLock();
 }
 
 void consoleLog::outColor(int color, const char * str, ...)
 {
     va_list ap;
-    char buf[32768];
     va_start(ap, str);
-    vsnprintf(buf, 32768, str, ap);
+    _Log(LOGRECORD_PLAIN, 0, color, LOGRECORD_FLAG_NEWLINE, NULL, str, ap);
     va_end(ap);
-
-    size_t pos = 0;
-    std::string message = buf;
-    if(message.empty())
-        return;
-
-    if((pos = message.rfind("\n")) == std::string::npos || (pos+5 < message.size()))
-        message.append("\n");
-
-    AcquireLock();
-    if(m_delayPrint)
-        m_delayedMessages.push_back(std::make_pair(std::make_pair(color, 0), std::make_pair("", message)));
-    else std::printf(message.c_str());
-    ReleaseLock();
 }
 
 void consoleLog::Line()
 {
-    AcquireLock();
-    if(m_delayPrint)
-        m_delayedMessages.push_back(std::make_pair(std::make_pair(0, 0), std::make_pair("", std::string("\n"))));
-    else std::printf("\n");
-    ReleaseLock();
+    _LogArgs(LOGRECORD_PLAIN, 0, 0, LOGRECORD_FLAG_NONE, NULL, "\n");
 }
 
 void consoleLog::Notice(const char * source, const char * format, ...)
 {
-    if(m_clogLevel < 0)
+    if(m_clogLevel < 0 && m_fileLevel < 0)
         return;
 
     va_list ap;
     va_start(ap, format);
-    char msg0[1024];
-    vsnprintf(msg0, 1024, format, ap);
+    _Log(LOGRECORD_NOTICE, 0, TNORMAL, LOGRECORD_FLAG_NEWLINE | (m_clogLevel < 0 ? LOGRECORD_FLAG_FILEONLY : 0), source, format, ap);
     va_end(ap);
-    CNotice(TNORMAL, source, msg0);
 }
 
 void consoleLog::Info(const char * source, const char * format, ...)
 {
     va_list ap;
     va_start(ap, format);
-    char msg0[1024];
-    vsnprintf(msg0, 1024, format, ap);
+    _Log(LOGRECORD_NOTICE, 0, TPURPLE, LOGRECORD_FLAG_NEWLINE, source, format, ap);
     va_end(ap);
-    CNotice(TPURPLE, source, msg0);
 }
 
 void consoleLog::Error(const char * source, const char * format, ...)
 {
-    if(m_clogLevel < 1)
+    if(m_clogLevel < 1 && m_fileLevel < 1)
         return;
 
     va_list ap;
     va_start(ap, format);
-    char msg0[1024];
-    vsnprintf(msg0, 1024, format, ap);
+    _Log(LOGRECORD_NOTICE, 1, TRED, LOGRECORD_FLAG_NEWLINE | (m_clogLevel < 1 ? LOGRECORD_FLAG_FILEONLY : 0), source, format, ap);
     va_end(ap);
-    CNotice(TRED, source, msg0);
 }
 
 void consoleLog::Warning(const char * source, const char * format, ...)
 {
-    if(m_clogLevel < 2)
+    if(m_clogLevel < 2 && m_fileLevel < 2)
         return;
 
     /* warning is old loglevel 2/detail */
     va_list ap;
     va_start(ap, format);
-    char msg0[1024];
-    vsnprintf(msg0, 1024, format, ap);
+    _Log(LOGRECORD_NOTICE, 2, TYELLOW, LOGRECORD_FLAG_NEWLINE | (m_clogLevel < 2 ? LOGRECORD_FLAG_FILEONLY : 0), source, format, ap);
     va_end(ap);
-    CNotice(TYELLOW, source, msg0);
 }
 
 void consoleLog::Success(const char * source, const char * format, ...)
 {
     va_list ap;
     va_start(ap, format);
-    char msg0[1024];
-    vsnprintf(msg0, 1024, format, ap);
+    _Log(LOGRECORD_NOTICE, 0, TGREEN, LOGRECORD_FLAG_NEWLINE, source, format, ap);
     va_end(ap);
-    CNotice(TGREEN, source, msg0);
 }
 
 void consoleLog::Debug(const char * source, const char * format, ...)
 {
-    if(m_clogLevel != 3 && m_clogLevel != 6)
+    if(m_clogLevel != 3 && m_clogLevel != 6 && m_fileLevel < 3)
         return;
 
     va_list ap;
     va_start(ap, format);
-    char msg0[1024];
-    vsnprintf(msg0, 1024, format, ap);
+    _Log(LOGRECORD_NOTICE, 3, TBLUE, LOGRECORD_FLAG_NEWLINE | ((m_clogLevel != 3 && m_clogLevel != 6) ? LOGRECORD_FLAG_FILEONLY : 0), source, format, ap);
     va_end(ap);
-    CNotice(TBLUE, source, msg0);
 }
 
 void consoleLog::CNotice(int color, const char * source, const char * message)
 {
-    size_t pos = 0;
-    std::string strHeader, strMessage = message;
-    if(strMessage.empty())
-        return;
-
-    if((pos = strMessage.rfind("\n")) == std::string::npos || (pos+5 < strMessage.size()))
-        strMessage.append("\n");
-    strHeader.append(source);
-    if(!strHeader.empty())
-        strHeader.append(": ");
-
-    AcquireLock();
-    if(m_delayPrint)
-        m_delayedMessages.push_back(std::make_pair(std::make_pair(color, GetTime()), std::make_pair(strHeader, strMessage)));
-    else
-    {
-        PrintTime();
-        std::printf("N ");
-        if(!strHeader.empty())
-        {
-            SetColor(TWHITE);
-            std::printf(strHeader.c_str());
-            SetColor(TNORMAL);
-        }
-
-        SetColor(color);
-        std::printf(strMessage.c_str());
-        SetColor(TNORMAL);
-    }
-    ReleaseLock();
+    _LogArgs(LOGRECORD_NOTICE, 0, color, LOGRECORD_FLAG_NEWLINE, source, "%s", message);
 }
 
 void consoleLog::LargeErrorMessage(int Colour, ...)
@@ -44,11 +44,17 @@
 
 #endif
 
+#define LOG_FILE_BACKUPS 5
+
 class SERVER_DECL consoleLog : public Singleton<consoleLog>
 {
 public:
+    consoleLog();
+    ~consoleLog();
+
     void Init(int log_Level);
     void SetDelayPrint(bool delay) { m_delayPrint = delay; }
+    void SetFileLogging(int fileLevel, const char *fileName, uint32 rotateSize);
 
     unsigned int Update(int targetTime);
     void SetLoggingLevel(int loglevel) { m_logLevel = loglevel; };
@@ -57,6 +63,10 @@ public:
     int GetLogLevel() { return m_logLevel; }
     int GetCLogLevel() { return m_clogLevel; }
 
+    bool IsLogging(int level) { return m_logLevel >= level || m_fileLevel >= level; }
+    bool IsCLogging(int level) { return m_clogLevel >= level || m_fileLevel >= level; }
+    bool IsCDebugLogging() { return m_clogLevel == 3 || m_clogLevel == 6 || m_fileLevel >= 3; }
+
     void printf( const char *format, ... );
 
 private:
@@ -67,6 +77,19 @@ private:
     void AcquireLock() { logLock.Acquire(); };
     void ReleaseLock() { logLock.Release(); };
 
+    // Queues the message into our thread's ring when delayed, otherwise prints it right away
+    void _Log(uint8 type, int level, int color, uint8 flags, const char *source, const char *format, va_list ap);
+    void _LogArgs(uint8 type, int level, int color, uint8 flags, const char *source, const char *format, ...);
+    void _WriteMessage(int level, int color, uint8 flags, time_t timeStamp, const char *source, const char *message);
+    void _WriteFile(time_t timeStamp, const char *source, const char *message);
+    void _RotateFile();
+
+    friend struct LogThreadRing;
+    LogRingBuffer *_GetThreadRing();
+    void _ReleaseThreadRing(LogRingBuffer *ring);
+    // Formats and prints pending records in sequence order, stopping at the first sequence not yet published, returns the amount printed
+    uint32 _DrainRings();
+
 public: // String outputs
     void outString( const char * str, ... );
     void outError( const char * err, ... );
@@ -93,14 +116,30 @@ private:
 #endif
 
     Mutex logLock;
-    int m_logLevel, m_clogLevel;
+    int m_logLevel, m_clogLevel, m_fileLevel;
 
     bool m_delayPrint;
-    std::vector<std::pair<std::pair<int, time_t>, std::pair<std::string, std::string>>> m_delayedMessages;
+
+    // Per thread record rings, registration is guarded by logLock, rings of exited threads wait in m_freeRings for reuse
+    std::vector<LogRingBuffer*> m_threadRings, m_freeRings;
+    std::atomic<uint64> m_recordSequence;
+    // Next sequence the log thread prints, only touched while draining
+    uint64 m_drainSequence;
+
+    FILE *m_logFile;
+    std::string m_logFileName;
+    uint32 m_logFileSize, m_logFileRotateSize;
 };
 
 #define sLog consoleLog::getSingleton()
 
-#define OUT_ERROR sLog.outError
-#define OUT_DEBUG sLog.outDebug
-#define OUT_DETAIL sLog.outDetail
+// Logging levels compiled out entirely, arguments of filtered calls are never evaluated
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 7
+#endif
+
+#define OUT_ERROR if(LOG_COMPILE_LEVEL < 1 || !sLog.IsLogging(1)) {} else sLog.outError
+#define OUT_DEBUG if(LOG_COMPILE_LEVEL < 3 || !sLog.IsLogging(3)) {} else sLog.outDebug
+#define OUT_DETAIL if(LOG_COMPILE_LEVEL < 2 || !sLog.IsLogging(2)) {} else sLog.outDetail
+#define CLOG_WARNING if(LOG_COMPILE_LEVEL < 2 || !sLog.IsCLogging(2)) {} else sLog.Warning
+#define CLOG_DEBUG if(LOG_COMPILE_LEVEL < 3 || !sLog.IsCDebugLogging()) {} else sLog.Debug
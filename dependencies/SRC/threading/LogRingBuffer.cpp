@@ -0,0 +1,348 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Threading.h"
+
+enum LogArgLength : uint8
+{
+    LOGARGLEN_DEFAULT,
+    LOGARGLEN_CHAR,
+    LOGARGLEN_SHORT,
+    LOGARGLEN_LONG,
+    LOGARGLEN_LONGLONG,
+    LOGARGLEN_SIZE,
+    LOGARGLEN_INTMAX,
+    LOGARGLEN_PTRDIFF,
+    LOGARGLEN_LONGDOUBLE,
+    LOGARGLEN_INT64
+};
+
+struct LogFormatSpec
+{
+    const char *start;
+    size_t len;
+    char conversion;
+    uint8 length;
+    bool widthStar, precisionStar;
+};
+
+// Parses a conversion starting at the '%', returns the character past the conversion or NULL when malformed
+static const char *_ParseLogSpec(const char *p, LogFormatSpec &spec)
+{
+    spec.start = p++;
+    spec.length = LOGARGLEN_DEFAULT;
+    spec.widthStar = spec.precisionStar = false;
+
+    while(*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0')
+        ++p;
+    if(*p == '*')
+        spec.widthStar = true, ++p;
+    else while(*p >= '0' && *p <= '9')
+        ++p;
+    if(*p == '.')
+    {
+        ++p;
+        if(*p == '*')
+            spec.precisionStar = true, ++p;
+        else while(*p >= '0' && *p <= '9')
+            ++p;
+    }
+
+    switch(*p)
+    {
+    case 'h': ++p; if(*p == 'h') { spec.length = LOGARGLEN_CHAR; ++p; } else spec.length = LOGARGLEN_SHORT; break;
+    case 'l': ++p; if(*p == 'l') { spec.length = LOGARGLEN_LONGLONG; ++p; } else spec.length = LOGARGLEN_LONG; break;
+    case 'z': ++p; spec.length = LOGARGLEN_SIZE; break;
+    case 'j': ++p; spec.length = LOGARGLEN_INTMAX; break;
+    case 't': ++p; spec.length = LOGARGLEN_PTRDIFF; break;
+    case 'L': ++p; spec.length = LOGARGLEN_LONGDOUBLE; break;
+    case 'I':
+        {
+            ++p;
+            if(p[0] == '6' && p[1] == '4')
+                p += 2, spec.length = LOGARGLEN_INT64;
+            else if(p[0] == '3' && p[1] == '2')
+                p += 2;
+            else spec.length = LOGARGLEN_SIZE;
+        }break;
+    }
+
+    if(*p == 0)
+        return NULL;
+    spec.conversion = *p++;
+    spec.len = p-spec.start;
+    return p;
+}
+
+class LogArgWriter
+{
+public:
+    LogArgWriter(uint8 *buffer, size_t len) : m_buffer(buffer), m_len(len), m_pos(0) {}
+
+    bool Put(const void *data, size_t len)
+    {
+        if(m_pos + len > m_len)
+            return false;
+        memcpy(&m_buffer[m_pos], data, len);
+        m_pos += len;
+        return true;
+    }
+
+    template<typename T> bool Put(T value) { return Put(&value, sizeof(T)); }
+    size_t Size() { return m_pos; }
+
+private:
+    uint8 *m_buffer;
+    size_t m_len, m_pos;
+};
+
+bool LogCaptureRecord(LogRecord *record, const char *source, const char *format, va_list ap)
+{
+    size_t sourceLen = source ? strlen(source) : 0, formatLen = strlen(format);
+    if(sourceLen + formatLen + 2 > sizeof(record->payload))
+        return false;
+
+    memcpy(record->payload, source ? source : "", sourceLen+1);
+    memcpy(&record->payload[sourceLen+1], format, formatLen+1);
+    record->sourceLen = uint16(sourceLen);
+    record->formatLen = uint16(formatLen);
+
+    LogFormatSpec spec;
+    LogArgWriter writer((uint8*)&record->payload[sourceLen+formatLen+2], sizeof(record->payload)-(sourceLen+formatLen+2));
+    for(const char *p = format; *p;)
+    {
+        if(*p != '%')
+        {
+            ++p;
+            continue;
+        }
+        if(p[1] == '%')
+        {
+            p += 2;
+            continue;
+        }
+        if((p = _ParseLogSpec(p, spec)) == NULL)
+            return false;
+
+        if(spec.widthStar && !writer.Put<int64>(va_arg(ap, int)))
+            return false;
+        if(spec.precisionStar && !writer.Put<int64>(va_arg(ap, int)))
+            return false;
+
+        bool res = true;
+        switch(spec.conversion)
+        {
+        case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+            {
+                switch(spec.length)
+                {
+                case LOGARGLEN_LONG: res = writer.Put<int64>(va_arg(ap, long)); break;
+                case LOGARGLEN_LONGLONG: res = writer.Put<int64>(va_arg(ap, long long)); break;
+                case LOGARGLEN_INT64: res = writer.Put<int64>(va_arg(ap, int64)); break;
+                case LOGARGLEN_SIZE: res = writer.Put<int64>(int64(va_arg(ap, size_t))); break;
+                case LOGARGLEN_INTMAX: res = writer.Put<int64>(int64(va_arg(ap, intmax_t))); break;
+                case LOGARGLEN_PTRDIFF: res = writer.Put<int64>(int64(va_arg(ap, ptrdiff_t))); break;
+                default: res = writer.Put<int64>(va_arg(ap, int)); break;
+                }
+            }break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            {
+                if(spec.length == LOGARGLEN_LONGDOUBLE)
+                    res = writer.Put<double>(double(va_arg(ap, long double)));
+                else res = writer.Put<double>(va_arg(ap, double));
+            }break;
+        case 's':
+            {
+                if(spec.length == LOGARGLEN_LONG)
+                    return false;
+
+                const char *str = va_arg(ap, const char*);
+                if(str == NULL)
+                    str = "(null)";
+                size_t len = strlen(str);
+                if(len > 0xFFFF)
+                    return false;
+                res = writer.Put<uint16>(uint16(len)) && writer.Put(str, len);
+            }break;
+        case 'p':
+            res = writer.Put<uint64>(uint64(uintptr_t(va_arg(ap, void*))));
+            break;
+        default: // %n and anything we don't understand gets formatted by the caller
+            return false;
+        }
+
+        if(res == false)
+            return false;
+    }
+
+    record->argLen = uint16(writer.Size());
+    record->flags &= ~LOGRECORD_FLAG_RAW;
+    return true;
+}
+
+void LogCaptureRawRecord(LogRecord *record, const char *source, const char *message)
+{
+    size_t sourceLen = source ? strlen(source) : 0;
+    if(sourceLen > 64)
+        sourceLen = 64;
+    memcpy(record->payload, source ? source : "", sourceLen);
+    record->payload[sourceLen] = 0;
+
+    size_t messageLen = std::min<size_t>(strlen(message), 0xFFFF);
+    if(messageLen + sourceLen + 2 > sizeof(record->payload))
+    {
+        char *text = (char*)malloc(messageLen+1);
+        memcpy(text, message, messageLen);
+        text[messageLen] = 0;
+        memcpy(&record->payload[sourceLen+1], &text, sizeof(char*));
+        record->flags |= LOGRECORD_FLAG_HEAP;
+    }
+    else
+    {
+        memcpy(&record->payload[sourceLen+1], message, messageLen);
+        record->payload[sourceLen+1+messageLen] = 0;
+        record->flags &= ~LOGRECORD_FLAG_HEAP;
+    }
+
+    record->sourceLen = uint16(sourceLen);
+    record->formatLen = uint16(messageLen);
+    record->argLen = 0;
+    record->flags |= LOGRECORD_FLAG_RAW;
+}
+
+void LogReleaseRecord(LogRecord *record)
+{
+    if(record->flags & LOGRECORD_FLAG_HEAP)
+        free(record->GetHeapText());
+    record->flags &= ~LOGRECORD_FLAG_HEAP;
+}
+
+class LogArgReader
+{
+public:
+    LogArgReader(const uint8 *buffer, size_t len) : m_buffer(buffer), m_len(len), m_pos(0) {}
+
+    template<typename T> T Get()
+    {
+        T value = T();
+        if(m_pos + sizeof(T) <= m_len)
+            memcpy(&value, &m_buffer[m_pos], sizeof(T));
+        m_pos += sizeof(T);
+        return value;
+    }
+
+    const char *GetString(uint16 &len)
+    {
+        len = Get<uint16>();
+        const char *ret = (const char*)&m_buffer[m_pos];
+        m_pos += len;
+        return ret;
+    }
+
+private:
+    const uint8 *m_buffer;
+    size_t m_len, m_pos;
+};
+
+size_t LogFormatRecord(const LogRecord *record, char *buffer, size_t bufferLen)
+{
+    const char *format = record->GetFormat();
+    if(record->flags & LOGRECORD_FLAG_RAW)
+    {
+        size_t len = std::min<size_t>(record->formatLen, bufferLen-1);
+        memcpy(buffer, (record->flags & LOGRECORD_FLAG_HEAP) ? record->GetHeapText() : format, len);
+        buffer[len] = 0;
+        return len;
+    }
+
+    LogFormatSpec spec;
+    LogArgReader reader(record->GetArgs(), record->argLen);
+    char specBuffer[64];
+    size_t pos = 0;
+    for(const char *p = format; *p && pos < bufferLen-1;)
+    {
+        if(*p != '%')
+        {
+            buffer[pos++] = *p++;
+            continue;
+        }
+        if(p[1] == '%')
+        {
+            buffer[pos++] = '%';
+            p += 2;
+            continue;
+        }
+        if((p = _ParseLogSpec(p, spec)) == NULL || spec.len >= 32)
+            break;
+
+        // Substitute our captured star values back into the specifier
+        size_t specLen = 0;
+        for(size_t i = 0; i < spec.len; ++i)
+        {
+            if(spec.start[i] == '*')
+                specLen += snprintf(&specBuffer[specLen], sizeof(specBuffer)-specLen, "%d", int(reader.Get<int64>()));
+            else specBuffer[specLen++] = spec.start[i];
+        }
+        specBuffer[specLen] = 0;
+
+        int res = 0;
+        char *out = &buffer[pos];
+        size_t remaining = bufferLen-pos;
+        switch(spec.conversion)
+        {
+        case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+            {
+                int64 value = reader.Get<int64>();
+                switch(spec.length)
+                {
+                case LOGARGLEN_LONG: res = snprintf(out, remaining, specBuffer, long(value)); break;
+                case LOGARGLEN_LONGLONG: res = snprintf(out, remaining, specBuffer, (long long)value); break;
+                case LOGARGLEN_INT64: res = snprintf(out, remaining, specBuffer, value); break;
+                case LOGARGLEN_SIZE: res = snprintf(out, remaining, specBuffer, size_t(value)); break;
+                case LOGARGLEN_INTMAX: res = snprintf(out, remaining, specBuffer, intmax_t(value)); break;
+                case LOGARGLEN_PTRDIFF: res = snprintf(out, remaining, specBuffer, ptrdiff_t(value)); break;
+                default: res = snprintf(out, remaining, specBuffer, int(value)); break;
+                }
+            }break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            {
+                double value = reader.Get<double>();
+                if(spec.length == LOGARGLEN_LONGDOUBLE)
+                    res = snprintf(out, remaining, specBuffer, (long double)value);
+                else res = snprintf(out, remaining, specBuffer, value);
+            }break;
+        case 's':
+            {
+                uint16 len;
+                const char *str = reader.GetString(len);
+                std::string value(str, len);
+                res = snprintf(out, remaining, specBuffer, value.c_str());
+            }break;
+        case 'p':
+            res = snprintf(out, remaining, specBuffer, (void*)uintptr_t(reader.Get<uint64>()));
+            break;
+        }
+
+        if(res > 0)
+            pos += std::min<size_t>(res, remaining-1);
+    }
+
+    buffer[pos] = 0;
+    return pos;
+}
@@ -0,0 +1,115 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#define LOG_RECORD_SIZE 512
+#define LOG_RING_RECORD_COUNT 256
+#define LOG_RING_CACHE_LINE 64
+
+enum LogRecordType : uint8
+{
+    LOGRECORD_PLAIN     = 0,
+    LOGRECORD_NOTICE    = 1
+};
+
+enum LogRecordFlags : uint8
+{
+    LOGRECORD_FLAG_NONE     = 0x00,
+    LOGRECORD_FLAG_NEWLINE  = 0x01, // Append a newline when the message doesn't end in one
+    LOGRECORD_FLAG_RAW      = 0x02, // Arguments couldn't be captured, payload holds the formatted text
+    LOGRECORD_FLAG_FILEONLY = 0x04, // Filtered from the screen, only written to the log file
+    LOGRECORD_FLAG_HEAP     = 0x08  // Raw text didn't fit the payload, it holds a pointer to a heap copy instead
+};
+
+/** Binary log record
+ * Payload layout is [source\0][format\0][captured arguments], formatting is done by the log thread.
+ */
+struct LogRecord
+{
+    uint64 sequence;
+    time_t timeStamp;
+    uint8 type, flags, color;
+    int8 level;
+    uint16 sourceLen, formatLen, argLen;
+    char payload[LOG_RECORD_SIZE - (sizeof(uint64) + sizeof(time_t) + 4 + 6)];
+
+    RONIN_INLINE const char *GetSource() const { return payload; }
+    RONIN_INLINE const char *GetFormat() const { return &payload[sourceLen+1]; }
+    RONIN_INLINE const uint8 *GetArgs() const { return (const uint8*)&payload[sourceLen+formatLen+2]; }
+    RONIN_INLINE char *GetHeapText() const { char *text; memcpy(&text, &payload[sourceLen+1], sizeof(char*)); return text; }
+};
+
+/** Single producer, single consumer ring of log records
+ * Every thread that logs owns one, the log thread drains them all.
+ * A full ring never blocks, the record is dropped and counted instead.
+ */
+class SERVER_DECL LogRingBuffer
+{
+public:
+    LogRingBuffer() : m_writePos(0), m_readPos(0), m_dropped(0) {}
+
+    // Producer side
+    RONIN_INLINE LogRecord *BeginWrite()
+    {
+        uint32 writePos = m_writePos.load(std::memory_order_relaxed);
+        if(writePos - m_readPos.load(std::memory_order_acquire) >= LOG_RING_RECORD_COUNT)
+        {
+            ++m_dropped;
+            return NULL;
+        }
+        return &m_records[writePos & (LOG_RING_RECORD_COUNT-1)];
+    }
+
+    RONIN_INLINE void FinishWrite() { m_writePos.fetch_add(1, std::memory_order_release); }
+
+    // Consumer side
+    RONIN_INLINE LogRecord *Peek()
+    {
+        uint32 readPos = m_readPos.load(std::memory_order_relaxed);
+        if(readPos == m_writePos.load(std::memory_order_acquire))
+            return NULL;
+        return &m_records[readPos & (LOG_RING_RECORD_COUNT-1)];
+    }
+
+    RONIN_INLINE void FinishRead() { m_readPos.fetch_add(1, std::memory_order_release); }
+
+    RONIN_INLINE uint32 TakeDropped() { return m_dropped.exchange(0); }
+
+private:
+    std::atomic<uint32> m_writePos;
+    char _writePad[LOG_RING_CACHE_LINE - sizeof(std::atomic<uint32>)];
+    std::atomic<uint32> m_readPos;
+    char _readPad[LOG_RING_CACHE_LINE - sizeof(std::atomic<uint32>)];
+    std::atomic<uint32> m_dropped;
+
+    LogRecord m_records[LOG_RING_RECORD_COUNT];
+};
+
+// Copies source, format and the variadic arguments into the record, returns false if they don't fit or can't be captured
+SERVER_DECL bool LogCaptureRecord(LogRecord *record, const char *source, const char *format, va_list ap);
+
+// Stores already formatted text as a raw record, text too long for the payload is copied to the heap
+SERVER_DECL void LogCaptureRawRecord(LogRecord *record, const char *source, const char *message);
+
+// Frees anything the record holds outside of its payload, called once it's been read
+SERVER_DECL void LogReleaseRecord(LogRecord *record);
+
+// Expands a captured record into buffer, returns the written length
+SERVER_DECL size_t LogFormatRecord(const LogRecord *record, char *buffer, size_t bufferLen);
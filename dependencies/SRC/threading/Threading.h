@@ -65,5 +65,8 @@
 // Thread Pool
 #include "ThreadManagement.h"
 
+// Binary log record rings
+#include "LogRingBuffer.h"
+
 // Thread safe console log
 #include "ConsoleLog.h"
@@ -27,20 +27,31 @@ WowCrypt::WowCrypt()
     _initialized = false;
 }
 
+static const uint8 SeedKeyLen = 16;
+static uint8 ServerEncryptionKey[SeedKeyLen] = { 0xCC, 0x98, 0xAE, 0x04, 0xE8, 0x97, 0xEA, 0xCA, 0x12, 0xDD, 0xC0, 0x93, 0x42, 0x91, 0x53, 0x57 };
+static uint8 ServerDecryptionKey[SeedKeyLen] = { 0xC2, 0xB3, 0x72, 0x3C, 0xC6, 0xAE, 0xD9, 0xB5, 0x34, 0x3C, 0x53, 0xEE, 0x2F, 0x43, 0x67, 0xCE };
+
 void WowCrypt::Init(uint8 *K)
 {
-    const uint8 SeedKeyLen = 16;
-    uint8 ServerEncryptionKey[SeedKeyLen] = { 0xCC, 0x98, 0xAE, 0x04, 0xE8, 0x97, 0xEA, 0xCA, 0x12, 0xDD, 0xC0, 0x93, 0x42, 0x91, 0x53, 0x57 };
+    _Init(K, ServerEncryptionKey, ServerDecryptionKey);
+}
+
+void WowCrypt::InitClient(uint8 *K)
+{
+    // Clients encrypt what the server decrypts and vice versa
+    _Init(K, ServerDecryptionKey, ServerEncryptionKey);
+}
 
+void WowCrypt::_Init(uint8 *K, uint8 *encryptionKey, uint8 *decryptionKey)
+{
     HMACHash auth;
-    auth.Initialize(SeedKeyLen, (uint8*)ServerEncryptionKey);
+    auth.Initialize(SeedKeyLen, encryptionKey);
     auth.UpdateData(K, 40);
     auth.Finalize();
     uint8 *encryptHash = auth.GetDigest();
 
-    uint8 ServerDecryptionKey[SeedKeyLen] = { 0xC2, 0xB3, 0x72, 0x3C, 0xC6, 0xAE, 0xD9, 0xB5, 0x34, 0x3C, 0x53, 0xEE, 0x2F, 0x43, 0x67, 0xCE };
     HMACHash auth2;
-    auth2.Initialize(SeedKeyLen, (uint8*)ServerDecryptionKey);
+    auth2.Initialize(SeedKeyLen, decryptionKey);
     auth2.UpdateData(K, 40);
     auth2.Finalize();
     uint8 *decryptHash = auth2.GetDigest();
@@ -35,12 +35,15 @@ public:
     ~WowCrypt();
 
     void Init(uint8 *K);
+    void InitClient(uint8 *K);
     void DecryptRecv(uint8 * data, size_t len);
     void EncryptSend(uint8 * data, size_t len);
 
     bool IsInitialized() { return _initialized; }
 
 private:
+    void _Init(uint8 *K, uint8 *encryptionKey, uint8 *decryptionKey);
+
     bool _initialized;
     RC4Engine _Decrypt;
     RC4Engine _Encrypt;
@@ -0,0 +1,178 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "WoWGuid.h"
+
+#define FLAT_GUID_SET_MIN_CAPACITY 16
+
+/** Open addressing guid set
+ * Guids live in one flat array probed linearly, a zero guid marks an empty slot so guid 0 can't be stored.
+ * Erase shifts the following run back instead of leaving tombstones, which also invalidates iterators.
+ */
+class FlatGuidSet
+{
+public:
+    class const_iterator
+    {
+    public:
+        const_iterator(const uint64 *slot, const uint64 *end) : m_slot(slot), m_end(end) { _skip(); }
+
+        WoWGuid operator*() const { return WoWGuid(*m_slot); }
+        const_iterator &operator++() { ++m_slot; _skip(); return *this; }
+        bool operator==(const const_iterator &other) const { return m_slot == other.m_slot; }
+        bool operator!=(const const_iterator &other) const { return m_slot != other.m_slot; }
+
+    private:
+        void _skip() { while(m_slot != m_end && *m_slot == 0) ++m_slot; }
+
+        const uint64 *m_slot, *m_end;
+    };
+
+    FlatGuidSet() : m_slots(NULL), m_mask(0), m_size(0) {}
+    FlatGuidSet(const FlatGuidSet &other) : m_slots(NULL), m_mask(0), m_size(0) { *this = other; }
+    ~FlatGuidSet() { delete [] m_slots; }
+
+    FlatGuidSet &operator=(const FlatGuidSet &other)
+    {
+        if(this == &other)
+            return *this;
+
+        clear();
+        for(const_iterator itr = other.begin(); itr != other.end(); ++itr)
+            insert(*itr);
+        return *this;
+    }
+
+    void swap(FlatGuidSet &other)
+    {
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_mask, other.m_mask);
+        std::swap(m_size, other.m_size);
+    }
+
+    const_iterator begin() const { return const_iterator(m_slots, m_slots ? m_slots+m_mask+1 : NULL); }
+    const_iterator end() const { return const_iterator(m_slots ? m_slots+m_mask+1 : NULL, m_slots ? m_slots+m_mask+1 : NULL); }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_t capacity() const { return m_slots ? m_mask+1 : 0; }
+    size_t memoryUsage() const { return sizeof(FlatGuidSet) + capacity()*sizeof(uint64); }
+
+    bool contains(WoWGuid guid) const
+    {
+        uint64 key = guid;
+        if(key == 0 || m_size == 0)
+            return false;
+
+        for(size_t i = _hash(key) & m_mask;; i = (i+1) & m_mask)
+        {
+            if(m_slots[i] == key)
+                return true;
+            if(m_slots[i] == 0)
+                return false;
+        }
+    }
+
+    // Returns false if the guid was already present
+    bool insert(WoWGuid guid)
+    {
+        uint64 key = guid;
+        if(key == 0)
+            return false;
+
+        // Keep the load factor under three quarters
+        if((m_size+1)*4 > capacity()*3)
+            _rehash(std::max<size_t>(FLAT_GUID_SET_MIN_CAPACITY, capacity()*2));
+
+        size_t i = _hash(key) & m_mask;
+        for(; m_slots[i] != 0; i = (i+1) & m_mask)
+            if(m_slots[i] == key)
+                return false;
+
+        m_slots[i] = key;
+        ++m_size;
+        return true;
+    }
+
+    // Returns false if the guid wasn't present
+    bool erase(WoWGuid guid)
+    {
+        uint64 key = guid;
+        if(key == 0 || m_size == 0)
+            return false;
+
+        size_t i = _hash(key) & m_mask;
+        for(; m_slots[i] != key; i = (i+1) & m_mask)
+            if(m_slots[i] == 0)
+                return false;
+
+        // Pull back any later entry of the run that may legally sit in the hole
+        for(size_t j = (i+1) & m_mask; m_slots[j] != 0; j = (j+1) & m_mask)
+        {
+            size_t home = _hash(m_slots[j]) & m_mask;
+            if(((j - home) & m_mask) >= ((j - i) & m_mask))
+            {
+                m_slots[i] = m_slots[j];
+                i = j;
+            }
+        }
+
+        m_slots[i] = 0;
+        --m_size;
+        return true;
+    }
+
+    void clear()
+    {
+        if(m_slots)
+            memset(m_slots, 0, capacity()*sizeof(uint64));
+        m_size = 0;
+    }
+
+private:
+    static size_t _hash(uint64 key)
+    {
+        // Guid low parts are sequential, mix the bits so runs don't cluster
+        key ^= key >> 33;
+        key *= 0xFF51AFD7ED558CCDULL;
+        key ^= key >> 33;
+        return size_t(key);
+    }
+
+    void _rehash(size_t newCapacity)
+    {
+        uint64 *oldSlots = m_slots;
+        size_t oldCapacity = capacity();
+
+        m_slots = new uint64[newCapacity];
+        memset(m_slots, 0, newCapacity*sizeof(uint64));
+        m_mask = newCapacity-1;
+        m_size = 0;
+
+        for(size_t i = 0; i < oldCapacity; ++i)
+            if(oldSlots[i] != 0)
+                insert(WoWGuid(oldSlots[i]));
+        delete [] oldSlots;
+    }
+
+    uint64 *m_slots;
+    size_t m_mask, m_size;
+};
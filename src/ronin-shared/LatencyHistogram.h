@@ -0,0 +1,89 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Values under 8 get their own bucket, everything above is split into 4 buckets per power of two
+#define LATENCY_HISTOGRAM_BUCKETS 128
+
+/** Lock free millisecond latency histogram
+ * Any thread may add samples, percentiles are accurate to within a quarter of their power of two.
+ */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram() { Reset(); }
+
+    void Reset()
+    {
+        for(uint32 i = 0; i < LATENCY_HISTOGRAM_BUCKETS; ++i)
+            m_buckets[i].store(0, std::memory_order_relaxed);
+        m_count.store(0, std::memory_order_relaxed);
+    }
+
+    void AddSample(uint32 ms)
+    {
+        m_buckets[_GetBucket(ms)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint32 GetSampleCount() { return m_count.load(std::memory_order_relaxed); }
+
+    // Returns the upper bound of the bucket holding the requested percentile, pct being 0-100
+    uint32 GetPercentile(float pct)
+    {
+        uint32 count = GetSampleCount();
+        if(count == 0)
+            return 0;
+
+        uint64 target = std::max<uint64>(1, uint64(ceil(double(count) * pct / 100.)));
+        uint64 seen = 0;
+        for(uint32 i = 0; i < LATENCY_HISTOGRAM_BUCKETS; ++i)
+        {
+            if((seen += m_buckets[i].load(std::memory_order_relaxed)) >= target)
+                return _GetBucketLimit(i);
+        }
+        return _GetBucketLimit(LATENCY_HISTOGRAM_BUCKETS-1);
+    }
+
+private:
+    static uint32 _GetBucket(uint32 ms)
+    {
+        if(ms < 8)
+            return ms;
+
+        uint32 exponent = 3;
+        while(exponent < 31 && (ms >> (exponent+1)) != 0)
+            ++exponent;
+        return 8 + (exponent-3)*4 + ((ms >> (exponent-2)) & 3);
+    }
+
+    static uint32 _GetBucketLimit(uint32 bucket)
+    {
+        if(bucket < 8)
+            return bucket;
+
+        uint32 exponent = 3 + (bucket-8)/4, sub = (bucket-8)%4;
+        uint64 limit = (uint64(5+sub) << (exponent-2)) - 1;
+        return uint32(std::min<uint64>(limit, 0xFFFFFFFF));
+    }
+
+    std::atomic<uint32> m_buckets[LATENCY_HISTOGRAM_BUCKETS];
+    std::atomic<uint32> m_count;
+};
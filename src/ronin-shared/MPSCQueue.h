@@ -0,0 +1,227 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#define MPSC_CACHE_LINE_SIZE 64
+
+/** Lock-free multi producer, single consumer queue
+ * Any thread may Push, but only one thread at a time may Pop, front, pop_front or Clear.
+ * Nodes are linked intrusively behind a stub node, and consumed nodes are handed back
+ * to producers through a bounded recycle ring instead of being deleted.
+ * While a producer is mid push, Pop can report empty; the element shows up on the next pass.
+ */
+template<class T, size_t RECYCLECOUNT = 64>
+class MPSCQueue
+{
+    struct node
+    {
+        std::atomic<node*> next;
+        T element;
+    };
+
+    struct recycleCell
+    {
+        std::atomic<size_t> sequence;
+        node *n;
+    };
+
+    // Producer side
+    std::atomic<node*> m_head;
+    char _headPad[MPSC_CACHE_LINE_SIZE - sizeof(std::atomic<node*>)];
+
+    // Consumer side
+    node *m_tail;
+    char _tailPad[MPSC_CACHE_LINE_SIZE - sizeof(node*)];
+
+    std::atomic<size_t> m_len;
+    char _lenPad[MPSC_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+
+    // Recycle ring, consumer enqueues and producers dequeue
+    std::atomic<size_t> m_recycleIn;
+    char _recycleInPad[MPSC_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> m_recycleOut;
+    char _recycleOutPad[MPSC_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+
+    recycleCell m_recycle[RECYCLECOUNT];
+    node m_stub;
+
+public:
+    MPSCQueue() : m_len(0), m_recycleIn(0), m_recycleOut(0)
+    {
+        static_assert((RECYCLECOUNT & (RECYCLECOUNT-1)) == 0, "MPSCQueue recycle count must be a power of two");
+
+        m_stub.next.store(NULL, std::memory_order_relaxed);
+        m_head.store(&m_stub, std::memory_order_relaxed);
+        m_tail = &m_stub;
+        for(size_t i = 0; i < RECYCLECOUNT; ++i)
+        {
+            m_recycle[i].sequence.store(i, std::memory_order_relaxed);
+            m_recycle[i].n = NULL;
+        }
+    }
+
+    ~MPSCQueue()
+    {
+        Clear();
+
+        node *n;
+        while((n = _TakeRecycled()) != NULL)
+            delete n;
+    }
+
+    void Clear()
+    {
+        while(HasItems())
+            pop_front();
+    }
+
+    void Push(T elem)
+    {
+        node *n = _TakeRecycled();
+        if(n == NULL)
+            n = new node();
+        n->element = elem;
+        ++m_len;
+        _Link(n);
+    }
+
+    T Pop()
+    {
+        node *n = _Unlink();
+        if(n == NULL)
+            return T();
+
+        T ret = n->element;
+        _Recycle(n);
+        return ret;
+    }
+
+    T front()
+    {
+        node *tail = _SkipStub();
+        if(tail == NULL)
+            return T();
+        return tail->element;
+    }
+
+    void pop_front()
+    {
+        if(node *n = _Unlink())
+            _Recycle(n);
+    }
+
+    size_t size() { return m_len.load(std::memory_order_relaxed); }
+
+    bool HasItems() { return m_len.load(std::memory_order_acquire) != 0; }
+
+private:
+    RONIN_INLINE void _Link(node *n)
+    {
+        n->next.store(NULL, std::memory_order_relaxed);
+        node *prev = m_head.exchange(n, std::memory_order_acq_rel);
+        prev->next.store(n, std::memory_order_release);
+    }
+
+    // Move the consumer past the stub node, returns our current front or NULL
+    RONIN_INLINE node *_SkipStub()
+    {
+        node *tail = m_tail;
+        if(tail == &m_stub)
+        {
+            node *next = tail->next.load(std::memory_order_acquire);
+            if(next == NULL)
+                return NULL;
+            m_tail = tail = next;
+        }
+        return tail;
+    }
+
+    node *_Unlink()
+    {
+        node *tail = _SkipStub();
+        if(tail == NULL)
+            return NULL;
+
+        node *next = tail->next.load(std::memory_order_acquire);
+        if(next == NULL)
+        {
+            // A producer has swapped the head but not linked it yet
+            if(tail != m_head.load(std::memory_order_acquire))
+                return NULL;
+
+            // We're the last node, put the stub behind us so we can be unlinked
+            _Link(&m_stub);
+            if((next = tail->next.load(std::memory_order_acquire)) == NULL)
+                return NULL;
+        }
+
+        m_tail = next;
+        --m_len;
+        return tail;
+    }
+
+    void _Recycle(node *n)
+    {
+        n->element = T();
+        size_t pos = m_recycleIn.load(std::memory_order_relaxed);
+        while(true)
+        {
+            recycleCell *cell = &m_recycle[pos & (RECYCLECOUNT-1)];
+            intptr_t dif = (intptr_t)cell->sequence.load(std::memory_order_acquire) - (intptr_t)pos;
+            if(dif == 0)
+            {
+                if(m_recycleIn.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed))
+                {
+                    cell->n = n;
+                    cell->sequence.store(pos+1, std::memory_order_release);
+                    return;
+                }
+            }
+            else if(dif < 0)
+            {   // Ring is full, just free the node
+                delete n;
+                return;
+            }
+            else pos = m_recycleIn.load(std::memory_order_relaxed);
+        }
+    }
+
+    node *_TakeRecycled()
+    {
+        size_t pos = m_recycleOut.load(std::memory_order_relaxed);
+        while(true)
+        {
+            recycleCell *cell = &m_recycle[pos & (RECYCLECOUNT-1)];
+            intptr_t dif = (intptr_t)cell->sequence.load(std::memory_order_acquire) - (intptr_t)(pos+1);
+            if(dif == 0)
+            {
+                if(m_recycleOut.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed))
+                {
+                    node *n = cell->n;
+                    cell->sequence.store(pos+RECYCLECOUNT, std::memory_order_release);
+                    return n;
+                }
+            }
+            else if(dif < 0)
+                return NULL;
+            else pos = m_recycleOut.load(std::memory_order_relaxed);
+        }
+    }
+};
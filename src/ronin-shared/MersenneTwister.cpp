@@ -21,10 +21,17 @@
 
 #include "MersenneTwister.h"
 
-#define NUMBER_OF_GENERATORS 5
-Mutex * m_locks[NUMBER_OF_GENERATORS];
-CRandomMersenne * m_generators[NUMBER_OF_GENERATORS];
-uint32 counter = 0;
+// Every thread draws from its own xoshiro128** state, seeded from a shared splitmix64 sequence
+struct RandomGeneratorState
+{
+    uint32 s[4];
+    uint32 epoch;
+    bool seeded;
+};
+
+static std::atomic<uint64> m_seedSequence(0);
+static std::atomic<uint32> m_seedEpoch(0);
+static thread_local RandomGeneratorState t_generator = { { 0, 0, 0, 0 }, 0, false };
 
 uint32 generate_seed()
 {
@@ -39,74 +46,87 @@ uint32 generate_seed()
     return val;
 }
 
+static uint64 _SplitMix64()
+{
+    uint64 z = m_seedSequence.fetch_add(0x9E3779B97F4A7C15ULL, std::memory_order_relaxed) + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static RONIN_INLINE uint32 _Rotl(uint32 x, int k) { return (x << k) | (x >> (32 - k)); }
+
+static RONIN_INLINE uint32 _NextRandom()
+{
+    RandomGeneratorState &gen = t_generator;
+    // First draw on this thread or a reseed was requested, stir fresh seed material into our state
+    uint32 epoch = m_seedEpoch.load(std::memory_order_relaxed);
+    if(!gen.seeded || gen.epoch != epoch)
+    {
+        uint64 a = _SplitMix64(), b = _SplitMix64();
+        gen.s[0] ^= uint32(a);
+        gen.s[1] ^= uint32(a >> 32);
+        gen.s[2] ^= uint32(b);
+        gen.s[3] ^= uint32(b >> 32);
+        // The all zero state never leaves zero
+        if((gen.s[0] | gen.s[1] | gen.s[2] | gen.s[3]) == 0)
+            gen.s[0] = 1;
+        gen.epoch = epoch;
+        gen.seeded = true;
+    }
+
+    uint32 result = _Rotl(gen.s[1] * 5, 7) * 9, t = gen.s[1] << 9;
+    gen.s[2] ^= gen.s[0];
+    gen.s[3] ^= gen.s[1];
+    gen.s[1] ^= gen.s[2];
+    gen.s[0] ^= gen.s[3];
+    gen.s[2] ^= t;
+    gen.s[3] = _Rotl(gen.s[3], 11);
+    return result;
+}
+
+// Maps 32 random bits onto 0 <= x <= n without a division
+static RONIN_INLINE uint32 _BoundRandom(uint32 bits, uint32 n)
+{
+    return uint32((uint64(bits) * (uint64(n)+1)) >> 32);
+}
+
+static RONIN_INLINE double _UnitRandom(uint32 bits)
+{
+    return double(bits) * (1.0/4294967296.0);
+}
+
 void InitRandomNumberGenerators()
 {
     srand(getMSTime());
-    for(uint32 i = 0; i < NUMBER_OF_GENERATORS; ++i) {
-        m_generators[i] = new CRandomMersenne(generate_seed());
-        m_locks[i] = new Mutex();
-    }
+    m_seedSequence.store((uint64(generate_seed()) << 32) | generate_seed());
+}
+
+void ReseedRandomNumberGenerators()
+{
+    m_seedSequence.fetch_add((uint64(generate_seed()) << 32) | generate_seed());
+    m_seedEpoch.fetch_add(1);
 }
 
 void CleanupRandomNumberGenerators()
-{   srand(getMSTime());
-    for(uint32 i = 0; i < NUMBER_OF_GENERATORS; ++i)
-    {
-        delete m_generators[i];
-        m_generators[i] = NULL;
-        delete m_locks[i];
-        m_locks[i] = NULL;
-    }
+{
+    srand(getMSTime());
 }
 
 void UpdateRandomNumberGenerators()
 {
-    for(uint32 i = 0; i < NUMBER_OF_GENERATORS; ++i)
-    {
-        m_locks[i]->Acquire();
-        m_generators[i]->RandomInit(getMSTime());
-        m_locks[i]->Release();
-    }
+    // Threads pick the new epoch up on their next draw
+    ReseedRandomNumberGenerators();
 }
 
 double RandomDouble()
 {
-    double ret;
-    uint32 c;
-    for(;;)
-    {
-        c=counter%NUMBER_OF_GENERATORS;
-        if(m_locks[c] == NULL)
-            return 0.0f;
-        if(m_locks[c]->AttemptAcquire())
-        {
-            ret = m_generators[c]->Random();
-            m_locks[c]->Release();
-            return ret;
-        }
-
-        ++counter;
-    }
+    return _UnitRandom(_NextRandom());
 }
 
 uint32 RandomUInt(uint32 n)
 {
-    uint32 ret;
-    uint32 c;
-    for(;;)
-    {
-        c=counter%NUMBER_OF_GENERATORS;
-        if(m_locks[c] == NULL)
-            return 0;
-        if(m_locks[c]->AttemptAcquire())
-        {
-            ret = m_generators[c]->IRandom(0, n);
-            m_locks[c]->Release();
-            return ret;
-        }
-
-        ++counter;
-    }
+    return _BoundRandom(_NextRandom(), n);
 }
 
 double RandomDouble(double n)
@@ -126,22 +146,19 @@ float RandomFloat()
 
 uint32 RandomUInt()
 {
-    uint32 ret;
-    uint32 c;
-    for(;;)
-    {
-        c=counter%NUMBER_OF_GENERATORS;
-        if(m_locks[c] == NULL)
-            return 0;
-        if(m_locks[c]->AttemptAcquire())
-        {
-            ret = m_generators[c]->IRandom(0, RAND_MAX);
-            m_locks[c]->Release();
-            return ret;
-        }
+    return RandomUInt(RAND_MAX);
+}
 
-        ++counter;
-    }
+void RandomUIntBatch(uint32 *out, size_t count, uint32 n)
+{
+    for(size_t i = 0; i < count; ++i)
+        out[i] = _BoundRandom(_NextRandom(), n);
+}
+
+void RandomFloatBatch(float *out, size_t count, float n)
+{
+    for(size_t i = 0; i < count; ++i)
+        out[i] = float(_UnitRandom(_NextRandom()) * double(n));
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -33,6 +33,9 @@ SERVER_DECL float RandomFloat();
 SERVER_DECL float RandomFloat(float n);
 SERVER_DECL uint32 RandomUInt();
 SERVER_DECL uint32 RandomUInt(uint32 n);
+// Fill count values at once, same ranges as RandomUInt(n) and RandomFloat(n)
+SERVER_DECL void RandomUIntBatch(uint32 *out, size_t count, uint32 n);
+SERVER_DECL void RandomFloatBatch(float *out, size_t count, float n = 1.f);
 SERVER_DECL void expon(int &variable, int count);
 SERVER_DECL void expon(long &variable, int count);
 SERVER_DECL void expon(float &variable, int count);
@@ -0,0 +1,136 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ProcessMetrics.h"
+
+#if PLATFORM != PLATFORM_WIN
+#include <dirent.h>
+
+// Parses a proc stat line, the command name is in parentheses and may itself hold spaces or parentheses
+static bool ParseStatLine(const char *line, char *name, size_t nameLen, uint64 &userTicks, uint64 &systemTicks)
+{
+    const char *nameStart = strchr(line, '('), *nameEnd = strrchr(line, ')');
+    if(nameStart == NULL || nameEnd == NULL || nameEnd < nameStart)
+        return false;
+
+    if(name && nameLen)
+    {
+        size_t len = std::min<size_t>(nameEnd-nameStart-1, nameLen-1);
+        memcpy(name, nameStart+1, len);
+        name[len] = 0;
+    }
+
+    // State is field 3, utime and stime are fields 14 and 15
+    unsigned long long utime = 0, stime = 0;
+    if(sscanf(nameEnd+1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu", &utime, &stime) != 2)
+        return false;
+
+    userTicks = utime;
+    systemTicks = stime;
+    return true;
+}
+
+static bool ReadStatFile(const char *path, char *name, size_t nameLen, uint64 &userTicks, uint64 &systemTicks)
+{
+    FILE *file = fopen(path, "r");
+    if(file == NULL)
+        return false;
+
+    char line[512];
+    bool res = fgets(line, sizeof(line), file) != NULL && ParseStatLine(line, name, nameLen, userTicks, systemTicks);
+    fclose(file);
+    return res;
+}
+#endif
+
+bool ReadProcessCPUTimes(ProcessCPUTimes &times)
+{
+#if PLATFORM != PLATFORM_WIN
+    return ReadStatFile("/proc/self/stat", NULL, 0, times.userTicks, times.systemTicks);
+#else
+    return false;
+#endif
+}
+
+bool ReadProcessMemoryStats(ProcessMemoryStats &stats)
+{
+#if PLATFORM != PLATFORM_WIN
+    FILE *file = fopen("/proc/self/status", "r");
+    if(file == NULL)
+        return false;
+
+    memset(&stats, 0, sizeof(ProcessMemoryStats));
+    char line[256];
+    while(fgets(line, sizeof(line), file) != NULL)
+    {
+        if(strncmp(line, "VmSize:", 7) == 0)
+            stats.virtualKB = atol(line+7);
+        else if(strncmp(line, "VmRSS:", 6) == 0)
+            stats.residentKB = atol(line+6);
+        else if(strncmp(line, "VmHWM:", 6) == 0)
+            stats.peakResidentKB = atol(line+6);
+        else if(strncmp(line, "VmData:", 7) == 0)
+            stats.dataKB = atol(line+7);
+        else if(strncmp(line, "Threads:", 8) == 0)
+            stats.threads = atol(line+8);
+    }
+    fclose(file);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ReadThreadCPUTimes(std::vector<ThreadCPUTimes> &threads)
+{
+    threads.clear();
+#if PLATFORM != PLATFORM_WIN
+    DIR *dir = opendir("/proc/self/task");
+    if(dir == NULL)
+        return false;
+
+    char path[64];
+    ThreadCPUTimes thread;
+    while(struct dirent *entry = readdir(dir))
+    {
+        if(entry->d_name[0] < '0' || entry->d_name[0] > '9')
+            continue;
+
+        // Threads can exit between listing and reading, just skip them
+        snprintf(path, sizeof(path), "/proc/self/task/%s/stat", entry->d_name);
+        thread.threadId = atol(entry->d_name);
+        if(ReadStatFile(path, thread.name, sizeof(thread.name), thread.userTicks, thread.systemTicks))
+            threads.push_back(thread);
+    }
+    closedir(dir);
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint32 GetProcessClockTicks()
+{
+#if PLATFORM != PLATFORM_WIN
+    static long ticks = sysconf(_SC_CLK_TCK);
+    return ticks > 0 ? uint32(ticks) : 100;
+#else
+    return 0;
+#endif
+}
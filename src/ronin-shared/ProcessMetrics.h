@@ -0,0 +1,51 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "Common.h"
+
+// Process wide cpu time, in clock ticks
+struct ProcessCPUTimes
+{
+    uint64 userTicks, systemTicks;
+};
+
+// Sizes in kilobytes, as reported by /proc/self/status
+struct ProcessMemoryStats
+{
+    uint32 virtualKB, residentKB, peakResidentKB, dataKB;
+    uint32 threads;
+};
+
+struct ThreadCPUTimes
+{
+    uint32 threadId;
+    char name[16];
+    uint64 userTicks, systemTicks;
+};
+
+/** Linux process metrics read straight from procfs
+ * Every call reopens its file, so these are meant for periodic sampling, not hot paths.
+ * All of them return false on platforms without procfs.
+ */
+SERVER_DECL bool ReadProcessCPUTimes(ProcessCPUTimes &times);
+SERVER_DECL bool ReadProcessMemoryStats(ProcessMemoryStats &stats);
+SERVER_DECL bool ReadThreadCPUTimes(std::vector<ThreadCPUTimes> &threads);
+SERVER_DECL uint32 GetProcessClockTicks();
@@ -0,0 +1,273 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SlabAllocator.h"
+
+#if PLATFORM == PLATFORM_WIN
+#include <malloc.h>
+#endif
+
+struct SlabHeader
+{
+    SlabThreadCache *owner;
+    SlabHeader *next;
+};
+
+class SlabThreadCache
+{
+public:
+    SlabThreadCache(SlabPool *pool) : pool(pool), freeList(NULL), bumpPtr(NULL), bumpEnd(NULL), slabs(NULL),
+        remoteFreeList(NULL), slabCount(0), allocations(0), localFrees(0), remoteFrees(0) {}
+
+    // Pull everything other threads have freed back onto our own list
+    void ReclaimRemoteFrees()
+    {
+        void *list = remoteFreeList.exchange(NULL, std::memory_order_acquire);
+        while(list)
+        {
+            void *next = *(void**)list;
+            *(void**)list = freeList;
+            freeList = list;
+            list = next;
+        }
+    }
+
+    SlabPool *pool;
+
+    // Owning thread only
+    void *freeList;
+    char *bumpPtr, *bumpEnd;
+    SlabHeader *slabs;
+
+    std::atomic<void*> remoteFreeList;
+
+    // Written by the owner (or by remote frees for remoteFrees), read racily for stats
+    std::atomic<uint32> slabCount;
+    std::atomic<uint64> allocations, localFrees, remoteFrees;
+};
+
+struct SlabThreadCaches
+{
+    SlabThreadCaches() { memset(caches, 0, sizeof(caches)); }
+    ~SlabThreadCaches()
+    {
+        for(uint32 i = 0; i < SLAB_MAX_POOLS; ++i)
+        {
+            if(caches[i])
+                caches[i]->pool->_ReleaseThreadCache(caches[i]);
+            caches[i] = NULL;
+        }
+    }
+
+    SlabThreadCache *caches[SLAB_MAX_POOLS];
+};
+
+static thread_local SlabThreadCaches t_slabCaches;
+
+static Mutex &GetPoolRegistryLock()
+{
+    static Mutex lock;
+    return lock;
+}
+
+static std::vector<SlabPool*> &GetPoolRegistry()
+{
+    static std::vector<SlabPool*> pools;
+    return pools;
+}
+
+SlabPool::SlabPool(const char *name, size_t objectSize) : m_name(name), m_fallbacks(0)
+{
+    // Every slot has to hold our free list link and keep the default alignment
+    m_objectSize = (std::max<size_t>(objectSize, sizeof(void*)) + 15) & ~size_t(15);
+
+    GetPoolRegistryLock().Acquire();
+    m_poolId = uint32(GetPoolRegistry().size());
+    GetPoolRegistry().push_back(this);
+    GetPoolRegistryLock().Release();
+
+    // Pools past our thread cache limit, or with objects too large to slab, just pass through
+    if(m_poolId >= SLAB_MAX_POOLS || m_objectSize*4 > SLAB_SIZE-SLAB_HEADER_SIZE)
+        m_poolId = SLAB_MAX_POOLS;
+}
+
+void *SlabPool::Allocate(size_t size)
+{
+    SlabThreadCache *cache;
+    if(size > m_objectSize || (cache = _GetThreadCache()) == NULL)
+    {
+        m_fallbacks.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    if(cache->freeList == NULL && cache->remoteFreeList.load(std::memory_order_relaxed) != NULL)
+        cache->ReclaimRemoteFrees();
+
+    void *ptr = cache->freeList;
+    if(ptr)
+        cache->freeList = *(void**)ptr;
+    else
+    {
+        if(cache->bumpPtr == NULL || cache->bumpPtr + m_objectSize > cache->bumpEnd)
+            _AllocateSlab(cache);
+        ptr = cache->bumpPtr;
+        cache->bumpPtr += m_objectSize;
+    }
+
+    cache->allocations.store(cache->allocations.load(std::memory_order_relaxed)+1, std::memory_order_relaxed);
+    return ptr;
+}
+
+void SlabPool::Free(void *ptr, size_t size)
+{
+    if(ptr == NULL)
+        return;
+
+    if(size > m_objectSize || m_poolId >= SLAB_MAX_POOLS)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    SlabHeader *slab = (SlabHeader*)(uintptr_t(ptr) & ~uintptr_t(SLAB_SIZE-1));
+    SlabThreadCache *cache = slab->owner;
+    if(t_slabCaches.caches[m_poolId] == cache)
+    {
+        *(void**)ptr = cache->freeList;
+        cache->freeList = ptr;
+        cache->localFrees.store(cache->localFrees.load(std::memory_order_relaxed)+1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Freed away from the owning thread, defer it to the owner's next allocation
+    void *head = cache->remoteFreeList.load(std::memory_order_relaxed);
+    do
+    {
+        *(void**)ptr = head;
+    }while(!cache->remoteFreeList.compare_exchange_weak(head, ptr, std::memory_order_release, std::memory_order_relaxed));
+    cache->remoteFrees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SlabPool::GetStats(SlabPoolStats &stats)
+{
+    memset(&stats, 0, sizeof(SlabPoolStats));
+    stats.objectSize = m_objectSize;
+    stats.fallbacks = m_fallbacks.load(std::memory_order_relaxed);
+
+    m_cacheLock.Acquire();
+    stats.threadCaches = uint32(m_caches.size()-m_orphanedCaches.size());
+    for(std::vector<SlabThreadCache*>::iterator itr = m_caches.begin(); itr != m_caches.end(); itr++)
+    {
+        stats.allocations += (*itr)->allocations.load(std::memory_order_relaxed);
+        stats.frees += (*itr)->localFrees.load(std::memory_order_relaxed);
+        stats.remoteFrees += (*itr)->remoteFrees.load(std::memory_order_relaxed);
+        stats.slabs += (*itr)->slabCount.load(std::memory_order_relaxed);
+    }
+    m_cacheLock.Release();
+
+    stats.frees += stats.remoteFrees;
+    stats.liveObjects = stats.allocations > stats.frees ? stats.allocations-stats.frees : 0;
+    stats.reservedBytes = size_t(stats.slabs)*SLAB_SIZE;
+}
+
+void SlabPool::Purge()
+{
+    m_cacheLock.Acquire();
+    for(std::vector<SlabThreadCache*>::iterator itr = m_caches.begin(); itr != m_caches.end(); itr++)
+    {
+        SlabThreadCache *cache = *itr;
+        while(SlabHeader *slab = cache->slabs)
+        {
+            cache->slabs = slab->next;
+#if PLATFORM == PLATFORM_WIN
+            _aligned_free(slab);
+#else
+            free(slab);
+#endif
+        }
+
+        // Caches stay registered with their threads, they just start over empty
+        cache->freeList = NULL;
+        cache->bumpPtr = cache->bumpEnd = NULL;
+        cache->remoteFreeList = NULL;
+        cache->slabCount = 0;
+        cache->allocations = cache->localFrees = cache->remoteFrees = 0;
+    }
+    m_cacheLock.Release();
+}
+
+void SlabPool::GetPools(std::vector<SlabPool*> &pools)
+{
+    GetPoolRegistryLock().Acquire();
+    pools = GetPoolRegistry();
+    GetPoolRegistryLock().Release();
+}
+
+SlabThreadCache *SlabPool::_GetThreadCache()
+{
+    if(m_poolId >= SLAB_MAX_POOLS)
+        return NULL;
+
+    SlabThreadCache *&cache = t_slabCaches.caches[m_poolId];
+    if(cache == NULL)
+    {
+        // Adopt a cache left behind by an exited thread before growing a new one
+        m_cacheLock.Acquire();
+        if(!m_orphanedCaches.empty())
+        {
+            cache = m_orphanedCaches.back();
+            m_orphanedCaches.pop_back();
+        }
+        else
+        {
+            cache = new SlabThreadCache(this);
+            m_caches.push_back(cache);
+        }
+        m_cacheLock.Release();
+    }
+    return cache;
+}
+
+void SlabPool::_ReleaseThreadCache(SlabThreadCache *cache)
+{
+    m_cacheLock.Acquire();
+    m_orphanedCaches.push_back(cache);
+    m_cacheLock.Release();
+}
+
+void SlabPool::_AllocateSlab(SlabThreadCache *cache)
+{
+    void *memory = NULL;
+#if PLATFORM == PLATFORM_WIN
+    memory = _aligned_malloc(SLAB_SIZE, SLAB_SIZE);
+#else
+    if(posix_memalign(&memory, SLAB_SIZE, SLAB_SIZE) != 0)
+        memory = NULL;
+#endif
+    if(memory == NULL)
+        throw std::bad_alloc();
+
+    SlabHeader *slab = (SlabHeader*)memory;
+    slab->owner = cache;
+    slab->next = cache->slabs;
+    cache->slabs = slab;
+    cache->bumpPtr = (char*)memory + SLAB_HEADER_SIZE;
+    cache->bumpEnd = (char*)memory + SLAB_SIZE;
+    cache->slabCount.fetch_add(1, std::memory_order_relaxed);
+}
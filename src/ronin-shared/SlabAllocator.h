@@ -0,0 +1,89 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "Common.h"
+
+// Slabs are aligned to their size so an object's slab header is found by masking its address
+#define SLAB_SIZE (256*1024)
+#define SLAB_HEADER_SIZE 64
+#define SLAB_MAX_POOLS 32
+
+struct SlabPoolStats
+{
+    size_t objectSize;
+    uint64 allocations, frees, remoteFrees, fallbacks;
+    uint64 liveObjects;
+    uint32 slabs, threadCaches;
+    size_t reservedBytes;
+};
+
+class SlabThreadCache;
+
+/** Fixed size object pool carved out of aligned slabs
+ * Every thread allocates from its own cache of slabs without locking. Frees from the owning thread go
+ * straight back on its free list, frees from any other thread are pushed onto the owner's remote list
+ * and reclaimed on its next allocation. Slabs are kept until the pool is purged, and a thread's cache
+ * is handed to the next new thread once it exits.
+ */
+class SERVER_DECL SlabPool
+{
+public:
+    SlabPool(const char *name, size_t objectSize);
+
+    // Requests larger than our object size are passed to the global allocator
+    void *Allocate(size_t size);
+    void Free(void *ptr, size_t size);
+
+    const char *GetName() { return m_name; }
+    void GetStats(SlabPoolStats &stats);
+
+    // Returns every slab to the system, only safe once all objects are freed and no thread is allocating
+    void Purge();
+
+    static void GetPools(std::vector<SlabPool*> &pools);
+
+private:
+    friend struct SlabThreadCaches;
+
+    SlabThreadCache *_GetThreadCache();
+    void _ReleaseThreadCache(SlabThreadCache *cache);
+    void _AllocateSlab(SlabThreadCache *cache);
+
+    const char *m_name;
+    size_t m_objectSize;
+    uint32 m_poolId;
+    std::atomic<uint64> m_fallbacks;
+
+    Mutex m_cacheLock;
+    std::vector<SlabThreadCache*> m_caches, m_orphanedCaches;
+};
+
+/** Routes a class's new and delete through its own slab pool
+ * The sized delete lets derived classes larger than the pool fall back to the global allocator,
+ * so poolSize must cover every class that can be deleted through the declaring class.
+ */
+#define DECLARE_SLAB_ALLOCATION() \
+    static SlabPool &GetSlabPool(); \
+    static void *operator new(size_t size) { return GetSlabPool().Allocate(size); } \
+    static void operator delete(void *ptr, size_t size) { GetSlabPool().Free(ptr, size); }
+
+#define IMPLEMENT_SLAB_ALLOCATION(className, poolSize) \
+    SlabPool &className::GetSlabPool() { static SlabPool pool(#className, poolSize); return pool; }
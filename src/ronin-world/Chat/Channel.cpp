@@ -147,7 +147,7 @@ void Channel::AttemptJoin(Player* plr, const char * password)
         flags |= CHANNEL_FLAG_OWNER;
 
     plr->JoinedChannel(this);
-    m_members.insert(std::make_pair(plr, flags));
+    _AddMember(plr, flags);
 
     if(m_announce && !plr->hasGMTag())
     {
@@ -181,7 +181,7 @@ void Channel::Part(Player* plr, bool silent, bool keepData)
     }
 
     flags = itr->second;
-    m_members.erase(itr);
+    _RemoveMember(itr);
 
     plr->LeftChannel(this);
 
@@ -351,26 +351,37 @@ void Channel::Moderate(Player* plr)
 
 void Channel::Say(Player* plr, const char * message, Player* for_gm_client, bool forced)
 {
-    Guard mGuard(m_lock);
-    MemberMap::iterator itr = m_members.find(plr);
     WorldPacket data(strlen(message)+100);
     if(!forced)
     {
-        if(m_members.end() == itr)
+        bool isMember = false, muted;
+        uint32 flags = CHANNEL_FLAG_NONE;
+        {   // Only the flag lookup needs the lock, the message goes out from the member snapshot
+            Guard mGuard(m_lock);
+            MemberMap::iterator itr = m_members.find(plr);
+            if(itr != m_members.end())
+            {
+                isMember = true;
+                flags = itr->second;
+            }
+            muted = m_muted;
+        }
+
+        if(!isMember)
         {
             MakeNotifyPacket(&data, CHANNEL_NOTIFY_FLAG_NOTON);
             plr->PushPacket(&data);
             return;
         }
 
-        if(itr->second & CHANNEL_FLAG_MUTED)
+        if(flags & CHANNEL_FLAG_MUTED)
         {
             MakeNotifyPacket(&data, CHANNEL_NOTIFY_FLAG_YOUCANTSPEAK);
             plr->PushPacket(&data);
             return;
         }
 
-        if(m_muted && !(itr->second & CHANNEL_FLAG_VOICED) && !(itr->second & CHANNEL_FLAG_MODERATOR) && !(itr->second & CHANNEL_FLAG_OWNER))
+        if(muted && !(flags & CHANNEL_FLAG_VOICED) && !(flags & CHANNEL_FLAG_MODERATOR) && !(flags & CHANNEL_FLAG_OWNER))
         {
             MakeNotifyPacket(&data, CHANNEL_NOTIFY_FLAG_YOUCANTSPEAK);
             plr->PushPacket(&data);
@@ -450,7 +461,7 @@ void Channel::Kick(Player* plr, Player* die_player, bool ban)
         SendToAll(&data);
     }
 
-    m_members.erase(itr);
+    _RemoveMember(itr);
 
     if(flags & CHANNEL_FLAG_OWNER)
         SetOwner(NULL, NULL);
@@ -818,14 +829,53 @@ void Channel::GetOwner(Player* plr)
 
 void Channel::SendToAll(WorldPacket * data, Player* plr)
 {
-    Guard guard(m_lock);
-    for(MemberMap::iterator itr = m_members.begin(); itr != m_members.end(); itr++)
+    // The packet is built once by the caller, members only copy it if they have to queue it
+    std::shared_ptr<const MemberList> members = std::atomic_load(&m_memberList);
+    if(members == NULL)
+        return;
+
+    for(MemberList::const_iterator itr = members->begin(); itr != members->end(); itr++)
     {
-        if(plr != NULL && itr->first == plr)
+        MemberRef *ref = itr->get();
+        Guard refGuard(ref->lock);
+        if(ref->player == NULL || ref->player == plr)
             continue;
 
-        itr->first->PushPacket(data);
+        ref->player->PushPacket(data);
+    }
+}
+
+void Channel::_AddMember(Player *plr, uint32 flags)
+{
+    m_members.insert(std::make_pair(plr, flags));
+    m_memberRefs[plr] = std::make_shared<MemberRef>(plr);
+    _RebuildMemberList();
+}
+
+void Channel::_RemoveMember(MemberMap::iterator itr)
+{
+    std::map<Player*, std::shared_ptr<MemberRef> >::iterator refItr = m_memberRefs.find(itr->first);
+    if(refItr != m_memberRefs.end())
+    {
+        // Only waits out a push to this player that's already under way
+        refItr->second->lock.Acquire();
+        refItr->second->player = NULL;
+        refItr->second->lock.Release();
+        m_memberRefs.erase(refItr);
     }
+
+    m_members.erase(itr);
+    _RebuildMemberList();
+}
+
+void Channel::_RebuildMemberList()
+{
+    std::shared_ptr<MemberList> members = std::make_shared<MemberList>();
+    members->reserve(m_memberRefs.size());
+    for(std::map<Player*, std::shared_ptr<MemberRef> >::iterator itr = m_memberRefs.begin(); itr != m_memberRefs.end(); itr++)
+        members->push_back(itr->second);
+
+    std::atomic_store(&m_memberList, std::shared_ptr<const MemberList>(members));
 }
 
 ChannelMgr::ChannelMgr()
@@ -80,6 +80,23 @@ private:
     MemberMap m_members;
     std::set<WoWGuid> m_bannedMembers;
 
+    // Snapshots share a reference per member, leaving clears it under its own lock so a fan out never reaches a removed player
+    struct MemberRef
+    {
+        MemberRef(Player *plr) : player(plr) {}
+        Mutex lock;
+        Player *player;
+    };
+
+    // Copy on write recipient list, SendToAll walks a snapshot without taking m_lock
+    typedef std::vector<std::shared_ptr<MemberRef> > MemberList;
+    std::map<Player*, std::shared_ptr<MemberRef> > m_memberRefs;
+    std::shared_ptr<const MemberList> m_memberList;
+    // Called under m_lock after membership changes
+    void _AddMember(Player *plr, uint32 flags);
+    void _RemoveMember(MemberMap::iterator itr);
+    void _RebuildMemberList();
+
 public:
     friend class ChannelIterator;
     static void LoadConfSettings();
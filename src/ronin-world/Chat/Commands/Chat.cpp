@@ -167,6 +167,12 @@ void CommandTableStorage::Init()
         { "setallratings",              COMMAND_LEVEL_D, &ChatHandler::HandleRatingsCommand,                        "Sets rating values to incremental numbers based on their index.",                                                      NULL, 0, 0, 0 },
         { "sendmirrortimer",            COMMAND_LEVEL_D, &ChatHandler::HandleMirrorTimerCommand,                    "Sends a mirror Timer opcode to target syntax: <type>",                                                                 NULL, 0, 0, 0 },
         { "setstartlocation",           COMMAND_LEVEL_D, &ChatHandler::HandleSetPlayerStartLocation,                "",                                                                                                                     NULL, 0, 0, 0 },
+        { "cellbench",                  COMMAND_LEVEL_D, &ChatHandler::HandleDebugCellBenchCommand,                 ".cellbench <range> <iterations> - Times range scans of your current cell, visible set memory and cell change deltas.",                         NULL, 0, 0, 0 },
+        { "randbench",                  COMMAND_LEVEL_D, &ChatHandler::HandleDebugRandBenchCommand,                 ".randbench <threads> <count> - Times random number generation from one up to the given number of threads.",            NULL, 0, 0, 0 },
+        { "mpscbench",                  COMMAND_LEVEL_D, &ChatHandler::HandleDebugMPSCBenchCommand,                 ".mpscbench <producers> <packets per second> <seconds> - Times the session receive queue against the old locked queue at a steady packet rate.", NULL, 0, 0, 0 },
+        { "instanceworkers",            COMMAND_LEVEL_D, &ChatHandler::HandleDebugInstanceWorkersCommand,           ".instanceworkers - Shows queue size, update times, overruns and takeovers for each instance update worker.",          NULL, 0, 0, 0 },
+        { "slabstats",                  COMMAND_LEVEL_D, &ChatHandler::HandleDebugSlabStatsCommand,                 ".slabstats - Shows live objects, reserved memory and remote frees for each slab pool.",                                NULL, 0, 0, 0 },
+        { "slabbench",                  COMMAND_LEVEL_D, &ChatHandler::HandleDebugSlabBenchCommand,                 ".slabbench <threads> <count> - Times aura sized allocations through a slab pool against the default allocator.",       NULL, 0, 0, 0 },
         { NULL,                         COMMAND_LEVEL_0, NULL,                                                      "",                                                                                                                     NULL, 0, 0, 0 }
     };
     dupe_command_table(debugCommandTable, _debugCommandTable);
@@ -555,6 +555,12 @@ protected:
     bool HandleModifyAuraStateCommand(const char *args, WorldSession *m_session);
     bool HandleMirrorTimerCommand(const char *args, WorldSession *m_session);
     bool HandleSetPlayerStartLocation(const char *args, WorldSession *m_session);
+    bool HandleDebugCellBenchCommand(const char *args, WorldSession *m_session);
+    bool HandleDebugRandBenchCommand(const char *args, WorldSession *m_session);
+    bool HandleDebugMPSCBenchCommand(const char *args, WorldSession *m_session);
+    bool HandleDebugInstanceWorkersCommand(const char *args, WorldSession *m_session);
+    bool HandleDebugSlabStatsCommand(const char *args, WorldSession *m_session);
+    bool HandleDebugSlabBenchCommand(const char *args, WorldSession *m_session);
     bool HandleModifySpeedCommand(const char *args, WorldSession *m_session);
     bool HandleModifySwimSpeedCommand(const char *args, WorldSession *m_session);
     bool HandleModifyFlightSpeedCommand(const char *args, WorldSession *m_session);
@@ -24,6 +24,9 @@
 //
 
 #include "StdAfx.h"
+#include <chrono>
+#include <functional>
+#include <thread>
 
 bool ChatHandler::HandleDebugInFrontCommand(const char* args, WorldSession *m_session)
 {
@@ -378,6 +381,423 @@ bool ChatHandler::HandleSetPlayerStartLocation(const char* args, WorldSession *m
     return true;
 }
 
+class CellBenchCallback : public ObjectProcessCallback
+{
+public:
+    CellBenchCallback(float range) : _rangeSq(range*range), hits(0), calls(0) {}
+    void operator()(WorldObject *obj, WorldObject *curObj)
+    {
+        ++calls;
+        if(obj->GetDistanceSq(curObj) <= _rangeSq)
+            ++hits;
+    }
+
+    float _rangeSq;
+    uint32 hits, calls;
+};
+
+bool ChatHandler::HandleDebugCellBenchCommand(const char* args, WorldSession *m_session)
+{
+    Player* plr = m_session->GetPlayer();
+    MapCell *cell = plr->GetMapCell();
+    if(cell == NULL)
+        return false;
+
+    float range = 30.f;
+    uint32 iterations = 1000;
+    sscanf(args, "%f %u", &range, &iterations);
+    iterations = std::max<uint32>(1, iterations);
+
+    // Walk every object in the cell the old way, then let the position index drop what's out of range
+    CellBenchCallback fullCallback(range), indexCallback(range);
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for(uint32 i = 0; i < iterations; ++i)
+        cell->ProcessObjectSets(plr, &fullCallback, 0);
+    std::chrono::high_resolution_clock::time_point mid = std::chrono::high_resolution_clock::now();
+    for(uint32 i = 0; i < iterations; ++i)
+        cell->ProcessObjectSetsInRange(plr, &indexCallback, plr->GetPositionX(), plr->GetPositionY(), plr->GetPositionZ(), range, true, 0);
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+    double fullTime = std::chrono::duration<double, std::micro>(mid-start).count()/iterations, indexTime = std::chrono::duration<double, std::micro>(end-mid).count()/iterations;
+    SystemMessage(m_session, "Cell %u %u, range %.1f, %u iterations", cell->GetPositionX(), cell->GetPositionY(), range, iterations);
+    SystemMessage(m_session, "Full scan: %.2fus, %u callbacks, %u in range", fullTime, fullCallback.calls/iterations, fullCallback.hits/iterations);
+    SystemMessage(m_session, "Indexed scan: %.2fus, %u callbacks, %u in range", indexTime, indexCallback.calls/iterations, indexCallback.hits/iterations);
+
+    // Visible set footprint, a tree node carries three pointers and a color word on top of the guid
+    const FlatGuidSet &visible = plr->GetVisibleSet();
+    SystemMessage(m_session, "Visible objects: %u, flat set %u bytes, tree set would be %u bytes", uint32(visible.size()), uint32(visible.memoryUsage()), uint32(visible.size()*(sizeof(WoWGuid)+4*sizeof(void*))));
+
+    // Cell delta for a one cell step, old set difference against rectangle bounds
+    uint16 cellRange = std::max<uint16>(1, ObjectCellManager::VisibleCellRange), cx = cell->GetPositionX(), cy = cell->GetPositionY();
+    uint16 lowX = cx-std::min<uint16>(cx, cellRange), highX = cx+cellRange, lowY = cy-std::min<uint16>(cy, cellRange), highY = cy+cellRange;
+    uint32 setDelta = 0, rectDelta = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for(uint32 i = 0; i < iterations; ++i)
+    {
+        std::set<uint32> prev;
+        for(uint16 x = lowX; x <= highX; x++)
+            for(uint16 y = lowY; y <= highY; y++)
+                prev.insert((uint32(x)<<16) | y);
+        for(uint16 x = lowX+1; x <= highX+1; x++)
+            for(uint16 y = lowY; y <= highY; y++)
+                if(prev.erase((uint32(x)<<16) | y) == 0)
+                    ++setDelta;
+        setDelta += prev.size();
+    }
+    mid = std::chrono::high_resolution_clock::now();
+    for(uint32 i = 0; i < iterations; ++i)
+    {
+        for(uint16 x = lowX+1; x <= highX+1; x++)
+            for(uint16 y = lowY; y <= highY; y++)
+                if(x > highX)
+                    ++rectDelta;
+        for(uint16 x = lowX; x <= highX; x++)
+            for(uint16 y = lowY; y <= highY; y++)
+                if(x < lowX+1)
+                    ++rectDelta;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    SystemMessage(m_session, "Cell change delta: set %.2fus (%u cells), bounds %.2fus (%u cells)", std::chrono::duration<double, std::micro>(mid-start).count()/iterations, setDelta/iterations,
+        std::chrono::duration<double, std::micro>(end-mid).count()/iterations, rectDelta/iterations);
+    return true;
+}
+
+/** Runs a debug benchmark on its own thread so the caller's map keeps ticking
+ * Each pass is run from one thread up to the requested count, doubling each time. Output is
+ * collected and sent to the account that asked once the run is over, only one runs at a time.
+ */
+class DebugBenchRunner : public ThreadContext
+{
+public:
+    DebugBenchRunner(uint32 maxThreads) : m_maxThreads(std::min<uint32>(std::max<uint32>(1, maxThreads), 32)), m_accountId(0) { }
+
+    static void Start(WorldSession *session, DebugBenchRunner *runner)
+    {
+        bool expected = false;
+        if(!m_running.compare_exchange_strong(expected, true))
+        {
+            ChatHandler::SystemMessage(session, "A benchmark is already running.");
+            delete runner;
+            return;
+        }
+
+        runner->m_accountId = session->GetAccountId();
+        ChatHandler::SystemMessage(session, "Benchmark started, results follow when it finishes.");
+        sThreadManager.ExecuteTask("DebugBench", runner);
+    }
+
+    bool run()
+    {
+        for(uint32 threads = 1; threads <= m_maxThreads; threads *= 2)
+            Pass(threads);
+        Finish();
+
+        if(WorldSession *session = sWorld.FindSession(m_accountId))
+            for(std::vector<std::string>::iterator itr = m_output.begin(); itr != m_output.end(); itr++)
+                ChatHandler::SystemMessage(session, "%s", itr->c_str());
+        m_running = false;
+        return true;
+    }
+
+protected:
+    virtual void Pass(uint32 threads) = 0;
+    virtual void Finish() { }
+
+    // Runs work(index) on the given number of threads at once, returns the wall time in nanoseconds
+    double TimeThreads(uint32 threads, std::function<void(uint32)> work)
+    {
+        std::vector<std::thread> workers;
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for(uint32 i = 0; i < threads; ++i)
+            workers.push_back(std::thread(work, i));
+        for(std::vector<std::thread>::iterator itr = workers.begin(); itr != workers.end(); itr++)
+            itr->join();
+        return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now()-start).count();
+    }
+
+    void Report(const char *format, ...)
+    {
+        char buffer[512];
+        va_list ap;
+        va_start(ap, format);
+        vsnprintf(buffer, 512, format, ap);
+        va_end(ap);
+        m_output.push_back(buffer);
+    }
+
+    uint32 m_maxThreads;
+
+private:
+    uint32 m_accountId;
+    std::vector<std::string> m_output;
+
+    static std::atomic<bool> m_running;
+};
+
+std::atomic<bool> DebugBenchRunner::m_running(false);
+
+class RandBenchRunner : public DebugBenchRunner
+{
+public:
+    RandBenchRunner(uint32 maxThreads, uint32 count) : DebugBenchRunner(maxThreads), m_count(std::max<uint32>(1, count)) { }
+
+    // Draw from every thread at once, per value cost should stay flat as threads are added
+    void Pass(uint32 threads)
+    {
+        std::atomic<uint32> sink(0);
+        uint32 count = m_count;
+        double elapsed = TimeThreads(threads, [count, &sink](uint32)
+        {
+            uint32 total = 0, batch[64];
+            for(uint32 j = 0; j < count; ++j)
+                total += RandomUInt(100);
+            for(uint32 j = 0; j < count; j += 64)
+            {
+                RandomUIntBatch(batch, 64, 100);
+                total += batch[0];
+            }
+            sink += total;
+        });
+        Report("%u threads: %.2fns per value", threads, elapsed/(double(count)*2.0*threads));
+    }
+
+private:
+    uint32 m_count;
+};
+
+bool ChatHandler::HandleDebugRandBenchCommand(const char* args, WorldSession *m_session)
+{
+    uint32 threadCount = 4, count = 1000000;
+    sscanf(args, "%u %u", &threadCount, &count);
+    DebugBenchRunner::Start(m_session, new RandBenchRunner(threadCount, count));
+    return true;
+}
+
+// Map threads drain their sessions once per tick, the continent managers sleep 50ms between updates
+#define QUEUE_BENCH_TICK 50
+
+struct QueueBenchResult
+{
+    QueueBenchResult() : pushed(0), popped(0), pushTime(0.), popTime(0.), worstDrain(0.) { }
+
+    uint64 pushed, popped;
+    double pushTime, popTime, worstDrain;
+};
+
+/** Socket threads feed packets at a steady rate while one consumer drains every map tick
+ * Times are only taken around the queue calls, the pacing sleeps are left out.
+ */
+template<class Queue> static void QueueBenchRun(Queue &queue, uint32 producers, uint32 rate, uint32 duration, QueueBenchResult &result)
+{
+    static WorldPacket packet(MSG_NULL_ACTION, 0);
+    std::atomic<uint32> running(producers);
+    std::vector<std::thread> workers;
+    std::vector<QueueBenchResult> producerResults(producers);
+    for(uint32 i = 0; i < producers; ++i)
+    {
+        workers.push_back(std::thread([&queue, &running, &producerResults, i, producers, rate, duration]()
+        {
+            // Spread each millisecond's share of the rate over every producer
+            uint32 perMs = std::max<uint32>(1, rate/1000/producers);
+            QueueBenchResult &res = producerResults[i];
+            std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+            for(uint32 ms = 0; ms < duration; ++ms)
+            {
+                std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+                for(uint32 j = 0; j < perMs; ++j)
+                    queue.Push(&packet);
+                res.pushTime += std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now()-start).count();
+                res.pushed += perMs;
+
+                next += std::chrono::milliseconds(1);
+                std::this_thread::sleep_until(next);
+            }
+            --running;
+        }));
+    }
+
+    std::thread consumer([&queue, &running, &result]()
+    {
+        bool last = false;
+        while(!last)
+        {
+            last = running == 0;
+            std::this_thread::sleep_for(std::chrono::milliseconds(QUEUE_BENCH_TICK));
+
+            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+            while(queue.Pop() != NULL)
+                ++result.popped;
+            double drain = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now()-start).count();
+            result.popTime += drain;
+            result.worstDrain = std::max<double>(result.worstDrain, drain);
+        }
+    });
+
+    for(std::vector<std::thread>::iterator itr = workers.begin(); itr != workers.end(); itr++)
+        itr->join();
+    consumer.join();
+
+    for(std::vector<QueueBenchResult>::iterator itr = producerResults.begin(); itr != producerResults.end(); itr++)
+        result.pushed += itr->pushed, result.pushTime += itr->pushTime;
+}
+
+class MPSCBenchRunner : public DebugBenchRunner
+{
+public:
+    MPSCBenchRunner(uint32 producers, uint32 rate, uint32 seconds) : DebugBenchRunner(producers), m_rate(std::max<uint32>(1000, rate)), m_duration(std::min<uint32>(std::max<uint32>(1, seconds), 60)*1000) { }
+
+    void Pass(uint32 threads)
+    {
+        for(uint32 pass = 0; pass < 2; ++pass)
+        {
+            QueueBenchResult result;
+            if(pass)
+            {
+                MPSCQueue<WorldPacket*> queue;
+                QueueBenchRun(queue, threads, m_rate, m_duration, result);
+            }
+            else
+            {
+                FastQueue<WorldPacket*, Mutex> queue;
+                QueueBenchRun(queue, threads, m_rate, m_duration, result);
+            }
+
+            Report("%u producers, %s: %.1fns per push, %.1fns per pop, worst tick drain %.1fus, %u of %u packets received", threads, pass ? "lock-free queue" : "locked queue",
+                result.pushed ? result.pushTime/result.pushed : 0., result.popped ? result.popTime/result.popped : 0., result.worstDrain/1000., uint32(result.popped), uint32(result.pushed));
+        }
+    }
+
+private:
+    uint32 m_rate, m_duration;
+};
+
+bool ChatHandler::HandleDebugMPSCBenchCommand(const char* args, WorldSession *m_session)
+{
+    uint32 producers = 1, rate = 20000, seconds = 5;
+    sscanf(args, "%u %u %u", &producers, &rate, &seconds);
+    DebugBenchRunner::Start(m_session, new MPSCBenchRunner(producers, rate, seconds));
+    return true;
+}
+
+bool ChatHandler::HandleDebugInstanceWorkersCommand(const char* args, WorldSession *m_session)
+{
+    InstanceWorkerStatus status;
+    for(uint32 i = 0; i < sInstanceMgr.GetWorkerCount(); ++i)
+    {
+        sInstanceMgr.GetWorkerStatus(i, status);
+        SystemMessage(m_session, "Worker %u: %u instances, %u updates averaging %ums (worst %ums, %ums late), %u overruns, %u taken over",
+            i+1, status.queued, status.updates, status.averageUpdateTime, status.worstUpdateTime, status.worstLateness, status.overruns, status.stolen);
+    }
+    return true;
+}
+
+bool ChatHandler::HandleDebugSlabStatsCommand(const char* args, WorldSession *m_session)
+{
+    std::vector<SlabPool*> pools;
+    SlabPool::GetPools(pools);
+
+    SlabPoolStats stats;
+    for(std::vector<SlabPool*>::iterator itr = pools.begin(); itr != pools.end(); itr++)
+    {
+        (*itr)->GetStats(stats);
+        SystemMessage(m_session, "%s: %u byte objects, %u live using %uKB of %uKB in %u slabs, %u allocations, %u frees (%u remote), %u fallbacks, %u threads",
+            (*itr)->GetName(), uint32(stats.objectSize), uint32(stats.liveObjects), uint32(stats.liveObjects*stats.objectSize/1024), uint32(stats.reservedBytes/1024), stats.slabs,
+            uint32(stats.allocations), uint32(stats.frees), uint32(stats.remoteFrees), uint32(stats.fallbacks), stats.threadCaches);
+    }
+    return true;
+}
+
+#define SLAB_BENCH_BATCH 1024
+
+// Allocates and frees in batches, freeing each batch in random order the way spawns and auras die off
+static void SlabBenchChurn(SlabPool *pool, uint32 count, std::vector<void*> &leftover)
+{
+    void *batch[SLAB_BENCH_BATCH];
+    uint32 order[SLAB_BENCH_BATCH];
+    for(uint32 done = 0; done < count; done += SLAB_BENCH_BATCH)
+    {
+        for(uint32 i = 0; i < SLAB_BENCH_BATCH; ++i)
+            batch[i] = pool ? pool->Allocate(sizeof(Aura)) : ::operator new(sizeof(Aura));
+
+        RandomUIntBatch(order, SLAB_BENCH_BATCH, SLAB_BENCH_BATCH-1);
+        for(uint32 i = 0; i < SLAB_BENCH_BATCH; ++i)
+            std::swap(batch[i], batch[order[i]%SLAB_BENCH_BATCH]);
+
+        for(uint32 i = 0; i < SLAB_BENCH_BATCH; ++i)
+        {
+            if(pool) pool->Free(batch[i], sizeof(Aura));
+            else ::operator delete(batch[i]);
+        }
+    }
+
+    // Left for the calling thread to free
+    for(uint32 i = 0; i < SLAB_BENCH_BATCH; ++i)
+        leftover.push_back(pool ? pool->Allocate(sizeof(Aura)) : ::operator new(sizeof(Aura)));
+}
+
+class SlabBenchRunner : public DebugBenchRunner
+{
+public:
+    SlabBenchRunner(uint32 maxThreads, uint32 count) : DebugBenchRunner(maxThreads), m_count(std::max<uint32>(SLAB_BENCH_BATCH, count)) { }
+
+    void Pass(uint32 threads)
+    {
+        for(uint32 pass = 0; pass < 2; ++pass)
+        {
+            SlabPool *pool = pass ? &GetBenchPool() : NULL;
+            std::vector<std::vector<void*> > leftovers(threads);
+            uint32 count = m_count;
+            double churnTime = TimeThreads(threads, [pool, count, &leftovers](uint32 index) { SlabBenchChurn(pool, count, leftovers[index]); });
+
+            // Everything left over was allocated on a worker, so these are all cross thread frees
+            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+            for(uint32 i = 0; i < threads; ++i)
+            {
+                for(std::vector<void*>::iterator itr = leftovers[i].begin(); itr != leftovers[i].end(); itr++)
+                {
+                    if(pool) pool->Free(*itr, sizeof(Aura));
+                    else ::operator delete(*itr);
+                }
+            }
+            double freeTime = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now()-start).count();
+
+            uint32 rounds = (count+SLAB_BENCH_BATCH-1)/SLAB_BENCH_BATCH;
+            Report("%u threads, %s: %.2fns per allocation and free, %.2fns per cross thread free", threads, pool ? "slab pool" : "default allocator",
+                churnTime/(double(rounds*SLAB_BENCH_BATCH+SLAB_BENCH_BATCH)*threads), freeTime/(double(SLAB_BENCH_BATCH)*threads));
+        }
+    }
+
+    void Finish()
+    {
+        // Each worker holds at most one batch at a time, anything reserved past that is fragmentation
+        SlabPoolStats stats;
+        GetBenchPool().GetStats(stats);
+        uint32 largestRun = 1;
+        while(largestRun*2 <= m_maxThreads)
+            largestRun *= 2;
+        uint64 peakBytes = uint64(largestRun)*SLAB_BENCH_BATCH*stats.objectSize;
+        Report("Slab pool: %uKB reserved in %u slabs for a peak of %uKB live, %.1f%% used, %u remote frees", uint32(stats.reservedBytes/1024), stats.slabs,
+            uint32(peakBytes/1024), stats.reservedBytes ? double(peakBytes)*100./double(stats.reservedBytes) : 0., uint32(stats.remoteFrees));
+
+        // Everything was freed and the workers are gone, so the slabs can go back
+        GetBenchPool().Purge();
+    }
+
+private:
+    // Kept apart from the live pools so the stats only cover the benchmark
+    static SlabPool &GetBenchPool() { static SlabPool benchPool("SlabBench", sizeof(Aura)); return benchPool; }
+
+    uint32 m_count;
+};
+
+bool ChatHandler::HandleDebugSlabBenchCommand(const char* args, WorldSession *m_session)
+{
+    uint32 threadCount = 4, count = 100000;
+    sscanf(args, "%u %u", &threadCount, &count);
+    DebugBenchRunner::Start(m_session, new SlabBenchRunner(threadCount, count));
+    return true;
+}
+
 bool ChatHandler::HandleModifySpeedCommand(const char* args, WorldSession *m_session)
 {
     if(Unit* target = getSelectedChar(m_session, true))
@@ -589,6 +589,7 @@ void WorldSession::HandleCharRenameOpcode(WorldPacket & recv_data)
 void WorldSession::HandlePlayerLoginOpcode( WorldPacket & recv_data )
 {
     sLog.Debug( "WorldSession"," Recvd Player Logon Message" );
+    m_loginRequestTime = getMSTime();
 
     WoWGuid guid;
     recv_data.ReadGuidBitString(8, guid, 2, 3, 0, 6, 4, 5, 1, 7);
@@ -656,6 +657,7 @@ void WorldSession::FullLogin(Player* plr)
     sLog.Debug("WorldSession", "Fully loading player %u", plr->GetLowGUID());
     SetPlayer(plr);
     m_loggingInPlayer = NULL;
+    sWorld.m_playerLoginLatency.AddSample(getMSTime() - m_loginRequestTime);
 
     m_MoverWoWGuid = plr->GetGUID();
 
@@ -42,7 +42,7 @@ void WorldSession::HandleMovementOpcodes( WorldPacket & recv_data )
     uint32 mstime = getMSTime();
 
     MovementInterface *moveInterface = _player->GetMovementInterface();
-    if(!moveInterface->ReadFromClient(recv_data.GetOpcode(), &recv_data))
+    if(!moveInterface->ReadFromClient(recv_data.GetOpcode(), &recv_data, m_moveDecode))
         Disconnect();
 }
 
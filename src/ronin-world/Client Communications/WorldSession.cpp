@@ -45,6 +45,7 @@ _logoutTime(0), permissioncount(0), _loggingOut(false), m_eventInstanceId(-1), _
     m_moveDelayTime=0;
     m_clientTimeDelay =0;
     m_loggingInPlayer=NULL;
+    m_loginRequestTime = 0;
     m_muted = 0;
     m_repeatTime = 0;
     m_repeatEmoteTime = 0;
@@ -55,6 +56,8 @@ _logoutTime(0), permissioncount(0), _loggingOut(false), m_eventInstanceId(-1), _
     m_isKnockedback = false;
     m_jumpHackChances = 5;
     m_tutorials.Clear();
+    _decodedIndex = 0;
+    m_moveDecode = NULL;
 
     for(uint32 x = 0; x < 8; x++)
         m_accountData[x] = NULL;
@@ -69,7 +72,7 @@ WorldSession::~WorldSession()
     }
 
     WorldPacket *packet;
-    while((packet = _recvQueue.Pop()))
+    while((packet = _PopPacket()))
         delete packet;
 
     for(uint32 x = 0;x < 8; x++)
@@ -103,9 +106,23 @@ WorldSession::~WorldSession()
 void WorldSession::Init()
 {
     m_maxLevel = sWorld.GetMaxLevel(this);
-    LoadTutorials();
-    LoadAccountData();
-    LoadCharacterData();
+
+    // Everything we need before auth completes goes out as one batch, World picks the session back up once it's loaded
+    AsyncQuery *q = new AsyncQuery(new SQLClassCallbackP1<World, uint32>(World::getSingletonPtr(), &World::LoginDataLoaded, GetAccountId()));
+    q->AddQuery("SELECT * FROM account_tutorials WHERE acct = '%u';", GetAccountId());
+    q->AddQuery("SELECT orderId, charGuid FROM account_characters WHERE accountId = '%u';", GetAccountId());
+    if(sWorld.m_useAccountData)
+        q->AddQuery("SELECT * FROM account_data WHERE accountid = %u", GetAccountId());
+    q->SetBatched();
+    CharacterDatabase.QueueThreadedAsyncQuery(q);
+}
+
+void WorldSession::LoadLoginData(QueryResultVector & results)
+{
+    LoadTutorials(results[LOGIN_LO_TUTORIALS].result);
+    LoadCharacterData(results[LOGIN_LO_CHARACTERS].result);
+    if(results.size() > LOGIN_LO_ACCOUNT_DATA)
+        LoadAccountData(results[LOGIN_LO_ACCOUNT_DATA].result);
 }
 
 bool WorldSession::InitializeZLibCompression()
@@ -125,6 +142,99 @@ bool WorldSession::InitializeZLibCompression()
     return CanUseCommand('z');
 }
 
+bool WorldSession::IsDecodeHandledOpcode(uint16 opcode)
+{
+    // These only read from static storage and reply, so they're safe off the map thread
+    switch(opcode)
+    {
+    case CMSG_QUERY_TIME:
+    case CMSG_CREATURE_QUERY:
+    case CMSG_GAMEOBJECT_QUERY:
+    case CMSG_PAGE_TEXT_QUERY:
+        return true;
+    }
+    return false;
+}
+
+void WorldSession::DecodeQueuedPackets()
+{
+    if(_player == NULL || !_recvQueue.HasItems())
+        return;
+
+    if(_decodedIndex == _decodedPackets.size())
+    {
+        _decodedPackets.clear();
+        _decodedIndex = 0;
+    }
+
+    // Chain the prediction from whatever is still waiting from the last pass
+    int32 previous = -1;
+    for(size_t i = _decodedIndex; i < _decodedPackets.size(); ++i)
+        if(_decodedPackets[i].second.decoded)
+            previous = i;
+
+    WorldPacket *packet;
+    MovementInterface *moveInterface = _player->GetMovementInterface();
+    while((packet = _recvQueue.Pop()))
+    {
+        uint16 opcode = packet->GetOpcode();
+        if(opcode < NUM_CLIENT_MSG && IsDecodeHandledOpcode(opcode) && _CanHandleEarly(&WorldPacketHandlers[opcode]))
+        {
+            OpcodeHandler *Handler = &WorldPacketHandlers[opcode];
+            try
+            {
+                (this->*Handler->handler)(*packet);
+            }
+            catch (ByteBufferException &)
+            { sLog.Error("WorldSession", "Incorrect handling of opcode %s (0x%.4X) REPORT TO DEVS", sOpcodeMgr.GetOpcodeName(opcode), opcode); }
+
+            if(Handler->status == STATUS_AUTHED)
+                _recentlogout = false;
+            delete packet;
+            continue;
+        }
+
+        _decodedPackets.push_back(std::make_pair(packet, MovementClientDecode()));
+        if(opcode < NUM_CLIENT_MSG && WorldPacketHandlers[opcode].handler == &WorldSession::HandleMovementOpcodes)
+        {
+            MovementClientDecode &decode = _decodedPackets.back().second;
+            if(moveInterface->DecodeFromClient(opcode, packet, decode, previous == -1 ? NULL : &_decodedPackets[previous].second))
+                previous = _decodedPackets.size()-1;
+        }
+    }
+}
+
+bool WorldSession::_CanHandleEarly(OpcodeHandler *Handler)
+{
+    // Same state checks as the update loop, anything failing them stays in order for it to reject
+    if(Handler->status == STATUS_IGNORED || Handler->handler == 0)
+        return false;
+    if(Handler->status == STATUS_LOGGEDIN && !_player)
+        return false;
+    if(Handler->status == STATUS_IN_OR_LOGGINGOUT && !_player && !_recentlogout)
+        return false;
+    return true;
+}
+
+WorldPacket *WorldSession::_PopPacket()
+{
+    m_moveDecode = NULL;
+    if(_decodedIndex < _decodedPackets.size())
+    {
+        std::pair<WorldPacket*, MovementClientDecode> &next = _decodedPackets[_decodedIndex++];
+        if(next.second.decoded)
+            m_moveDecode = &next.second;
+        return next.first;
+    }
+
+    if(!_decodedPackets.empty())
+    {
+        _decodedPackets.clear();
+        _decodedIndex = 0;
+    }
+    return _recvQueue.Pop();
+}
+
 int WorldSession::Update(int32 instanceId)
 {
     m_currMsTime = getMSTime();
@@ -162,12 +272,12 @@ int WorldSession::Update(int32 instanceId)
             SetLogoutTimer(PLAYER_LOGOUT_DELAY);
     }
 
-    if(_recvQueue.HasItems())
+    if(_decodedIndex < _decodedPackets.size() || _recvQueue.HasItems())
     {
         WorldPacket *packet;
         OpcodeHandler * Handler;
         _lastPacketHandle = m_currMsTime;
-        while (!bDeleted && instanceId == m_eventInstanceId && _socket && _socket->IsConnected() && (packet = _recvQueue.Pop()))
+        while (!bDeleted && instanceId == m_eventInstanceId && _socket && _socket->IsConnected() && (packet = _PopPacket()))
         {
             ASSERT(packet);
             if(packet->GetOpcode() >= NUM_CLIENT_MSG)
@@ -178,11 +288,11 @@ int WorldSession::Update(int32 instanceId)
                 if(Handler->status != STATUS_IGNORED)
                 {
                     if(Handler->status == STATUS_LOGGEDIN && !_player && Handler->handler != 0)
-                        sLog.Warning("WorldSession", "Received unexpected/wrong state packet(Logged In) with opcode %s (0x%.4X)", sOpcodeMgr.GetOpcodeName(packet->GetOpcode()), packet->GetOpcode());
+                        CLOG_WARNING("WorldSession", "Received unexpected/wrong state packet(Logged In) with opcode %s (0x%.4X)", sOpcodeMgr.GetOpcodeName(packet->GetOpcode()), packet->GetOpcode());
                     else if(Handler->status == STATUS_IN_OR_LOGGINGOUT && !_player && !_recentlogout && Handler->handler != 0)
-                        sLog.Warning("WorldSession", "Received unexpected/wrong state packet(In or Out) with opcode %s (0x%.4X)", sOpcodeMgr.GetOpcodeName(packet->GetOpcode()), packet->GetOpcode());
+                        CLOG_WARNING("WorldSession", "Received unexpected/wrong state packet(In or Out) with opcode %s (0x%.4X)", sOpcodeMgr.GetOpcodeName(packet->GetOpcode()), packet->GetOpcode());
                     else if(Handler->handler == 0)
-                        sLog.Warning("WorldSession", "Received unhandled packet with opcode %s (0x%.4X)", sOpcodeMgr.GetOpcodeName(packet->GetOpcode()), packet->GetOpcode());
+                        CLOG_WARNING("WorldSession", "Received unhandled packet with opcode %s (0x%.4X)", sOpcodeMgr.GetOpcodeName(packet->GetOpcode()), packet->GetOpcode());
                     else
                     {   // Valid Packet :>
                         try
@@ -201,6 +311,7 @@ int WorldSession::Update(int32 instanceId)
                 }
             }
 
+            m_moveDecode = NULL;
             delete packet;
         }
     }
@@ -1119,23 +1230,18 @@ void WorldSession::SendAccountDataTimes(uint8 mask)
     SendPacket(&data);
 }
 
-void WorldSession::LoadAccountData()
+void WorldSession::LoadAccountData(QueryResult *pResult)
 {
-    if(sWorld.m_useAccountData)
-    {
-        QueryResult *pResult = CharacterDatabase.Query("SELECT * FROM account_data WHERE accountid = %u", GetAccountId());
-        if( pResult == NULL )
-            return;
+    if( pResult == NULL )
+        return;
 
-        for(uint8 i = 0; i < 8; i++)
-        {
-            const char *data = pResult->Fetch()[1+i].GetString();
-            uint32 len = data ? strlen(data) : 0;
-            if(len == 0)
-                continue;
-            SetAccountData(i, data, true, len);
-        }
-        delete pResult;
+    for(uint8 i = 0; i < 8; i++)
+    {
+        const char *data = pResult->Fetch()[1+i].GetString();
+        uint32 len = data ? strlen(data) : 0;
+        if(len == 0)
+            continue;
+        SetAccountData(i, data, true, len);
     }
 }
 
@@ -1161,9 +1267,8 @@ void WorldSession::SaveAccountData()
     }
 }
 
-void WorldSession::LoadCharacterData()
+void WorldSession::LoadCharacterData(QueryResult *res)
 {
-    QueryResult *res = CharacterDatabase.Query("SELECT orderId, charGuid FROM account_characters WHERE accountId = '%u';", GetAccountId());
     if(res == NULL)
         return;
 
@@ -1205,7 +1310,6 @@ void WorldSession::LoadCharacterData()
     }
 
     charDataLock.Release();
-    delete res;
 }
 
 bool WorldSession::HasCharacterData(WoWGuid guid)
@@ -1224,9 +1328,8 @@ bool WorldSession::HasCharacterData(WoWGuid guid)
     return res;
 }
 
-void WorldSession::LoadTutorials()
+void WorldSession::LoadTutorials(QueryResult *result)
 {
-    QueryResult *result = CharacterDatabase.Query("SELECT * FROM account_tutorials WHERE acct = '%u';", GetAccountId());
     if(result == NULL)
         return;
     for(uint32 ui = 0; ui < 8; ++ui)
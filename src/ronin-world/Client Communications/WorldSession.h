@@ -95,6 +95,14 @@ enum AccountDataTypes
 #define GLOBAL_CACHE_MASK           0x15
 #define PER_CHARACTER_CACHE_MASK    0xEA
 
+// Result order of the login data batch queued by WorldSession::Init
+enum LoginLoadOrder : uint8
+{
+    LOGIN_LO_TUTORIALS = 0,
+    LOGIN_LO_CHARACTERS,
+    LOGIN_LO_ACCOUNT_DATA
+};
+
 typedef struct Cords {
     float x,y,z;
 }Cords;
@@ -119,12 +127,14 @@ public:
     ~WorldSession();
 
     void Init();
+    void LoadLoginData(QueryResultVector & results);
 
     bool InitializeZLibCompression();
     void CharEnumDisplayData(QueryResultVector& results);
 
     RONIN_INLINE bool IsLoggingIn() { return (m_loggingInPlayer != NULL); };
     Player* m_loggingInPlayer;
+    uint32 m_loginRequestTime;
 
     RONIN_INLINE void SendPacket(WorldPacket* packet);
     void OutPacket(uint16 opcode, uint16 len = 0, const void* data = NULL);
@@ -232,6 +242,9 @@ public:
     }
 
     int __fastcall Update(int32 InstanceID);
+
+    // Run from the map's task pool before Update, handles read only queries and decodes movement for the map thread
+    void DecodeQueuedPackets();
     RONIN_INLINE int32 GetEventInstanceId() { return m_eventInstanceId; }
     RONIN_INLINE void SetEventInstanceId(int32 instanceId) { m_eventInstanceId = instanceId; }
 
@@ -739,7 +752,15 @@ private:
     WoWGuid m_MoverWoWGuid;
 
     z_stream *_zlibStream;
-    FastQueue<WorldPacket*, Mutex> _recvQueue;
+    MPSCQueue<WorldPacket*> _recvQueue;
+
+    // Packets already popped by DecodeQueuedPackets, handled before the receive queue
+    std::vector<std::pair<WorldPacket*, MovementClientDecode> > _decodedPackets;
+    size_t _decodedIndex;
+    const MovementClientDecode *m_moveDecode;
+    WorldPacket *_PopPacket();
+    static bool IsDecodeHandledOpcode(uint16 opcode);
+    bool _CanHandleEarly(OpcodeHandler *Handler);
     std::string permissions;
     int permissioncount;
 
@@ -756,12 +777,12 @@ private:
 
     // Data
     void SendAccountDataTimes(uint8 mask);
-    void LoadAccountData();
+    void LoadAccountData(QueryResult *pResult);
     void SaveAccountData();
     AccountDataEntry *m_accountData[8];
 
     // Characters
-    void LoadCharacterData();
+    void LoadCharacterData(QueryResult *res);
     bool HasCharacterData(WoWGuid lowGuid);
 
     Mutex charDataLock;
@@ -770,7 +791,7 @@ private:
     std::set<WoWGuid> m_bannedCharacters;
 
     // Tutorials
-    void LoadTutorials();
+    void LoadTutorials(QueryResult *result);
     void SaveTutorials();
     UpdateMask m_tutorials;
 
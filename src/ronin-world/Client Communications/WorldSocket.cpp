@@ -37,6 +37,7 @@ WorldSocket::WorldSocket(SOCKET fd, const sockaddr_in * peer) : TcpSocket(fd, WO
     mSeed = RandomUInt();
     addonPacket = NULL;
     mQueued = false;
+    mLoginPending = false;
     mRequestID = 0;
     m_fullAccountName = NULL;
 }
@@ -55,9 +56,13 @@ WorldSocket::~WorldSocket()
 
     if(mSession)
     {
+        sWorld.AcquirePendingLoginLock();
+        if(mLoginPending)
+            sWorld.RemovePendingLogin(this, mSession->GetAccountId());
         sWorld.CancelWorldPush(mSession);
         mSession->SetSocket(NULL);
         mSession=NULL;
+        sWorld.ReleasePendingLoginLock();
     }
 
     if( m_fullAccountName != NULL )
@@ -69,12 +74,21 @@ WorldSocket::~WorldSocket()
 
 void WorldSocket::OnDisconnect()
 {
+    // The world thread hands loaded logins back under the pending login lock, so it can't pick up our session halfway through
+    sWorld.AcquirePendingLoginLock();
     if(mSession)
     {
+        if(mLoginPending)
+        {
+            sWorld.RemovePendingLogin(this, mSession->GetAccountId());
+            mLoginPending = false;
+        }
+
         sWorld.CancelWorldPush(mSession);
         mSession->SetSocket(0);
         mSession = NULL;
     }
+    sWorld.ReleasePendingLoginLock();
 
     if(mRequestID != 0)
     {
@@ -209,6 +223,7 @@ OUTPACKET_RESULT WorldSocket::_OutPacket(uint16 opcode, size_t len, const void*
         rv = Write((const uint8*)data, (uint32)len);
     else if(rv) rv = ForceSend();
     UnlockWriteBuffer();
+    if(rv) sServerCounters.AddPacketOut(opcode, len);
     return rv ? OUTPACKET_RESULT_SUCCESS : OUTPACKET_RESULT_SOCKET_ERROR;
 }
 
@@ -313,6 +328,13 @@ void WorldSocket::InformationRetreiveCallback(WorldPacket & recvData, uint32 req
 
     recvData.read((uint8*)lang.data(), 4);
 
+    // Our previous connection is still waiting on its login data
+    if( sWorld.HasPendingLogin( AccountID ) )
+    {
+        SendAuthResponse(AUTH_ALREADY_LOGGING_IN, false);
+        return;
+    }
+
     //checking if player is already connected
     //disconnect current player and login this one(blizzlike)
     if( WorldSession *session = sWorld.FindSession( AccountID ) )
@@ -378,10 +400,27 @@ void WorldSocket::InformationRetreiveCallback(WorldPacket & recvData, uint32 req
         return;
     }
 
+    sLog.Debug("Auth", "%s from %s:%u [%ums]", AccountName.c_str(), GetIP(), GetPort(), _latency);
+
+    // Login data is loaded off thread, we pick back up in OnLoginDataLoaded
+    mLoginPending = true;
     mSession = pSession;
-    pSession->Init();
+    if(!sWorld.AddPendingLogin(this, pSession))
+    {
+        mLoginPending = false;
+        mSession = NULL;
+        delete pSession;
+        SendAuthResponse(AUTH_ALREADY_LOGGING_IN, false);
+    }
+}
 
-    sLog.Debug("Auth", "%s from %s:%u [%ums]", AccountName.c_str(), GetIP(), GetPort(), _latency);
+void WorldSocket::OnLoginDataLoaded()
+{
+    // Called by the world thread while holding the pending login lock
+    mLoginPending = false;
+    WorldSession *pSession = mSession;
+    if(pSession == NULL)
+        return;
 
     // Check for queue.
     if( (sWorld.GetSessionCount() < sWorld.GetPlayerLimit()) || pSession->HasGMPermissions() )
@@ -391,7 +430,7 @@ void WorldSocket::InformationRetreiveCallback(WorldPacket & recvData, uint32 req
         // Queued, sucker.
         uint32 Position = sWorld.AddQueuedSocket(this);
         mQueued = true;
-        sLog.Debug("Queue", "%s added to queue in position %u", AccountName.c_str(), Position);
+        sLog.Debug("Queue", "%s added to queue in position %u", pSession->GetAccountNameS(), Position);
 
         // Send packet so we know what we're doing
         SendAuthResponse(AUTH_WAIT_QUEUE, true, Position);
@@ -513,6 +552,7 @@ void WorldSocket::OnRecvData()
             Packet->resize(mRemaining);
             Read((uint8*)Packet->contents(), mRemaining);
         }
+        sServerCounters.AddPacketIn(mOpcode, mRemaining);
         mRemaining = mOpcode = 0;
 
         // Check for packets that we handle
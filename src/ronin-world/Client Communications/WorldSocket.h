@@ -94,6 +94,7 @@ public:
 
     void Authenticate();
     void InformationRetreiveCallback(WorldPacket & recvData, uint32 requestid);
+    void OnLoginDataLoaded();
 
     void SendAuthResponse(uint8 code, bool holdsPosition, uint32 position = 0);
     void SendAddonPacket(WorldSession *pSession);
@@ -124,7 +125,7 @@ private:
 
     WowCrypt _crypt;
     uint32 _latency;
-    bool m_authed, mQueued, isBattleNetAccount;
+    bool m_authed, mQueued, mLoginPending, isBattleNetAccount;
     std::string * m_fullAccountName;
 
     // Packet recv and send headers
@@ -45,7 +45,7 @@ bool HandleInfoCommand(BaseConsole * pConsole, int argc, const char * argv[])
     pConsole->Write("======================================================================\r\n");
     pConsole->Write("Server Revision: SS Ronin(%s::%s) r%u/%s-%s-%s\r\n", BUILD_TAG, BUILD_HASH_STR, BUILD_REVISION, CONFIG, PLATFORM_TEXT, ARCH);
     pConsole->Write("Server Uptime: %s\r\n", sWorld.GetUptimeString().c_str());
-    pConsole->Write("Useage(Win only): RAM:(%f), CPU:(%f)\r\n", sWorld.GetRAMUsage(), sWorld.GetAverageCPUUsage());
+    pConsole->Write("Usage: RAM:(%f), CPU:(%f)\r\n", sWorld.GetRAMUsage(), sWorld.GetAverageCPUUsage());
     pConsole->Write("SQL Query Cache Size: (W: %u/C: %u) queries delayed\r\n", WorldDatabase.GetQueueSize(), CharacterDatabase.GetQueueSize());
     pConsole->Write("Active Thread Count: %u\r\n", sThreadManager.GetActiveThreadCount());
     pConsole->Write("Players Online: (%u Alliance/%u Horde/%u GMs)\r\n",sWorld.AlliancePlayers, sWorld.HordePlayers, gm);
@@ -53,6 +53,67 @@ bool HandleInfoCommand(BaseConsole * pConsole, int argc, const char * argv[])
     pConsole->Write("Accepted Connections: %u\r\n", sWorld.mAcceptedConnections);
     pConsole->Write("Connection Peak: %u\r\n", sWorld.PeakSessionCount);
     pConsole->Write("Logonserver Latency: %u\r\n", sLogonCommHandler.GetLatency());
+    pConsole->Write("Login Data Latency: p50 %ums, p99 %ums (%u logins)\r\n", sWorld.m_loginDataLatency.GetPercentile(50.f), sWorld.m_loginDataLatency.GetPercentile(99.f), sWorld.m_loginDataLatency.GetSampleCount());
+    pConsole->Write("Player Login Latency: p50 %ums, p99 %ums (%u logins)\r\n", sWorld.m_playerLoginLatency.GetPercentile(50.f), sWorld.m_playerLoginLatency.GetPercentile(99.f), sWorld.m_playerLoginLatency.GetSampleCount());
+    pConsole->Write("======================================================================\r\n\r\n");
+    return true;
+}
+
+bool HandleMetricsCommand(BaseConsole * pConsole, int argc, const char * argv[])
+{
+    uint32 opcodeCount = argc > 1 ? std::max<uint32>(1, atol(argv[1])) : 10;
+
+    pConsole->Write("======================================================================\r\n");
+    pConsole->Write("Server Metrics: \r\n");
+    pConsole->Write("======================================================================\r\n");
+
+    ProcessMemoryStats memory;
+    if(ReadProcessMemoryStats(memory))
+        pConsole->Write("Memory: %uMB resident (peak %uMB), %uMB virtual, %uMB data, %u threads\r\n", memory.residentKB/1024, memory.peakResidentKB/1024, memory.virtualKB/1024, memory.dataKB/1024, memory.threads);
+    pConsole->Write("CPU: %.2f%% averaged over the last 10 seconds\r\n", sWorld.GetAverageCPUUsage());
+
+    // Thread cpu use since the last time this was run, busiest first
+    static std::map<uint32, uint64> lastThreadTicks;
+    static uint32 lastThreadSample = 0;
+    std::vector<ThreadCPUTimes> threads;
+    if(ReadThreadCPUTimes(threads))
+    {
+        uint32 mstime = getMSTime(), elapsed = lastThreadSample ? getMSTimeDiff(mstime, lastThreadSample) : 0;
+        std::vector<std::pair<uint64, ThreadCPUTimes*> > usage;
+        std::map<uint32, uint64> threadTicks;
+        for(std::vector<ThreadCPUTimes>::iterator itr = threads.begin(); itr != threads.end(); itr++)
+        {
+            uint64 ticks = itr->userTicks + itr->systemTicks;
+            std::map<uint32, uint64>::iterator lastItr = lastThreadTicks.find(itr->threadId);
+            usage.push_back(std::make_pair(ticks - (lastItr == lastThreadTicks.end() ? 0 : lastItr->second), &(*itr)));
+            threadTicks.insert(std::make_pair(itr->threadId, ticks));
+        }
+        lastThreadTicks.swap(threadTicks);
+        lastThreadSample = mstime;
+
+        std::sort(usage.begin(), usage.end(), std::greater<std::pair<uint64, ThreadCPUTimes*> >());
+        pConsole->Write("Threads (%s):\r\n", elapsed ? format("last %us", elapsed/1000).c_str() : "since start");
+        for(size_t i = 0; i < usage.size() && i < 10; ++i)
+        {
+            double seconds = double(usage[i].first) / double(GetProcessClockTicks());
+            pConsole->Write("  %6u %-15s %8.2fs cpu%s\r\n", usage[i].second->threadId, usage[i].second->name, seconds,
+                elapsed ? format(" (%.1f%%)", seconds * 100000.0 / double(elapsed)).c_str() : "");
+        }
+    }
+
+    for(uint32 i = 0; i < SERVER_COUNTER_MAX; ++i)
+        pConsole->Write("%s: " UI64FMTD "\r\n", ServerCounters::GetCounterName(ServerCounterType(i)), sServerCounters.Get(ServerCounterType(i)));
+    pConsole->Write("Database queues: World %u (peak %u), Character %u (peak %u)\r\n", sServerCounters.GetWorldQueueDepth(false), sServerCounters.GetWorldQueueDepth(true),
+        sServerCounters.GetCharacterQueueDepth(false), sServerCounters.GetCharacterQueueDepth(true));
+
+    std::vector<OpcodeCounter> opcodes;
+    for(uint32 direction = 0; direction < 2; ++direction)
+    {
+        sServerCounters.GetTopOpcodes(direction == 1, opcodeCount, opcodes);
+        pConsole->Write("Top %s opcodes:\r\n", direction ? "outgoing" : "incoming");
+        for(std::vector<OpcodeCounter>::iterator itr = opcodes.begin(); itr != opcodes.end(); itr++)
+            pConsole->Write("  %-40s " UI64FMTD " packets, " UI64FMTD " bytes\r\n", sOpcodeMgr.GetOpcodeName(itr->opcode), itr->packets, itr->bytes);
+    }
     pConsole->Write("======================================================================\r\n\r\n");
     return true;
 }
@@ -22,6 +22,7 @@
 #pragma once
 
 bool HandleInfoCommand(BaseConsole * pConsole, int argc, const char * argv[]);
+bool HandleMetricsCommand(BaseConsole * pConsole, int argc, const char * argv[]);
 bool HandleSuicideCommand(BaseConsole * pConsole, int argc, const char * argv[]);
 bool HandleGMsCommand(BaseConsole * pConsole, int argc, const char * argv[]);
 bool HandleAnnounceCommand(BaseConsole * pConsole, int argc, const char * argv[]);
@@ -343,6 +343,7 @@ void HandleConsoleInput(BaseConsole * pConsole, const char * szInput)
         { &HandleCancelCommand, "cancel", "none", "Cancels a pending shutdown." },
         { &HandleCreateAccountCommand, "createaccount", "<name> <pass> <email> <flags>", "Creates an account." },
         { &HandleInfoCommand, "info", "none", "Gives server runtime information." },
+        { &HandleMetricsCommand, "metrics", "[opcodes]", "Shows process cpu and memory, busiest threads, server counters and top opcodes." },
         { &HandleGMsCommand, "gms", "none", "Shows online GMs." },
         { &HandleKickCommand, "kick", "<plrname> <reason>", "Kicks player x for reason y." },
         { &HandleMOTDCommand, "getmotd", "none", "View the current MOTD" },
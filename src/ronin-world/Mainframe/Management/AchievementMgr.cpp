@@ -10,18 +10,6 @@ AchievementMgr::AchievementMgr()
 
 AchievementMgr::~AchievementMgr()
 {
-    while(!m_playerAchieveData.empty())
-    {
-        AchieveDataContainer *container = m_playerAchieveData.begin()->second;
-        m_playerAchieveData.erase(m_playerAchieveData.begin());
-        while(!container->m_criteriaProgress.empty())
-        {
-            delete container->m_criteriaProgress.begin()->second;
-            container->m_criteriaProgress.erase(container->m_criteriaProgress.begin());
-        }
-        container->m_criteriaProgress.clear();
-        delete container;
-    }
     m_playerAchieveData.clear();
 }
 
@@ -36,7 +24,6 @@ void AchievementMgr::ParseAchievements()
         AchievementEntry *achievement = dbcAchievement.LookupEntry(entry->referredAchievement);
         if(achievement == NULL || achievement->flags & ACHIEVEMENT_FLAG_GUILD) // Guild achievements are hard coded(need impl)
             continue;
-        m_criteriaByType.insert(std::make_pair(entry->requiredType, entry));
         m_criteriaByAchievement.insert(std::make_pair(entry->referredAchievement, entry));
     }
 
@@ -123,6 +110,27 @@ void AchievementMgr::ParseAchievements()
         }
     }
 
+    // Compact criteria by achievement and index them by the type and asset they fire on
+    for(CriteriaStorage::iterator itr = m_criteriaByAchievement.begin(); itr != m_criteriaByAchievement.end(); itr++)
+    {
+        AchievementCriteriaEntry *criteria = itr->second;
+        uint32 index = uint32(m_criteriaList.size());
+        m_criteriaList.push_back(criteria);
+        m_criteriaIndexById.insert(std::make_pair(criteria->ID, index));
+        m_criteriaDispatch[_GetDispatchKey(criteria->requiredType, _GetCriteriaAsset(criteria))].push_back(index);
+
+        // Achievements this criteria can earn, used to mask it once they're all done
+        m_criteriaAchievements.push_back(std::vector<AchievementEntry*>());
+        AchievementStorageBounds abounds = m_achievementsByReferrence.equal_range(criteria->referredAchievement);
+        for(AchievementStorage::iterator itr2 = abounds.first; itr2 != abounds.second; itr2++)
+        {
+            AchievementEntry *achievement = itr2->second;
+            if(achievement == NULL || achievement->flags & ACHIEVEMENT_FLAG_COUNTER || !_CheckCriteriaForAchievement(criteria, achievement))
+                continue;
+            m_criteriaAchievements.back().push_back(achievement);
+        }
+    }
+
     // See if we have any realm firsts already completed in our database
     if(m_realmFirstAchievements.size())
     {
@@ -149,26 +157,30 @@ void AchievementMgr::ParseAchievements()
 
 void AchievementMgr::AllocatePlayerData(WoWGuid guid)
 {
+    Guard guard(achieveDataLock);
     if(m_playerAchieveData.find(guid) != m_playerAchieveData.end())
         return;
-    m_playerAchieveData.insert(std::make_pair(guid, new AchieveDataContainer(guid)));
+    m_playerAchieveData.insert(std::make_pair(guid, std::make_shared<AchieveDataContainer>(guid)));
 }
 
 void AchievementMgr::CleanupPlayerData(WoWGuid guid)
 {
-    if(m_playerAchieveData.find(guid) == m_playerAchieveData.end())
-        return;
-    AchieveDataContainer *container = m_playerAchieveData.at(guid);
+    // Anyone still working on the container keeps it alive until they're done
+    Guard guard(achieveDataLock);
     m_playerAchieveData.erase(guid);
-    delete container;
 }
 
 void AchievementMgr::PlayerFinishedLoading(Player *plr)
 {
-    if(m_playerAchieveData.find(plr->GetGUID()) == m_playerAchieveData.end())
+    std::shared_ptr<AchieveDataContainer> container = _GetContainer(plr->GetGUID());
+    if(container == NULL)
         return;
 
-    m_playerAchieveData.at(plr->GetGUID())->_loading = false;
+    container->_loading = false;
+    // Mask out criteria that can't earn anything new
+    for(std::map<uint32, time_t>::iterator itr = container->m_completedAchievements.begin(); itr != container->m_completedAchievements.end(); itr++)
+        if(AchievementEntry *entry = dbcAchievement.LookupEntry(itr->first))
+            _UpdateCompletedMask(plr, container.get(), entry);
 
     // Update retroactive criteria
     UpdateCriteriaValue(plr, ACHIEVEMENT_CRITERIA_TYPE_REACH_LEVEL, plr->getLevel(), 0, 0, true);
@@ -177,9 +189,9 @@ void AchievementMgr::PlayerFinishedLoading(Player *plr)
 void AchievementMgr::LoadAchievementData(WoWGuid guid, PlayerInfo *info, QueryResult *result)
 {
     uint32 loadedPoints = 0;
-    if(result)
+    std::shared_ptr<AchieveDataContainer> container = _GetContainer(guid);
+    if(result && container)
     {
-        AchieveDataContainer *container = m_playerAchieveData.at(guid);
         do
         {
             Field *fields = result->Fetch();
@@ -200,23 +212,21 @@ void AchievementMgr::LoadAchievementData(WoWGuid guid, PlayerInfo *info, QueryRe
 
 void AchievementMgr::LoadCriteriaData(WoWGuid guid, QueryResult *result)
 {
-    if(result == NULL)
+    std::shared_ptr<AchieveDataContainer> container = _GetContainer(guid);
+    if(result == NULL || container == NULL)
         return;
 
-    AchieveDataContainer *container = m_playerAchieveData.at(guid);
     do
     {
         Field *fields = result->Fetch();
-        uint32 criteria = fields[1].GetUInt32();
-        AchievementCriteriaEntry *entry = dbcAchievementCriteria.LookupEntry(criteria);
-        if(entry == NULL)
+        uint32 index = _GetCriteriaIndex(fields[1].GetUInt32());
+        if(index == 0xFFFFFFFF)
             continue;
 
-        CriteriaData *data = new CriteriaData();
+        CriteriaData *data = container->CreateProgress(index);
         data->criteriaCounter = fields[2].GetUInt64();
         data->timerData[0] = fields[3].GetUInt64();
         data->timerData[1] = fields[4].GetUInt64();
-        container->m_criteriaProgress.insert(std::make_pair(criteria, data));
     }while(result->NextRow());
 }
 
@@ -227,7 +237,7 @@ void AchievementMgr::SaveAchievementData(WoWGuid guid, QueryBuffer *buff)
     else CharacterDatabase.Execute("DELETE FROM character_achievements WHERE guid = %u;", guid.getLow());
 
     // Append anything we need to save
-    AchieveDataContainer *container = m_playerAchieveData.at(guid);
+    std::shared_ptr<AchieveDataContainer> container = _GetContainer(guid);
     if(container == NULL)
         return;
 
@@ -257,21 +267,25 @@ void AchievementMgr::SaveCriteriaData(WoWGuid guid, QueryBuffer *buff)
     else CharacterDatabase.Execute("DELETE FROM character_criteria_data WHERE guid = %u;", guid.getLow());
 
     // Append anything we need to save
-    AchieveDataContainer *container = m_playerAchieveData.at(guid);
+    std::shared_ptr<AchieveDataContainer> container = _GetContainer(guid);
     if(container == NULL)
         return;
 
     std::stringstream ss;
-    for(auto it = container->m_criteriaProgress.begin(); it != container->m_criteriaProgress.end(); it++)
+    for(uint32 index = 0; index < container->m_progressMask.size()*64; index++)
     {
+        CriteriaData *data = container->GetProgress(index);
+        if(data == NULL)
+            continue;
+
         if(ss.str().length())
             ss << ", ";
 
         ss << "(" << guid.getLow()
-        << ", " << uint32(it->first)
-        << ", " << uint64(it->second->criteriaCounter)
-        << ", " << uint64(it->second->timerData[0])
-        << ", " << uint64(it->second->timerData[1]);
+        << ", " << uint32(m_criteriaList[index]->ID)
+        << ", " << uint64(data->criteriaCounter)
+        << ", " << uint64(data->timerData[0])
+        << ", " << uint64(data->timerData[1]);
         ss << ")";
     }
 
@@ -284,14 +298,18 @@ void AchievementMgr::SaveCriteriaData(WoWGuid guid, QueryBuffer *buff)
 
 void AchievementMgr::BuildAchievementData(WoWGuid guid, WorldPacket *data, bool buildEmpty)
 {
-    AchieveDataContainer *container = m_playerAchieveData.at(guid);
+    std::shared_ptr<AchieveDataContainer> container = _GetContainer(guid);
     ASSERT(container != NULL);
 
     ByteBuffer criteriaData;
-    data->WriteBits(buildEmpty ? 0 : container->m_criteriaProgress.size(), 21);
-    for(auto it = container->m_criteriaProgress.begin(); buildEmpty == false && it != container->m_criteriaProgress.end(); it++)
+    data->WriteBits(buildEmpty ? 0 : container->m_progressCount, 21);
+    for(uint32 index = 0; buildEmpty == false && index < container->m_progressMask.size()*64; index++)
     {
-        WoWGuid counter(it->second->criteriaCounter);
+        CriteriaData *progress = container->GetProgress(index);
+        if(progress == NULL)
+            continue;
+
+        WoWGuid counter(progress->criteriaCounter);
         // Append our bit data
         data->WriteBit(guid[4]);
         data->WriteBit(counter[3]);
@@ -302,7 +320,7 @@ void AchievementMgr::BuildAchievementData(WoWGuid guid, WorldPacket *data, bool
         data->WriteBit(guid[2]);
         data->WriteBit(counter[7]);
         data->WriteBit(guid[7]);
-        data->WriteBits(it->second->flag, 2);
+        data->WriteBits(progress->flag, 2);
         data->WriteBit(guid[6]);
         data->WriteGuidBitString(3, counter, 2, 1, 5);
         data->WriteBit(guid[1]);
@@ -313,16 +331,16 @@ void AchievementMgr::BuildAchievementData(WoWGuid guid, WorldPacket *data, bool
         criteriaData.WriteSeqByteString(2, guid, 4, 6);
         criteriaData.WriteByteSeq(counter[2]);
 
-        criteriaData << uint32(UNIXTIME - it->second->timerData[1]); // Timer 2
+        criteriaData << uint32(UNIXTIME - progress->timerData[1]); // Timer 2
         criteriaData.WriteByteSeq(guid[2]);
-        criteriaData << uint32(it->first);
+        criteriaData << uint32(m_criteriaList[index]->ID);
 
         criteriaData.WriteByteSeq(guid[5]);
         criteriaData.WriteSeqByteString(4, counter, 0, 3, 1, 4);
         criteriaData.WriteSeqByteString(2, guid, 0, 7);
         criteriaData.WriteByteSeq(counter[7]);
 
-        criteriaData << uint32(UNIXTIME - it->second->timerData[0]); // Timer 1
+        criteriaData << uint32(UNIXTIME - progress->timerData[0]); // Timer 1
         criteriaData << RONIN_UTIL::secsToTimeBitFields(UNIXTIME);
 
         criteriaData.WriteByteSeq(guid[1]);
@@ -360,28 +378,30 @@ bool AchievementMgr::IsValidAchievement(Player *plr, AchievementEntry *entry)
 
 void AchievementMgr::UpdateCriteriaValue(Player *plr, uint32 criteriaType, uint32 mod, uint32 misc1, uint32 misc2, bool onLoad)
 {
-    if(m_playerAchieveData.find(plr->GetGUID()) == m_playerAchieveData.end())
+    std::shared_ptr<AchieveDataContainer> container = _GetContainer(plr->GetGUID());
+    if(container == NULL || container->_loading)
         return;
-    AchieveDataContainer *container = m_playerAchieveData.at(plr->GetGUID());
-    if(container->_loading)
-        return;
-    CriteriaStorageBounds cbounds = m_criteriaByType.equal_range(criteriaType);
-    if(cbounds.first == cbounds.second)
+    // Asset keyed types only see the criteria naming this creature, quest or item
+    CriteriaDispatchMap::iterator dispatch = m_criteriaDispatch.find(_GetDispatchKey(criteriaType, _IsAssetKeyedType(criteriaType) ? misc1 : 0));
+    if(dispatch == m_criteriaDispatch.end())
         return;
 
-    std::vector<std::pair<uint64, AchievementCriteriaEntry*>> processedCriteria;
-    for(CriteriaStorage::iterator itr = cbounds.first; itr != cbounds.second; itr++)
+    std::vector<std::pair<uint64, uint32>> processedCriteria;
+    for(std::vector<uint32>::iterator itr = dispatch->second.begin(); itr != dispatch->second.end(); itr++)
     {
+        uint32 index = *itr;
+        // Skip criteria whose achievements are all earned
+        if(AchieveDataContainer::TestBit(container->m_completedMask, index))
+            continue;
+
         uint32 maxCounter = 0, thisMod = mod;
         CriteriaCounterModifier modType = CCM_HIGHEST;
-        AchievementCriteriaEntry *criteria = itr->second;
-        if(criteria == NULL || !_ValidateCriteriaRequirements(plr, criteria, modType, thisMod, maxCounter, misc1, misc2))
+        AchievementCriteriaEntry *criteria = m_criteriaList[index];
+        if(!_ValidateCriteriaRequirements(plr, criteria, modType, thisMod, maxCounter, misc1, misc2))
             continue;
 
         // Update criteria value here
-        if(container->m_criteriaProgress.find(criteria->ID) == container->m_criteriaProgress.end())
-            container->m_criteriaProgress.insert(std::make_pair(criteria->ID, new CriteriaData()));
-        CriteriaData *data = container->m_criteriaProgress.at(criteria->ID);
+        CriteriaData *data = container->CreateProgress(index);
         // store previous criteria value
         uint64 previous = data->criteriaCounter;
         if(!onLoad && maxCounter && previous == maxCounter)
@@ -404,34 +424,32 @@ void AchievementMgr::UpdateCriteriaValue(Player *plr, uint32 criteriaType, uint3
         if(criteria->referredAchievement == 0)
             continue;
         // Push the criteria into the processed batch before we update the counter
-        processedCriteria.push_back(std::make_pair(previous, criteria));
+        processedCriteria.push_back(std::make_pair(previous, index));
     }
 
-    for(std::vector<std::pair<uint64, AchievementCriteriaEntry*>>::iterator itr = processedCriteria.begin(); itr != processedCriteria.end(); itr++)
+    for(std::vector<std::pair<uint64, uint32>>::iterator itr = processedCriteria.begin(); itr != processedCriteria.end(); itr++)
     {
         uint64 previous = (*itr).first;
-        AchievementCriteriaEntry *criteria = (*itr).second;
+        AchievementCriteriaEntry *criteria = m_criteriaList[(*itr).second];
         // Get our list of achievements along the reference line and process them
-        AchievementStorageBounds abounds = m_achievementsByReferrence.equal_range(criteria->referredAchievement);
-        if(abounds.first == abounds.second)
+        std::vector<AchievementEntry*> &achievements = m_criteriaAchievements[(*itr).second];
+        if(achievements.empty())
             continue;
 
-        CriteriaData *data = container->m_criteriaProgress.at(criteria->ID);
+        CriteriaData *data = container->GetProgress((*itr).second);
         // The referrenced achievement is always at the front(or should be?) and in the storage
-        for(AchievementStorage::iterator itr2 = abounds.first; itr2 != abounds.second; itr2++)
+        for(std::vector<AchievementEntry*>::iterator itr2 = achievements.begin(); itr2 != achievements.end(); itr2++)
         {
-            AchievementEntry *entry = itr2->second;
-            if(entry == NULL || !IsValidAchievement(plr, entry) || entry->flags & ACHIEVEMENT_FLAG_COUNTER)
-                continue;
-            if(!_CheckCriteriaForAchievement(criteria, entry))
+            AchievementEntry *entry = *itr2;
+            if(!IsValidAchievement(plr, entry))
                 continue;
             if(data->criteriaCounter >= previous)
             {
-                if(!_FinishedCriteria(container, criteria, entry))
+                if(!_FinishedCriteria(container.get(), criteria, entry))
                     continue;
-                if(_CheckAchievementRequirements(container, entry))
+                if(_CheckAchievementRequirements(container.get(), entry))
                     EarnAchievement(plr, entry->ID);
-            } else if(!_CheckAchievementRequirements(container, entry))
+            } else if(!_CheckAchievementRequirements(container.get(), entry))
                 RemoveAchievement(plr, entry->ID);
         }
 
@@ -453,10 +471,8 @@ void AchievementMgr::UpdateCriteriaValue(Player *plr, uint32 criteriaType, uint3
 
 void AchievementMgr::EarnAchievement(Player *plr, uint32 achievementId)
 {
-    if(m_playerAchieveData.find(plr->GetGUID()) == m_playerAchieveData.end())
-        return;
-    AchieveDataContainer *container = m_playerAchieveData.at(plr->GetGUID());
-    if(container->_loading)
+    std::shared_ptr<AchieveDataContainer> container = _GetContainer(plr->GetGUID());
+    if(container == NULL || container->_loading)
         return;
     AchievementEntry *entry = dbcAchievement.LookupEntry(achievementId);
     if(entry == NULL || !IsValidAchievement(plr, entry))
@@ -465,6 +481,7 @@ void AchievementMgr::EarnAchievement(Player *plr, uint32 achievementId)
     if(achievements->find(achievementId) != achievements->end())
         return;
     achievements->insert(std::make_pair(achievementId, time_t(UNIXTIME)));
+    _UpdateCompletedMask(plr, container.get(), entry);
     // Increment cached achievement points
     plr->getPlayerInfo()->achievementPoints += entry->points;
     if(!plr->IsInWorld())
@@ -484,17 +501,16 @@ void AchievementMgr::EarnAchievement(Player *plr, uint32 achievementId)
 
 void AchievementMgr::RemoveAchievement(Player *plr, uint32 achievementId)
 {
-    if(m_playerAchieveData.find(plr->GetGUID()) == m_playerAchieveData.end())
-        return;
     AchievementEntry *entry = dbcAchievement.LookupEntry(achievementId);
-    AchieveDataContainer *container = m_playerAchieveData.at(plr->GetGUID());
-    if(container->_loading || entry == NULL)
+    std::shared_ptr<AchieveDataContainer> container = _GetContainer(plr->GetGUID());
+    if(container == NULL || container->_loading || entry == NULL)
         return;
     std::map<uint32, time_t> *achievements = &container->m_completedAchievements;
     if(achievements->find(achievementId) == achievements->end())
         return;
 
     achievements->erase(achievementId);
+    _UpdateCompletedMask(plr, container.get(), entry);
     // Remove cached achievement points
     plr->getPlayerInfo()->achievementPoints -= entry->points;
     if(!plr->IsInWorld())
@@ -567,9 +583,10 @@ bool AchievementMgr::_FinishedCriteria(AchieveDataContainer *container, Achievem
     if (achievement->flags & (ACHIEVEMENT_FLAG_REALM_FIRST_REACH | ACHIEVEMENT_FLAG_REALM_FIRST_KILL))
         if (m_realmFirstCompleted.find(achievement->ID) != m_realmFirstCompleted.end()) // See if we've already completed it
             return false;
-    if(container->m_criteriaProgress.find(criteria->ID) == container->m_criteriaProgress.end())
+    CriteriaData *data = container->GetProgress(_GetCriteriaIndex(criteria->ID));
+    if(data == NULL)
         return false;
-    uint64 criteriaCounter = container->m_criteriaProgress.at(criteria->ID)->criteriaCounter;
+    uint64 criteriaCounter = data->criteriaCounter;
     return criteriaCounter >= criteria->getMaxCounter() || (achievement->flags & ACHIEVEMENT_FLAG_REQ_COUNT && criteriaCounter);
 }
 
@@ -598,14 +615,14 @@ bool AchievementMgr::_CheckAchievementRequirements(AchieveDataContainer *contain
     // Oddly, the target count is NOT countained in the achievement, but in each individual criteria
     if (achievement->flags & ACHIEVEMENT_FLAG_SUMM)
     {
-        std::map<uint32, CriteriaData*> *criteriaMap = &container->m_criteriaProgress;
         for (CriteriaStorage::iterator itr = bounds.first; itr != bounds.second; ++itr)
         {
             AchievementCriteriaEntry *criteria = itr->second;
-            if(criteriaMap->find(criteria->ID) == criteriaMap->end())
+            CriteriaData *data = container->GetProgress(_GetCriteriaIndex(criteria->ID));
+            if(data == NULL)
                 continue;
 
-            count += criteriaMap->at(criteria->ID)->criteriaCounter;
+            count += data->criteriaCounter;
             // for counters, field4 contains the main count requirement
             if (count >= criteria->raw.count)
                 return true;
@@ -633,3 +650,77 @@ bool AchievementMgr::_CheckAchievementRequirements(AchieveDataContainer *contain
 
     return false;
 }
+
+bool AchievementMgr::_IsAssetKeyedType(uint32 criteriaType)
+{
+    switch(criteriaType)
+    {
+    case ACHIEVEMENT_CRITERIA_TYPE_KILL_CREATURE:
+    case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUEST:
+    case ACHIEVEMENT_CRITERIA_TYPE_OWN_ITEM:
+    case ACHIEVEMENT_CRITERIA_TYPE_EQUIP_ITEM:
+        return true;
+    }
+    return false;
+}
+
+uint32 AchievementMgr::_GetCriteriaAsset(AchievementCriteriaEntry *entry)
+{
+    switch(entry->requiredType)
+    {
+    case ACHIEVEMENT_CRITERIA_TYPE_KILL_CREATURE:
+        return entry->kill_creature.creatureID;
+    case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUEST:
+        return entry->complete_quest.questID;
+    case ACHIEVEMENT_CRITERIA_TYPE_OWN_ITEM:
+        return entry->own_item.itemID;
+    case ACHIEVEMENT_CRITERIA_TYPE_EQUIP_ITEM:
+        return entry->equip_item.itemID;
+    }
+    return 0;
+}
+
+bool AchievementMgr::_IsCriteriaCompleted(Player *plr, AchieveDataContainer *container, uint32 index)
+{
+    // Criteria that only feed counters or nothing at all keep updating
+    std::vector<AchievementEntry*> &achievements = m_criteriaAchievements[index];
+    if(achievements.empty())
+        return false;
+
+    for(std::vector<AchievementEntry*>::iterator itr = achievements.begin(); itr != achievements.end(); itr++)
+    {
+        if(container->m_completedAchievements.find((*itr)->ID) != container->m_completedAchievements.end())
+            continue;
+        if(IsValidAchievement(plr, *itr))
+            return false;
+    }
+    return true;
+}
+
+void AchievementMgr::_UpdateCompletedMask(Player *plr, AchieveDataContainer *container, AchievementEntry *achievement)
+{
+    CriteriaStorageBounds bounds = m_criteriaByAchievement.equal_range(achievement->refAchievement ? achievement->refAchievement : achievement->ID);
+    for(CriteriaStorage::iterator itr = bounds.first; itr != bounds.second; ++itr)
+    {
+        uint32 index = _GetCriteriaIndex(itr->second->ID);
+        if(index != 0xFFFFFFFF)
+            AchieveDataContainer::SetBit(container->m_completedMask, index, _IsCriteriaCompleted(plr, container, index));
+    }
+}
+
+std::shared_ptr<AchieveDataContainer> AchievementMgr::_GetContainer(WoWGuid guid)
+{
+    Guard guard(achieveDataLock);
+    std::map<WoWGuid, std::shared_ptr<AchieveDataContainer> >::iterator itr;
+    if((itr = m_playerAchieveData.find(guid)) == m_playerAchieveData.end())
+        return NULL;
+    return itr->second;
+}
+
+uint32 AchievementMgr::_GetCriteriaIndex(uint32 criteriaId)
+{
+    std::unordered_map<uint32, uint32>::iterator itr;
+    if((itr = m_criteriaIndexById.find(criteriaId)) == m_criteriaIndexById.end())
+        return 0xFFFFFFFF;
+    return itr->second;
+}
@@ -19,14 +19,63 @@ enum CriteriaCounterModifier : uint8
     CCM_TOTAL
 };
 
+// Criteria progress is allocated in pages of compact criteria indices, untouched ranges cost nothing
+#define CRITERIA_PROGRESS_PAGE_SIZE 64
+
 struct AchieveDataContainer
 {
-    AchieveDataContainer(uint64 guid) : playerguid(guid), _loading(true) {}
+    AchieveDataContainer(uint64 guid) : playerguid(guid), _loading(true), m_progressCount(0) {}
+    ~AchieveDataContainer()
+    {
+        for(size_t i = 0; i < m_progressPages.size(); ++i)
+            delete [] m_progressPages[i];
+    }
 
     bool _loading;
     WoWGuid playerguid;
     std::map<uint32, time_t> m_completedAchievements;
-    std::map<uint32, CriteriaData*> m_criteriaProgress;
+
+    // Criteria progress by compact index, a set progress bit marks a live slot
+    std::vector<CriteriaData*> m_progressPages;
+    std::vector<uint64> m_progressMask;
+    uint32 m_progressCount;
+
+    // Criteria whose achievements are all earned, skipped by dispatch
+    std::vector<uint64> m_completedMask;
+
+    RONIN_INLINE static bool TestBit(const std::vector<uint64> &mask, uint32 index) { return (index>>6) < mask.size() && (mask[index>>6] & (uint64(1) << (index&63))); }
+    RONIN_INLINE static void SetBit(std::vector<uint64> &mask, uint32 index, bool set)
+    {
+        if((index>>6) >= mask.size())
+            mask.resize((index>>6)+1, 0);
+        if(set) mask[index>>6] |= (uint64(1) << (index&63));
+        else mask[index>>6] &= ~(uint64(1) << (index&63));
+    }
+
+    RONIN_INLINE CriteriaData *GetProgress(uint32 index)
+    {
+        if(!TestBit(m_progressMask, index))
+            return NULL;
+        return &m_progressPages[index/CRITERIA_PROGRESS_PAGE_SIZE][index%CRITERIA_PROGRESS_PAGE_SIZE];
+    }
+
+    RONIN_INLINE CriteriaData *CreateProgress(uint32 index)
+    {
+        if(CriteriaData *data = GetProgress(index))
+            return data;
+
+        uint32 page = index/CRITERIA_PROGRESS_PAGE_SIZE;
+        if(page >= m_progressPages.size())
+            m_progressPages.resize(page+1, NULL);
+        if(m_progressPages[page] == NULL)
+            m_progressPages[page] = new CriteriaData[CRITERIA_PROGRESS_PAGE_SIZE];
+
+        SetBit(m_progressMask, index, true);
+        ++m_progressCount;
+        CriteriaData *data = &m_progressPages[page][index%CRITERIA_PROGRESS_PAGE_SIZE];
+        *data = CriteriaData();
+        return data;
+    }
 };
 
 class SERVER_DECL AchievementMgr : public Singleton < AchievementMgr >
@@ -38,6 +87,8 @@ class SERVER_DECL AchievementMgr : public Singleton < AchievementMgr >
     // Achievement storage
     typedef std::multimap<uint32, AchievementEntry*> AchievementStorage;
     typedef std::pair<AchievementStorage::iterator, AchievementStorage::iterator> AchievementStorageBounds;
+    // Compact criteria indices keyed by requirement type and the asset it names
+    typedef std::unordered_map<uint64, std::vector<uint32> > CriteriaDispatchMap;
 
 public:
     AchievementMgr();
@@ -81,14 +132,33 @@ protected:
     bool _CheckCriteriaForAchievement(AchievementCriteriaEntry *criteria, AchievementEntry *achievement);
     bool _CheckAchievementRequirements(AchieveDataContainer *container, AchievementEntry *achievement);
 
+    // Dispatch key helpers, kill/quest/item criteria are keyed on the creature, quest or item they name
+    static bool _IsAssetKeyedType(uint32 criteriaType);
+    static uint32 _GetCriteriaAsset(AchievementCriteriaEntry *entry);
+    static uint64 _GetDispatchKey(uint32 criteriaType, uint32 asset) { return (uint64(criteriaType) << 32) | asset; }
+
+    // Completed criteria masking
+    bool _IsCriteriaCompleted(Player *plr, AchieveDataContainer *container, uint32 index);
+    void _UpdateCompletedMask(Player *plr, AchieveDataContainer *container, AchievementEntry *achievement);
+
+    // Callers hold the reference for as long as they use the container, a logout can drop it from the map meanwhile
+    std::shared_ptr<AchieveDataContainer> _GetContainer(WoWGuid guid);
+    uint32 _GetCriteriaIndex(uint32 criteriaId);
+
 private:
     Mutex achieveDataLock;
-    std::map<WoWGuid, AchieveDataContainer*> m_playerAchieveData;
+    std::map<WoWGuid, std::shared_ptr<AchieveDataContainer> > m_playerAchieveData;
+
+    // Compact criteria index storage, criteria of one achievement sit next to each other
+    std::vector<AchievementCriteriaEntry*> m_criteriaList;
+    std::vector<std::vector<AchievementEntry*> > m_criteriaAchievements;
+    std::unordered_map<uint32, uint32> m_criteriaIndexById;
+    CriteriaDispatchMap m_criteriaDispatch;
 
     std::set<uint32> m_realmFirstAchievements, m_realmFirstCompleted;
 
     AchievementStorage m_achievementsByReferrence;
-    CriteriaStorage m_criteriaByType, m_criteriaByAchievement;
+    CriteriaStorage m_criteriaByAchievement;
 };
 
 #define AchieveMgr AchievementMgr::getSingleton()
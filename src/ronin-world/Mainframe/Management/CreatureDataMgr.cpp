@@ -6,7 +6,10 @@ initialiseSingleton( CreatureDataManager );
 CreatureDataManager::~CreatureDataManager()
 {
     for(std::map<uint32, CreatureData*>::iterator itr = m_creatureData.begin(); itr != m_creatureData.end(); itr++)
+    {
+        delete itr->second->spawnTemplate;
         delete itr->second;
+    }
     m_creatureData.clear();
 }
 
@@ -144,6 +147,64 @@ void CreatureDataManager::LoadCreatureSpells()
     }
 }
 
+void CreatureDataManager::BuildSpawnTemplates()
+{
+    for(std::map<uint32, CreatureData*>::iterator itr = m_creatureData.begin(); itr != m_creatureData.end(); itr++)
+    {
+        CreatureData *data = itr->second;
+        CreatureSpawnTemplate *tmpl = new CreatureSpawnTemplate();
+        tmpl->extraInfo = CreatureInfoExtraStorage.LookupEntry(data->entry);
+        tmpl->family = dbcCreatureFamily.LookupEntry(data->family);
+        tmpl->trainerData = (data->NPCFLags & (UNIT_NPC_FLAG_TRAINER|UNIT_NPC_FLAG_TRAINER_PROF)) ? objmgr.GetTrainerData(data->entry) : NULL;
+        tmpl->auctionHouse = (data->NPCFLags & UNIT_NPC_FLAG_AUCTIONEER) ? sAuctionMgr.GetAuctionHouse(data->entry) : NULL;
+
+        // First of our two weapon slots holding a shield
+        for(uint8 i = 0; i < 2 && tmpl->shieldProto == NULL; i++)
+        {
+            if(ItemDataEntry *DBCItem = db2Item.LookupEntry(data->inventoryItem[i]))
+                if(DBCItem->InventoryType == INVTYPE_SHIELD)
+                    tmpl->shieldProto = sItemMgr.LookupEntry(data->inventoryItem[i]);
+        }
+
+        for(uint8 i = 0; i < 4; i++)
+        {
+            tmpl->modelRace[i] = RACE_HUMAN;
+            if(CreatureDisplayInfoEntry *displayEntry = dbcCreatureDisplayInfo.LookupEntry(data->displayInfo[i]))
+            {
+                if(CreatureDisplayInfoExtraEntry *extraInfo = dbcCreatureDisplayInfoExtra.LookupEntry(displayEntry->ExtraDisplayInfoEntry))
+                    tmpl->modelRace[i] = extraInfo->Race;
+                tmpl->modelZoneVisible[i] = displayEntry->sizeClass >= 5;
+                tmpl->modelAreaVisible[i] = displayEntry->sizeClass == 4;
+            }
+        }
+
+        for(std::vector<uint32>::iterator spellItr = data->combatSpells.begin(); spellItr != data->combatSpells.end(); spellItr++)
+        {
+            SpellEntry *spellEntry = dbcSpell.LookupEntry(*spellItr);
+            if(spellEntry == NULL || (spellEntry->isSpellAuraApplicator() && !spellEntry->isNegativeSpell1()))
+                continue; // These aren't combat spells
+
+            CreatureSpell spell;
+            spell.spellEntry = spellEntry;
+            // Soonest cast time is the least of our cooldowns
+            spell.castTimer = std::min<uint32>(spellEntry->StartRecoveryTime, std::min<uint32>(spellEntry->CategoryRecoveryTime, spellEntry->RecoveryTime));
+            // Cast cooldown is based on the highest of our cooldowns
+            spell.cooldownTimer = std::max<uint32>(spellEntry->StartRecoveryTime, std::max<uint32>(spellEntry->CategoryRecoveryTime, spellEntry->RecoveryTime));
+            // Aura applicator check
+            if(spellEntry->isSpellAuraApplicator()) // If we're applying an aura, make sure that we don't recast within the duration time
+                spell.cooldownTimer += (spellEntry->Duration[0] > 0 ? spellEntry->Duration[0] : spellEntry->Duration[1] > 0 ? spellEntry->Duration[1] : spellEntry->Duration[2] > 0 ? spellEntry->Duration[2] : 0);
+            // Push back the cast timer a bit
+            if(spell.castTimer == 0 || spell.castTimer == spell.cooldownTimer)
+                spell.castTimer += spell.castTimer ? 2000 : 5000;
+            if(spell.cooldownTimer < 5000)
+                spell.cooldownTimer = 5000;
+            tmpl->combatSpells.push_back(spell);
+        }
+
+        data->spawnTemplate = tmpl;
+    }
+}
+
 void CreatureDataManager::Reload()
 {
 
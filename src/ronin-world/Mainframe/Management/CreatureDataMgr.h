@@ -36,6 +36,8 @@ enum TrainerSpellState
     TRAINER_SPELL_UNAVAILABLE = 2
 };
 
+struct CreatureSpawnTemplate;
+
 #pragma pack(PRAGMA_PACK)
 
 struct CreatureData
@@ -92,6 +94,7 @@ struct CreatureData
     uint32 extraFlags;
     std::set<uint32> Auras;
     std::vector<uint32> combatSpells, supportSpells;
+    CreatureSpawnTemplate *spawnTemplate;
 
     bool HasValidModelData()
     {
@@ -161,6 +164,7 @@ public:
 
     void LoadFromDB();
     void LoadCreatureSpells();
+    void BuildSpawnTemplates();
     void Reload();
 
     CreatureData *GetCreatureData(uint32 entry)
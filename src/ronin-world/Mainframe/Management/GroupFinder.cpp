@@ -23,7 +23,7 @@
 
 initialiseSingleton( GroupFinderMgr );
 
-GroupFinderMgr::GroupFinderMgr() : m_updateTimer(0), m_maxReqExpansion(0), updateTeamIndex(0), m_queueIdHigh(0x000000FF), m_propIdHigh(0x00000F0F)
+GroupFinderMgr::GroupFinderMgr() : m_updateTimer(0), m_updateMSTime(0), m_maxReqExpansion(0), updateTeamIndex(0), m_queueIdHigh(0x000000FF), m_propIdHigh(0x00000F0F)
 {
 
 }
@@ -181,11 +181,28 @@ void GroupFinderMgr::Update(uint32 msTime, uint32 uiDiff)
         return;
 
     _queueGroupLock.Acquire();
-    // Process proposition timeouts
-    std::vector<uint32> failedPropositions;
-    for(auto itr = m_propositionTimeouts[updateTeamIndex].begin(); itr != m_propositionTimeouts[updateTeamIndex].end(); itr++)
-        if((itr->second = std::max<int32>(0, itr->second - m_updateTimer)) == 0)
-            failedPropositions.push_back(itr->first);
+    m_updateMSTime = msTime;
+    // Process proposition timeouts, only the expired front of the set is touched
+    while(!m_propositionTimeouts[updateTeamIndex].empty() && m_propositionTimeouts[updateTeamIndex].begin()->first <= msTime)
+    {
+        DungeonPropositionMap::iterator propItr;
+        if((propItr = m_dungeonPropositionsByPropId.find(m_propositionTimeouts[updateTeamIndex].begin()->second)) == m_dungeonPropositionsByPropId.end())
+        {
+            m_propositionTimeouts[updateTeamIndex].erase(m_propositionTimeouts[updateTeamIndex].begin());
+            continue;
+        }
+
+        QueueProposition *prop = propItr->second;
+        prop->propState = LFG_PROP_STATE_FAILED;
+        _FinishProposition(prop);
+        SendProposalUpdate(prop, NULL);
+    }
+
+    static const uint8 tankPools[3] = { QUEUE_POOL_TALENTED, QUEUE_POOL_TANK, QUEUE_POOL_TANK_DPS };
+    static const uint8 healPools[3] = { QUEUE_POOL_TALENTED, QUEUE_POOL_HEAL, QUEUE_POOL_TANK_HEAL };
+    static const uint8 dpsPools[4] = { QUEUE_POOL_TALENTED, QUEUE_POOL_DPS, QUEUE_POOL_TANK_DPS, QUEUE_POOL_HEAL_DPS };
+    // Singles are walked tank and healer pools first, pure dps last since they can only ever fill the remaining spots
+    static const uint8 soloPools[QUEUE_POOL_COUNT] = { QUEUE_POOL_TANK, QUEUE_POOL_HEAL, QUEUE_POOL_TANK_HEAL, QUEUE_POOL_TANK_DPS, QUEUE_POOL_HEAL_DPS, QUEUE_POOL_TALENTED, QUEUE_POOL_DPS };
 
     // Time to process through our map of dungeons with queued player groups
     for(DungeonGroupStackMap::iterator itr = m_dungeonQueues[updateTeamIndex].begin(); itr != m_dungeonQueues[updateTeamIndex].end(); itr++)
@@ -200,53 +217,26 @@ void GroupFinderMgr::Update(uint32 msTime, uint32 uiDiff)
         LFGDungeonsEntry *entry = dbcLFGDungeons.LookupEntry(itr->first);
         QueueGroupStack *stack = itr->second;
 
-        // We have 3 processing types, combining groups, combining a group with singles, or combining singles
-        if(stack->m_groupQueues.size())
+        // Singles are matched from the role pools, so holders of cleared groups are only swept once they outnumber the live ones
+        if(stack->m_singleQueues.size() > 2 * stack->m_pooledCount)
         {
-            // First we're going to process our single queue to group up what we need... Why didn't we preprocess this
-            std::set<uint32> talentedPool, tankGroups, tankDPSGroups, healGroups, healDPSGroups, tankHealGroups, dpsGroups;
-            std::vector<std::set<uint32>*> setVector;
-            // Fill our sets into our set vector for easier removal processing
-            setVector.push_back(&talentedPool);
-            setVector.push_back(&tankGroups);
-            setVector.push_back(&tankDPSGroups);
-            setVector.push_back(&healGroups);
-            setVector.push_back(&healDPSGroups);
-            setVector.push_back(&tankHealGroups);
-            setVector.push_back(&dpsGroups);
-            // Begin the single queue processing!
-            for(std::vector<QueueGroupHolder*>::iterator sItr = stack->m_singleQueues.begin(); sItr != stack->m_singleQueues.end();)
+            for(std::vector<QueueGroupHolder*>::iterator gItr = stack->m_singleQueues.begin(); gItr != stack->m_singleQueues.end();)
             {
-                // If we have a null group, we're queued for cleanup
-                if((*sItr)->group == NULL)
-                    sItr = stack->m_singleQueues.erase(sItr);
-                else
-                {   // Check the single group for the player in map
-                    QueueGroup *group = (*sItr)->group;
-                    ++sItr;
-
-                    uint8 roleMask = (group->memberRoles.begin()->second & ROLEMASK_ROLE_TYPE);
-                    // Push us into our individual roles based on mask
-                    if(roleMask == (ROLEMASK_TANK|ROLEMASK_HEALER|ROLEMASK_DPS))
-                        talentedPool.insert(group->queueId);
-                    else if(roleMask == ROLEMASK_TANK)
-                        tankGroups.insert(group->queueId);
-                    else if(roleMask == (ROLEMASK_TANK|ROLEMASK_DPS))
-                        tankDPSGroups.insert(group->queueId);
-                    else if(roleMask == (ROLEMASK_TANK|ROLEMASK_HEALER))
-                        tankHealGroups.insert(group->queueId);
-                    else if(roleMask == ROLEMASK_HEALER)
-                        healGroups.insert(group->queueId);
-                    else if(roleMask == (ROLEMASK_HEALER|ROLEMASK_DPS))
-                        healDPSGroups.insert(group->queueId);
-                    else dpsGroups.insert(group->queueId);
-                }
+                if((*gItr)->group == NULL)
+                {
+                    delete *gItr;
+                    gItr = stack->m_singleQueues.erase(gItr);
+                } else ++gItr;
             }
+        }
 
+        // We have 3 processing types, combining groups, combining a group with singles, or combining singles
+        if(stack->m_groupQueues.size())
+        {
             // Create calculated bools ahead of iteration to easily check if we can fill from single queue
-            bool noSingleTanks = talentedPool.empty() && tankGroups.empty() && tankDPSGroups.empty();
-            bool noSingleHeals = talentedPool.empty() && healGroups.empty() && tankHealGroups.empty();
-            bool noSingleDPS = talentedPool.empty() && dpsGroups.empty() && tankDPSGroups.empty() && healDPSGroups.empty();
+            bool noSingleTanks = _GetPooledGroup(stack, tankPools, 3) == NULL;
+            bool noSingleHeals = _GetPooledGroup(stack, healPools, 3) == NULL;
+            bool noSingleDPS = _GetPooledGroup(stack, dpsPools, 4) == NULL;
 
             // If we have more than one group, try and combine
             if(stack->m_groupQueues.size() > 1)
@@ -258,7 +248,10 @@ void GroupFinderMgr::Update(uint32 msTime, uint32 uiDiff)
 
                     // If we have a null group, we're queued for cleanup
                     if((*gItr)->group == NULL)
+                    {
+                        delete *gItr;
                         gItr = stack->m_groupQueues.erase(gItr);
+                    }
                     else
                     {   // Check the single group for the player in map
                         QueueGroup *group = (*gItr)->group;
@@ -436,34 +429,10 @@ void GroupFinderMgr::Update(uint32 msTime, uint32 uiDiff)
                                     unselectedDPS.insert(member);
                                 }
 
-                                // More macros
-#define SET_GROUP_CACHE_POOL(pool, iterator)\
-                                if(m_queueGroupMap.find(*iterator) == m_queueGroupMap.end())\
-                                    continue;\
-                                group = m_queueGroupMap.at(*iterator);\
-                                break;
-                                // End macro
-
                                 // See what we need
                                 if(tank.empty())
                                 {   // Find a tank in our pool
-                                    QueueGroup *group = NULL;
-                                    if(talentedPool.size())
-                                    {
-                                        for(std::set<uint32>::iterator mItr = talentedPool.begin(); mItr != talentedPool.end(); mItr++)
-                                        { SET_GROUP_CACHE_POOL(talentedPool, mItr); }
-                                    }
-                                    else if(tankGroups.size())
-                                    {
-                                        for(std::set<uint32>::iterator mItr = tankGroups.begin(); mItr != tankGroups.end(); mItr++)
-                                        { SET_GROUP_CACHE_POOL(tankGroups, mItr); }
-                                    }
-                                    else if(tankDPSGroups.size())
-                                    {
-                                        for(std::set<uint32>::iterator mItr = tankDPSGroups.begin(); mItr != tankDPSGroups.end(); mItr++)
-                                        { SET_GROUP_CACHE_POOL(tankDPSGroups, mItr); }
-                                    }
-
+                                    QueueGroup *group = _GetPooledGroup(stack, tankPools, 3);
                                     if(group == NULL)
                                         continue; // we failed
 
@@ -472,30 +441,10 @@ void GroupFinderMgr::Update(uint32 msTime, uint32 uiDiff)
                                     if(tank.empty() || heal.empty() || (unselectedDPS.size() < 3))
                                         continue;
                                     groupIds.push_back(group->queueId);
-                                    // Remove us from all our pooled sets
-                                    for(auto sVItr = setVector.begin(); sVItr != setVector.end(); ++sVItr)
-                                        (*sVItr)->erase(group->queueId);
                                 }
                                 else if(heal.empty())
                                 {   // Find a healer in our pool
-                                    QueueGroup *group = NULL;
-                                    std::set<uint32> *fromPool;
-                                    if(talentedPool.size())
-                                    {
-                                        for(std::set<uint32>::iterator mItr = talentedPool.begin(); mItr != talentedPool.end(); mItr++)
-                                        { SET_GROUP_CACHE_POOL(talentedPool, mItr); }
-                                    }
-                                    else if(healGroups.size())
-                                    {
-                                        for(std::set<uint32>::iterator mItr = healGroups.begin(); mItr != healGroups.end(); mItr++)
-                                        { SET_GROUP_CACHE_POOL(healGroups, mItr); }
-                                    }
-                                    else if(tankHealGroups.size())
-                                    {
-                                        for(std::set<uint32>::iterator mItr = tankHealGroups.begin(); mItr != tankHealGroups.end(); mItr++)
-                                        { SET_GROUP_CACHE_POOL(tankHealGroups, mItr); }
-                                    }
-
+                                    QueueGroup *group = _GetPooledGroup(stack, healPools, 3);
                                     if(group == NULL)
                                         continue; // we failed
 
@@ -504,35 +453,10 @@ void GroupFinderMgr::Update(uint32 msTime, uint32 uiDiff)
                                     if(tank.empty() || heal.empty() || (unselectedDPS.size() < 3))
                                         continue;
                                     groupIds.push_back(group->queueId);
-                                    // Remove us from all our pooled sets
-                                    for(auto sVItr = setVector.begin(); sVItr != setVector.end(); ++sVItr)
-                                        (*sVItr)->erase(group->queueId);
                                 }
                                 else if(unselectedDPS.size() < 3)
                                 {   // Find a dps in our pool
-                                    QueueGroup *group = NULL;
-                                    std::set<uint32> *fromPool;
-                                    if(talentedPool.size())
-                                    {
-                                        for(std::set<uint32>::iterator mItr = talentedPool.begin(); mItr != talentedPool.end(); mItr++)
-                                        { SET_GROUP_CACHE_POOL(talentedPool, mItr); }
-                                    }
-                                    else if(dpsGroups.size())
-                                    {
-                                        for(std::set<uint32>::iterator mItr = dpsGroups.begin(); mItr != dpsGroups.end(); mItr++)
-                                        { SET_GROUP_CACHE_POOL(dpsGroups, mItr); }
-                                    }
-                                    else if(tankDPSGroups.size())
-                                    {
-                                        for(std::set<uint32>::iterator mItr = tankDPSGroups.begin(); mItr != tankDPSGroups.end(); mItr++)
-                                        { SET_GROUP_CACHE_POOL(tankDPSGroups, mItr); }
-                                    }
-                                    else if(healDPSGroups.size())
-                                    {
-                                        for(std::set<uint32>::iterator mItr = healDPSGroups.begin(); mItr != healDPSGroups.end(); mItr++)
-                                        { SET_GROUP_CACHE_POOL(healDPSGroups, mItr); }
-                                    }
-
+                                    QueueGroup *group = _GetPooledGroup(stack, dpsPools, 4);
                                     if(group == NULL)
                                         continue; // we failed
 
@@ -541,11 +465,7 @@ void GroupFinderMgr::Update(uint32 msTime, uint32 uiDiff)
                                     if(tank.empty() || heal.empty() || (unselectedDPS.size() < 3))
                                         continue;
                                     groupIds.push_back(group->queueId);
-                                    // Remove us from all our pooled sets
-                                    for(auto sVItr = setVector.begin(); sVItr != setVector.end(); ++sVItr)
-                                        (*sVItr)->erase(group->queueId);
                                 }
-#undef SET_GROUP_CACHE_POOL     // Thank you based macro
 
                                 // We win, see if we can properly create our group from these retards
                                 if(tank.empty() || heal.empty() || (unselectedDPS.size() < 3))
@@ -576,7 +496,7 @@ void GroupFinderMgr::Update(uint32 msTime, uint32 uiDiff)
                 continue;
 
             // We don't need to process group queues against single groups if we have none
-            if(stack->m_singleQueues.empty())
+            if(stack->m_pooledCount == 0)
                 continue;
 
             // Process our groups with single queued groups
@@ -584,7 +504,10 @@ void GroupFinderMgr::Update(uint32 msTime, uint32 uiDiff)
             {
                 // If we have a null group, we're queued for cleanup
                 if((*gItr)->group == NULL)
+                {
+                    delete *gItr;
                     gItr = stack->m_groupQueues.erase(gItr);
+                }
                 else
                 {   // Check the single group for the player in map
                     QueueGroup *group = (*gItr)->group;
@@ -598,7 +521,7 @@ void GroupFinderMgr::Update(uint32 msTime, uint32 uiDiff)
         }
 
         // Quick handle any single queue chances
-        if(stack->m_singleQueues.size() < dungeonTeamSize)
+        if(stack->m_pooledCount < dungeonTeamSize)
             continue; // no use if we're below the required size of singles
 
         // We need to find a tank and healer, then push anyone who isn't either into DPS if they have the flag
@@ -606,21 +529,17 @@ void GroupFinderMgr::Update(uint32 msTime, uint32 uiDiff)
         uint32 tankIL = 0, healIL = 0;
         uint32 tankRoles = 0, healRoles = 0;
         std::set<WoWGuid> unselectedDPS;
-        // Start processing through our single queues
-        for(std::vector<QueueGroupHolder*>::iterator gItr = stack->m_singleQueues.begin(); gItr != stack->m_singleQueues.end();)
+        // Start processing through our pooled singles, cleared groups are already out of the pools
+        for(uint8 p = 0; p < QUEUE_POOL_COUNT; ++p)
         {
-            // Stop iteration if we have a group ready to queue
-            if(!(tank.empty() || heal.empty() || (unselectedDPS.size() < 3)))
-                break;
-
-            // If we have a null group, we're queued for cleanup
-            if((*gItr)->group == NULL)
-                gItr = stack->m_singleQueues.erase(gItr);
-            else
-            {   // Check the single group for the player in map
-                QueueGroup *group = (*gItr)->group;
-                ++gItr;
+            for(QueueGroupHolder *holder = stack->m_rolePools[soloPools[p]].head; holder != NULL; holder = holder->poolNext)
+            {
+                // Stop iteration if we have a group ready to queue
+                if(!(tank.empty() || heal.empty() || (unselectedDPS.size() < 3)))
+                    break;
 
+                // Check the single group for the player in map
+                QueueGroup *group = holder->group;
                 Player *plr = objmgr.GetPlayer(*group->members.begin());
                 if(plr == NULL) // That ends the group for us
                     continue;
@@ -682,36 +601,20 @@ void GroupFinderMgr::Update(uint32 msTime, uint32 uiDiff)
             }
         }
 
-        // Make sure we weren't resized to less than required size
-        if(stack->m_singleQueues.size() < dungeonTeamSize)
-            continue;
-
         // We win, see if we can properly create our group from these retards
         if(tank.empty() || heal.empty() || (unselectedDPS.size() < 3))
             continue;
 
         std::vector<uint32> groupIds;
-        // Grab our tank
-        QueueGroup *tankGroup = m_queueGroupPlayerMap.at(tank);
-        groupIds.push_back(tankGroup->queueId);
-        // Grab our healer
-        QueueGroup *healGroup = m_queueGroupPlayerMap.at(heal);
-        groupIds.push_back(healGroup->queueId);
+        // Grab our tank and healer
+        groupIds.push_back(m_queueGroupPlayerMap.at(tank)->queueId);
+        groupIds.push_back(m_queueGroupPlayerMap.at(heal)->queueId);
+        // Grab our three DPS
         WoWGuid dps1, dps2, dps3;
-        // Grab our first DPS
-        QueueGroup *dpsGroup = m_queueGroupPlayerMap.at(dps1 = *unselectedDPS.begin());
-        unselectedDPS.erase(unselectedDPS.begin());
-        groupIds.push_back(dpsGroup->queueId);
-        // Grab our second DPS
-        dpsGroup = m_queueGroupPlayerMap.at(dps2 = *unselectedDPS.begin());
-        unselectedDPS.erase(unselectedDPS.begin());
-        groupIds.push_back(dpsGroup->queueId);
-        // Grab our third DPS
-        dpsGroup = m_queueGroupPlayerMap.at(dps3 = *unselectedDPS.begin());
-        unselectedDPS.erase(unselectedDPS.begin());
-        groupIds.push_back(dpsGroup->queueId);
-        // Clear out our unselected dps
-        unselectedDPS.clear();
+        std::set<WoWGuid>::iterator dItr = unselectedDPS.begin();
+        groupIds.push_back(m_queueGroupPlayerMap.at(dps1 = *dItr++)->queueId);
+        groupIds.push_back(m_queueGroupPlayerMap.at(dps2 = *dItr++)->queueId);
+        groupIds.push_back(m_queueGroupPlayerMap.at(dps3 = *dItr)->queueId);
         // Launch our dungeon proposition, this will handle random and clearing of players from other queues
         _LaunchProposition(itr->first, updateTeamIndex, &groupIds, tank, heal, dps1, dps2, dps3);
     }
@@ -850,10 +753,22 @@ void GroupFinderMgr::UpdateRoles(Player *plr, uint8 roleMask)
         return;
     }
 
+    QueueGroup *group = itr->second;
     Loki::AssocVector<WoWGuid, uint8>::iterator rItr;
-    if((rItr = itr->second->memberRoles.find(plr->GetGUID())) != itr->second->memberRoles.end())
+    if((rItr = group->memberRoles.find(plr->GetGUID())) != group->memberRoles.end())
         rItr->second = roleMask;
-    else itr->second->memberRoles.insert(std::make_pair(plr->GetGUID(), roleMask));
+    else group->memberRoles.insert(std::make_pair(plr->GetGUID(), roleMask));
+
+    // Queued singles move to the pool matching their new roles
+    if(group->groupType < 2 && group->queueState == LFG_STATE_INQUEUE)
+    {
+        for(std::vector<QueueGroupHolder*>::iterator hItr = group->groupHolders.begin(); hItr != group->groupHolders.end(); ++hItr)
+        {
+            _UnpoolHolder(*hItr);
+            _PoolHolder(*hItr, roleMask);
+            (*hItr)->stack->roleMask |= roleMask;
+        }
+    }
 
     if(itr->second->memberRoles.size() == itr->second->members.size())
     {
@@ -869,6 +784,7 @@ void GroupFinderMgr::HandleDungeonJoin(Player *plr, uint32 roleMask, std::vector
 
     Group *grp = plr->GetGroup();
 
+    _queueGroupLock.Acquire();
     if(grp && grp->GetLeader() != plr->getPlayerInfo())
         error = LFG_ERROR_ROLECHECK_FAILED;
     else if(m_queueGroupPlayerMap.find(plr->GetGUID()) != m_queueGroupPlayerMap.end())
@@ -888,32 +804,40 @@ void GroupFinderMgr::HandleDungeonJoin(Player *plr, uint32 roleMask, std::vector
         for(std::vector<uint32>::iterator itr = dungeonSet->begin(); itr != dungeonSet->end(); itr++)
         {
             bool needCheck = true;
-            if(m_dungeonQueues[teamId].find(*itr) == m_dungeonQueues[teamId].end())
+            QueueGroupStack *stack = NULL;
+            DungeonGroupStackMap::iterator sItr;
+            if((sItr = m_dungeonQueues[teamId].find(*itr)) == m_dungeonQueues[teamId].end())
             {
                 needCheck = false;
-                QueueGroupStack *stack = new QueueGroupStack();
+                stack = new QueueGroupStack();
                 stack->roleMask = 0;
+                stack->m_pooledCount = 0;
                 m_dungeonQueues[teamId].insert(std::make_pair(*itr, stack));
-            }
+            } else stack = sItr->second;
 
             // Add our new dungeon Id
             queueGroup->dungeonIds.push_back(*itr);
             // Create our group holder
             QueueGroupHolder *holder = new QueueGroupHolder();
             holder->group = queueGroup;
+            holder->stack = stack;
+            holder->pool = QUEUE_POOL_NONE;
+            holder->poolPrev = holder->poolNext = NULL;
             // Store the group holder locally
             queueGroup->groupHolders.push_back(holder);
             // Push our group holder into the appropriate dungeon queue map
             if(queueGroup->groupType >= 2)
-                m_dungeonQueues[teamId][*itr]->m_groupQueues.push_back(holder);
+                stack->m_groupQueues.push_back(holder);
             else
             {
-                m_dungeonQueues[teamId][*itr]->m_singleQueues.push_back(holder);
+                stack->m_singleQueues.push_back(holder);
+                // Singles are matched straight from their role pool
+                _PoolHolder(holder, roleMask);
                 // Also add our rolemask into the queue's rolemask for easy check
-                m_dungeonQueues[teamId][*itr]->roleMask |= roleMask;
+                stack->roleMask |= roleMask;
             }
             // Update our needCheck state
-            m_dungeonQueues[teamId][*itr]->needCheck = needCheck;
+            stack->needCheck = needCheck;
         }
 
         if(grp)
@@ -948,6 +872,7 @@ void GroupFinderMgr::HandleDungeonJoin(Player *plr, uint32 roleMask, std::vector
         // Stash our queue group by it's ID
         m_queueGroupMap[queueGroup->queueId] = queueGroup;
     }
+    _queueGroupLock.Release();
 
     SendLFGJoinResult(plr, error, queueGroup);
     if(error == LFG_ERROR_NONE && queueGroup)
@@ -1029,15 +954,7 @@ void GroupFinderMgr::UpdateProposal(Player *plr, uint32 proposalId, bool result,
     if((prop->acceptedMembers.size() + prop->rejectedMembers.size()) == prop->memberCount)
     {
         prop->propState = prop->rejectedMembers.empty() ? LFG_PROP_STATE_SUCCESS : LFG_PROP_STATE_FAILED;
-        // Queue us for finished prop handling
-        m_completedPropositions[prop->propTeam].push_back(prop);
-        // Remove our timeout, not necessary anymore
-        m_propositionTimeouts[prop->propTeam].erase(prop->propId);
-        // Remove us from our proposition map
-        m_dungeonPropositionsByPropId.erase(prop->propId);
-        // Remove us from assigned queue groups
-        for(std::vector<QueueGroup*>::iterator itr = prop->queueGroups.begin(); itr != prop->queueGroups.end(); itr++)
-            m_currentQueueGroupProposals.erase((*itr)->queueId);
+        _FinishProposition(prop);
     }
 
     SendProposalUpdate(prop, NULL);
@@ -1518,8 +1435,13 @@ void GroupFinderMgr::_CleanupQueueGroup(QueueGroup *group, bool silent)
         m_queueGroupPlayerMap.erase(guid);
     }
     m_queueGroupMap.erase(group->queueId);
+    // Holders are freed by the dungeon stacks once they see the cleared group
     for(std::vector<QueueGroupHolder*>::iterator itr = group->groupHolders.begin(); itr != group->groupHolders.end(); itr++)
+    {
+        _UnpoolHolder(*itr);
         (*itr)->group = NULL;
+    }
+    group->groupHolders.clear();
     m_queueGroupDeletionQueue.push_back(group);
 }
 
@@ -1572,6 +1494,8 @@ void GroupFinderMgr::_LaunchProposition(uint32 dungeonId, uint8 propTeam, std::v
             for(std::vector<uint32>::iterator itr = groupIds->begin(); itr != groupIds->end(); itr++)
                 m_currentQueueGroupProposals.insert(std::make_pair(*itr, proposition->propId));
             m_dungeonPropositionsByPropId.insert(std::make_pair(proposition->propId, proposition));
+            proposition->expireTime = m_updateMSTime + LFG_PROPOSITION_TIMEOUT;
+            m_propositionTimeouts[propTeam].insert(std::make_pair(proposition->expireTime, proposition->propId));
 
             SendProposalUpdate(proposition, NULL);
         }
@@ -1607,7 +1531,76 @@ void GroupFinderMgr::_LaunchProposition(uint32 dungeonId, uint8 propTeam, std::v
 
         // We're in random with players, remove our group holders
         for(std::vector<QueueGroupHolder*>::iterator itr = group->groupHolders.begin(); itr != group->groupHolders.end(); itr++)
+        {
+            _UnpoolHolder(*itr);
             (*itr)->group = NULL;
+        }
         group->groupHolders.clear();
     }
 }
+
+void GroupFinderMgr::_FinishProposition(QueueProposition *prop)
+{
+    // Queue us for finished prop handling
+    m_completedPropositions[prop->propTeam].push_back(prop);
+    // Remove our timeout, not necessary anymore
+    m_propositionTimeouts[prop->propTeam].erase(std::make_pair(prop->expireTime, prop->propId));
+    // Remove us from our proposition map
+    m_dungeonPropositionsByPropId.erase(prop->propId);
+    // Remove us from assigned queue groups
+    for(std::vector<QueueGroup*>::iterator itr = prop->queueGroups.begin(); itr != prop->queueGroups.end(); itr++)
+        m_currentQueueGroupProposals.erase((*itr)->queueId);
+}
+
+uint8 GroupFinderMgr::_GetRolePool(uint8 roleMask)
+{
+    switch(roleMask & ROLEMASK_ROLE_TYPE)
+    {
+    case ROLEMASK_TANK|ROLEMASK_HEALER|ROLEMASK_DPS: return QUEUE_POOL_TALENTED;
+    case ROLEMASK_TANK: return QUEUE_POOL_TANK;
+    case ROLEMASK_TANK|ROLEMASK_DPS: return QUEUE_POOL_TANK_DPS;
+    case ROLEMASK_TANK|ROLEMASK_HEALER: return QUEUE_POOL_TANK_HEAL;
+    case ROLEMASK_HEALER: return QUEUE_POOL_HEAL;
+    case ROLEMASK_HEALER|ROLEMASK_DPS: return QUEUE_POOL_HEAL_DPS;
+    }
+    return QUEUE_POOL_DPS;
+}
+
+void GroupFinderMgr::_PoolHolder(QueueGroupHolder *holder, uint8 roleMask)
+{
+    if(holder->group == NULL || holder->pool != QUEUE_POOL_NONE)
+        return;
+
+    QueueRolePoolList &pool = holder->stack->m_rolePools[(holder->pool = _GetRolePool(roleMask))];
+    holder->poolPrev = pool.tail;
+    holder->poolNext = NULL;
+    if(pool.tail) pool.tail->poolNext = holder;
+    else pool.head = holder;
+    pool.tail = holder;
+    ++pool.size;
+    ++holder->stack->m_pooledCount;
+}
+
+void GroupFinderMgr::_UnpoolHolder(QueueGroupHolder *holder)
+{
+    if(holder->pool == QUEUE_POOL_NONE)
+        return;
+
+    QueueRolePoolList &pool = holder->stack->m_rolePools[holder->pool];
+    if(holder->poolPrev) holder->poolPrev->poolNext = holder->poolNext;
+    else pool.head = holder->poolNext;
+    if(holder->poolNext) holder->poolNext->poolPrev = holder->poolPrev;
+    else pool.tail = holder->poolPrev;
+    holder->poolPrev = holder->poolNext = NULL;
+    holder->pool = QUEUE_POOL_NONE;
+    --pool.size;
+    --holder->stack->m_pooledCount;
+}
+
+GroupFinderMgr::QueueGroup *GroupFinderMgr::_GetPooledGroup(QueueGroupStack *stack, const uint8 *pools, uint8 poolCount)
+{
+    for(uint8 i = 0; i < poolCount; ++i)
+        if(QueueGroupHolder *holder = stack->m_rolePools[pools[i]].head)
+            return holder->group;
+    return NULL;
+}
@@ -107,6 +107,9 @@ enum ClientPropositionStates
 
 static const uint32 dungeonTeamSize = 5;
 
+// Unanswered propositions fail after this many milliseconds
+#define LFG_PROPOSITION_TIMEOUT 40000
+
 class GroupFinderMgr : public Singleton < GroupFinderMgr >
 {
     struct QueueGroup;
@@ -197,7 +200,7 @@ private:
     Quest *GetDungeonQuest(uint32 dungeonId, uint32 level, bool secondary);
     Quest *GetCallToArmsRole(uint32 dungeonId, uint8 roleIndex, uint32 &roleMask);
 
-    uint32 m_updateTimer;
+    uint32 m_updateTimer, m_updateMSTime;
     uint32 m_maxReqExpansion;
     std::set<uint32> m_currentSeasonDungeons;
 
@@ -215,7 +218,36 @@ private:
     /// Dungeon Queue functionality
     ////////////////////////////////
 private: // None of this needs to be public
-    struct QueueGroupHolder { QueueGroup *group; };
+    // Single queued players are pooled per dungeon by the exact role combination they picked
+    enum QueueRolePool : uint8
+    {
+        QUEUE_POOL_TALENTED = 0, // Tank, healer and dps
+        QUEUE_POOL_TANK,
+        QUEUE_POOL_TANK_DPS,
+        QUEUE_POOL_HEAL,
+        QUEUE_POOL_HEAL_DPS,
+        QUEUE_POOL_TANK_HEAL,
+        QUEUE_POOL_DPS,
+        QUEUE_POOL_COUNT,
+        QUEUE_POOL_NONE = QUEUE_POOL_COUNT
+    };
+
+    struct QueueGroupHolder
+    {
+        QueueGroup *group;
+        QueueGroupStack *stack;
+        // Intrusive links into the stack's role pool, pools keep join order
+        uint8 pool;
+        QueueGroupHolder *poolPrev, *poolNext;
+    };
+
+    struct QueueRolePoolList
+    {
+        QueueRolePoolList() : head(NULL), tail(NULL), size(0) {}
+
+        QueueGroupHolder *head, *tail;
+        uint32 size;
+    };
 
     struct QueueGroup
     {
@@ -252,9 +284,18 @@ private: // None of this needs to be public
         uint32 roleMask;
         std::vector<QueueGroupHolder*> m_groupQueues;
         std::vector<QueueGroupHolder*> m_singleQueues;
+        QueueRolePoolList m_rolePools[QUEUE_POOL_COUNT];
+        uint32 m_pooledCount;
     };
     typedef std::map<uint32, QueueGroupStack*> DungeonGroupStackMap;
 
+    // Role pool maintenance, called on join, role change and whenever a holder's group is cleared
+    static uint8 _GetRolePool(uint8 roleMask);
+    void _PoolHolder(QueueGroupHolder *holder, uint8 roleMask);
+    void _UnpoolHolder(QueueGroupHolder *holder);
+    // Returns the oldest group from the first non empty pool in the list
+    QueueGroup *_GetPooledGroup(QueueGroupStack *stack, const uint8 *pools, uint8 poolCount);
+
     uint8 updateTeamIndex;
     DungeonGroupStackMap m_dungeonQueues[2];
 
@@ -265,7 +306,7 @@ protected:
         uint32 encounterMask;
         uint32 propDungeonId;
         uint8 propState, propTeam;
-        uint32 timeLeft;
+        uint32 timeLeft, expireTime;
 
         uint32 memberCount;
         std::vector<QueueGroup*> queueGroups;
@@ -283,8 +324,11 @@ protected:
     RONIN_INLINE uint32 _GeneratePropositionId() { propIdLock.Acquire(); uint32 lockId = ++m_propIdHigh; propIdLock.Release(); return lockId; }
 
     void _LaunchProposition(uint32 dungeonId, uint8 propTeam, std::vector<uint32> *groupIds, WoWGuid tank, WoWGuid heal, WoWGuid dps1, WoWGuid dps2, WoWGuid dps3);
+    // Moves an answered or expired proposition into the completed queue
+    void _FinishProposition(QueueProposition *prop);
 
-    std::map<uint32, int32> m_propositionTimeouts[2];
+    // Ordered by expire time then proposition id
+    std::set<std::pair<uint32, uint32> > m_propositionTimeouts[2];
     std::vector<QueueProposition*> m_completedPropositions[2];
     DungeonPropositionMap m_dungeonPropositionsByPropId;
     QueueProposalIdsByGroupId m_currentQueueGroupProposals;
@@ -469,7 +469,7 @@ void GuildMgr::SetNote(PlayerInfo* pInfo, std::string Note, bool Officer)
     if(Officer)
         gMember->szOfficerNote = Note;
     else gMember->szPublicNote = Note;
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
 }
 
 bool GuildMgr::IsGuildPerk(SpellEntry *sp)
@@ -533,15 +533,15 @@ void GuildMgr::ModifyGuildLevel(GuildInfo *info, int32 mod)
     data << uint64(0); // Member xp given this week
     data << uint64(guildXP);
     MemberMapStorage->MemberMapLock.Acquire();
-    for(GuildMemberMap::iterator itr = MemberMapStorage->MemberMap.begin(); itr != MemberMapStorage->MemberMap.end(); itr++)
+    for(GuildOnlineMemberSet::iterator itr = MemberMapStorage->OnlineMembers.begin(); itr != MemberMapStorage->OnlineMembers.end(); itr++)
     {
-        Player *plr = itr->second->pPlayer->m_loggedInPlayer;
+        Player *plr = (*itr)->pPlayer->m_loggedInPlayer;
         if(plr == NULL)
             continue;
 
         // Update packet data
-        data.put<uint64>(16, itr->second->guildXPToday);
-        data.put<uint64>(24, itr->second->guildWeekXP);
+        data.put<uint64>(16, (*itr)->guildXPToday);
+        data.put<uint64>(24, (*itr)->guildWeekXP);
         plr->SetGuildLevel(info->m_guildLevel);
         for(std::set<uint32>::iterator itr = perksToMod.begin(); itr != perksToMod.end(); itr++)
         {
@@ -553,7 +553,7 @@ void GuildMgr::ModifyGuildLevel(GuildInfo *info, int32 mod)
         plr->PushPacket(&data);
     }
     MemberMapStorage->MemberMapLock.Release();
-    info->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(info);
 }
 
 void GuildMgr::AddGuildPerks(Player *plr, GuildInfo *gInfo)
@@ -611,7 +611,7 @@ void GuildMgr::GuildGainXP(Player *plr, uint32 xpGain)
         {
             gInfo->m_guildXPDirty = false;
             ModifyGuildLevel(gInfo, levelGain);
-        } else gInfo->m_guildXPDirty = true; // Or we update guild xp next manager update
+        } else MarkGuildXPDirty(gInfo); // Or we update guild xp next manager update
     }
     gInfo->guildXPLock.Release();
 }
@@ -641,7 +641,7 @@ void GuildMgr::AddGuildLogEntry(uint32 GuildId, uint8 iEvent, uint32 arguement1,
     ev->iEventData[2] = arguement3;
     LogStorage->m_logs.push_back(ev);
     LogStorage->Locks.Release();
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
 }
 
 void GuildMgr::LogGuildBankAction(uint64 GuildId, uint8 iAction, uint32 uGuid, uint32 uEntry, uint8 iStack, uint32 tabId)
@@ -732,16 +732,31 @@ void GuildMgr::LogGuildEvent(Player* plr, uint32 GuildId, uint8 iEvent, std::str
     {
         if(GuildMemberMapStorage* MemberMapStorage = GetGuildMemberMapStorage(GuildId))
         {
-            Player* target = NULL;
             MemberMapStorage->MemberMapLock.Acquire();
-            for(GuildMemberMap::iterator itr = MemberMapStorage->MemberMap.begin(); itr != MemberMapStorage->MemberMap.end(); itr++)
-                if( Player *target = itr->second->pPlayer->m_loggedInPlayer)
+            for(GuildOnlineMemberSet::iterator itr = MemberMapStorage->OnlineMembers.begin(); itr != MemberMapStorage->OnlineMembers.end(); itr++)
+                if( Player *target = (*itr)->pPlayer->m_loggedInPlayer)
                     target->PushPacket(&data);
             MemberMapStorage->MemberMapLock.Release();
         }
     }
 }
 
+void GuildMgr::MarkGuildDirty(GuildInfo* guildInfo, uint32 status)
+{
+    guildInfo->m_GuildStatus = status;
+    m_dirtyLock.Acquire();
+    m_dirtyGuilds.insert(guildInfo->m_guildId);
+    m_dirtyLock.Release();
+}
+
+void GuildMgr::MarkGuildXPDirty(GuildInfo* guildInfo)
+{
+    guildInfo->m_guildXPDirty = true;
+    m_dirtyLock.Acquire();
+    m_xpDirtyGuilds.insert(guildInfo->m_guildId);
+    m_dirtyLock.Release();
+}
+
 void GuildMgr::SaveGuild(QueryBuffer* qb, GuildInfo* guildInfo)
 {
 #ifdef USE_QMGR_QUERYBUFFER
@@ -1217,39 +1232,35 @@ void GuildMgr::SaveAllGuilds()
     QueryBuffer* qb = NULL;
 #endif
 
+    // Only guilds marked dirty since the last pass are visited, shutdown still flushes every guild
+    std::set<uint32> dirtyGuilds;
+    m_dirtyLock.Acquire();
+    dirtyGuilds.swap(m_dirtyGuilds);
+    m_dirtyLock.Release();
+    if(bServerShutdown)
+    {
+        for(GuildInfoMap::iterator itr = m_Guilds.begin(); itr != m_Guilds.end(); itr++)
+            dirtyGuilds.insert(itr->first);
+    }
+
     GuildInfo* gInfo = NULL;
-    for(GuildInfoMap::iterator itr = m_Guilds.begin(), itr2; itr != m_Guilds.end();)
+    GuildInfoMap::iterator itr;
+    for(std::set<uint32>::iterator id = dirtyGuilds.begin(); id != dirtyGuilds.end(); id++)
     {
-        itr2 = itr++;
-        gInfo = itr2->second;
+        if((itr = m_Guilds.find(*id)) == m_Guilds.end())
+            continue;
+
+        gInfo = itr->second;
         if(gInfo == NULL) // ??
         {
-            itr2->second = NULL;
-            m_Guilds.erase(itr2->first);
+            m_Guilds.erase(itr);
             continue;
         }
 
         gInfo->m_GuildLock.Acquire();
-        if(!bServerShutdown)
-        {
-            if(gInfo->m_GuildStatus == GUILD_STATUS_NORMAL)
-            {
-                gInfo->m_GuildLock.Release();
-                continue;
-            }
-
-            if(gInfo->m_GuildStatus == GUILD_STATUS_JUST_LOADED)
-            {
-                gInfo->m_GuildStatus = GUILD_STATUS_NORMAL;
-                gInfo->m_GuildLock.Release();
-                continue;
-            }
-        }
-
         if(gInfo->m_GuildStatus == GUILD_STATUS_DISBANDED)
         {
-            itr2->second = NULL;
-            m_Guilds.erase(itr2->first);
+            m_Guilds.erase(itr);
             m_GuildNames.erase(gInfo->m_guildName);
             DestroyGuild(gInfo);
             continue;
@@ -1263,8 +1274,8 @@ void GuildMgr::SaveAllGuilds()
 #else
             SaveGuild(NULL, gInfo);
 #endif
-            gInfo->m_GuildLock.Release();
         }
+        gInfo->m_GuildLock.Release();
         gInfo = NULL;
     }
 
@@ -1292,11 +1303,20 @@ GuildRank* GuildMgr::FindHighestRank(GuildRankStorage* Ranks)
 
 void GuildMgr::UpdateGuildXP()
 {
+    std::set<uint32> xpGuilds;
+    m_dirtyLock.Acquire();
+    xpGuilds.swap(m_xpDirtyGuilds);
+    m_dirtyLock.Release();
+
     WorldPacket data(SMSG_GUILD_XP, 40);
     data << uint64(0) << uint64(0) << uint64(0) << uint64(0) << uint64(0);
-    for(GuildInfoMap::iterator itr = m_Guilds.begin(), itr2; itr != m_Guilds.end();)
+    for(std::set<uint32>::iterator id = xpGuilds.begin(); id != xpGuilds.end(); id++)
     {
-        itr2 = itr++;
+        GuildInfoMap::iterator itr2 = m_Guilds.find(*id);
+        GuildMemberMaps::iterator members = m_GuildMemberMaps.find(*id);
+        if(itr2 == m_Guilds.end() || members == m_GuildMemberMaps.end())
+            continue;
+
         GuildInfo *gInfo = itr2->second;
         if(gInfo == NULL || !gInfo->m_guildXPDirty)
             continue;
@@ -1309,15 +1329,15 @@ void GuildMgr::UpdateGuildXP()
         data.put<uint64>(8, xpTillNextLevel);
         data.put<uint64>(32, guildXP);
 
-        GuildMemberMapStorage* MemberMapStorage = m_GuildMemberMaps[gInfo->m_guildId];
+        GuildMemberMapStorage* MemberMapStorage = members->second;
         MemberMapStorage->MemberMapLock.Acquire();
-        for(GuildMemberMap::iterator itr = MemberMapStorage->MemberMap.begin(); itr != MemberMapStorage->MemberMap.end(); itr++)
+        for(GuildOnlineMemberSet::iterator itr = MemberMapStorage->OnlineMembers.begin(); itr != MemberMapStorage->OnlineMembers.end(); itr++)
         {
-            if(Player *plr = itr->second->pPlayer->m_loggedInPlayer)
+            if(Player *plr = (*itr)->pPlayer->m_loggedInPlayer)
             {
                 // Update packet data
-                data.put<uint64>(16, itr->second->guildXPToday);
-                data.put<uint64>(24, itr->second->guildWeekXP);
+                data.put<uint64>(16, (*itr)->guildXPToday);
+                data.put<uint64>(24, (*itr)->guildWeekXP);
                 plr->PushPacket(&data);
             }
         }
@@ -1457,7 +1477,7 @@ void GuildMgr::CreateGuildRank(GuildRankStorage* storage, const char* szRankName
             storage->ssid = i+1;
             storage->m_ranks[i] = new GuildRank(i, iPermissions, szRankName, bFullGuildBankPermissions);
             storage->RankLock.Release();
-            gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+            MarkGuildDirty(gInfo);
             gInfo->m_GuildLock.Release();
 //          sLog.Notice("Guild", "Created rank %u on guild %u (%s)", i, storage->GuildId, szRankName);
             return;
@@ -1501,7 +1521,7 @@ uint32 GuildMgr::RemoveGuildRank(uint32 GuildId)
     storage->ssid--; // Decremention.
     storage->m_ranks[pLowestRank->iId] = NULL;
     delete pLowestRank;
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
     gInfo->m_GuildLock.Release();
     storage->RankLock.Release();
     return 0;
@@ -1523,7 +1543,7 @@ bool GuildMgr::Disband(uint32 GuildId)
             guildmgr.ForceRemoveMember(NULL, itr2->second->pPlayer);
         }
     }
-    gInfo->m_GuildStatus = GUILD_STATUS_DISBANDED;
+    MarkGuildDirty(gInfo, GUILD_STATUS_DISBANDED);
     AddDestructionQueries(GuildId);
     return true;
 }
@@ -1536,9 +1556,27 @@ void GuildMgr::PlayerLoggedIn(PlayerInfo* plr)
 
 void GuildMgr::PlayerLoggedOff(PlayerInfo* plr)
 {
+    SetMemberOnline(plr, false);
     LogGuildEvent(NULL, plr->GuildId, GUILD_EVENT_HASGONEOFFLINE, plr->charName.c_str());
 }
 
+void GuildMgr::SetMemberOnline(PlayerInfo* plr, bool online)
+{
+    if(plr->GuildId == 0)
+        return;
+
+    GuildMember* gMember = GetGuildMember(plr->charGuid);
+    GuildMemberMapStorage* MemberMapStorage = GetGuildMemberMapStorage(plr->GuildId);
+    if(gMember == NULL || MemberMapStorage == NULL)
+        return;
+
+    MemberMapStorage->MemberMapLock.Acquire();
+    if(online)
+        MemberMapStorage->OnlineMembers.insert(gMember);
+    else MemberMapStorage->OnlineMembers.erase(gMember);
+    MemberMapStorage->MemberMapLock.Release();
+}
+
 void GuildMgr::SendMotd(PlayerInfo* plr, uint32 guildid)
 {
     if(plr != NULL)
@@ -1598,6 +1636,7 @@ void GuildMgr::RemoveMember(Player* remover, PlayerInfo* removee)
         GuildMemberMap::iterator itr = MemberMapStorage->MemberMap.find(removee->charGuid);
         if(itr != MemberMapStorage->MemberMap.end())
             MemberMapStorage->MemberMap.erase(itr);
+        MemberMapStorage->OnlineMembers.erase(ToRemove);
         MemberMapStorage->MemberMapLock.Release();
     }
 
@@ -1634,7 +1673,7 @@ void GuildMgr::RemoveMember(Player* remover, PlayerInfo* removee)
         removee->m_loggedInPlayer->SetGuildId(0);
     }
 
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
 }
 
 void GuildMgr::ForceRemoveMember(Player* remover, PlayerInfo* removee)
@@ -1659,6 +1698,7 @@ void GuildMgr::ForceRemoveMember(Player* remover, PlayerInfo* removee)
         GuildMemberMap::iterator itr = MemberMapStorage->MemberMap.find(removee->charGuid);
         if(itr != MemberMapStorage->MemberMap.end())
             MemberMapStorage->MemberMap.erase(itr);
+        MemberMapStorage->OnlineMembers.erase(ToRemove);
         MemberMapStorage->MemberMapLock.Release();
     }
 
@@ -1696,7 +1736,7 @@ void GuildMgr::ForceRemoveMember(Player* remover, PlayerInfo* removee)
         removee->m_loggedInPlayer->SetGuildId(0);
     }
 
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
 }
 
 // adding a member
@@ -1735,6 +1775,8 @@ void GuildMgr::AddGuildMember(GuildInfo* gInfo, PlayerInfo* newmember, WorldSess
     m_GuildMembers.insert(std::make_pair(pm->PlrGuid, pm));
     MemberList->MemberMapLock.Acquire();
     MemberList->MemberMap.insert(std::make_pair(pm->PlrGuid, pm));
+    if(newmember->m_loggedInPlayer)
+        MemberList->OnlineMembers.insert(pm);
     MemberList->MemberMapLock.Release();
 
     newmember->GuildRank = rank;
@@ -1749,7 +1791,7 @@ void GuildMgr::AddGuildMember(GuildInfo* gInfo, PlayerInfo* newmember, WorldSess
         SendMotd(newmember);
     }
 
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
     LogGuildEvent(NULL, gInfo->m_guildId, GUILD_EVENT_JOINED, newmember->charName.c_str());
     AddGuildLogEntry(gInfo->m_guildId, GUILD_LOG_EVENT_JOIN, newmember->charGuid.getLow());
 }
@@ -1780,9 +1822,9 @@ void GuildMgr::GuildChat(WorldSession* m_session, uint32 Language, const char* m
     WorldPacket data;
     sChatHandler.FillMessageData(&data, false, CHAT_MSG_GUILD, LANG_UNIVERSAL, plr->GetGUID(), 0, plr->GetName(), message, "", plr->GetChatTag());
     MemberMapStorage->MemberMapLock.Acquire();
-    for(GuildMemberMap::iterator itr = MemberMapStorage->MemberMap.begin(); itr != MemberMapStorage->MemberMap.end(); itr++)
+    for(GuildOnlineMemberSet::iterator itr = MemberMapStorage->OnlineMembers.begin(); itr != MemberMapStorage->OnlineMembers.end(); itr++)
     {
-        Target = itr->second->pPlayer->m_loggedInPlayer;
+        Target = (*itr)->pPlayer->m_loggedInPlayer;
         if(Target == NULL)
             continue;
 
@@ -1818,9 +1860,9 @@ void GuildMgr::OfficerChat(WorldSession* m_session, uint32 Language, const char*
     WorldPacket data;
     sChatHandler.FillMessageData(&data, false, CHAT_MSG_OFFICER, Language, plr->GetGUID(), 0, plr->GetName(), message, "", plr->GetChatTag());
     MemberMapStorage->MemberMapLock.Acquire();
-    for(GuildMemberMap::iterator itr = MemberMapStorage->MemberMap.begin(); itr != MemberMapStorage->MemberMap.end(); itr++)
+    for(GuildOnlineMemberSet::iterator itr = MemberMapStorage->OnlineMembers.begin(); itr != MemberMapStorage->OnlineMembers.end(); itr++)
     {
-        Target = itr->second->pPlayer->m_loggedInPlayer;
+        Target = (*itr)->pPlayer->m_loggedInPlayer;
         if(Target == NULL)
             continue;
 
@@ -237,6 +237,7 @@ struct GuildMember
 };
 
 typedef std::map<WoWGuid, GuildMember*> GuildMemberMap;
+typedef std::set<GuildMember*> GuildOnlineMemberSet;
 
 struct GuildMemberMapStorage
 {
@@ -245,6 +246,8 @@ struct GuildMemberMapStorage
     uint32 GuildId;
     Mutex MemberMapLock;
     GuildMemberMap MemberMap;
+    // Members with a logged in player, broadcasts walk this instead of the full map
+    GuildOnlineMemberSet OnlineMembers;
 };
 
 #pragma pack(PRAGMA_POP)
@@ -281,6 +284,10 @@ private:
     GuildMemberMap m_GuildMembers;
 
     uint32 m_updateTimer, m_xpUpdateTimer;
+
+    // Guild ids changed since the last save or xp broadcast pass
+    Mutex m_dirtyLock;
+    std::set<uint32> m_dirtyGuilds, m_xpDirtyGuilds;
 public:
     GuildMgr();
     ~GuildMgr();
@@ -295,6 +302,8 @@ public:
     void DestroyGuild(GuildInfo* guildInfo);
     void AddDestructionQueries(uint32 guildid);
     void SaveGuild(QueryBuffer* qb, GuildInfo* guildInfo);
+    void MarkGuildDirty(GuildInfo* guildInfo, uint32 status = GUILD_STATUS_DIRTY);
+    void MarkGuildXPDirty(GuildInfo* guildInfo);
 
     bool IsGuildPerk(SpellEntry *sp);
     void ModifyGuildLevel(GuildInfo *gInfo, int32 mod);
@@ -462,6 +471,7 @@ public: // Guild Functions and calls
     bool Disband(uint32 guildId);
     void PlayerLoggedIn(PlayerInfo* plr);
     void PlayerLoggedOff(PlayerInfo* plr);
+    void SetMemberOnline(PlayerInfo* plr, bool online);
     void SendMotd(PlayerInfo* plr, uint32 guildid = 0);
     void RemoveMember(Player* remover, PlayerInfo* removee);
     void ForceRemoveMember(Player* remover, PlayerInfo* removee);
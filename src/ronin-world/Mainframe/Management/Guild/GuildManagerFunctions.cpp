@@ -89,7 +89,7 @@ void GuildMgr::Packet_SetMotd(WorldSession* m_session, std::string motd)
     }
 
     gInfo->m_motd = motd;
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
     SendMotd(NULL, gInfo->m_guildId);
 }
 
@@ -679,7 +679,7 @@ void GuildMgr::Packet_SaveGuildEmblem(WorldSession* m_session, uint32 emblemStyl
     gInfo->m_borderStyle = borderStyle;
     gInfo->m_borderColor = borderColor;
     gInfo->m_backgroundColor = backgroundColor;
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
     gInfo->m_GuildLock.Release();
     Packet_SendGuildQuery(NULL, plr->GetGuildId());
 }
@@ -794,7 +794,7 @@ void GuildMgr::Packet_HandleEditRank(WorldSession* m_session, std::string name,
         rank->iTabPermissions[i].iFlags = iflags[i];
         rank->iTabPermissions[i].iStacksPerDay = istacksperday[i];
     }
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
     RankStorage->RankLock.Release();
     Packet_SendGuildRoster(m_session);
 }
@@ -840,7 +840,7 @@ void GuildMgr::Packet_ChangeGuildLeader(WorldSession* m_session, PlayerInfo* new
     NewGuildLeader->pRank = RankStorage->m_ranks[0];
     if(newLeader->m_loggedInPlayer)
         newLeader->m_loggedInPlayer->SetGuildRank(0);
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
     gInfo->m_GuildLock.Release();
 
     LogGuildEvent(NULL, plr->GetGuildId(), GUILD_EVENT_LEADER_CHANGED, plr->GetName(), newLeader->charName.c_str());
@@ -925,7 +925,7 @@ void GuildMgr::Packet_DemoteGuildMember(WorldSession* m_session, PlayerInfo *dem
     // if the player is online, update his guildrank
     if(demoteeInfo->m_loggedInPlayer)
         demoteeInfo->m_loggedInPlayer->SetGuildRank(nh);
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
     gInfo->m_GuildLock.Release();
 }
 
@@ -1003,7 +1003,7 @@ void GuildMgr::Packet_PromoteGuildMember(WorldSession* m_session, PlayerInfo *pr
     // if the player is online, update his guildrank
     if(promoteeInfo->m_loggedInPlayer)
         promoteeInfo->m_loggedInPlayer->SetGuildRank(nh);
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
     gInfo->m_GuildLock.Release();
 }
 
@@ -1076,7 +1076,7 @@ void GuildMgr::Packet_SetGuildInformation(WorldSession* m_session, std::string g
         gInfo->m_guildInfo = strdup(guildInfo.c_str());
     else
         gInfo->m_guildInfo = "";
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
     gInfo->m_GuildLock.Release();
 }
 
@@ -1240,7 +1240,7 @@ void GuildMgr::Packet_SetGuildBankText(WorldSession* m_session, uint32 tabid, st
 
     gInfo->m_GuildLock.Acquire();
     BankTabStorage->m_Tabs[tabid]->szTabInfo = tabtext.c_str();
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
     gInfo->m_GuildLock.Release();
 }
 
@@ -1306,7 +1306,7 @@ void GuildMgr::Packet_WithdrawItem(WorldSession* m_session, uint8 dest_bank, uin
         return;
     }
 
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
     gInfo->m_GuildLock.Release();
 }
 
@@ -1359,7 +1359,7 @@ void GuildMgr::Packet_DepositItem(WorldSession* m_session, uint8 dest_bank, uint
 
     /* update the clients view of the bank tab */
     Packet_SendGuildBankTab(m_session, dest_bank, dest_bankslot);
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
     gInfo->m_GuildLock.Release();
 }
 
@@ -1456,7 +1456,7 @@ void GuildMgr::Packet_BuyBankTab(WorldSession* m_session, uint64 BankGuid)
     BankTabStorage->m_Tabs[i] = new GuildBankTab(i);
     BankTabStorage->m_TabLogs[i] = new BankLogInternalStorage();
     BankTabStorage->m_TabLogs[i]->log_high_guid = 0;
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
 
     gInfo->m_GuildLock.Release();
     LogGuildEvent(plr, gInfo->m_guildId, GUILD_EVENT_BANKTABBOUGHT, "");
@@ -1590,7 +1590,7 @@ void GuildMgr::Packet_DepositMoney(WorldSession* m_session, uint64 BankGuid, uin
     gInfo->m_GuildLock.Acquire();
     // add to the bank balance
     gInfo->m_bankBalance += Amount;
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
 
     // take the money, oh noes gm pls gief gold mi hero poor
     plr->ModUnsigned32Value(PLAYER_FIELD_COINAGE, -(int32)Amount);
@@ -1683,7 +1683,7 @@ void GuildMgr::Packet_WithdrawMoney(WorldSession* m_session, uint64 BankGuid, ui
 
     // subtract the balance
     gInfo->m_bankBalance -= Amount;
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
 
     char buf[20];
     snprintf(buf, 20, I64FMT, ((LLUI)(gInfo->m_bankBalance)));
@@ -1755,7 +1755,7 @@ void GuildMgr::Packet_SetBankTabInfo(WorldSession* m_session, uint64 BankGuid, u
         if(BankTab->szTabIcon.size())
             BankTab->szTabIcon = "";
     }
-    gInfo->m_GuildStatus = GUILD_STATUS_DIRTY;
+    MarkGuildDirty(gInfo);
     gInfo->m_GuildLock.Release();
     Packet_SendGuildBankInfo(m_session, BankGuid);
     Packet_SendGuildBankTab(m_session, TabSlot, true);
@@ -107,6 +107,7 @@ void LootMgr::LoadLoot()
     LoadLootProp();
     sLog.Debug("LootMgr","Loading loot...");
     LoadLootTables(LOOT_FISHING, &FishingLoot, false);
+    CompileLootStore(&FishingLoot, &m_compiledFishingLoot, 1);
     is_loading = false;
 }
 
@@ -118,6 +119,11 @@ void LootMgr::LoadDelayedLoot()
     LoadLootTables(LOOT_GATHERING, &GatheringLoot, true);
     LoadLootTables(LOOT_ITEMS, &ItemLoot, false);
     LoadLootTables(LOOT_PICKPOCKETING, &PickpocketingLoot, false);
+    CompileLootStore(&CreatureLoot, &m_compiledCreatureLoot, 4);
+    CompileLootStore(&GOLoot, &m_compiledGOLoot, 4);
+    CompileLootStore(&GatheringLoot, &m_compiledGatheringLoot, 4);
+    CompileLootStore(&ItemLoot, &m_compiledItemLoot, 1);
+    CompileLootStore(&PickpocketingLoot, &m_compiledPickpocketingLoot, 1);
     is_loading = false;
 }
 
@@ -323,81 +329,154 @@ void LootMgr::LoadLootTables(const char * szTableName, LootStore * LootTable, bo
     delete result;
 }
 
-void LootMgr::PushLoot(StoreLootList *list, ObjectLoot *loot, uint8 difficulty, uint8 team, bool disenchant)
+void LootMgr::CompileLootTables()
 {
-    uint32 i;
-    uint32 count;
-    float nrand = 0;
-    float ncount = 0;
-    assert(difficulty < 4);
+    CompileLootStore(&CreatureLoot, &m_compiledCreatureLoot, 4);
+    CompileLootStore(&FishingLoot, &m_compiledFishingLoot, 1);
+    CompileLootStore(&GatheringLoot, &m_compiledGatheringLoot, 4);
+    CompileLootStore(&GOLoot, &m_compiledGOLoot, 4);
+    CompileLootStore(&ItemLoot, &m_compiledItemLoot, 1);
+    CompileLootStore(&PickpocketingLoot, &m_compiledPickpocketingLoot, 1);
+}
 
-    if (disenchant)
+void LootMgr::CompileLootStore(LootStore *source, CompiledLootStore *dest, uint8 difficulties)
+{
+    // Build on the side so fills only wait for the swap
+    CompiledLootStore compiled;
+    compiled.reserve(source->size());
+    for(LootStore::iterator itr = source->begin(); itr != source->end(); ++itr)
     {
-        nrand = RandomUInt(10000) / 100.0f;
-        ncount = 0;
+        std::vector<CompiledLootTable> &tables = compiled[itr->first];
+        tables.resize(difficulties);
+        for(uint8 i = 0; i < difficulties; ++i)
+            CompileLootTable(&itr->second, i, &tables[i]);
     }
 
-    for(auto itr = list->begin(); itr != list->end(); itr++)
+    m_compiledLock.HighAcquire();
+    dest->swap(compiled);
+    m_compiledLock.HighRelease();
+}
+
+void LootMgr::CompileLootTable(StoreLootList *list, uint8 difficulty, CompiledLootTable *table)
+{
+    // Bucket 0 always drops, bucket b holds chances in [2^-b, 2^-(b-1)), the extra slot never drops with current rates
+    std::vector<CompiledLootItem> bucketItems[LOOT_CHANCE_BUCKETS+1];
+    for(StoreLootList::iterator itr = list->begin(); itr != list->end(); ++itr)
     {
         StoreLootItem *storeLoot = (*itr);
         if(storeLoot->proto == NULL)
             continue;
 
-        float chance = storeLoot->chance[difficulty];
-        if(chance == 0.0f)
+        float chance = storeLoot->chance[storeLoot->multiChance ? difficulty : 0];
+        if(chance <= 0.0f)
             continue;
 
-        int lucky;
-        if (disenchant)
+        CompiledLootItem item;
+        item.proto = storeLoot->proto;
+        item.minCount = storeLoot->minCount;
+        item.maxCount = storeLoot->maxCount;
+        item.weight = chance;
+        item.chance = std::min(1.f, chance * sWorld.getRate(RATE_DROP0 + storeLoot->proto->Quality) / 100.f);
+
+        uint32 bucket = 0;
+        if(item.chance <= 0.f)
+            bucket = LOOT_CHANCE_BUCKETS;
+        else if(item.chance < 1.f)
         {
-            lucky = nrand >= ncount && nrand <= (ncount+chance);
-            ncount+= chance;
-        } else lucky = Rand( chance * sWorld.getRate( RATE_DROP0 + storeLoot->proto->Quality ) );
+            int exponent;
+            frexp(item.chance, &exponent);
+            bucket = std::min<uint32>(LOOT_CHANCE_BUCKETS-1, uint32(1-exponent));
+        }
+        bucketItems[bucket].push_back(item);
+    }
+
+    for(uint32 b = 0; b <= LOOT_CHANCE_BUCKETS; ++b)
+    {
+        if(bucketItems[b].empty())
+            continue;
 
-        if( lucky )
+        CompiledLootBucket bucket;
+        bucket.start = uint32(table->items.size());
+        bucket.maxChance = 0.f;
+        for(size_t i = 0; i < bucketItems[b].size(); ++i)
         {
-            if( storeLoot->minCount < storeLoot->maxCount )
-                count = RandomUInt(storeLoot->maxCount - storeLoot->minCount) + storeLoot->minCount;
-            else count = storeLoot->maxCount;
-
-            __LootItem itm;
-            itm.roll = NULL;
-            itm.proto = storeLoot->proto;
-            itm.StackSize = count;
-            itm.all_passed = false;
-            itm.has_looted.clear();
-            GenerateRandomProperties(&itm);
-
-            loot->items.push_back(itm);
-            if(loot->items.size() == 16)
-                break;
+            bucket.maxChance = std::max(bucket.maxChance, bucketItems[b][i].chance);
+            table->items.push_back(bucketItems[b][i]);
         }
+        bucket.end = uint32(table->items.size());
+        bucket.logMiss = bucket.maxChance >= 1.f ? 0. : log(1. - bucket.maxChance);
+        if(b != LOOT_CHANCE_BUCKETS)
+            table->buckets.push_back(bucket);
     }
+}
+
+void LootMgr::PushLootItem(CompiledLootItem *item, ObjectLoot *loot)
+{
+    __LootItem itm;
+    itm.roll = NULL;
+    itm.proto = item->proto;
+    if( item->minCount < item->maxCount )
+        itm.StackSize = RandomUInt(item->maxCount - item->minCount) + item->minCount;
+    else itm.StackSize = item->maxCount;
+    itm.all_passed = false;
+    itm.has_looted.clear();
+    GenerateRandomProperties(&itm);
+    loot->items.push_back(itm);
+}
+
+void LootMgr::PushLoot(CompiledLootStore *store, uint32 loot_id, ObjectLoot *loot, uint8 difficulty, uint8 team, bool disenchant)
+{
+    assert(difficulty < 4);
+
+    RWGuard guard(m_compiledLock, false);
+    CompiledLootStore::iterator tab = store->find(loot_id);
+    if(tab == store->end() || tab->second.empty())
+        return;
 
-    if( loot->items.size() > 16 )
+    CompiledLootTable *table = &tab->second[std::min<size_t>(difficulty, tab->second.size()-1)];
+    if(table->items.empty())
+        return;
+
+    if (disenchant)
     {
-        std::vector<__LootItem>::iterator item_to_remove;
-        std::vector<__LootItem>::iterator itr;
-        int32 item_quality;
-        bool quest_item;
-        while( loot->items.size() > 16 )
+        // Grouped picks roll once over 100 against the raw chances, nothing calls this on a hot path so a scan will do
+        float nrand = RandomUInt(10000) / 100.0f, ncount = 0.f;
+        for(std::vector<CompiledLootItem>::iterator itr = table->items.begin(); itr != table->items.end(); ++itr)
         {
-            item_to_remove = loot->items.begin();
-            item_quality = 0;
-            quest_item = false;
-            for( itr = loot->items.begin(); itr != loot->items.end(); itr++ )
+            if(nrand >= ncount && nrand <= ncount + itr->weight)
             {
-                item_quality = (*itr).proto->Quality;
-                quest_item = (*itr).proto->Class == ITEM_CLASS_QUEST;
-                if( (*item_to_remove).proto->Quality > item_quality && !quest_item )
-                {
-                    item_to_remove = itr;
-                }
+                PushLootItem(&(*itr), loot);
+                break;
             }
-            loot->items.erase( item_to_remove );
+            ncount += itr->weight;
         }
+        return;
     }
 
+    for(std::vector<CompiledLootBucket>::iterator itr = table->buckets.begin(); itr != table->buckets.end(); ++itr)
+    {
+        CompiledLootBucket &bucket = *itr;
+        for(uint32 i = bucket.start; i < bucket.end; ++i)
+        {
+            if(bucket.logMiss != 0.)
+            {
+                // Jump straight to the next item that passes a roll at the bucket's highest chance
+                double skip = floor(log(1. - RandomDouble()) / bucket.logMiss);
+                if(skip >= double(bucket.end - i))
+                    break;
+                i += uint32(skip);
+
+                // Then thin the hit down to the item's own chance
+                CompiledLootItem &item = table->items[i];
+                if(item.chance < bucket.maxChance && RandomFloat(bucket.maxChance) >= item.chance)
+                    continue;
+            }
+
+            PushLootItem(&table->items[i], loot);
+            if(loot->items.size() == 16)
+                return;
+        }
+    }
 }
 
 void LootMgr::FillCreatureLoot(ObjectLoot * loot,uint32 loot_id, uint8 difficulty, uint8 team)
@@ -405,10 +484,7 @@ void LootMgr::FillCreatureLoot(ObjectLoot * loot,uint32 loot_id, uint8 difficult
     loot->items.clear();
     loot->gold = 0;
 
-    LootStore::iterator tab = CreatureLoot.find(loot_id);
-    if( CreatureLoot.end() == tab)
-        return;
-    PushLoot(&tab->second, loot, difficulty, team, false);
+    PushLoot(&m_compiledCreatureLoot, loot_id, loot, difficulty, team, false);
 }
 
 void LootMgr::FillGOLoot(ObjectLoot * loot,uint32 loot_id, uint8 difficulty, uint8 team)
@@ -416,10 +492,7 @@ void LootMgr::FillGOLoot(ObjectLoot * loot,uint32 loot_id, uint8 difficulty, uin
     loot->items.clear ();
     loot->gold = 0;
 
-    LootStore::iterator tab = GOLoot.find(loot_id);
-    if( GOLoot.end() == tab)
-        return;
-    PushLoot(&tab->second, loot, difficulty, team, false);
+    PushLoot(&m_compiledGOLoot, loot_id, loot, difficulty, team, false);
 }
 
 void LootMgr::FillFishingLoot(ObjectLoot * loot,uint32 loot_id)
@@ -427,10 +500,7 @@ void LootMgr::FillFishingLoot(ObjectLoot * loot,uint32 loot_id)
     loot->items.clear();
     loot->gold = 0;
 
-    LootStore::iterator tab = FishingLoot.find(loot_id);
-    if( FishingLoot.end() == tab)
-        return;
-    PushLoot(&tab->second, loot, 0, 0, false);
+    PushLoot(&m_compiledFishingLoot, loot_id, loot, 0, 0, false);
 }
 
 void LootMgr::FillGatheringLoot(ObjectLoot * loot,uint32 loot_id)
@@ -438,10 +508,7 @@ void LootMgr::FillGatheringLoot(ObjectLoot * loot,uint32 loot_id)
     loot->items.clear();
     loot->gold = 0;
 
-    LootStore::iterator tab = GatheringLoot.find(loot_id);
-    if(tab == GatheringLoot.end())
-        return;
-    PushLoot(&tab->second, loot, 0, 0, false);
+    PushLoot(&m_compiledGatheringLoot, loot_id, loot, 0, 0, false);
 }
 
 void LootMgr::FillPickpocketingLoot(ObjectLoot * loot,uint32 loot_id)
@@ -449,10 +516,7 @@ void LootMgr::FillPickpocketingLoot(ObjectLoot * loot,uint32 loot_id)
     loot->items.clear();
     loot->gold = 0;
 
-    LootStore::iterator tab = PickpocketingLoot.find(loot_id);
-    if( PickpocketingLoot.end() == tab)
-        return;
-    PushLoot(&tab->second, loot, 0, 0, false);
+    PushLoot(&m_compiledPickpocketingLoot, loot_id, loot, 0, 0, false);
 }
 
 void LootMgr::FillItemLoot(ObjectLoot *loot, uint32 loot_id, uint8 team)
@@ -461,10 +525,7 @@ void LootMgr::FillItemLoot(ObjectLoot *loot, uint32 loot_id, uint8 team)
 	// Todo: item gold
     loot->gold = 0 * sWorld.getRate(RATE_MONEY);
 
-    LootStore::iterator tab = ItemLoot.find(loot_id);
-    if( ItemLoot.end()==tab)
-        return;
-    PushLoot(&tab->second, loot, 0, team, false);
+    PushLoot(&m_compiledItemLoot, loot_id, loot, 0, team, false);
 }
 
 bool LootMgr::CanGODrop(uint32 LootId,uint32 itemid)
@@ -96,6 +96,36 @@ struct StoreLootItem
 typedef std::set<StoreLootItem*> StoreLootList;
 typedef std::map<uint32, StoreLootList > LootStore;
 
+// Chances below 2^-(LOOT_CHANCE_BUCKETS-1) all share the last sampling bucket
+#define LOOT_CHANCE_BUCKETS 16
+
+struct CompiledLootItem
+{
+    ItemPrototype *proto;
+    uint32 minCount, maxCount;
+    float chance; // Drop probability with rates applied, 0-1
+    float weight; // Raw chance used by grouped picks
+};
+
+struct CompiledLootBucket
+{
+    uint32 start, end;
+    float maxChance;
+    double logMiss; // log(1-maxChance), zero when everything in the bucket always drops
+};
+
+/** One difficulty of a loot table flattened into arrays
+ * Items are grouped by power of two chance and each bucket is rolled by skipping ahead geometrically,
+ * so a roll costs the number of drops rather than the table size.
+ */
+struct CompiledLootTable
+{
+    std::vector<CompiledLootItem> items;
+    std::vector<CompiledLootBucket> buckets;
+};
+
+typedef std::unordered_map<uint32, std::vector<CompiledLootTable> > CompiledLootStore;
+
 //////////////////////////////////////////////////////////////////////////////////////////
 
 enum PARTY_LOOT
@@ -152,6 +182,9 @@ public:
     void LoadDelayedLoot();
     void LoadLootProp();
 
+    // Rebuilds the sampling tables from the loot stores, call again after drop rates change
+    void CompileLootTables();
+
     LootStore CreatureLoot;
     LootStore FishingLoot;
     LootStore GatheringLoot;
@@ -170,7 +203,15 @@ public:
 
 private:
     void LoadLootTables(const char * szTableName, LootStore * LootTable, bool MultiDifficulty);
-    void PushLoot(StoreLootList *list, ObjectLoot *loot, uint8 difficulty, uint8 team, bool disenchant);
+    void PushLoot(CompiledLootStore *store, uint32 loot_id, ObjectLoot *loot, uint8 difficulty, uint8 team, bool disenchant);
+    void PushLootItem(CompiledLootItem *item, ObjectLoot *loot);
+
+    void CompileLootStore(LootStore *source, CompiledLootStore *dest, uint8 difficulties);
+    void CompileLootTable(StoreLootList *list, uint8 difficulty, CompiledLootTable *table);
+
+    RWMutex m_compiledLock;
+    CompiledLootStore m_compiledCreatureLoot, m_compiledFishingLoot, m_compiledGatheringLoot;
+    CompiledLootStore m_compiledGOLoot, m_compiledItemLoot, m_compiledPickpocketingLoot;
 
     std::map<uint32, std::vector<uint32>> _creaturequestloot;
     std::map<uint32, std::vector<uint32>> _gameobjectquestloot;
@@ -189,6 +189,7 @@ bool Master::Run(int argc, char ** argv)
     sLog.outString("");
 
     new OpcodeManager();
+    new ServerCounters();
     new World();
 
     /* load the config file */
@@ -316,6 +317,7 @@ bool Master::Run(int argc, char ** argv)
         LogDatabase.EndThreads();
 
     guildmgr.SaveAllGuilds();
+    sMailSystem.FlushWrites(true);
     sWorld.LogoutPlayers(); //(Also saves players).
     CharacterDatabase.Execute("UPDATE character_data SET online = 0");
 
@@ -370,6 +372,9 @@ bool Master::Run(int argc, char ** argv)
     sLog.Notice("OpcodeManager", "~OpcodeManager()");
     delete OpcodeManager::getSingletonPtr();
 
+    sLog.Notice("ServerCounters", "~ServerCounters()");
+    delete ServerCounters::getSingletonPtr();
+
     // Wait for cleanup thread to exit
     sThreadManager.Shutdown();
 
@@ -566,6 +571,7 @@ void segfault_handler(int c)
             sLog.outString( "All pending database operations cleared.\n" );
             sWorld.SaveAllPlayers();
             guildmgr.SaveAllGuilds();
+            sMailSystem.FlushWrites(true);
             objmgr.CorpseCollectorUnload(true);
             CharacterDatabase.EndThreads();
             sLog.outString( "Data saved." );
@@ -636,6 +642,7 @@ void OnCrash( bool Terminate )
             WorldDatabase.EndThreads();
             sWorld.SaveAllPlayers();
             guildmgr.SaveAllGuilds();
+            sMailSystem.FlushWrites(true);
             objmgr.CorpseCollectorUnload(true);
             CharacterDatabase.EndThreads();
 
@@ -288,14 +288,25 @@ void ObjectMgr::RenamePlayerInfo(PlayerInfo * pn, const char * oldname, const ch
 {
     playernamelock.AcquireWriteLock();
     std::string oldn = RONIN_UTIL::TOLOWER_RETURN(oldname);
+    std::string newn = RONIN_UTIL::TOLOWER_RETURN(newname);
     PlayerNameStringIndexMap::iterator itr = m_playersInfoByName.find( oldn );
     if( itr != m_playersInfoByName.end() && itr->second == pn )
     {
-        std::string newn = RONIN_UTIL::TOLOWER_RETURN(newname);
         m_playersInfoByName.erase( itr );
         m_playersInfoByName[newn] = pn;
     }
 
+    // Move the online name entry too, if the player is in world
+    _playerslock.AcquireWriteLock();
+    PlayerNameStorageMap::iterator online = _playersByName.find( oldn );
+    if( online != _playersByName.end() && online->second->GetGUID() == pn->charGuid )
+    {
+        Player *plr = online->second;
+        _playersByName.erase( online );
+        _playersByName[newn] = plr;
+    }
+    _playerslock.ReleaseWriteLock();
+
     playernamelock.ReleaseWriteLock();
 }
 
@@ -671,35 +682,13 @@ uint32 ObjectMgr::GeneratePlayerGuid()
 Player* ObjectMgr::GetPlayer(const char* name, bool caseSensitive)
 {
     Player * rv = NULL;
-    PlayerStorageMap::const_iterator itr;
+    std::string strName = RONIN_UTIL::TOLOWER_RETURN(name);
     _playerslock.AcquireReadLock();
 
-    if(!caseSensitive)
-    {
-        std::string strName = name;
-        RONIN_UTIL::TOLOWER(strName);
-        for (itr = _players.begin(); itr != _players.end();)
-        {
-            if(!stricmp(itr->second->GetNameString()->c_str(), strName.c_str()))
-            {
-                rv = itr->second;
-                break;
-            }
-            ++itr;
-        }
-    }
-    else
-    {
-        for (itr = _players.begin(); itr != _players.end();)
-        {
-            if(!strcmp(itr->second->GetName(), name))
-            {
-                rv = itr->second;
-                break;
-            }
-            ++itr;
-        }
-    }
+    // Names are unique regardless of case, a case sensitive lookup only has to confirm the hit
+    PlayerNameStorageMap::const_iterator itr = _playersByName.find(strName);
+    if(itr != _playersByName.end() && (!caseSensitive || !strcmp(itr->second->GetName(), name)))
+        rv = itr->second;
 
     _playerslock.ReleaseReadLock();
 
@@ -1169,6 +1158,7 @@ void ObjectMgr::AddPlayer(Player* p)//add it to global storage
 {
     _playerslock.AcquireWriteLock();
     _players[p->GetLowGUID()] = p;
+    _playersByName[RONIN_UTIL::TOLOWER_RETURN(*p->GetNameString())] = p;
     _playerslock.ReleaseWriteLock();
 }
 
@@ -1176,6 +1166,9 @@ void ObjectMgr::RemovePlayer(Player* p)
 {
     _playerslock.AcquireWriteLock();
     _players.erase(p->GetLowGUID());
+    PlayerNameStorageMap::iterator itr = _playersByName.find(RONIN_UTIL::TOLOWER_RETURN(*p->GetNameString()));
+    if(itr != _playersByName.end() && itr->second == p)
+        _playersByName.erase(itr);
     _playerslock.ReleaseWriteLock();
 }
 
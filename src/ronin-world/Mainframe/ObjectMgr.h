@@ -121,7 +121,7 @@ static const uint32 NextLevelXp[MAX_PREDEFINED_NEXTLEVELXP]=
     1686300,    2121500,    4004000,    5203400,    9165100};
 
 typedef std::map<uint32, std::list<SpellEntry*>* > OverrideIdMap;
-typedef std::map<std::string, PlayerInfo*> PlayerNameStringIndexMap;
+typedef std::unordered_map<std::string, PlayerInfo*> PlayerNameStringIndexMap;
 
 struct RecallLocation
 {
@@ -278,7 +278,10 @@ public:
     PlayerInfo* CreatePlayer();
     Mutex m_playerguidlock;
     typedef std::map<uint64, Player*> PlayerStorageMap;
+    typedef std::unordered_map<std::string, Player*> PlayerNameStorageMap;
     PlayerStorageMap _players;
+    // Online players by lowercase name, guarded by _playerslock
+    PlayerNameStorageMap _playersByName;
     RWLock _playerslock;
     uint32 m_hiPlayerGuid;
 
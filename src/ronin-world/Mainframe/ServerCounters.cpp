@@ -0,0 +1,91 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StdAfx.h"
+
+initialiseSingleton( ServerCounters );
+
+static const char *counterNames[SERVER_COUNTER_MAX] =
+{
+    "Packets in",
+    "Packets out",
+    "Bytes in",
+    "Bytes out",
+    "Bytes compressed",
+    "Compressed output",
+    "Continent overruns",
+    "Instance overruns"
+};
+
+ServerCounters::ServerCounters() : m_worldQueueDepth(0), m_worldQueuePeak(0), m_characterQueueDepth(0), m_characterQueuePeak(0)
+{
+    for(uint32 i = 0; i < SERVER_COUNTER_MAX; ++i)
+        m_counters[i].store(0, std::memory_order_relaxed);
+    for(uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        m_opcodesIn[i].packets.store(0, std::memory_order_relaxed);
+        m_opcodesIn[i].bytes.store(0, std::memory_order_relaxed);
+        m_opcodesOut[i].packets.store(0, std::memory_order_relaxed);
+        m_opcodesOut[i].bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+static bool CompareOpcodeCounters(const OpcodeCounter &a, const OpcodeCounter &b)
+{
+    return a.packets > b.packets;
+}
+
+void ServerCounters::GetTopOpcodes(bool outgoing, uint32 count, std::vector<OpcodeCounter> &out)
+{
+    out.clear();
+    OpcodeSlot *slots = outgoing ? m_opcodesOut : m_opcodesIn;
+
+    OpcodeCounter counter;
+    for(uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        if((counter.packets = slots[i].packets.load(std::memory_order_relaxed)) == 0)
+            continue;
+
+        counter.opcode = i;
+        counter.bytes = slots[i].bytes.load(std::memory_order_relaxed);
+        out.push_back(counter);
+    }
+
+    if(out.size() > count)
+    {
+        std::partial_sort(out.begin(), out.begin()+count, out.end(), CompareOpcodeCounters);
+        out.resize(count);
+    } else std::sort(out.begin(), out.end(), CompareOpcodeCounters);
+}
+
+void ServerCounters::SampleDatabaseQueues(uint32 worldQueue, uint32 characterQueue)
+{
+    // Only the world thread samples, so plain stores are enough for the peaks
+    m_worldQueueDepth.store(worldQueue, std::memory_order_relaxed);
+    m_characterQueueDepth.store(characterQueue, std::memory_order_relaxed);
+    if(worldQueue > m_worldQueuePeak.load(std::memory_order_relaxed))
+        m_worldQueuePeak.store(worldQueue, std::memory_order_relaxed);
+    if(characterQueue > m_characterQueuePeak.load(std::memory_order_relaxed))
+        m_characterQueuePeak.store(characterQueue, std::memory_order_relaxed);
+}
+
+const char *ServerCounters::GetCounterName(ServerCounterType type)
+{
+    return type < SERVER_COUNTER_MAX ? counterNames[type] : "Unknown";
+}
@@ -0,0 +1,89 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+enum ServerCounterType
+{
+    SERVER_COUNTER_PACKETS_IN,
+    SERVER_COUNTER_PACKETS_OUT,
+    SERVER_COUNTER_BYTES_IN,
+    SERVER_COUNTER_BYTES_OUT,
+    SERVER_COUNTER_COMPRESSION_IN,      // Bytes handed to deflate
+    SERVER_COUNTER_COMPRESSION_OUT,     // Bytes deflate produced
+    SERVER_COUNTER_CONTINENT_OVERRUNS,
+    SERVER_COUNTER_INSTANCE_OVERRUNS,
+    SERVER_COUNTER_MAX
+};
+
+struct OpcodeCounter
+{
+    uint32 opcode;
+    uint64 packets, bytes;
+};
+
+/** Process wide counters for our hot paths
+ * Every counter is a relaxed atomic so any thread can bump them without locking.
+ * Database queue depths are gauges, sampled once a second by the world update.
+ */
+class SERVER_DECL ServerCounters : public Singleton<ServerCounters>
+{
+public:
+    ServerCounters();
+
+    RONIN_INLINE void Add(ServerCounterType type, uint64 amount = 1) { m_counters[type].fetch_add(amount, std::memory_order_relaxed); }
+    RONIN_INLINE uint64 Get(ServerCounterType type) { return m_counters[type].load(std::memory_order_relaxed); }
+
+    RONIN_INLINE void AddPacketIn(uint32 opcode, size_t len) { _AddPacket(m_opcodesIn, opcode, len, SERVER_COUNTER_PACKETS_IN, SERVER_COUNTER_BYTES_IN); }
+    RONIN_INLINE void AddPacketOut(uint32 opcode, size_t len) { _AddPacket(m_opcodesOut, opcode, len, SERVER_COUNTER_PACKETS_OUT, SERVER_COUNTER_BYTES_OUT); }
+
+    // Fills out with the busiest opcodes by packet count
+    void GetTopOpcodes(bool outgoing, uint32 count, std::vector<OpcodeCounter> &out);
+
+    void SampleDatabaseQueues(uint32 worldQueue, uint32 characterQueue);
+    uint32 GetWorldQueueDepth(bool peak) { return (peak ? m_worldQueuePeak : m_worldQueueDepth).load(std::memory_order_relaxed); }
+    uint32 GetCharacterQueueDepth(bool peak) { return (peak ? m_characterQueuePeak : m_characterQueueDepth).load(std::memory_order_relaxed); }
+
+    static const char *GetCounterName(ServerCounterType type);
+
+private:
+    struct OpcodeSlot
+    {
+        std::atomic<uint64> packets, bytes;
+    };
+
+    RONIN_INLINE void _AddPacket(OpcodeSlot *slots, uint32 opcode, size_t len, ServerCounterType packetCounter, ServerCounterType byteCounter)
+    {
+        opcode &= ~OPCODE_COMPRESSION_MASK;
+        if(opcode < NUM_MSG_TYPES)
+        {
+            slots[opcode].packets.fetch_add(1, std::memory_order_relaxed);
+            slots[opcode].bytes.fetch_add(len, std::memory_order_relaxed);
+        }
+        Add(packetCounter);
+        Add(byteCounter, len);
+    }
+
+    std::atomic<uint64> m_counters[SERVER_COUNTER_MAX];
+    OpcodeSlot m_opcodesIn[NUM_MSG_TYPES], m_opcodesOut[NUM_MSG_TYPES];
+
+    std::atomic<uint32> m_worldQueueDepth, m_worldQueuePeak, m_characterQueueDepth, m_characterQueuePeak;
+};
+
+#define sServerCounters ServerCounters::getSingleton()
@@ -48,11 +48,13 @@ World::World() : m_eventHandler(NULL)
     m_shutdownTime = 0;
     m_queueUpdateTimer = 180000;
     m_pushUpdateTimer = 0;
+    m_loginAdmissionRate = 100;
+    m_loginAdmissionTokens = 0;
     m_continentTaskPoolCount = 0;
     m_current_holiday_mask = 0;
+    m_cpuUsageTimer = 0;
 
 #ifdef WIN32
-    m_cpuUsageTimer = 0;
     m_lnOldValue = 0;
     memset( &m_OldPerfTime100nSec, 0, sizeof( m_OldPerfTime100nSec ) );
 
@@ -118,6 +120,9 @@ World::World() : m_eventHandler(NULL)
         }
     }
 #else
+    m_lastCPUTicks = 0;
+    m_lastCPUSampleTime = getMSTime();
+
     number_of_cpus = sysconf(_SC_NPROCESSORS_ONLN);
     // Assign all CPUs to the same cache/numa
     for(uint32 i = 0; i < number_of_cpus; ++i)
@@ -216,6 +221,8 @@ bool World::CompressPacketData(z_stream *stream, const void *data, uint32 len, B
             res = true;
             destSize -= stream->avail_out;
             output->append(buff->contents(), destSize);
+            sServerCounters.Add(SERVER_COUNTER_COMPRESSION_IN, len);
+            sServerCounters.Add(SERVER_COUNTER_COMPRESSION_OUT, destSize);
         } else sLog.outDebug("deflate failed: did not end stream");
     } else sLog.outDebug("deflate failed.");
     // Compression failed, readd the buffer
@@ -599,6 +606,9 @@ bool World::SetInitialWorldSettings()
     new AuctionMgr;
     sAuctionMgr.LoadAuctionHouses();
 
+    sLog.Notice("World", "Building creature spawn templates...");
+    sCreatureDataMgr.BuildSpawnTemplates();
+
     sLog.Success("World", "Database loaded in %ums.", getMSTime() - start_time);
 
     // calling this puts all maps into our task list.
@@ -715,9 +725,15 @@ void World::Update(uint32 msTime, uint32 uiDiff)
     // Through main thread, we calculate our timers for weekday and event timers etc
     UpdateServerTimers(uiDiff);
 
+    // Admit and finish our pending logins
+    UpdatePendingLogins(uiDiff);
+
     // Update our queued sessions
     UpdateQueuedSessions(uiDiff);
 
+    // Fire callbacks for character data loaded off thread
+    CharacterDatabase.ProcessDeferredCallbacks();
+
     // Update our group finder
     if(GroupFinderMgr::getSingletonPtr() != NULL)
         sGroupFinder.Update(msTime, uiDiff);
@@ -743,21 +759,23 @@ void World::Update(uint32 msTime, uint32 uiDiff)
 float World::GetAverageCPUUsage()
 {
     float val = 0.f;
-#ifdef WIN32
+    if(m_cpuPercentages.empty())
+        return val;
+
     for(auto itr = m_cpuPercentages.begin(); itr != m_cpuPercentages.end(); itr++)
         val += (*itr);
     val /= m_cpuPercentages.size();
-#endif
     return val;
 }
 
 void World::UpdateServerPerformance(uint32 uiDiff)
 {
-#ifdef WIN32
     if((m_cpuUsageTimer += uiDiff) < 1000)
         return;
 
     m_cpuUsageTimer = 0;
+    sServerCounters.SampleDatabaseQueues(WorldDatabase.GetQueueSize(), CharacterDatabase.GetQueueSize());
+
     double currentUsage = GetCPUUsage();
     m_cpuPercentages.push_back(currentUsage);
     if(m_cpuPercentages.size() <= 10)
@@ -765,7 +783,6 @@ void World::UpdateServerPerformance(uint32 uiDiff)
 
     // Pop front if we have more than 10
     m_cpuPercentages.erase(m_cpuPercentages.begin());
-#endif
 }
 
 void World::UpdateServerTimers(uint32 diff)
@@ -1147,6 +1164,102 @@ void World::UpdateQueuedSessions(uint32 diff)
     }
 }
 
+bool World::AddPendingLogin(WorldSocket *socket, WorldSession *session)
+{
+    Guard guard(m_pendingLoginLock);
+    if(m_pendingLogins.find(session->GetAccountId()) != m_pendingLogins.end())
+        return false;
+
+    PendingLogin *login = new PendingLogin();
+    login->socket = socket;
+    login->session = session;
+    login->startTime = getMSTime();
+    m_pendingLogins.insert(std::make_pair(session->GetAccountId(), login));
+    m_loginAdmissionQueue.push_back(login);
+    return true;
+}
+
+void World::RemovePendingLogin(WorldSocket *socket, uint32 accountId)
+{
+    Guard guard(m_pendingLoginLock);
+    std::map<uint32, PendingLogin*>::iterator itr;
+    if((itr = m_pendingLogins.find(accountId)) == m_pendingLogins.end() || itr->second->socket != socket)
+        return;
+
+    // The login loses its socket and the world thread frees it, the socket still touches the session on the way out
+    PendingLogin *login = itr->second;
+    login->socket = NULL;
+    // Logins that haven't been admitted yet give up their account slot now so a reconnect isn't refused
+    if(std::find(m_loginAdmissionQueue.begin(), m_loginAdmissionQueue.end(), login) != m_loginAdmissionQueue.end())
+        m_pendingLogins.erase(itr);
+}
+
+bool World::HasPendingLogin(uint32 accountId)
+{
+    Guard guard(m_pendingLoginLock);
+    return m_pendingLogins.find(accountId) != m_pendingLogins.end();
+}
+
+void World::LoginDataLoaded(QueryResultVector& results, uint32 accountId)
+{
+    // Called from the query thread, the session isn't visible to anyone else until we hand it back
+    m_pendingLoginLock.Acquire();
+    std::map<uint32, PendingLogin*>::iterator itr = m_pendingLogins.find(accountId);
+    PendingLogin *login = itr == m_pendingLogins.end() ? NULL : itr->second;
+    m_pendingLoginLock.Release();
+    if(login == NULL)
+        return;
+
+    login->session->LoadLoginData(results);
+    m_loginDataLatency.AddSample(getMSTime() - login->startTime);
+
+    m_pendingLoginLock.Acquire();
+    m_loadedLogins.push_back(login);
+    m_pendingLoginLock.Release();
+}
+
+void World::UpdatePendingLogins(uint32 diff)
+{
+    Guard guard(m_pendingLoginLock);
+    // Tokens are in thousandths of a login, and we allow up to a second of burst
+    m_loginAdmissionTokens = std::min<uint32>(m_loginAdmissionTokens + diff * m_loginAdmissionRate, m_loginAdmissionRate * 1000);
+    if(m_loginAdmissionQueue.empty() && m_loadedLogins.empty())
+        return;
+
+    while(!m_loginAdmissionQueue.empty())
+    {
+        PendingLogin *login = m_loginAdmissionQueue.front();
+        if(login->socket != NULL)
+        {
+            if(m_loginAdmissionTokens < 1000)
+                break;
+            m_loginAdmissionTokens -= 1000;
+        }
+
+        m_loginAdmissionQueue.pop_front();
+        if(login->socket == NULL)
+        {
+            // Dropped before admission, RemovePendingLogin already gave up the account slot
+            delete login->session;
+            delete login;
+            continue;
+        }
+
+        login->session->Init();
+    }
+
+    for(std::vector<PendingLogin*>::iterator itr = m_loadedLogins.begin(); itr != m_loadedLogins.end(); ++itr)
+    {
+        PendingLogin *login = *itr;
+        m_pendingLogins.erase(login->session->GetAccountId());
+        if(login->socket == NULL)
+            delete login->session;
+        else login->socket->OnLoginDataLoaded();
+        delete login;
+    }
+    m_loadedLogins.clear();
+}
+
 void World::SaveAllPlayers()
 {
     if(!(ObjectMgr::getSingletonPtr()))
@@ -1194,7 +1307,22 @@ double World::GetCPUUsage()
     a /= double(number_of_cpus);
     return ceil(a * 10000.0)/100.0;
 #else
-    return 0.0f;
+    // Process cpu ticks spent since our last sample, against the wall time of every core
+    ProcessCPUTimes times;
+    if(!ReadProcessCPUTimes(times))
+        return 0.0;
+
+    uint32 mstime = getMSTime(), elapsed = getMSTimeDiff(mstime, m_lastCPUSampleTime);
+    uint64 ticks = times.userTicks + times.systemTicks, tickDelta = ticks - m_lastCPUTicks;
+    bool firstSample = m_lastCPUTicks == 0;
+    m_lastCPUTicks = ticks;
+    m_lastCPUSampleTime = mstime;
+    if(firstSample || elapsed == 0 || number_of_cpus == 0)
+        return 0.0;
+
+    double a = (double(tickDelta) * 1000.0 / double(GetProcessClockTicks())) / double(elapsed);
+    a /= double(number_of_cpus);
+    return ceil(a * 10000.0)/100.0;
 #endif
 }
 
@@ -1266,19 +1394,9 @@ float World::GetRAMUsage(bool external)
     RAMUsage /= 1024.0f;
     RAMUsage /= 1024.0f;
 #else
-#ifdef UNTESTED_CODE
-    FILE* file = fopen("/proc/self/status", "r");
-    char line[128];
-    while (fgets(line, 128, file) != NULL)
-    {
-        if (strncmp(line, "VmSize:", 7) == 0)
-        {
-            RAMUsage = parseLine(line);
-            break;
-        }
-    }
-    fclose(file);
-#endif
+    ProcessMemoryStats stats;
+    if(ReadProcessMemoryStats(stats))
+        RAMUsage = float(stats.residentKB) / 1024.0f;
 #endif
     return RAMUsage;
 }
@@ -1502,6 +1620,7 @@ void World::Rehash(bool load)
         new MailSystem;
 
     sLog.Init(mainIni->ReadInteger("LogLevel", "Screen", 1));
+    sLog.SetFileLogging(mainIni->ReadInteger("LogLevel", "File", -1), mainIni->ReadString("LogLevel", "FileName", "ronin-world.log").c_str(), mainIni->ReadInteger("LogLevel", "FileRotateSize", 32)*1024*1024);
     QueryLog = mainIni->ReadBoolean("LogLevel", "Query", false);
 
     // Data configs
@@ -1527,6 +1646,7 @@ void World::Rehash(bool load)
     gm_force_robes = mainIni->ReadBoolean("ServerSettings", "ForceRobesForGM", false);
     trade_world_chat = mainIni->ReadInteger("ServerSettings", "TradeWorldChat", 0);
     SetPlayerLimit(mainIni->ReadInteger("ServerSettings", "PlayerLimit", 1000));
+    m_loginAdmissionRate = std::max<int>(1, mainIni->ReadInteger("ServerSettings", "LoginAdmissionRate", 100));
     FunServerMall = mainIni->ReadInteger("ServerSettings", "MallAreaID", -1);
     LogoutDelay = mainIni->ReadInteger("ServerSettings", "Logout_Delay", 20);
     EnableFatigue = mainIni->ReadBoolean("ServerSettings", "EnableFatigue", true);
@@ -1588,6 +1708,10 @@ void World::Rehash(bool load)
     setRate(RATE_QUESTREPUTATION, mainIni->ReadFloat("Rates", "QuestReputation", 1.0f));
     setRate(RATE_KILLREPUTATION, mainIni->ReadFloat("Rates", "KillReputation", 1.0f));
 
+    // Drop rates are baked into the loot sampling tables
+    if(!load && LootMgr::getSingletonPtr() && !lootmgr.is_loading)
+        lootmgr.CompileLootTables();
+
     GmClientChannel = mainIni->ReadString("GMClient", "GmClientChannel", "");
     m_reqGmForCommands = !mainIni->ReadBoolean("ServerSettings", "AllowPlayerCommands", false);
 
@@ -462,6 +462,19 @@ public:
     uint32 GetQueuePos(WorldSocket* Socket);
     void UpdateQueuedSessions(uint32 diff);
 
+    // Authenticated sockets wait here while their login data is loaded off thread
+    bool AddPendingLogin(WorldSocket *socket, WorldSession *session);
+    void RemovePendingLogin(WorldSocket *socket, uint32 accountId);
+    bool HasPendingLogin(uint32 accountId);
+    void LoginDataLoaded(QueryResultVector& results, uint32 accountId);
+    void UpdatePendingLogins(uint32 diff);
+    // Loaded logins are handed back under this lock, sockets hold it while giving up their session on disconnect
+    void AcquirePendingLoginLock() { m_pendingLoginLock.Acquire(); }
+    void ReleasePendingLoginLock() { m_pendingLoginLock.Release(); }
+
+    // Auth to login data loaded, and character login request to in world
+    LatencyHistogram m_loginDataLatency, m_playerLoginLatency;
+
     // Auth seeds
     BigNumber authSeed1, authSeed2;
 
@@ -624,15 +637,26 @@ private:
     SessionSet m_globalSessions, m_gmSessions, m_sessionGarbageCollector;
     Mutex m_sessionLock;
 
+    struct PendingLogin
+    {
+        WorldSocket *socket;
+        WorldSession *session;
+        uint32 startTime;
+    };
+
+    // Pending logins are keyed by account, admitted into loading and then handed back loaded
+    Mutex m_pendingLoginLock;
+    std::map<uint32, PendingLogin*> m_pendingLogins;
+    std::deque<PendingLogin*> m_loginAdmissionQueue;
+    std::vector<PendingLogin*> m_loadedLogins;
+
     // Push to world queue
     Mutex m_worldPushLock;
     std::map<WorldSession*, std::pair<WoWGuid, uint32> > m_worldPushQueue;
 
     double GetCPUUsage();
-#ifdef WIN32
     uint32 m_cpuUsageTimer;
     std::vector<double> m_cpuPercentages;
-#endif
 protected:
     float regen_values[MAX_RATES];
 
@@ -647,6 +671,7 @@ protected:
 
     bool m_heroicReset, m_heroicWarning, m_dailyReset;
     uint32 m_StartTime, m_queueUpdateTimer, m_pushUpdateTimer;
+    uint32 m_loginAdmissionRate, m_loginAdmissionTokens;
 
     QueueSet mQueuedSessions;
 
@@ -706,6 +731,9 @@ private:
 #ifdef WIN32
     __int64 m_lnOldValue;
     LARGE_INTEGER m_OldPerfTime100nSec;
+#else
+    uint64 m_lastCPUTicks;
+    uint32 m_lastCPUSampleTime;
 #endif // WIN32
 };
 
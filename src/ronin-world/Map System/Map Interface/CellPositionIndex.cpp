@@ -0,0 +1,153 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//
+// CellPositionIndex.cpp
+//
+
+#include "StdAfx.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CELL_INDEX_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CELL_INDEX_SSE2
+#endif
+
+void CellPositionIndex::Insert(WorldObject *obj, uint32 cellTypeMask)
+{
+    Loki::AssocVector<WoWGuid, uint32>::iterator itr;
+    if((itr = m_slots.find(obj->GetGUID())) != m_slots.end())
+    {
+        m_typeMask[itr->second] = cellTypeMask;
+        m_objects[itr->second] = obj;
+        UpdatePosition(obj);
+        return;
+    }
+
+    m_slots.insert(std::make_pair(obj->GetGUID(), uint32(m_objects.size())));
+    m_x.push_back(obj->GetPositionX());
+    m_y.push_back(obj->GetPositionY());
+    m_z.push_back(obj->GetPositionZ());
+    m_typeMask.push_back(cellTypeMask);
+    m_objects.push_back(obj);
+}
+
+void CellPositionIndex::Remove(WoWGuid guid)
+{
+    Loki::AssocVector<WoWGuid, uint32>::iterator itr;
+    if((itr = m_slots.find(guid)) == m_slots.end())
+        return;
+
+    uint32 slot = itr->second, last = uint32(m_objects.size()-1);
+    m_slots.erase(itr);
+    if(slot != last)
+    {
+        m_x[slot] = m_x[last];
+        m_y[slot] = m_y[last];
+        m_z[slot] = m_z[last];
+        m_typeMask[slot] = m_typeMask[last];
+        m_objects[slot] = m_objects[last];
+        m_slots[m_objects[slot]->GetGUID()] = slot;
+    }
+
+    m_x.pop_back();
+    m_y.pop_back();
+    m_z.pop_back();
+    m_typeMask.pop_back();
+    m_objects.pop_back();
+}
+
+void CellPositionIndex::UpdatePosition(WorldObject *obj)
+{
+    Loki::AssocVector<WoWGuid, uint32>::iterator itr;
+    if((itr = m_slots.find(obj->GetGUID())) == m_slots.end())
+        return;
+
+    m_x[itr->second] = obj->GetPositionX();
+    m_y[itr->second] = obj->GetPositionY();
+    m_z[itr->second] = obj->GetPositionZ();
+}
+
+void CellPositionIndex::Clear()
+{
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_typeMask.clear();
+    m_objects.clear();
+    m_slots.clear();
+}
+
+void CellPositionIndex::Filter(float x, float y, float z, float range, bool use3D, uint32 typeMask, std::vector<WorldObject*> &out)
+{
+    size_t i = 0, count = m_objects.size();
+    range += CELL_INDEX_POSITION_SLACK;
+    float rangeSq = range*range;
+
+#ifdef CELL_INDEX_AVX2
+    __m256 cx8 = _mm256_set1_ps(x), cy8 = _mm256_set1_ps(y), cz8 = _mm256_set1_ps(use3D ? z : 0.f), range8 = _mm256_set1_ps(rangeSq);
+    __m256 zMask8 = _mm256_castsi256_ps(_mm256_set1_epi32(use3D ? -1 : 0));
+    __m256i type8 = _mm256_set1_epi32(int(typeMask)), zero8 = _mm256_setzero_si256();
+    for(; i + 8 <= count; i += 8)
+    {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&m_x[i]), cx8), dy = _mm256_sub_ps(_mm256_loadu_ps(&m_y[i]), cy8);
+        __m256 dz = _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(&m_z[i]), cz8), zMask8);
+        __m256 distSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+        __m256 inRange = _mm256_cmp_ps(distSq, range8, _CMP_LE_OQ);
+        __m256i typeHit = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256((const __m256i*)&m_typeMask[i]), type8), zero8);
+        int hits = _mm256_movemask_ps(_mm256_andnot_ps(_mm256_castsi256_ps(typeHit), inRange));
+        for(size_t bit = 0; hits; ++bit, hits >>= 1)
+            if(hits & 1)
+                out.push_back(m_objects[i+bit]);
+    }
+#endif
+
+#ifdef CELL_INDEX_SSE2
+    __m128 cx = _mm_set1_ps(x), cy = _mm_set1_ps(y), cz = _mm_set1_ps(use3D ? z : 0.f), range4 = _mm_set1_ps(rangeSq);
+    __m128 zMask = _mm_castsi128_ps(_mm_set1_epi32(use3D ? -1 : 0));
+    __m128i type4 = _mm_set1_epi32(int(typeMask)), zero4 = _mm_setzero_si128();
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&m_x[i]), cx), dy = _mm_sub_ps(_mm_loadu_ps(&m_y[i]), cy);
+        __m128 dz = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(&m_z[i]), cz), zMask);
+        __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        __m128 inRange = _mm_cmple_ps(distSq, range4);
+        __m128i typeHit = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128((const __m128i*)&m_typeMask[i]), type4), zero4);
+        int hits = _mm_movemask_ps(_mm_andnot_ps(_mm_castsi128_ps(typeHit), inRange));
+        for(size_t bit = 0; hits; ++bit, hits >>= 1)
+            if(hits & 1)
+                out.push_back(m_objects[i+bit]);
+    }
+#endif
+
+    // Scalar tail, or the whole set without SSE2
+    for(; i < count; ++i)
+    {
+        if((m_typeMask[i] & typeMask) == 0)
+            continue;
+
+        float dx = m_x[i]-x, dy = m_y[i]-y, dz = use3D ? m_z[i]-z : 0.f;
+        if(dx*dx + dy*dy + dz*dz <= rangeSq)
+            out.push_back(m_objects[i]);
+    }
+}
@@ -0,0 +1,54 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+//
+// CellPositionIndex.h
+//
+
+#pragma once
+
+// Positions are refreshed when the map processes a location change, pad range checks to cover that delay
+#define CELL_INDEX_POSITION_SLACK 5.f
+
+/** Structure of arrays copy of a cell's active object positions
+ * Range queries filter the contiguous arrays four (or eight with AVX2) at a time,
+ * so only objects that pass the distance and type check are ever dereferenced.
+ * The owning cell's lock guards every call.
+ */
+class SERVER_DECL CellPositionIndex
+{
+public:
+    void Insert(WorldObject *obj, uint32 cellTypeMask);
+    void Remove(WoWGuid guid);
+    void UpdatePosition(WorldObject *obj);
+    void Clear();
+
+    // Appends every object matching typeMask within range of x, y (and z when use3D)
+    void Filter(float x, float y, float z, float range, bool use3D, uint32 typeMask, std::vector<WorldObject*> &out);
+
+    RONIN_INLINE size_t size() { return m_objects.size(); }
+
+private:
+    std::vector<float> m_x, m_y, m_z;
+    std::vector<uint32> m_typeMask;
+    std::vector<WorldObject*> m_objects;
+
+    // Guid to array slot, removal swaps the last slot into the hole
+    Loki::AssocVector<WoWGuid, uint32> m_slots;
+};
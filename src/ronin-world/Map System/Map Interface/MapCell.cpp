@@ -52,7 +52,10 @@ void MapCell::AddObject(WorldObject* obj)
     if(obj->IsActiveObject() && !obj->IsActivated())
         m_deactivatedObjects[obj->GetGUID()] = obj;
     else if(obj->IsPlayer())
+    {
         m_activePlayerSet[obj->GetGUID()] = obj;
+        m_positionIndex.Insert(obj, TYPEMASK_TYPE_PLAYER);
+    }
     else
     {
         m_activeNonPlayerSet[obj->GetGUID()] = obj;
@@ -60,9 +63,17 @@ void MapCell::AddObject(WorldObject* obj)
             m_creatureSet[obj->GetGUID()] = obj;
         else if(obj->IsGameObject())
             m_gameObjectSet[obj->GetGUID()] = obj;
+        // Index type matches the sets ProcessObjectSets walks for each mask bit
+        m_positionIndex.Insert(obj, obj->IsCreature() ? TYPEMASK_TYPE_UNIT : obj->IsGameObject() ? TYPEMASK_TYPE_GAMEOBJECT : TYPEMASK_TYPE_OBJECT);
     }
 }
 
+void MapCell::UpdateObjectPosition(WorldObject *obj)
+{
+    RWGuard guard(_objLock, true);
+    m_positionIndex.UpdatePosition(obj);
+}
+
 void MapCell::RemoveObject(WorldObject* obj)
 {
     Guard guard(_pendingLock);
@@ -83,6 +94,7 @@ void MapCell::ProcessPendingActions()
         m_creatureSet.erase(guid);
         m_gameObjectSet.erase(guid);
         m_deactivatedObjects.erase(guid);
+        m_positionIndex.Remove(guid);
     }
 
     MapCell::CellObjectMap::iterator itr;
@@ -98,6 +110,7 @@ void MapCell::ProcessPendingActions()
             m_activeNonPlayerSet.erase(guid);
             m_creatureSet.erase(guid);
             m_gameObjectSet.erase(guid);
+            m_positionIndex.Remove(guid);
             m_deactivatedObjects[obj->GetGUID()] = obj;
         }
     }
@@ -201,6 +214,43 @@ void MapCell::ProcessObjectSets(WorldObject *obj, ObjectProcessCallback *callbac
     }
 }
 
+void MapCell::ProcessObjectSetsInRange(WorldObject *obj, ObjectProcessCallback *callback, float x, float y, float z, float range, bool use3D, uint32 objectMask)
+{
+    static thread_local std::vector<WorldObject*> t_survivors;
+
+    RWGuard guard(_objLock, false);
+
+    WorldObject *curObj;
+    uint32 indexMask = objectMask == 0 ? 0xFFFFFFFF : (objectMask & (TYPEMASK_TYPE_UNIT|TYPEMASK_TYPE_PLAYER|TYPEMASK_TYPE_GAMEOBJECT));
+    if(indexMask)
+    {
+        size_t start = t_survivors.size();
+        m_positionIndex.Filter(x, y, z, range, use3D, indexMask, t_survivors);
+        // Callbacks can recurse into other cells on this thread, so only walk our own slice
+        for(size_t i = start; i < t_survivors.size(); ++i)
+        {
+            if((curObj = t_survivors[i]) == obj)
+                continue;
+            (*callback)(obj, curObj);
+        }
+        t_survivors.resize(start);
+    }
+
+    // Deactivated objects aren't indexed, they're rare enough to check directly
+    if(objectMask & TYPEMASK_TYPE_DEACTIVATED)
+    {
+        float rangeSq = (range + CELL_INDEX_POSITION_SLACK) * (range + CELL_INDEX_POSITION_SLACK);
+        for(MapCell::CellObjectMap::iterator itr = m_deactivatedObjects.begin(); itr != m_deactivatedObjects.end(); itr++)
+        {
+            if((curObj = itr->second) == NULL || obj == curObj)
+                continue;
+            if((use3D ? curObj->GetDistanceSq(x, y, z) : curObj->GetDistance2dSq(x, y)) > rangeSq)
+                continue;
+            (*callback)(obj, curObj);
+        }
+    }
+}
+
 void MapCell::SetActivity(bool state)
 {
     uint32 x = _x/CellsPerTile, y = _y/CellsPerTile;
@@ -227,6 +277,10 @@ uint32 MapCell::LoadCellData(CellSpawns * sp)
 
     uint32 loadCount = 0, mapId = _instance->GetMapId();
     InstanceData *data = _instance->m_iData;
+    // Fresh instances have no saved states, skip the per spawn lookups for the whole cell
+    if(data && !data->HasObjectStates())
+        data = NULL;
+
     if(sp->CreatureSpawns.size())//got creatures
     {
         for(CreatureSpawnArray::iterator i=sp->CreatureSpawns.begin();i!=sp->CreatureSpawns.end();++i)
@@ -336,6 +390,9 @@ void MapCell::UnloadCellData(bool preDestruction)
             pair.second->Cleanup();
     });
 
+    for(MapCell::CellObjectMap::iterator itr = m_activeNonPlayerSet.begin(); itr != m_activeNonPlayerSet.end(); itr++)
+        m_positionIndex.Remove(itr->first);
+
     m_activeNonPlayerSet.clear();
     m_deactivatedObjects.clear();
     m_gameObjectSet.clear();
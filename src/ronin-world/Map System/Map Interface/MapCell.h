@@ -60,6 +60,9 @@ public:
 
     // Iterating through different phases of sets
     void ProcessObjectSets(WorldObject *obj, ObjectProcessCallback *callback, uint32 objectMask = 0);
+    // Same as above, but only objects within range of x, y (and z when use3D) reach the callback
+    void ProcessObjectSetsInRange(WorldObject *obj, ObjectProcessCallback *callback, float x, float y, float z, float range, bool use3D, uint32 objectMask = 0);
+    void UpdateObjectPosition(WorldObject *obj);
 
     //State Related
     void SetActivity(bool state);
@@ -106,6 +109,8 @@ private:
     CellObjectMap m_gameObjectSet, m_creatureSet;
     // Deactivated objects
     CellObjectMap m_deactivatedObjects;
+    // Positions of our active objects for range filtering
+    CellPositionIndex m_positionIndex;
 
     // Used for instance based guid recalculation
     Loki::AssocVector<WoWGuid, WoWGuid> m_sqlIdToGuid;
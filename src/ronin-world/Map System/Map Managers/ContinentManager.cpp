@@ -215,6 +215,9 @@ bool ContinentManager::run()
         }
 #endif
 
+        if(getMSTime()-lastUpdate > MapInstanceUpdatePeriod)
+            sServerCounters.Add(SERVER_COUNTER_CONTINENT_OVERRUNS);
+
         // Set the thread to sleep to prevent thread overrun and wasted cycles
         if(!SetThreadState(THREADSTATE_SLEEPING))
             break;
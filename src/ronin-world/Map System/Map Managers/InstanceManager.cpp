@@ -18,12 +18,14 @@
  */
 
 #include "StdAfx.h"
+#include <thread>
 
 SERVER_DECL InstanceManager sInstanceMgr;
 
 InstanceManager::InstanceManager()
 {
-
+    // Continents run on their own threads, leave them half of the cores
+    m_workerCount = std::min<uint32>(std::max<uint32>(1, std::thread::hardware_concurrency()/2), INSTANCE_MANAGER_MAX_WORKERS);
 }
 
 InstanceManager::~InstanceManager()
@@ -38,9 +40,10 @@ void InstanceManager::Destruct()
 
 void InstanceManager::Launch()
 {
-    InstanceManagerSlave *worker = new InstanceManagerSlave();
-    // Only need one instance management thread to start with, dynamically allocate more if we need them.
-    sThreadManager.ExecuteTask(format("InstanceManager - Worker %u", 0+1).c_str(), worker);
+    // Every worker owns a deadline ordered queue, idle workers take over instances that fall behind
+    for(uint32 i = 0; i < m_workerCount; ++i)
+        sThreadManager.ExecuteTask(format("InstanceManager - Worker %u", i+1).c_str(), new InstanceManagerSlave(i));
+    sLog.Notice("InstanceManager", "Started %u instance update workers", m_workerCount);
 
     // Nullify these counters here
     m_creatureGUIDCounter = m_gameObjectGUIDCounter = 0;
@@ -359,7 +362,21 @@ void InstanceManager::_AddInstance(uint32 instanceId, MapInstance *instance)
     uint32 msTime = getMSTime();
     instance->Init(msTime);
     container->ResetTimer(msTime);
-    mInstancePool.push_back(container);
+
+    // New instances go to the worker with the shortest queue
+    uint32 workerId = 0;
+    size_t queued = 0xFFFFFFFF;
+    for(uint32 i = 0; i < m_workerCount; ++i)
+    {
+        m_workers[i].queueLock.Acquire();
+        if(m_workers[i].queue.size() < queued)
+        {
+            queued = m_workers[i].queue.size();
+            workerId = i;
+        }
+        m_workers[i].queueLock.Release();
+    }
+    _QueueContainer(workerId, container);
     instancePoolLock.Release();
 }
 
@@ -377,105 +394,219 @@ MapInstance *InstanceManager::_LoadInstance(uint32 mapId, uint32 instanceId)
     return ret;
 }
 
+void InstanceManager::_QueueContainer(uint32 workerId, MapInstanceContainer *container)
+{
+    InstanceWorker *worker = &m_workers[workerId];
+    container->SetWorker(workerId);
+    worker->queueLock.Acquire();
+    worker->queue.push_back(container);
+    std::push_heap(worker->queue.begin(), worker->queue.end(), MapInstanceContainer::DueLater());
+    worker->queueLock.Release();
+}
+
+MapInstanceContainer *InstanceManager::_GetNextContainer(uint32 workerId, uint32 msTime, uint32 &waitTime)
+{
+    MapInstanceContainer *container = NULL;
+    InstanceWorker *worker = &m_workers[workerId];
+    waitTime = INSTANCE_WORKER_MAX_IDLE;
+
+    worker->queueLock.Acquire();
+    if(!worker->queue.empty())
+    {
+        int32 timeLeft = int32(worker->queue.front()->GetDueTime() - msTime);
+        if(timeLeft < 0)
+        {
+            std::pop_heap(worker->queue.begin(), worker->queue.end(), MapInstanceContainer::DueLater());
+            container = worker->queue.back();
+            worker->queue.pop_back();
+        } else waitTime = std::min<uint32>(waitTime, std::max<int32>(1, timeLeft));
+    }
+    worker->queueLock.Release();
+    if(container != NULL)
+        return container;
+
+    // Nothing of ours is due, take over the most overdue instance a busy worker hasn't reached yet
+    uint32 victimId = workerId;
+    int32 mostLate = int32(MapInstanceUpdatePeriod);
+    for(uint32 i = 0; i < m_workerCount; ++i)
+    {
+        if(i == workerId)
+            continue;
+
+        m_workers[i].queueLock.Acquire();
+        if(!m_workers[i].queue.empty())
+        {
+            int32 lateness = int32(msTime - m_workers[i].queue.front()->GetDueTime());
+            if(lateness > mostLate)
+            {
+                mostLate = lateness;
+                victimId = i;
+            }
+        }
+        m_workers[i].queueLock.Release();
+    }
+
+    if(victimId == workerId)
+        return NULL;
+
+    InstanceWorker *victim = &m_workers[victimId];
+    victim->queueLock.Acquire();
+    // Recheck, the owner may have picked it up while we were scanning
+    if(!victim->queue.empty() && int32(msTime - victim->queue.front()->GetDueTime()) > int32(MapInstanceUpdatePeriod))
+    {
+        std::pop_heap(victim->queue.begin(), victim->queue.end(), MapInstanceContainer::DueLater());
+        container = victim->queue.back();
+        victim->queue.pop_back();
+    }
+    victim->queueLock.Release();
+
+    if(container != NULL)
+    {   // The instance stays with us from now on
+        container->SetWorker(workerId);
+        ++worker->stolen;
+    }
+    return container;
+}
+
+void InstanceManager::GetWorkerStatus(uint32 workerId, InstanceWorkerStatus &status)
+{
+    memset(&status, 0, sizeof(InstanceWorkerStatus));
+    if(workerId >= m_workerCount)
+        return;
+
+    InstanceWorker *worker = &m_workers[workerId];
+    worker->queueLock.Acquire();
+    status.queued = uint32(worker->queue.size());
+    worker->queueLock.Release();
+
+    status.updates = worker->updates;
+    status.overruns = worker->overruns;
+    status.stolen = worker->stolen;
+    status.averageUpdateTime = status.updates ? uint32(worker->totalUpdateTime / status.updates) : 0;
+    status.worstUpdateTime = worker->worstUpdateTime;
+    status.worstLateness = worker->worstLateness;
+}
+
 void InstanceManager::HandleUpdateRequests(InstanceManagerSlave *slaveThis)
 {
-    uint32 diff = 0, msTimer = 0;
+    uint32 diff = 0, msTimer = 0, waitTime = 0, workerId = slaveThis->GetWorkerId();
+    InstanceWorker *worker = &m_workers[workerId];
     MapInstanceContainer *container = NULL;
     while(slaveThis->SetThreadState(THREADSTATE_BUSY))
     {
         msTimer = getMSTime();
-        instancePoolLock.Acquire();
-        if(!mInstancePool.empty())
+        if((container = _GetNextContainer(workerId, msTimer, waitTime)) == NULL)
         {
-            container = mInstancePool.front();
-            // Test if the update timeout has passed and grab our map difference
-            if(container->Validate(msTimer, diff))
-                mInstancePool.pop_front();
-            else container = NULL;
+            if(!slaveThis->SetThreadState(THREADSTATE_SLEEPING))
+                break;
+            // Sleep until our earliest instance is due instead of a fixed interval
+            slaveThis->Delay(waitTime);
+            continue;
         }
-        instancePoolLock.Release();
 
-        if(container != NULL)
-        {
-            if(MapInstance *instance = container->Get())
-            {
-                // Update our collision system via instanced map system
-                sVMapInterface.UpdateSingleMap(instance->GetMapId(), diff, instance->GetInstanceID());
-
-                // Process all pending actions in sequence
-                instance->_PerformPendingActions();
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Process all pending inputs in sequence
-                instance->_ProcessInputQueue();
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Process all script updates before object updates
-                instance->_PerformScriptUpdates(msTimer, diff);
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Perform all combat state updates before any unit updates
-                instance->_PerformCombatUpdates(msTimer, diff);
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Perform all delayed spell updates before object updates
-                instance->_PerformDelayedSpellUpdates(msTimer, diff);
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Perform all unit path updates in sequence
-                instance->_PerformUnitPathUpdates(msTimer, diff);
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Perform all player updates in sequence
-                instance->_PerformPlayerUpdates(msTimer, diff);
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Perform all dynamic object updates in sequence
-                instance->_PerformDynamicObjectUpdates(msTimer, diff);
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Perform all creature updates in sequence
-                instance->_PerformCreatureUpdates(msTimer, diff);
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Perform all object updates in sequence
-                instance->_PerformObjectUpdates(msTimer, diff);
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Perform all movement updates in sequence without player data
-                instance->_PerformMovementUpdates(false);
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Perform all session updates in sequence
-                instance->_PerformSessionUpdates();
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Perform all movement updates in sequence with player data
-                instance->_PerformMovementUpdates(true);
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Process secondary pending actions in sequence
-                instance->_PerformPendingActions();
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Perform all pending object updates in sequence
-                instance->_PerformPendingUpdates();
-                if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
-                    break;
-                // Reset the last update timer for next update processing
-                container->ResetTimer(msTimer);
-                // Readd the instance to the update pool
-                instancePoolLock.Acquire();
-                mInstancePool.push_back(container);
-                instancePoolLock.Release();
-            } else delete container; // Clean up the empty container
+        MapInstance *instance = container->Get();
+        if(instance == NULL)
+        {   // Clean up the empty container
+            delete container;
+            continue;
         }
-        if(!slaveThis->SetThreadState(THREADSTATE_SLEEPING))
+
+        // Grab our map difference, the container was due so this is at least one update period
+        container->Validate(msTimer, diff);
+        uint32 lateness = int32(msTimer - container->GetDueTime()) > 0 ? msTimer - container->GetDueTime() : 0;
+        if(lateness > worker->worstLateness)
+            worker->worstLateness = lateness;
+
+        _UpdateInstance(slaveThis, instance, msTimer, diff);
+        if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
             break;
-        Sleep(25);
+
+        uint32 updateTime = getMSTimeDiff(getMSTime(), msTimer);
+        ++worker->updates;
+        worker->totalUpdateTime += updateTime;
+        if(updateTime > worker->worstUpdateTime)
+            worker->worstUpdateTime = updateTime;
+
+        // Reset the last update timer for next update processing, our next diff always runs from this update's start
+        container->ResetTimer(msTimer);
+        if(updateTime > MapInstanceUpdatePeriod)
+        {   // Overrunning instances wait a full period from when they finished so they can't starve the rest of our queue
+            sServerCounters.Add(SERVER_COUNTER_INSTANCE_OVERRUNS);
+            if((++worker->overruns % 100) == 1)
+                sLog.Warning("InstanceManager", "Instance %u (map %u) took %ums to update, %u overruns on worker %u", instance->GetInstanceID(), instance->GetMapId(), updateTime, uint32(worker->overruns), workerId+1);
+            container->DelayTimer(getMSTime());
+        }
+
+        // Readd the instance to the update queue of whichever worker owns it now
+        _QueueContainer(container->GetWorker(), container);
     }
 }
 
+void InstanceManager::_UpdateInstance(InstanceManagerSlave *slaveThis, MapInstance *instance, uint32 msTimer, uint32 diff)
+{
+    // Update our collision system via instanced map system
+    sVMapInterface.UpdateSingleMap(instance->GetMapId(), diff, instance->GetInstanceID());
+
+    // Process all pending actions in sequence
+    instance->_PerformPendingActions();
+    if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
+        return;
+    // Process all pending inputs in sequence
+    instance->_ProcessInputQueue();
+    if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
+        return;
+    // Process all script updates before object updates
+    instance->_PerformScriptUpdates(msTimer, diff);
+    if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
+        return;
+    // Perform all combat state updates before any unit updates
+    instance->_PerformCombatUpdates(msTimer, diff);
+    if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
+        return;
+    // Perform all delayed spell updates before object updates
+    instance->_PerformDelayedSpellUpdates(msTimer, diff);
+    if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
+        return;
+    // Perform all unit path updates in sequence
+    instance->_PerformUnitPathUpdates(msTimer, diff);
+    if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
+        return;
+    // Perform all player updates in sequence
+    instance->_PerformPlayerUpdates(msTimer, diff);
+    if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
+        return;
+    // Perform all dynamic object updates in sequence
+    instance->_PerformDynamicObjectUpdates(msTimer, diff);
+    if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
+        return;
+    // Perform all creature updates in sequence
+    instance->_PerformCreatureUpdates(msTimer, diff);
+    if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
+        return;
+    // Perform all object updates in sequence
+    instance->_PerformObjectUpdates(msTimer, diff);
+    if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
+        return;
+    // Perform all movement updates in sequence without player data
+    instance->_PerformMovementUpdates(false);
+    if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
+        return;
+    // Perform all session updates in sequence
+    instance->_PerformSessionUpdates();
+    if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
+        return;
+    // Perform all movement updates in sequence with player data
+    instance->_PerformMovementUpdates(true);
+    if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
+        return;
+    // Process secondary pending actions in sequence
+    instance->_PerformPendingActions();
+    if(!slaveThis->SetThreadState(THREADSTATE_BUSY))
+        return;
+    // Perform all pending object updates in sequence
+    instance->_PerformPendingUpdates();
+}
+
 void InstanceData::Update(uint32 msTime)
 {
     if(!m_isUpdated)
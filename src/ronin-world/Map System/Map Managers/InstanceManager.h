@@ -21,8 +21,21 @@
 
 extern const uint32 MapInstanceUpdatePeriod;
 
+// Instance update workers are sized to the hardware but never more than this
+#define INSTANCE_MANAGER_MAX_WORKERS 16
+// Longest a worker sleeps before looking at its queue again
+#define INSTANCE_WORKER_MAX_IDLE 25
+
 class MapInstanceContainer;
 class InstanceData;
+class InstanceManagerSlave;
+
+// Snapshot of one update worker's counters
+struct InstanceWorkerStatus
+{
+    uint32 queued, updates, overruns, stolen;
+    uint32 averageUpdateTime, worstUpdateTime, worstLateness;
+};
 
 // Each instance has it's own instance data linked to unique IDs
 typedef std::map<uint32, InstanceData*> InstanceDataMap;
@@ -80,9 +93,34 @@ private:
     friend class InstanceManagerSlave;
     void HandleUpdateRequests(InstanceManagerSlave *slaveThis);
 
+    // Per worker instance queue, containers are ordered by the time their next update is due
+    struct InstanceWorker
+    {
+        InstanceWorker() : updates(0), overruns(0), stolen(0), totalUpdateTime(0), worstUpdateTime(0), worstLateness(0) {}
+
+        Mutex queueLock;
+        std::vector<MapInstanceContainer*> queue;
+
+        std::atomic<uint32> updates, overruns, stolen;
+        std::atomic<uint64> totalUpdateTime;
+        std::atomic<uint32> worstUpdateTime, worstLateness;
+    };
+
+    void _QueueContainer(uint32 workerId, MapInstanceContainer *container);
+    // Pops the next due container for this worker, taking an overdue one from another worker if we're idle
+    MapInstanceContainer *_GetNextContainer(uint32 workerId, uint32 msTime, uint32 &waitTime);
+    void _UpdateInstance(InstanceManagerSlave *slaveThis, MapInstance *instance, uint32 msTimer, uint32 diff);
+
     // Processing queue lock
     Mutex instancePoolLock, instanceStorageLock;
-    std::deque<MapInstanceContainer*> mInstancePool;
+    uint32 m_workerCount;
+    InstanceWorker m_workers[INSTANCE_MANAGER_MAX_WORKERS];
+
+public:
+    uint32 GetWorkerCount() { return m_workerCount; }
+    void GetWorkerStatus(uint32 workerId, InstanceWorkerStatus &status);
+
+private:
 
     // First is instance id, second is pointer
     std::map<uint32, std::pair<MapInstanceContainer*, MapInstance*>> mInstanceStorage;
@@ -115,9 +153,9 @@ extern SERVER_DECL InstanceManager sInstanceMgr;
 class MapInstanceContainer
 {
 public:
-    MapInstanceContainer(MapInstance *instance) : _lastUpdateTimer(0), _instance(instance) {}
+    MapInstanceContainer(MapInstance *instance) : _lastUpdateTimer(0), _dueTimer(0), _worker(0), _instance(instance) {}
 
-    void Invalidate() { _instance = NULL; _lastUpdateTimer = 0; }
+    void Invalidate() { _instance = NULL; _lastUpdateTimer = _dueTimer = 0; }
     MapInstance *Get() { return _instance; }
     bool Validate(uint32 msTime, uint32 &diff)
     {
@@ -129,17 +167,32 @@ public:
         return false;
     }
 
-    void ResetTimer(uint32 msTime) { _lastUpdateTimer = msTime; }
+    void ResetTimer(uint32 msTime) { _lastUpdateTimer = msTime; _dueTimer = msTime + MapInstanceUpdatePeriod; }
+    // Pushes back the next update without touching the start time our diff is taken from
+    void DelayTimer(uint32 msTime) { _dueTimer = msTime + MapInstanceUpdatePeriod; }
+    uint32 GetDueTime() { return _dueTimer; }
+
+    // Worker that keeps updating this instance while it isn't falling behind
+    uint32 GetWorker() { return _worker; }
+    void SetWorker(uint32 worker) { _worker = worker; }
+
+    struct DueLater { bool operator()(MapInstanceContainer *a, MapInstanceContainer *b) const { return int32(a->GetDueTime() - b->GetDueTime()) > 0; } };
 
 private:
-    uint32 _lastUpdateTimer;
+    uint32 _lastUpdateTimer, _dueTimer, _worker;
     MapInstance *_instance;
 };
 
 class InstanceManagerSlave : public ThreadContext
 {
 public: // Just make calls into instance management, then return true for auto deletion.
+    InstanceManagerSlave(uint32 workerId) : m_workerId(workerId) {}
+
     bool run() { sInstanceMgr.HandleUpdateRequests(this); return true; }
+    uint32 GetWorkerId() { return m_workerId; }
+
+private:
+    uint32 m_workerId;
 };
 
 class InstanceData
@@ -174,6 +227,7 @@ public:
 
     bool GetObjectState(WoWGuid guid, uint8 &stateOut);
     void AddObjectState(WoWGuid guid, uint8 state);
+    bool HasObjectStates() { return !m_objectState.empty(); }
 
     void SetUpdated() { m_isUpdated = true; }
 
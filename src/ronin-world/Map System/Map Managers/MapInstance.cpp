@@ -25,7 +25,7 @@
 extern bool bServerShutdown;
 
 MapInstance::MapInstance(Map *map, uint32 mapId, uint32 instanceid, InstanceData *data) : CellHandler<MapCell>(map), _mapId(mapId), m_instanceID(instanceid), m_script(NULL), pdbcMap(dbcMap.LookupEntry(mapId)),
-    m_stateManager(new WorldStateManager(this)), _processCallback(this), _removalCallback(this)
+    m_stateManager(new WorldStateManager(this)), _processCallback(this), _removalCallback(this), _aggroSensorCallback(this)
 {
     m_mapPreloading = false;
 
@@ -37,6 +37,9 @@ MapInstance::MapInstance(Map *map, uint32 mapId, uint32 instanceid, InstanceData
     InactiveMoveTime = 0;
 
     m_forceCombatState = false;
+    m_combatClock = m_combatWheelTime = 0;
+
+    _aggroSensorRange = AGGRO_SENSOR_BASE_RANGE;
 
     // buffers
     m_createBuffer.reserve(0x7FFF);
@@ -65,8 +68,7 @@ MapInstance::MapInstance(Map *map, uint32 mapId, uint32 instanceid, InstanceData
     mDynamicObjectPool.Initialize(pdbcMap && pdbcMap->IsContinent() ? 2 * std::max<uint32>(1, threadCount) : 1);
     mUnitPathPool.Initialize(pdbcMap && pdbcMap->IsContinent() ? 2 * std::max<uint32>(1, threadCount) : 1);
 
-    projectileSpellUpdateTime[0] = projectileSpellUpdateTime[1] = 0;
-    projectileSpellIndex[0] = projectileSpellIndex[1] = 0;
+    m_projectileClock = 0;
 
     if(m_instanceData = (m_iData = data) ? new MapInstance::MapInstanceData() : NULL)
     {
@@ -331,6 +333,7 @@ void MapInstance::PushObject(WorldObject* obj)
                 m_CreatureStorage.insert(std::make_pair(obj->GetGUID(), creature));
                 TRIGGER_INSTANCE_EVENT( this, OnCreaturePushToWorld )( creature );
                 mUnitPathPool.Add(creature->GetMovementInterface()->GetPath());
+                RaiseAggroSensorRange(creature->GetAggroRange());
             }break;
 
         case HIGHGUID_TYPE_GAMEOBJECT:
@@ -428,6 +431,10 @@ void MapInstance::PushObject(WorldObject* obj)
     bool skipCellLoad = m_mapPreloading || (obj->IsActiveObject() && !obj->IsActivated());
     obj->GetCellManager()->SetCurrentCell(skipCellLoad ? NULL : this, mx, my, mz, ObjectCellManager::VisibleCellRange);
     CacheObjectCell(obj->GetGUID(), ObjectCellManager::_makeCell(cx, cy));
+
+    // Creatures around us won't notice we've arrived until we move otherwise
+    if(plObj && !skipCellLoad)
+        TriggerAggroSensors(plObj);
 }
 
 void MapInstance::RemoveObject(WorldObject* obj)
@@ -439,6 +446,10 @@ void MapInstance::RemoveObject(WorldObject* obj)
     ASSERT(obj);
     ASSERT(obj->GetMapId() == _mapId);
 
+    // Units leaving the map drop out of combat here rather than waiting for their timers
+    if(obj->IsUnit())
+        ClearCombatTimers(obj->GetGUID());
+
     m_poolLock.Acquire();
     RemoveCachedCell(obj->GetGUID());
     switch(obj->GetTypeId())
@@ -718,7 +729,14 @@ void MapInstance::ChangeObjectLocation( WorldObject* obj )
             // Set our cellId
             obj->GetCellManager()->SetCurrentCell(this, fposX, fposY, fposZ, ObjectCellManager::VisibleCellRange);
             CacheObjectCell(obj->GetGUID(), ObjectCellManager::_makeCell(cellX, cellY));
-        }
+        } else if(objCell) // Same cell, just refresh our indexed position
+            objCell->UpdateObjectPosition(obj);
+
+        // Moving creatures search for themselves, and every unit wakes idle creatures we've come close to
+        if(obj->IsCreature())
+            castPtr<Creature>(obj)->GetAIInterface()->ArmAggroSensor();
+        if(obj->IsUnit())
+            TriggerAggroSensors(castPtr<Unit>(obj));
     }
 }
 
@@ -775,7 +793,7 @@ void MapInstanceObjectRemovalCallback::operator()(WorldObject *obj, WorldObject
         castPtr<Player>( curObj )->RemoveIfVisible(_instance->GetMapId(), obj);
 }
 
-void MapInstance::RemoveCellData(WorldObject *Obj, std::set<uint32> &set, bool forced)
+void MapInstance::RemoveCellData(WorldObject *Obj, std::vector<uint32> &set, bool forced)
 {
     if(!forced && IsFullRangeObject(Obj))
         return;
@@ -828,13 +846,12 @@ void MapInstance::UpdateObjectVisibility(Player *plObj, WorldObject *curObj)
 {
     ASSERT(plObj && curObj);
 
-    std::set<WoWGuid>::iterator itr;
-    bool cansee = canObjectsInteract(plObj, curObj) && plObj->CanSee(curObj), isvisible = plObj->GetVisibility(curObj, &itr);
+    bool cansee = canObjectsInteract(plObj, curObj) && plObj->CanSee(curObj), isvisible = plObj->IsVisible(curObj);
     if(!cansee && isvisible)
     {
         curObj->GetCellManager()->RemoveVisibleBy(plObj->GetGUID());
         plObj->PushOutOfRange(_mapId, curObj->GetGUID());
-        plObj->RemoveVisibleObject(itr);
+        plObj->RemoveVisibleObject(curObj);
     }
     else if(cansee && !isvisible)
     {
@@ -1152,11 +1169,13 @@ Unit *MapInstance::FindInRangeTarget(Creature *ctr, float range, uint32 typeMask
     // Lock the storage lock in case we are allocated to a few threads
     storage->callback.ResetData(range);
     ctr->GetCellManager()->CreateCellRange(&storage->cellvector, range);
-    std::for_each(storage->cellvector.begin(), storage->cellvector.end(), [this, ctr, typeMask, storage](uint32 cellId)
+    // Targets can grow our detection range by up to 25 levels worth of yards
+    float filterRange = range + 28.f;
+    std::for_each(storage->cellvector.begin(), storage->cellvector.end(), [this, ctr, typeMask, storage, filterRange](uint32 cellId)
     {
         std::pair<uint16, uint16> cellPair = ObjectCellManager::unPack(cellId);
         if(MapCell *cell = GetCell(cellPair.first, cellPair.second))
-            cell->ProcessObjectSets(ctr, &storage->callback, typeMask);
+            cell->ProcessObjectSetsInRange(ctr, &storage->callback, ctr->GetPositionX(), ctr->GetPositionY(), ctr->GetPositionZ(), filterRange, true, typeMask);
     });
 
     Unit *Result = storage->callback.GetResult();
@@ -1164,6 +1183,86 @@ Unit *MapInstance::FindInRangeTarget(Creature *ctr, float range, uint32 typeMask
     return Result;
 }
 
+Unit *MapInstance::FindInRangeTarget(Creature *ctr, float range, uint32 typeMask, std::vector<WoWGuid> &candidates)
+{
+    // Acquire our storage for this thread
+    InrangeTargetCallbackStack::callbackStorage *storage = _inRangeTargetCBStack.getOrAllocateCallback(RONIN_UTIL::GetThreadId(), this);
+    ASSERT(storage != NULL);
+
+    // Only the units our aggro sensor picked up need the full target check
+    storage->callback.ResetData(range);
+    for(std::vector<WoWGuid>::iterator itr = candidates.begin(); itr != candidates.end(); itr++)
+    {
+        Unit *unit = GetUnit(*itr);
+        if(unit == NULL || unit == ctr || (unit->GetTypeFlags() & typeMask) == 0)
+            continue;
+        storage->callback(ctr, unit);
+    }
+    return storage->callback.GetResult();
+}
+
+void MapInstanceAggroSensorCallback::operator()(WorldObject *obj, WorldObject *curObj)
+{
+    if(obj == curObj || !curObj->IsCreature())
+        return;
+
+    Creature *ctr = castPtr<Creature>(curObj);
+    if(!ctr->isAlive() || ctr->GetAIInterface()->GetAIState() != AI_STATE_IDLE)
+        return;
+    // Non hostile creatures don't search, and only creatures hostile to npcs care about anything but players
+    if(ctr->IsFactionNonHostile() || (!obj->IsPlayer() && !ctr->IsFactionNPCHostile()))
+        return;
+
+    // Targets can grow our detection range by up to 25 levels worth of yards, the target check is exact
+    float range = ctr->GetAggroRange() + AGGRO_SENSOR_LEVEL_RANGE;
+    if(ctr->GetDistanceSq(obj) > range*range)
+        return;
+    ctr->GetAIInterface()->OnAggroSensorTrigger(obj->GetGUID());
+}
+
+void MapInstance::TriggerAggroSensors(Unit *unit)
+{
+    if(unit->isDead())
+        return;
+
+    m_aggroSensorLock.Acquire();
+    _pendingAggroSensors.insert(unit->GetGUID());
+    m_aggroSensorLock.Release();
+}
+
+void MapInstance::RaiseAggroSensorRange(float aggroRange)
+{
+    m_aggroSensorLock.Acquire();
+    _aggroSensorRange = std::max<float>(_aggroSensorRange, aggroRange + AGGRO_SENSOR_LEVEL_RANGE);
+    m_aggroSensorLock.Release();
+}
+
+void MapInstance::_ProcessAggroSensors()
+{
+    std::set<WoWGuid> pendingSensors;
+    m_aggroSensorLock.Acquire();
+    pendingSensors.swap(_pendingAggroSensors);
+    float range = _aggroSensorRange;
+    m_aggroSensorLock.Release();
+
+    for(std::set<WoWGuid>::iterator gItr = pendingSensors.begin(); gItr != pendingSensors.end(); ++gItr)
+    {
+        // Units can leave the map or die between queueing and the walk
+        Unit *unit = GetUnit(*gItr);
+        if(unit == NULL || !unit->IsInWorld() || unit->isDead())
+            continue;
+
+        unit->GetCellManager()->CreateCellRange(&_aggroSensorCells, range);
+        for(std::vector<uint32>::iterator itr = _aggroSensorCells.begin(); itr != _aggroSensorCells.end(); itr++)
+        {
+            std::pair<uint16, uint16> cellPair = ObjectCellManager::unPack(*itr);
+            if(MapCell *cell = GetCell(cellPair.first, cellPair.second))
+                cell->ProcessObjectSetsInRange(unit, &_aggroSensorCallback, unit->GetPositionX(), unit->GetPositionY(), unit->GetPositionZ(), range, true, TYPEMASK_TYPE_UNIT);
+        }
+        _aggroSensorCells.clear();
+    }
+}
+
 void MapInstanceBroadcastMessageCallback::operator()(WorldObject *obj, WorldObject *curObj)
 {
     if(!curObj->IsPlayer())
@@ -1217,11 +1316,15 @@ void MapInstance::MessageToCells(WorldObject *obj, uint16 opcodeId, uint16 Len,
 
     storage->callback.ResetData(range, opcodeId, Len, data, false, 0);
     obj->GetCellManager()->CreateCellRange(&storage->cellvector, range);
-    std::for_each(storage->cellvector.begin(), storage->cellvector.end(), [this, obj, storage](uint32 cellId)
+    std::for_each(storage->cellvector.begin(), storage->cellvector.end(), [this, obj, storage, range](uint32 cellId)
     {
         std::pair<uint16, uint16> cellPair = ObjectCellManager::unPack(cellId);
         if(MapCell *cell = GetCell(cellPair.first, cellPair.second))
-            cell->ProcessObjectSets(obj, &storage->callback, TYPEMASK_TYPE_PLAYER);
+        {
+            if(range > 1.f)
+                cell->ProcessObjectSetsInRange(obj, &storage->callback, obj->GetPositionX(), obj->GetPositionY(), 0.f, range, false, TYPEMASK_TYPE_PLAYER);
+            else cell->ProcessObjectSets(obj, &storage->callback, TYPEMASK_TYPE_PLAYER);
+        }
     });
 
     storage->cellvector.clear();
@@ -1235,11 +1338,15 @@ void MapInstance::MessageToCells(WorldObject *obj, WorldPacket *data, float rang
 
     storage->callback.ResetData(range, data, myTeam, teamId);
     obj->GetCellManager()->CreateCellRange(&storage->cellvector, range);
-    std::for_each(storage->cellvector.begin(), storage->cellvector.end(), [this, obj, storage](uint32 cellId)
+    std::for_each(storage->cellvector.begin(), storage->cellvector.end(), [this, obj, storage, range](uint32 cellId)
     {
         std::pair<uint16, uint16> cellPair = ObjectCellManager::unPack(cellId);
         if(MapCell *cell = GetCell(cellPair.first, cellPair.second))
-            cell->ProcessObjectSets(obj, &storage->callback, TYPEMASK_TYPE_PLAYER);
+        {
+            if(range > 1.f)
+                cell->ProcessObjectSetsInRange(obj, &storage->callback, obj->GetPositionX(), obj->GetPositionY(), 0.f, range, false, TYPEMASK_TYPE_PLAYER);
+            else cell->ProcessObjectSets(obj, &storage->callback, TYPEMASK_TYPE_PLAYER);
+        }
     });
 
     storage->cellvector.clear();
@@ -1354,11 +1461,11 @@ void MapInstance::HandleDynamicObjectRangeMapping(DynamicObjectTargetCallback *c
 
     storage->callback.SetData(callback, object, caster, minRange*minRange, maxRange*maxRange);
     ObjectCellManager::ConstructCellData(object->GetPositionX(), object->GetPositionY(), maxRange, &storage->cellvector);
-    std::for_each(storage->cellvector.begin(), storage->cellvector.end(), [this, object, typeMask, storage](uint32 cellId)
+    std::for_each(storage->cellvector.begin(), storage->cellvector.end(), [this, object, typeMask, storage, maxRange](uint32 cellId)
     {
         std::pair<uint16, uint16> cellPair = ObjectCellManager::unPack(cellId);
         if(MapCell *cell = GetCell(cellPair.first, cellPair.second))
-            cell->ProcessObjectSets(object, &storage->callback, typeMask);
+            cell->ProcessObjectSetsInRange(object, &storage->callback, object->GetPositionX(), object->GetPositionY(), object->GetPositionZ(), maxRange, true, typeMask);
     });
 
     storage->cellvector.clear();
@@ -1387,11 +1494,11 @@ void MapInstance::HandleSpellTargetMapping(MapTargetCallback *callback, SpellTar
 
     storage->callback.SetData(callback, spell, i, targetType, x, y, z, minRange*minRange, maxRange*maxRange);
     ObjectCellManager::ConstructCellData(x, y, maxRange, &storage->cellvector);
-    std::for_each(storage->cellvector.begin(), storage->cellvector.end(), [this, spell, typeMask, storage](uint32 cellId)
+    std::for_each(storage->cellvector.begin(), storage->cellvector.end(), [this, spell, typeMask, storage, x, y, z, maxRange](uint32 cellId)
     {
         std::pair<uint16, uint16> cellPair = ObjectCellManager::unPack(cellId);
         if(MapCell *cell = GetCell(cellPair.first, cellPair.second))
-            cell->ProcessObjectSets(spell->GetCaster(), &storage->callback, typeMask);
+            cell->ProcessObjectSetsInRange(spell->GetCaster(), &storage->callback, x, y, z, maxRange, true, typeMask);
     });
 
     storage->cellvector.clear();
@@ -1612,43 +1719,46 @@ void MapInstance::_PerformScriptUpdates(uint32 msTime, uint32 uiDiff)
 void MapInstance::_PerformCombatUpdates(uint32 msTime, uint32 uiDiff)
 {
     Guard guard(m_combatLock);
-    if(m_combatTimers.empty())
+    m_combatClock += uiDiff;
+    if(m_combatSlots.empty())
+    {   // Anything left in the wheel is stale, park the cursor on the current slot
+        for(uint8 i = 0; i < COMBAT_WHEEL_SIZE; ++i)
+            m_combatWheel[i].clear();
+        m_combatValidation.clear();
+        m_combatWheelTime = m_combatClock - (m_combatClock % COMBAT_WHEEL_RESOLUTION);
         return;
+    }
 
-    std::vector<std::pair<WoWGuid, WoWGuid>> deletionQueue;
-    // Find combats that have cleared up
-    for(std::map<std::pair<WoWGuid, WoWGuid>, uint32>::iterator itr = m_combatTimers.begin(); itr != m_combatTimers.end(); itr++)
-    {
-        bool toDelete = false;
-        itr->second -= std::min<uint32>(itr->second, uiDiff);
-        Unit *unit1 = GetUnit(itr->first.first), *unit2 = GetUnit(itr->first.second);
-        if(unit1 == NULL || unit2 == NULL)
-            toDelete = true;
-        else if(!(unit1->ValidateAttackTarget(itr->first.second) || unit2->ValidateAttackTarget(itr->first.first)))
-            toDelete = true;
-        else if(itr->second == 0)
-            toDelete = true;
-        if(toDelete == false)
-            continue;
-        // Queue our combat into deletion queue
-        deletionQueue.push_back(itr->first);
-    }
-
-    // Cleaning up finished combat
-    std::for_each(deletionQueue.begin(), deletionQueue.end(), [this](std::pair<WoWGuid, WoWGuid> pair)
-    {
-        // Remove our combatants from our partner lists
-        m_combatPartners[pair.first].erase(pair.second);
-        m_combatPartners[pair.second].erase(pair.first);
-        // Clean up our combat partner list
-        if(m_combatPartners[pair.first].empty())
-            m_combatPartners.erase(pair.first);
-        if(m_combatPartners[pair.second].empty())
-            m_combatPartners.erase(pair.second);
-        m_combatTimers.erase(pair);
-    });
+    // Pairs whose participants changed attack targets or just entered combat
+    std::vector<CombatWheelEntry> validation;
+    validation.swap(m_combatValidation);
+    for(std::vector<CombatWheelEntry>::iterator itr = validation.begin(); itr != validation.end(); itr++)
+        _ValidateCombatPair(itr->index, itr->generation);
 
-    deletionQueue.clear();
+    // Don't spin through the wheel more than once after a long stall
+    if(m_combatClock - m_combatWheelTime >= COMBAT_WHEEL_SIZE*COMBAT_WHEEL_RESOLUTION)
+        m_combatWheelTime = (m_combatClock/COMBAT_WHEEL_RESOLUTION - (COMBAT_WHEEL_SIZE-1))*COMBAT_WHEEL_RESOLUTION;
+
+    // The cursor slot only fires once all of its time has passed
+    std::vector<CombatWheelEntry> slot;
+    for(; m_combatWheelTime + COMBAT_WHEEL_RESOLUTION <= m_combatClock; m_combatWheelTime += COMBAT_WHEEL_RESOLUTION)
+    {
+        slot.clear();
+        slot.swap(m_combatWheel[(m_combatWheelTime/COMBAT_WHEEL_RESOLUTION) % COMBAT_WHEEL_SIZE]);
+        for(std::vector<CombatWheelEntry>::iterator itr = slot.begin(); itr != slot.end(); itr++)
+        {
+            CombatPair &pair = m_combatPairs[itr->index];
+            // Pair was removed, recycled or rescheduled since this entry was queued
+            if(!pair.active || pair.generation != itr->generation || pair.scheduledTime != itr->time)
+                continue;
+            // Entry is from a later lap of the wheel
+            if(itr->time > m_combatClock)
+                m_combatWheel[(itr->time/COMBAT_WHEEL_RESOLUTION) % COMBAT_WHEEL_SIZE].push_back(*itr);
+            else if(pair.expireTime <= m_combatClock)
+                _RemoveCombatPair(itr->index);
+            else _ScheduleCombatPair(itr->index, pair.expireTime);
+        }
+    }
 }
 
 void MapInstance::_PerformPlayerUpdates(uint32 msTime, uint32 uiDiff)
@@ -1685,27 +1795,47 @@ void MapInstance::_PerformDynamicObjectUpdates(uint32 msTime, uint32 uiDiff)
     mDynamicObjectPool.ProcessRemovals();
 }
 
-void MapInstance::_PerformDelayedSpellUpdates(uint32 msTime, uint32 uiDiff)
+void MapInstance::AddProjectile(Spell *spell)
+{
+    Guard guard(m_poolLock);
+    _QueueProjectile(spell, m_projectileClock);
+}
+
+void MapInstance::_QueueProjectile(Spell *spell, uint32 lastTime)
 {
-    projectileSpellUpdateTime[0] += uiDiff;
-    projectileSpellUpdateTime[1] += uiDiff;
-    uint8 index = projectileSpellIndex[0]++;
-    if(projectileSpellIndex[0] == 2)
-        projectileSpellIndex[0] = 0;
+    ProjectileImpact impact;
+    impact.dueTime = m_projectileClock + spell->GetDelayedImpactDelay(this);
+    impact.lastTime = lastTime;
+    impact.spell = spell;
+    m_projectileQueue.push_back(impact);
+    std::push_heap(m_projectileQueue.begin(), m_projectileQueue.end(), ProjectileImpactLater());
+}
 
-    std::vector<Spell*> cleanupSet;
-    for(std::set<Spell*>::iterator itr = m_projectileSpells[index].begin(); itr != m_projectileSpells[index].end(); itr++)
-        if((*itr)->UpdateDelayedTargetEffects(this, projectileSpellUpdateTime[index]))
-            cleanupSet.push_back(*itr);
+void MapInstance::_PerformDelayedSpellUpdates(uint32 msTime, uint32 uiDiff)
+{
+    std::vector<ProjectileImpact> dueImpacts;
+    m_poolLock.Acquire();
+    m_projectileClock += uiDiff;
+    while(!m_projectileQueue.empty() && int32(m_projectileQueue.front().dueTime - m_projectileClock) <= 0)
+    {
+        std::pop_heap(m_projectileQueue.begin(), m_projectileQueue.end(), ProjectileImpactLater());
+        dueImpacts.push_back(m_projectileQueue.back());
+        m_projectileQueue.pop_back();
+    }
+    m_poolLock.Release();
 
-    while(!cleanupSet.empty())
+    for(std::vector<ProjectileImpact>::iterator itr = dueImpacts.begin(); itr != dueImpacts.end(); ++itr)
     {
-        Spell *spell = *cleanupSet.begin();
-        cleanupSet.erase(cleanupSet.begin());
-        m_projectileSpells[index].erase(spell);
-        spell->Destruct();
+        if(itr->spell->UpdateDelayedTargetEffects(this, m_projectileClock - itr->lastTime))
+        {
+            itr->spell->Destruct();
+            continue;
+        }
+
+        // Targets moved away from the missile, reschedule against their new distance
+        Guard guard(m_poolLock);
+        _QueueProjectile(itr->spell, m_projectileClock);
     }
-    projectileSpellUpdateTime[index] = 0;
 }
 
 void MapInstance::_PerformUnitPathUpdates(uint32 msTime, uint32 uiDiff)
@@ -1735,10 +1865,48 @@ void MapInstance::_PerformMovementUpdates(bool includePlayers)
     }
     _movedObjects.clear();
     m_updateMutex.Release();
+
+    // Creature updates have finished, so idle creatures can be handed their candidates
+    _ProcessAggroSensors();
 }
 
+class SessionDecodeTask : public ThreadManager::PoolTask
+{
+public:
+    SessionDecodeTask(std::vector<WorldSession*> *sessions) : _sessions(sessions) { }
+
+    virtual int call()
+    {
+        for(std::vector<WorldSession*>::iterator itr = _sessions->begin(); itr != _sessions->end(); ++itr)
+            (*itr)->DecodeQueuedPackets();
+        return 0;
+    }
+
+private:
+    std::vector<WorldSession*> *_sessions;
+};
+
 void MapInstance::_PerformSessionUpdates()
 {
+    if(_updatePool && MapSessions.size() >= SESSION_DECODE_MIN_SESSIONS)
+    {
+        // Parse queued packets in parallel, handlers that change state still run below in order
+        uint32 taskCount = std::max<uint32>(1, _updatePool->getThreadCount()), count = 0;
+        std::vector<std::vector<WorldSession*> > batches(taskCount);
+        for(SessionSet::iterator itr = MapSessions.begin(); itr != MapSessions.end(); ++itr)
+        {
+            WorldSession *MapSession = (*itr);
+            if(MapSession->GetEventInstanceId() != m_instanceID || MapSession->GetPlayer() == NULL || MapSession->GetPlayer()->GetMapInstance() != this)
+                continue;
+            batches[count++ % taskCount].push_back(MapSession);
+        }
+
+        for(uint32 i = 0; i < taskCount; ++i)
+            if(!batches[i].empty())
+                _updatePool->AddTask(new SessionDecodeTask(&batches[i]));
+        _updatePool->wait();
+    }
+
     // Sessions are updated every loop.
     for(SessionSet::iterator itr = MapSessions.begin(), it2; itr != MapSessions.end();)
     {
@@ -2049,55 +2217,143 @@ bool MapInstance::CheckCombatStatus(Unit *unit)
     if(m_forceCombatState)
         return true;
     if(unit == NULL)
-        return !m_combatPartners.empty();
-    // We have no combat history
-    if(m_combatPartners.find(unit->GetGUID()) == m_combatPartners.end())
-        return false;
-    // We have no combatants
-    if(m_combatPartners.at(unit->GetGUID()).empty())
-        return false;
-
-    return true;
+        return !m_combatSlots.empty();
+    // Units without combatants have no slot entry
+    return m_combatSlots.find(unit->GetGUID()) != m_combatSlots.end();
 }
 
 void MapInstance::ClearCombatTimers(WoWGuid guid, WoWGuid guid2)
 {
     Guard guard(m_combatLock);
     if(guid2.empty())
-    {   // Remove all guids tied to guid1'
-        for(std::set<WoWGuid>::iterator itr = m_combatPartners[guid].begin(); itr != m_combatPartners[guid].end(); itr++)
-        {
-            // Remove our combatant from our partner lists
-            m_combatPartners[*itr].erase(guid);
-            // Clean up our combat partner list
-            if(m_combatPartners[*itr].empty())
-                m_combatPartners.erase(*itr);
-            // Remove combat timer from processing list
-            m_combatTimers.erase(std::make_pair(guid, *itr));
-        }
-        // Clean up our combat partner list
-        m_combatPartners.erase(guid);
+    {   // Remove all pairs tied to guid1
+        std::unordered_map<WoWGuid, std::vector<uint32>>::iterator itr;
+        while((itr = m_combatSlots.find(guid)) != m_combatSlots.end())
+            _RemoveCombatPair(itr->second.back());
         return;
     }
 
-    // Remove our combatants from our partner lists
-    m_combatPartners[guid].erase(guid2);
-    m_combatPartners[guid2].erase(guid);
-    // Clean up our combat partner list
-    if(m_combatPartners[guid].empty())
-        m_combatPartners.erase(guid);
-    if(m_combatPartners[guid2].empty())
-        m_combatPartners.erase(guid2);
-    // Remove combat timer from processing list
-    m_combatTimers.erase(std::make_pair(guid, guid2));
+    uint32 index = _FindCombatPair(guid, guid2);
+    if(index != 0xFFFFFFFF)
+        _RemoveCombatPair(index);
 }
 
 void MapInstance::TriggerCombatTimer(WoWGuid guid, WoWGuid guid2, uint32 timer)
 {
     Guard guard(m_combatLock);
-    m_combatPartners[guid].insert(guid2);
-    m_combatPartners[guid2].insert(guid);
-    m_combatTimers[std::make_pair(guid, guid2)] = timer;
+    uint32 index = _FindCombatPair(guid, guid2), expireTime = m_combatClock + timer;
+    if(index == 0xFFFFFFFF)
+    {
+        if(m_freeCombatPairs.empty())
+        {
+            index = uint32(m_combatPairs.size());
+            m_combatPairs.push_back(CombatPair());
+            m_combatPairs[index].generation = 0;
+        }
+        else
+        {
+            index = m_freeCombatPairs.back();
+            m_freeCombatPairs.pop_back();
+        }
+
+        CombatPair &pair = m_combatPairs[index];
+        pair.unit1 = guid;
+        pair.unit2 = guid2;
+        pair.expireTime = expireTime;
+        pair.active = true;
+        m_combatSlots[guid].push_back(index);
+        m_combatSlots[guid2].push_back(index);
+        _ScheduleCombatPair(index, expireTime);
+    }
+    else
+    {   // Later expiries are picked up when the current wheel entry fires, earlier ones need a new entry
+        CombatPair &pair = m_combatPairs[index];
+        pair.expireTime = expireTime;
+        if(expireTime < pair.scheduledTime)
+            _ScheduleCombatPair(index, expireTime);
+    }
+
+    // Combat only holds while one side is attacking the other
+    CombatWheelEntry entry = { index, m_combatPairs[index].generation, 0 };
+    m_combatValidation.push_back(entry);
+}
+
+void MapInstance::OnCombatTargetChange(WoWGuid guid)
+{
+    Guard guard(m_combatLock);
+    std::unordered_map<WoWGuid, std::vector<uint32>>::iterator itr;
+    if((itr = m_combatSlots.find(guid)) == m_combatSlots.end())
+        return;
+
+    for(std::vector<uint32>::iterator it2 = itr->second.begin(); it2 != itr->second.end(); it2++)
+    {
+        CombatWheelEntry entry = { *it2, m_combatPairs[*it2].generation, 0 };
+        m_combatValidation.push_back(entry);
+    }
+}
+
+uint32 MapInstance::_FindCombatPair(WoWGuid guid, WoWGuid guid2)
+{
+    std::unordered_map<WoWGuid, std::vector<uint32>>::iterator itr;
+    if((itr = m_combatSlots.find(guid)) == m_combatSlots.end())
+        return 0xFFFFFFFF;
+
+    for(std::vector<uint32>::iterator it2 = itr->second.begin(); it2 != itr->second.end(); it2++)
+    {
+        CombatPair &pair = m_combatPairs[*it2];
+        if((pair.unit1 == guid && pair.unit2 == guid2) || (pair.unit1 == guid2 && pair.unit2 == guid))
+            return *it2;
+    }
+    return 0xFFFFFFFF;
+}
+
+void MapInstance::_ScheduleCombatPair(uint32 index, uint32 time)
+{
+    CombatPair &pair = m_combatPairs[index];
+    // Slots behind the wheel cursor have already fired, use the next one instead
+    time = std::max<uint32>(time, m_combatWheelTime);
+    pair.scheduledTime = time;
+
+    CombatWheelEntry entry = { index, pair.generation, time };
+    m_combatWheel[(time/COMBAT_WHEEL_RESOLUTION) % COMBAT_WHEEL_SIZE].push_back(entry);
+}
+
+void MapInstance::_RemoveCombatPair(uint32 index)
+{
+    CombatPair &pair = m_combatPairs[index];
+    WoWGuid guids[2] = { pair.unit1, pair.unit2 };
+    for(uint8 i = 0; i < 2; ++i)
+    {
+        std::unordered_map<WoWGuid, std::vector<uint32>>::iterator itr;
+        if((itr = m_combatSlots.find(guids[i])) == m_combatSlots.end())
+            continue;
+
+        std::vector<uint32>::iterator it2;
+        if((it2 = std::find(itr->second.begin(), itr->second.end(), index)) != itr->second.end())
+        {
+            *it2 = itr->second.back();
+            itr->second.pop_back();
+        }
+        // Clean up our combat slot list
+        if(itr->second.empty())
+            m_combatSlots.erase(itr);
+    }
+
+    // Outstanding wheel and validation entries go stale with the generation bump
+    pair.active = false;
+    ++pair.generation;
+    m_freeCombatPairs.push_back(index);
+}
+
+void MapInstance::_ValidateCombatPair(uint32 index, uint32 generation)
+{
+    CombatPair &pair = m_combatPairs[index];
+    if(!pair.active || pair.generation != generation)
+        return;
+
+    Unit *unit1 = GetUnit(pair.unit1), *unit2 = GetUnit(pair.unit2);
+    if(unit1 == NULL || unit2 == NULL || !(unit1->ValidateAttackTarget(pair.unit2) || unit2->ValidateAttackTarget(pair.unit1)))
+        _RemoveCombatPair(index);
 }
 
 void MapInstance::HookOnAreaTrigger(Player* plr, uint32 id)
@@ -48,6 +48,13 @@ static const uint32 MaxViewDistance = 28000;
 #define TRIGGER_INSTANCE_EVENT( Mgr, Func )
 #define VECTOR_POOLS 1
 
+// Combat timers expire through a wheel of 100ms slots, spanning 6.4 seconds before entries wrap
+#define COMBAT_WHEEL_RESOLUTION 100
+#define COMBAT_WHEEL_SIZE 64
+
+// Below this many sessions the packet pre-pass isn't worth handing to the task pool
+#define SESSION_DECODE_MIN_SESSIONS 8
+
 template <class T> class StoragePoolTask : public ThreadManager::PoolTask
 {
 public:
@@ -320,6 +327,16 @@ protected:
     float _resultDist;
 };
 
+class MapInstanceAggroSensorCallback : public ObjectProcessCallback
+{
+public:
+    MapInstanceAggroSensorCallback(MapInstance *instance) : _instance(instance) {}
+    void operator()(WorldObject *obj, WorldObject *curObj);
+
+protected:
+    MapInstance *_instance;
+};
+
 class MapInstanceBroadcastMessageCallback : public ObjectProcessCallback
 {
 public:
@@ -481,7 +498,6 @@ public:
     typedef std::set<Player*> PlayerSet;
     typedef std::set<Creature*> CreatureSet;
     typedef std::set<GameObject*> GameObjectSet;
-    typedef std::set<WoWGuid> CombatProgressSet;
     typedef Loki::AssocVector<uint32, Creature*> CreatureSqlIdMap;
     typedef Loki::AssocVector<uint32, GameObject* > GameObjectSqlIdMap;
 
@@ -536,16 +552,47 @@ public:
     bool CheckCombatStatus(Unit *unit = NULL);
     void ClearCombatTimers(WoWGuid guid, WoWGuid guid2 = WoWGuid());
     void TriggerCombatTimer(WoWGuid guid, WoWGuid guid2, uint32 timer);
+    // Attack target changes can end combat before the timer runs out
+    void OnCombatTargetChange(WoWGuid guid);
 
 private:
+    struct CombatPair
+    {
+        WoWGuid unit1, unit2;
+        uint32 expireTime, scheduledTime, generation;
+        bool active;
+    };
+
+    struct CombatWheelEntry
+    {
+        uint32 index, generation, time;
+    };
+
+    uint32 _FindCombatPair(WoWGuid guid, WoWGuid guid2);
+    void _ScheduleCombatPair(uint32 index, uint32 time);
+    void _RemoveCombatPair(uint32 index);
+    void _ValidateCombatPair(uint32 index, uint32 generation);
+
     Mutex m_combatLock;
     bool m_forceCombatState;
-    std::map<WoWGuid, std::set<WoWGuid>> m_combatPartners;
-    std::map<std::pair<WoWGuid, WoWGuid>, uint32> m_combatTimers;
+    uint32 m_combatClock, m_combatWheelTime;
+
+    // Pairs are stored densely and recycled, each unit keeps the indices of the pairs it belongs to
+    std::vector<CombatPair> m_combatPairs;
+    std::vector<uint32> m_freeCombatPairs;
+    std::unordered_map<WoWGuid, std::vector<uint32>> m_combatSlots;
+    // Only pairs in a firing wheel slot or flagged for validation are looked at on update
+    std::vector<CombatWheelEntry> m_combatWheel[COMBAT_WHEEL_SIZE], m_combatValidation;
 
 public:
     // Cell walking functions
     Unit *FindInRangeTarget(Creature *ctr, float range, uint32 typeMask);
+    Unit *FindInRangeTarget(Creature *ctr, float range, uint32 typeMask, std::vector<WoWGuid> &candidates);
+
+    // Queues a wake up for every idle creature whose aggro radius we've moved into, walked after movement updates
+    void TriggerAggroSensors(Unit *unit);
+    // Widens the sensor walk so creatures with a larger aggro radius are still found
+    void RaiseAggroSensorRange(float aggroRange);
 
     void MessageToCells(WorldObject *obj, uint16 opcodeId, uint16 Len, const void *data, float range);
     void MessageToCells(WorldObject *obj, WorldPacket *data, float range, bool myTeam, uint32 teamId);
@@ -568,6 +615,16 @@ protected:
     friend class MapInstanceObjectRemovalCallback;
     MapInstanceObjectRemovalCallback _removalCallback;
 
+    // Triggers come in from pool threads, the walk itself only runs from movement processing on the map thread
+    friend class MapInstanceAggroSensorCallback;
+    MapInstanceAggroSensorCallback _aggroSensorCallback;
+    Mutex m_aggroSensorLock;
+    std::set<WoWGuid> _pendingAggroSensors;
+    std::vector<uint32> _aggroSensorCells;
+    float _aggroSensorRange;
+
+    void _ProcessAggroSensors();
+
     typedef CallbackStack<MapInstanceInRangeTargetCallback> InrangeTargetCallbackStack;
     friend class MapInstanceInRangeTargetCallback;
     InrangeTargetCallbackStack _inRangeTargetCBStack;
@@ -668,15 +725,7 @@ public:
     void BeginInstanceExpireCountdown();
     void HookOnAreaTrigger(Player* plr, uint32 id);
 
-    RONIN_INLINE void AddProjectile(Spell *spell)
-    {
-        m_poolLock.Acquire();
-        uint8 index = projectileSpellIndex[1]++;
-        if(projectileSpellIndex[1] == 2)
-            projectileSpellIndex[1] = 0;
-        m_projectileSpells[index].insert(spell);
-        m_poolLock.Release();
-    }
+    void AddProjectile(Spell *spell);
 
 protected: ///! Instance identification data
     //! Our instance's map ID
@@ -703,7 +752,7 @@ protected: ///! Objects that exist on map
     friend class ObjectCellManager;
     friend class PlayerCellManager;
     bool UpdateCellData(WorldObject *Obj, uint32 cellX, uint32 cellY, bool playerObj, bool priority);
-    void RemoveCellData(WorldObject *Obj, std::set<uint32> &set, bool forced);
+    void RemoveCellData(WorldObject *Obj, std::vector<uint32> &set, bool forced);
 
 public:
     bool IsPreloading() { return m_mapPreloading; }
@@ -742,11 +791,16 @@ public:
     StoragePool<DynamicObject> mDynamicObjectPool;
     StoragePool<UnitPathSystem> mUnitPathPool;
 
-    // Storage pool setup for projectile spells
-    uint32 projectileSpellUpdateTime[2];
-    uint8 projectileSpellIndex[2];
-    std::set<Spell*> m_projectileSpells[2];
-    // End storage pool setup for projectile spells
+    // Projectile spells ordered by their next impact, only due entries are touched each tick
+    struct ProjectileImpact
+    {
+        uint32 dueTime, lastTime;
+        Spell *spell;
+    };
+    struct ProjectileImpactLater { bool operator()(const ProjectileImpact &a, const ProjectileImpact &b) const { return int32(a.dueTime - b.dueTime) > 0; } };
+    std::vector<ProjectileImpact> m_projectileQueue;
+    uint32 m_projectileClock;
+    void _QueueProjectile(Spell *spell, uint32 lastTime);
 
     CBattleground* m_battleground;
     std::vector<Corpse* > m_corpses;
@@ -99,10 +99,10 @@ int VMapInterface::ActivateTile(uint32 mapId, uint32 tileX, uint32 tileY, FILE *
     if( loadData->m_tileLoadCount[tileX][tileY] == 0 )
     {
         if(vMapMgr->loadMap(mapId, tileX, tileY, file))
-            sLog.outDebug("Loading VMap [%u/%u] successful", tileX, tileY);
+            OUT_DEBUG("Loading VMap [%u/%u] successful", tileX, tileY);
         else
         {
-            sLog.outDebug("Loading VMap [%u/%u] unsuccessful", tileX, tileY);
+            OUT_DEBUG("Loading VMap [%u/%u] unsuccessful", tileX, tileY);
             loadData->m_lock.Release();
             return 0;
         }
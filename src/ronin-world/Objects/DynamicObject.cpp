@@ -21,6 +21,8 @@
 
 #include "StdAfx.h"
 
+IMPLEMENT_SLAB_ALLOCATION(DynamicObject, sizeof(DynamicObject));
+
 DynamicObject::DynamicObject(uint32 high, uint32 low, uint32 fieldCount) : WorldObject(MAKE_NEW_GUID(low, 0, high), fieldCount)
 {
     SetTypeFlags(TYPEMASK_TYPE_DYNAMICOBJECT);
@@ -38,6 +38,7 @@ class SERVER_DECL DynamicObject : public WorldObject
 public:
     DynamicObject( uint32 high, uint32 low, uint32 fieldCount = DYNAMICOBJECT_END );
     ~DynamicObject( );
+    DECLARE_SLAB_ALLOCATION();
     virtual void Init();
     virtual void Destruct();
     virtual void Update(uint32 msTime, uint32 uiDiff);
@@ -21,6 +21,8 @@
 
 #include "StdAfx.h"
 
+IMPLEMENT_SLAB_ALLOCATION(GameObject, sizeof(GameObject));
+
 GameObject::GameObject(GameObjectInfo *info, WoWGuid guid, uint32 fieldCount) : WorldObject(guid, fieldCount)
 {
     pInfo = info;
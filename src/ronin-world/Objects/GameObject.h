@@ -541,6 +541,7 @@ class SERVER_DECL GameObject : public WorldObject
 public:
     GameObject(GameObjectInfo *info, WoWGuid guid, uint32 fieldCount = GAMEOBJECT_END);
     ~GameObject( );
+    DECLARE_SLAB_ALLOCATION();
 
     virtual void Init();
     virtual void Destruct();
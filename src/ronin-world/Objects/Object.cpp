@@ -631,7 +631,7 @@ void ObjectCellManager::OnRelocate(MapInstance *instance, LocationVector &destin
     if(!(posX < _lowX || posX > _highX || posY < _lowY || posY > _highY))
         return;
 
-    std::set<uint32> cellSet;
+    std::vector<uint32> cellSet;
     for(uint16 x = _lowX; x <= _highX; x++)
     {
         for(uint16 y = _lowY; y <= _highY; y++)
@@ -639,7 +639,7 @@ void ObjectCellManager::OnRelocate(MapInstance *instance, LocationVector &destin
             if(cutCorners && isCorner(x, y, _lowX, _highX, _lowY, _highY, VisibleCellRange))
                 continue;
 
-            cellSet.insert(_makeCell(x, y));
+            cellSet.push_back(_makeCell(x, y));
         }
     }
 
@@ -651,14 +651,12 @@ void ObjectCellManager::ClearInRangeObjects(MapInstance *instance)
     _visRange = _currX = _currY = 0;
     _lowX = _lowY = _highX = _highY = 0;
 
-    // Clear our visible spectrum,
-    while(!m_visibleTo.empty())
-    {
-        WoWGuid guid = *m_visibleTo.begin();
-        m_visibleTo.erase(m_visibleTo.begin());
-        if(Player *plr = instance->GetPlayer(guid))
+    // Clear our visible spectrum, erasing shifts the flat set so walk a detached copy
+    FlatGuidSet visibleTo;
+    visibleTo.swap(m_visibleTo);
+    for(FlatGuidSet::const_iterator itr = visibleTo.begin(); itr != visibleTo.end(); ++itr)
+        if(Player *plr = instance->GetPlayer(*itr))
             plr->RemoveIfVisible(instance->GetMapId(), _object);
-    }
 
     instance->RemoveCachedCell(_object->GetGUID());
     if(MapCell *cell = _object->GetMapCell())
@@ -773,20 +771,8 @@ void ObjectCellManager::Update(MapInstance *instance, uint32 msTime, uint32 uiDi
 
 void ObjectCellManager::SetCurrentCell(MapInstance *instance, float newX, float newY, float newZ, uint8 cellRange)
 {
-    std::set<uint32> prev;
-    std::vector<uint32> newCells;
-    if(instance && _visRange)
-    {
-        for(uint16 x = _lowX; x <= _highX; x++)
-        {
-            for(uint16 y = _lowY; y <= _highY; y++)
-            {
-                if(cutCorners && isCorner(x, y, _lowX, _highX, _lowY, _highY, VisibleCellRange))
-                    continue;
-                prev.insert(_makeCell(x, y));
-            }
-        }
-    }
+    bool hadCells = instance && _visRange;
+    uint16 oldLowX = _lowX, oldHighX = _highX, oldLowY = _lowY, oldHighY = _highY;
 
     _luX = newX;
     _luY = newY;
@@ -804,28 +790,25 @@ void ObjectCellManager::SetCurrentCell(MapInstance *instance, float newX, float
     if(instance == NULL)
         return;
 
+    // New cells are in the new bounds but not the old, removals are the reverse
+    std::vector<uint32> newCells, oldCells;
     for(uint16 x = _lowX; x <= _highX; x++)
-    {
         for(uint16 y = _lowY; y <= _highY; y++)
-        {
-            if(cutCorners && isCorner(x, y, _lowX, _highX, _lowY, _highY, VisibleCellRange))
-                continue;
-            uint32 cellId = _makeCell(x, y);
-            if(prev.find(cellId) != prev.end())
-            {   // We already have this cell, remove from previous cell removal set
-                prev.erase(cellId); 
-                continue;
-            }
+            if(inCellBounds(x, y, _lowX, _highX, _lowY, _highY) && !(hadCells && inCellBounds(x, y, oldLowX, oldHighX, oldLowY, oldHighY)))
+                newCells.push_back(_makeCell(x, y));
 
-            // Add new cells to processing vector
-            newCells.push_back(cellId);
-        }
+    if(hadCells)
+    {
+        for(uint16 x = oldLowX; x <= oldHighX; x++)
+            for(uint16 y = oldLowY; y <= oldHighY; y++)
+                if(inCellBounds(x, y, oldLowX, oldHighX, oldLowY, oldHighY) && !inCellBounds(x, y, _lowX, _highX, _lowY, _highY))
+                    oldCells.push_back(_makeCell(x, y));
     }
 
     // Update for our current cell here, other cell updates will occur in WorldObject::Update
     instance->UpdateObjectCellVisibility(_object, &newCells);
     // Push calls to remove cell data
-    instance->RemoveCellData(_object, prev, false);
+    instance->RemoveCellData(_object, oldCells, false);
 }
 
 uint32 ObjectCellManager::_getCellId(float pos)
@@ -356,7 +356,7 @@ protected:
 
     RONIN_INLINE bool isCorner(uint16 x, uint16 y, uint16 lX, uint16 hX, uint16 lY, uint16 hY, uint16 visRange = 0)
     {
-        uint16 lowX = _lowX, highX = _highX, lowY = _lowY, highY = _highY;
+        uint16 lowX = lX, highX = hX, lowY = lY, highY = hY;
         if(visRange > 1)
         {
             // We can just add the range extension here
@@ -375,6 +375,14 @@ protected:
         return false;
     }
 
+    // Whether a cell falls inside the given bounds, corners excluded when we're cutting them
+    RONIN_INLINE bool inCellBounds(uint16 x, uint16 y, uint16 lX, uint16 hX, uint16 lY, uint16 hY)
+    {
+        if(x < lX || x > hX || y < lY || y > hY)
+            return false;
+        return !(cutCorners && isCorner(x, y, lX, hX, lY, hY, VisibleCellRange));
+    }
+
     uint16 _visRange;
     uint16 _currX, _currY, _lowX, _lowY, _highX, _highY;
 
@@ -382,7 +390,7 @@ protected:
     float _luX, _luY, _luZ;
 
     // Players that can see us
-    std::set<WoWGuid> m_visibleTo;
+    FlatGuidSet m_visibleTo;
 };
 
 //===============================================
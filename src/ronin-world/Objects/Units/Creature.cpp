@@ -27,6 +27,8 @@
 
 #define M_PI 3.14159265358979323846f
 
+IMPLEMENT_SLAB_ALLOCATION(Creature, sizeof(Creature));
+
 Creature::Creature(CreatureData *data, uint64 guid) : Unit(guid), _creatureData(data), m_aiInterface(this, m_movementInterface.GetPath())
 {
     SetEntry(data->entry);
@@ -83,30 +85,10 @@ void Creature::Init()
 
     m_aiInterface.Init();
 
-    for(std::vector<uint32>::iterator itr = _creatureData->combatSpells.begin(); itr != _creatureData->combatSpells.end(); itr++)
-    {
-        if(SpellEntry *spellEntry = dbcSpell.LookupEntry(*itr))
-        {
-            if(spellEntry->isSpellAuraApplicator() && !spellEntry->isNegativeSpell1())
-                continue; // These aren't combat spells
-
-            CreatureSpell *spell = new CreatureSpell();
-            spell->spellEntry = spellEntry;
-            // Soonest cast time is the least of our cooldowns
-            spell->castTimer = std::min<uint32>(spellEntry->StartRecoveryTime, std::min<uint32>(spellEntry->CategoryRecoveryTime, spellEntry->RecoveryTime));
-            // Cast cooldown is based on the highest of our cooldowns
-            spell->cooldownTimer = std::max<uint32>(spellEntry->StartRecoveryTime, std::max<uint32>(spellEntry->CategoryRecoveryTime, spellEntry->RecoveryTime));
-            // Aura applicator check
-            if(spellEntry->isSpellAuraApplicator()) // If we're applying an aura, make sure that we don't recast within the duration time
-                spell->cooldownTimer += (spellEntry->Duration[0] > 0 ? spellEntry->Duration[0] : spellEntry->Duration[1] > 0 ? spellEntry->Duration[1] : spellEntry->Duration[2] > 0 ? spellEntry->Duration[2] : 0);
-            // Push back the cast timer a bit
-            if(spell->castTimer == 0 || spell->castTimer == spell->cooldownTimer)
-                spell->castTimer += spell->castTimer ? 2000 : 5000;
-            if(spell->cooldownTimer < 5000)
-                spell->cooldownTimer = 5000;
-            m_combatSpells.push_back(spell);
-        }
-    }
+    // Combat spell timers are precomputed per entry, each spawn only needs its own copy
+    if(CreatureSpawnTemplate *tmpl = _creatureData->spawnTemplate)
+        for(std::vector<CreatureSpell>::iterator itr = tmpl->combatSpells.begin(); itr != tmpl->combatSpells.end(); itr++)
+            m_combatSpells.push_back(new CreatureSpell(*itr));
 
     if(uint32 vehicleKitId = _creatureData->vehicleEntry)
         InitVehicleKit(vehicleKitId);
@@ -190,10 +172,9 @@ void Creature::UpdateFieldValues()
 {
     if(m_modQueuedModUpdates.find(100) != m_modQueuedModUpdates.end())
     {
-        m_aggroRangeMod = 0.f;
-        if(AuraInterface::modifierMap *modMap = m_AuraInterface.GetModMapByModType(SPELL_AURA_MOD_DETECT_RANGE))
-            for(AuraInterface::modifierMap::iterator itr = modMap->begin(); itr != modMap->end(); itr++)
-                m_aggroRangeMod += itr->second->m_amount;
+        m_aggroRangeMod = float(m_AuraInterface.GetModTypeTotal(SPELL_AURA_MOD_DETECT_RANGE));
+        if(m_mapInstance)
+            m_mapInstance->RaiseAggroSensorRange(GetAggroRange());
     }
     Unit::UpdateFieldValues();
 }
@@ -203,7 +184,8 @@ void Creature::OnAuraModChanged(uint32 modType)
     switch(modType)
     {
     case SPELL_AURA_MOD_DETECT_RANGE:
-        m_modQueuedModUpdates[100].push_back(modType);
+        if(m_modQueuedModUpdates[100].empty())
+            m_modQueuedModUpdates[100].push_back(modType);
         break;
     }
     Unit::OnAuraModChanged(modType);
@@ -932,8 +914,11 @@ void Creature::Load(uint32 mapId, float x, float y, float z, float o, uint32 mod
         WorldObject::Deactivate(5000);
     }
 
+    // Everything derived from the prototype alone is looked up once per entry
+    CreatureSpawnTemplate *tmpl = _creatureData->spawnTemplate;
+
     // Set our extra data pointer
-    _extraInfo = CreatureInfoExtraStorage.LookupEntry(GetEntry());
+    _extraInfo = tmpl ? tmpl->extraInfo : CreatureInfoExtraStorage.LookupEntry(GetEntry());
 
     // Set our phase mask
     m_phaseMask = m_spawn ? m_spawn->phaseMask : m_phaseMask;
@@ -950,8 +935,25 @@ void Creature::Load(uint32 mapId, float x, float y, float z, float o, uint32 mod
     for(uint8 i = 0; i < 7; i++)
         SetUInt32Value(UNIT_FIELD_RESISTANCES+i, _creatureData->resistances[i]);
 
-    uint8 race = RACE_HUMAN;
-    if(CreatureDisplayInfoEntry *displayEntry = dbcCreatureDisplayInfo.LookupEntry(model))
+    uint8 race = RACE_HUMAN, modelSlot = 4;
+    for(uint8 i = 0; tmpl && model && i < 4; i++)
+    {
+        if(_creatureData->displayInfo[i] == model)
+        {
+            modelSlot = i;
+            break;
+        }
+    }
+
+    if(modelSlot < 4)
+    {
+        race = tmpl->modelRace[modelSlot];
+        if(tmpl->modelZoneVisible[modelSlot])
+            m_zoneVisibleSpawn = true;
+        else if(tmpl->modelAreaVisible[modelSlot])
+            m_areaVisibleSpawn = true;
+    }
+    else if(CreatureDisplayInfoEntry *displayEntry = dbcCreatureDisplayInfo.LookupEntry(model))
     {
         if(CreatureDisplayInfoExtraEntry *extraInfo = dbcCreatureDisplayInfoExtra.LookupEntry(displayEntry->ExtraDisplayInfoEntry))
             race = extraInfo->Race;
@@ -1000,7 +1002,7 @@ void Creature::Load(uint32 mapId, float x, float y, float z, float o, uint32 mod
         objmgr.FillVendorList(GetEntry(), GetVendorMask(), m_vendorItems);
 
     if(!reload && HasFlag(UNIT_NPC_FLAGS, UNIT_NPC_FLAG_TRAINER|UNIT_NPC_FLAG_TRAINER_PROF))
-        m_trainerData = objmgr.GetTrainerData(GetEntry());
+        m_trainerData = tmpl ? tmpl->trainerData : objmgr.GetTrainerData(GetEntry());
 
     if (!reload && HasFlag(UNIT_NPC_FLAGS, UNIT_NPC_FLAG_TAXIVENDOR))
         sTaxiMgr.GetNearestTaxiNodes(mapId, x, y, z, m_taxiNode);
@@ -1009,13 +1011,13 @@ void Creature::Load(uint32 mapId, float x, float y, float z, float o, uint32 mod
         _LoadQuests();
 
     if (!reload && HasFlag(UNIT_NPC_FLAGS, UNIT_NPC_FLAG_AUCTIONEER))
-        auctionHouse = sAuctionMgr.GetAuctionHouse(GetEntry());
+        auctionHouse = tmpl ? tmpl->auctionHouse : sAuctionMgr.GetAuctionHouse(GetEntry());
 
     // load formation data
     Formation* form = NULL;//m_spawn ? sObjMgr.GetFormation(m_spawn->id) : NULL;
 
     //////////////AI
-    myFamily = dbcCreatureFamily.LookupEntry(_creatureData->family);
+    myFamily = tmpl ? tmpl->family : dbcCreatureFamily.LookupEntry(_creatureData->family);
 
     //CanMove (overrules AI)
     if(!GetCanMove())
@@ -1023,21 +1025,26 @@ void Creature::Load(uint32 mapId, float x, float y, float z, float o, uint32 mod
 
     m_invisFlag = _creatureData->invisType;
 
-    if(uint32 tmpitemid = _creatureData->inventoryItem[0])
+    if(tmpl)
+        b_has_shield = (m_shieldProto = tmpl->shieldProto) != NULL;
+    else
     {
-        if(ItemDataEntry* DBCItem = db2Item.LookupEntry(tmpitemid))
+        if(uint32 tmpitemid = _creatureData->inventoryItem[0])
         {
-            if(DBCItem->InventoryType == INVTYPE_SHIELD)
-                b_has_shield = (m_shieldProto = sItemMgr.LookupEntry(tmpitemid)) != NULL;
+            if(ItemDataEntry* DBCItem = db2Item.LookupEntry(tmpitemid))
+            {
+                if(DBCItem->InventoryType == INVTYPE_SHIELD)
+                    b_has_shield = (m_shieldProto = sItemMgr.LookupEntry(tmpitemid)) != NULL;
+            }
         }
-    }
 
-    if(uint32 tmpitemid = _creatureData->inventoryItem[1])
-    {
-        if(ItemDataEntry* DBCItem = db2Item.LookupEntry(tmpitemid))
+        if(uint32 tmpitemid = _creatureData->inventoryItem[1])
         {
-            if(!b_has_shield && DBCItem->InventoryType == INVTYPE_SHIELD)
-                b_has_shield = (m_shieldProto = sItemMgr.LookupEntry(tmpitemid)) != NULL;
+            if(ItemDataEntry* DBCItem = db2Item.LookupEntry(tmpitemid))
+            {
+                if(!b_has_shield && DBCItem->InventoryType == INVTYPE_SHIELD)
+                    b_has_shield = (m_shieldProto = sItemMgr.LookupEntry(tmpitemid)) != NULL;
+            }
         }
     }
 
@@ -22,7 +22,9 @@
 #pragma once
 
 class AIInterface;
+class AuctionHouse;
 class CreatureTemplate;
+struct ItemPrototype;
 
 #define MAX_CREATURE_ITEMS 128
 #define MAX_CREATURE_LOOT 8
@@ -212,7 +214,24 @@ struct CreatureSpell
     SpellEntry *spellEntry;
 };
 
-class AuctionHouse;
+/** Immutable per entry spawn state
+ * Everything Creature::Load and Init would otherwise look up or derive from the prototype for each spawn.
+ * Built once after all world data is loaded, spawns copy from it.
+ */
+struct CreatureSpawnTemplate
+{
+    CreatureInfoExtra *extraInfo;
+    CreatureFamilyEntry *family;
+    TrainerData *trainerData;
+    AuctionHouse *auctionHouse;
+    ItemPrototype *shieldProto;
+
+    // Display data per CreatureData::displayInfo slot
+    uint8 modelRace[4];
+    bool modelZoneVisible[4], modelAreaVisible[4];
+
+    std::vector<CreatureSpell> combatSpells;
+};
 
 #define TRIGGER_AI_EVENT(obj, func)
 
@@ -225,6 +244,7 @@ class SERVER_DECL Creature : public Unit
 public:
     Creature(CreatureData *data, uint64 guid);
     virtual ~Creature();
+    DECLARE_SLAB_ALLOCATION();
     virtual void Init();
     virtual void Destruct();
     virtual void Reactivate();
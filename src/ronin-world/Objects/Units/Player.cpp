@@ -69,45 +69,33 @@ void PlayerCellManager::SetCurrentCell(MapInstance *instance, float newX, float
     _delayedCells[0].clear();
     _delayedCells[1].clear();
 
-    std::set<uint32> preProcessed;
-    // Push old processed data to preProcessed group
-    if(_lowX != _highX && _lowY != _highY)
-    {
-        for(uint16 x = _lowX; x <= _highX; x++)
-            for(uint16 y = _lowY; y <= _highY; y++)
-                preProcessed.insert(_makeCell(x, y));
-    }
+    // Old bounds were fully processed, cells inside them carry over without reprocessing
+    bool hadCells = (_lowX != _highX && _lowY != _highY);
+    uint16 oldLowX = _lowX, oldHighX = _highX, oldLowY = _lowY, oldHighY = _highY;
     // Clear old processed cells
     _processedCells.clear();
     // Push current cell to proccessed, we'll handle it in this function
     _processedCells.insert(_makeCell(_currX, _currY));
 
+    uint16 innerLowX = 1, innerHighX = 0, innerLowY = 1, innerHighY = 0;
+    bool outerCells = false;
     if(cellRange)
     {   // Fill priority cells from a range of 1
-        _lowX = _currX >= 1 ? _currX-1 : 0;
-        _lowY = _currY >= 1 ? _currY-1 : 0;
-        _highX = std::min<uint16>(_currX+1, _sizeX-1);
-        _highY = std::min<uint16>(_currY+1, _sizeY-1);
+        _lowX = innerLowX = _currX >= 1 ? _currX-1 : 0;
+        _lowY = innerLowY = _currY >= 1 ? _currY-1 : 0;
+        _highX = innerHighX = std::min<uint16>(_currX+1, _sizeX-1);
+        _highY = innerHighY = std::min<uint16>(_currY+1, _sizeY-1);
         for(uint16 x = _lowX; x <= _highX; x++)
         {
             for(uint16 y = _lowY; y <= _highY; y++)
             {
                 uint32 cellId = _makeCell(x, y);
-
                 // Check to see if we're a preprocessed cell
-                if(preProcessed.find(cellId) != preProcessed.end())
-                {
+                if(hadCells && x >= oldLowX && x <= oldHighX && y >= oldLowY && y <= oldHighY)
                     _processedCells.insert(cellId);
-                    preProcessed.erase(cellId);
-                    continue;
-                }
-
-                // Skip processed cells(current usually)
-                if(_processedCells.find(cellId) != _processedCells.end())
-                    continue;
-
-                // Add as a priority delayed cell
-                _delayedCells[0].insert(cellId);
+                // Skip the current cell, otherwise add as a priority delayed cell
+                else if(x != _currX || y != _currY)
+                    _delayedCells[0].insert(cellId);
             }
         }
 
@@ -120,7 +108,8 @@ void PlayerCellManager::SetCurrentCell(MapInstance *instance, float newX, float
             _highY = std::min<uint16>(_currY+cellRange, _sizeY-1);
 
             // Only add extra cells if we're a player
-            if(_object->IsPlayer())
+            outerCells = _object->IsPlayer();
+            if(outerCells)
             {
                 for(uint16 x = _lowX; x <= _highX; x++)
                 {
@@ -131,24 +120,18 @@ void PlayerCellManager::SetCurrentCell(MapInstance *instance, float newX, float
                         // To improve functionality of the client and not affect how our view distance is
                         // Actually perceived by the client, only really affects visibility since creatures
                         // Can use cell walkers outside of their range set if needed
-                        if(cutCorners && isCorner(x, y, _lowX, _highX, _lowY, _highY, VisibleCellRange))
+                        if(!inCellBounds(x, y, _lowX, _highX, _lowY, _highY))
+                            continue;
+                        // Priority cells were handled above
+                        if(x >= innerLowX && x <= innerHighX && y >= innerLowY && y <= innerHighY)
                             continue;
 
                         uint32 cellId = _makeCell(x, y);
                         // Check to see if we're a preprocessed cell
-                        if(preProcessed.find(cellId) != preProcessed.end())
-                        {
+                        if(hadCells && x >= oldLowX && x <= oldHighX && y >= oldLowY && y <= oldHighY)
                             _processedCells.insert(cellId);
-                            preProcessed.erase(cellId);
-                            continue;
-                        }
-
-                        // Skip processed cells(current usually)
-                        if(_processedCells.find(cellId) != _processedCells.end())
-                            continue;
-
                         // Add as a low priority delayed cell
-                        _delayedCells[1].insert(cellId);
+                        else _delayedCells[1].insert(cellId);
                     }
                 }
             }
@@ -166,6 +149,23 @@ void PlayerCellManager::SetCurrentCell(MapInstance *instance, float newX, float
         return;
     }
 
+    // Old cells outside of everything we just walked need their data removed
+    std::vector<uint32> preProcessed;
+    if(hadCells)
+    {
+        for(uint16 x = oldLowX; x <= oldHighX; x++)
+        {
+            for(uint16 y = oldLowY; y <= oldHighY; y++)
+            {
+                if(x >= innerLowX && x <= innerHighX && y >= innerLowY && y <= innerHighY)
+                    continue;
+                if(outerCells && inCellBounds(x, y, _lowX, _highX, _lowY, _highY))
+                    continue;
+                preProcessed.push_back(_makeCell(x, y));
+            }
+        }
+    }
+
     // Update for our current cell here, other cell updates will occur in WorldObject::Update
     instance->UpdateCellData(_object, _currX, _currY, _object->IsPlayer(), true);
     // Push calls to remove cell data
@@ -294,6 +294,8 @@ Player::Player(PlayerInfo *pInfo, WorldSession *session, uint32 fieldCount) : Un
     PreventRes                      = false;
     m_drunkTimer                    = 0;
     m_drunk                         = 0;
+    m_partyUpdateFlags              = 0;
+    m_partyUpdateTimer              = 0;
     m_hasSentMoTD = false;
     m_cooldownCheat = false;
     CastTimeCheat = false;
@@ -529,6 +531,14 @@ void Player::Update(uint32 msTime, uint32 diff)
 
     ProcessPendingItemUpdates();
 
+    if((m_partyUpdateTimer += diff) >= GROUP_MEMBER_STATS_INTERVAL)
+    {
+        m_partyUpdateTimer = 0;
+        if(uint32 partyFlags = m_partyUpdateFlags.exchange(0))
+            if(Group *group = GetGroup())
+                group->FlushMemberStats(this, partyFlags);
+    }
+
     if(m_KickDelay)
     {
         if(m_KickDelay <= diff)
@@ -1277,7 +1287,7 @@ void Player::DeleteFromDB(WoWGuid guid)
     CharacterDatabase.Execute("DELETE FROM account_characters WHERE charGuid = '%u';", guid.getLow());
     CharacterDatabase.Execute("DELETE FROM auctions WHERE owner = %u", guid.getLow());
     CharacterDatabase.Execute("DELETE FROM charters WHERE leaderGuid = %u", guid.getLow());
-    CharacterDatabase.Execute("DELETE FROM mailbox WHERE player_guid = %u", guid.getLow());
+    sMailSystem.DeletePlayerMail(guid.getLow());
     CharacterDatabase.Execute("DELETE FROM guild_members WHERE playerid = %u", guid.getLow());
     CharacterDatabase.Execute("DELETE FROM item_enchantments WHERE itemguid IN(SELECT itemguid FROM item_data WHERE ownerguid = %u)", guid.getLow());
     CharacterDatabase.Execute("DELETE FROM item_data WHERE ownerguid = %u", guid.getLow());
@@ -1341,7 +1351,7 @@ bool Player::LoadFromDB()
     q->AddQuery("SELECT * FROM character_talents WHERE guid = '%u'", m_objGuid.getLow());
     q->AddQuery("SELECT * FROM character_taximasks WHERE guid = '%u'", m_objGuid.getLow());
     q->AddQuery("SELECT * FROM character_timestamps WHERE guid = '%u'", m_objGuid.getLow());
-    CharacterDatabase.QueueAsyncQuery(q);
+    CharacterDatabase.QueueDeferredAsyncQuery(q);
     return true;
 }
 
@@ -1459,6 +1469,7 @@ void Player::LoadFromDBProc(QueryResultVector & results)
         m_talentInterface.ResetAllSpecs();
 
     m_playerInfo->m_loggedInPlayer = this;
+    guildmgr.SetMemberOnline(m_playerInfo, true);
 
     m_session->FullLogin(this);
 
@@ -3791,7 +3802,7 @@ void Player::ProcessVisibleQuestGiverStatus()
     uint32 count = 0;
     WorldPacket data(SMSG_QUESTGIVER_STATUS_MULTIPLE, 1000);
     data << count;
-    for(std::set<WoWGuid>::iterator itr = m_visibleObjects.begin(); itr != m_visibleObjects.end(); itr++)
+    for(FlatGuidSet::const_iterator itr = m_visibleObjects.begin(); itr != m_visibleObjects.end(); ++itr)
     {
         if(WorldObject *curObj = GetInRangeObject(*itr))
         {
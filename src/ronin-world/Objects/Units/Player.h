@@ -960,6 +960,7 @@ public:
     /************************************************************************/
     void EventGroupFullUpdate();
     void GroupUninvite(Player* player, PlayerInfo *info);
+    RONIN_INLINE void AddPartyUpdateFlags(uint32 flags) { m_partyUpdateFlags.fetch_or(flags); }
 
     void ClearGroupInviter() { m_GroupInviter.Clean(); }
     void SetInviter(WoWGuid pInviter) { m_GroupInviter = pInviter; }
@@ -1112,32 +1113,19 @@ public:
 
     // Visible objects
     bool CanSee(WorldObject* obj);
-    RONIN_INLINE bool IsVisible(WoWGuid guid) { return !(m_visibleObjects.find(guid) == m_visibleObjects.end()); }
-    RONIN_INLINE bool IsVisible(WorldObject* pObj) { return !(m_visibleObjects.find(pObj->GetGUID()) == m_visibleObjects.end()); }
+    RONIN_INLINE bool IsVisible(WoWGuid guid) { return m_visibleObjects.contains(guid); }
+    RONIN_INLINE bool IsVisible(WorldObject* pObj) { return m_visibleObjects.contains(pObj->GetGUID()); }
 
     void ClearInRangeObjects();
     RONIN_INLINE void AddVisibleObject(WorldObject* pObj) { m_visibleObjects.insert(pObj->GetGUID()); }
     RONIN_INLINE void RemoveVisibleObject(WorldObject* pObj) { m_visibleObjects.erase(pObj->GetGUID()); }
-    RONIN_INLINE void RemoveVisibleObject(std::set<WoWGuid>::iterator itr) { m_visibleObjects.erase(itr); }
-    RONIN_INLINE std::set<WoWGuid>::iterator FindVisible(WorldObject* obj) { return m_visibleObjects.find(obj->GetGUID()); }
     RONIN_INLINE void RemoveIfVisible(uint16 mapId, WorldObject* obj)
     {
-        std::set<WoWGuid>::iterator itr = m_visibleObjects.find(obj->GetGUID());
-        if(itr == m_visibleObjects.end())
-            return;
-
-        m_visibleObjects.erase(obj->GetGUID());
-        PushOutOfRange(mapId, obj->GetGUID());
-    }
-
-    RONIN_INLINE bool GetVisibility(WorldObject* obj, std::set<WoWGuid>::iterator *itr)
-    {
-        *itr = m_visibleObjects.find(obj->GetGUID());
-        return ((*itr) != m_visibleObjects.end());
+        if(m_visibleObjects.erase(obj->GetGUID()))
+            PushOutOfRange(mapId, obj->GetGUID());
     }
 
-    RONIN_INLINE std::set<WoWGuid>::iterator GetVisibleSetBegin() { return m_visibleObjects.begin(); }
-    RONIN_INLINE std::set<WoWGuid>::iterator GetVisibleSetEnd() { return m_visibleObjects.end(); }
+    RONIN_INLINE const FlatGuidSet &GetVisibleSet() { return m_visibleObjects; }
 
     void ProcessVisibleQuestGiverStatus();
 
@@ -1569,7 +1557,7 @@ public:
     std::set<uint32> m_channels;
     std::map<uint32, Channel*> m_channelsbyDBCID;
     // Visible objects
-    std::set<WoWGuid> m_visibleObjects;
+    FlatGuidSet m_visibleObjects;
     // Groups/Raids
     WoWGuid m_GroupInviter;
 
@@ -1596,6 +1584,9 @@ public:
     bool m_mageInvisibility;
     uint16 m_drunk;
     uint32 m_drunkTimer;
+    // Group stats changed since the last flush, set from field updates
+    std::atomic<uint32> m_partyUpdateFlags;
+    uint32 m_partyUpdateTimer;
     bool m_hasSentMoTD;
     float MobXPGainRate;
 };
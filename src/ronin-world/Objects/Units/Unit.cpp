@@ -184,59 +184,60 @@ void Unit::Update(uint32 msTime, uint32 uiDiff)
 
 void Unit::OnAuraModChanged(uint32 modType)
 {
-    std::vector<uint8> pendingIndex;
+    // At most two update types per mod type, queued once and processed in UpdateFieldValues
+    uint8 pendingIndex[2], pendingCount = 0;
     switch(modType)
     {
     case SPELL_AURA_MOD_STAT:
     case SPELL_AURA_MOD_PERCENT_STAT:
     case SPELL_AURA_MOD_TOTAL_STAT_PERCENTAGE:
-        pendingIndex.push_back(UF_UTYPE_STATS);
+        pendingIndex[pendingCount++] = UF_UTYPE_STATS;
         break;
     case SPELL_AURA_MOD_BASE_HEALTH_PCT:
     case SPELL_AURA_MOD_INCREASE_HEALTH:
     case SPELL_AURA_MOD_INCREASE_MAX_HEALTH:
     case SPELL_AURA_MOD_INCREASE_HEALTH_2:
     case SPELL_AURA_MOD_INCREASE_HEALTH_PERCENT:
-        pendingIndex.push_back(UF_UTYPE_HEALTH);
+        pendingIndex[pendingCount++] = UF_UTYPE_HEALTH;
         break;
     case SPELL_AURA_MOD_INCREASE_ENERGY:
     case SPELL_AURA_MOD_INCREASE_ENERGY_PERCENT:
-        pendingIndex.push_back(UF_UTYPE_POWER);
+        pendingIndex[pendingCount++] = UF_UTYPE_POWER;
         break;
     case SPELL_AURA_MOD_POWER_REGEN:
     case SPELL_AURA_MOD_POWER_REGEN_PERCENT:
     case SPELL_AURA_MOD_MANA_REGEN_INTERRUPT:
-        pendingIndex.push_back(UF_UTYPE_REGEN);
+        pendingIndex[pendingCount++] = UF_UTYPE_REGEN;
         break;
     case SPELL_AURA_MOD_ATTACKSPEED:
-        pendingIndex.push_back(UF_UTYPE_ATTACKTIME);
+        pendingIndex[pendingCount++] = UF_UTYPE_ATTACKTIME;
         break;
     case SPELL_AURA_MOD_RESISTANCE:
     case SPELL_AURA_MOD_RESISTANCE_PCT:
     case SPELL_AURA_MOD_BASE_RESISTANCE:
     case SPELL_AURA_MOD_BASE_RESISTANCE_PCT:
     case SPELL_AURA_MOD_RESISTANCE_EXCLUSIVE:
-        pendingIndex.push_back(UF_UTYPE_RESISTANCE);
+        pendingIndex[pendingCount++] = UF_UTYPE_RESISTANCE;
         break;
     case SPELL_AURA_MOD_ATTACK_POWER_PCT:
     case SPELL_AURA_MOD_ATTACK_POWER_OF_ARMOR:
-        pendingIndex.push_back(UF_UTYPE_ATTACKPOWER);
+        pendingIndex[pendingCount++] = UF_UTYPE_ATTACKPOWER;
         break;
     case SPELL_AURA_MOD_RANGED_ATTACK_POWER_PCT:
-        pendingIndex.push_back(UF_UTYPE_RANGEDATTACKPOWER);
+        pendingIndex[pendingCount++] = UF_UTYPE_RANGEDATTACKPOWER;
         break;
     case SPELL_AURA_MOD_DAMAGE_DONE:
     case SPELL_AURA_MOD_DAMAGE_PERCENT_DONE:
-        pendingIndex.push_back(UF_UTYPE_ATTACKDAMAGE);
-        if(IsPlayer()) pendingIndex.push_back(UF_UTYPE_PLAYERDAMAGEMODS);
+        pendingIndex[pendingCount++] = UF_UTYPE_ATTACKDAMAGE;
+        if(IsPlayer()) pendingIndex[pendingCount++] = UF_UTYPE_PLAYERDAMAGEMODS;
         break;
     case SPELL_AURA_MOD_POWER_COST_SCHOOL:
     case SPELL_AURA_MOD_POWER_COST:
-        pendingIndex.push_back(UF_UTYPE_POWERCOST);
+        pendingIndex[pendingCount++] = UF_UTYPE_POWERCOST;
         break;
     case SPELL_AURA_HOVER:
-        pendingIndex.push_back(UF_UTYPE_HOVER);
-        pendingIndex.push_back(UF_UTYPE_MOVEMENT);
+        pendingIndex[pendingCount++] = UF_UTYPE_HOVER;
+        pendingIndex[pendingCount++] = UF_UTYPE_MOVEMENT;
         break;
         // Player opcode handling
     case SPELL_AURA_OVERRIDE_SPELL_POWER_BY_AP_PCT:
@@ -245,12 +246,12 @@ void Unit::OnAuraModChanged(uint32 modType)
     case SPELL_AURA_MOD_HEALING_DONE:
     case SPELL_AURA_MOD_SPELL_HEALING_OF_STAT_PERCENT:
     case SPELL_AURA_MOD_SPELL_HEALING_OF_ATTACK_POWER:
-        if(IsPlayer()) pendingIndex.push_back(UF_UTYPE_PLAYERDAMAGEMODS);
+        if(IsPlayer()) pendingIndex[pendingCount++] = UF_UTYPE_PLAYERDAMAGEMODS;
         break;
     case SPELL_AURA_MASTERY:
     case SPELL_AURA_MOD_RATING:
     case SPELL_AURA_MOD_RATING_FROM_STAT:
-        if(IsPlayer()) pendingIndex.push_back(UF_UTYPE_PLAYERRATINGS);
+        if(IsPlayer()) pendingIndex[pendingCount++] = UF_UTYPE_PLAYERRATINGS;
         break;
         /// Movement handler opcodes
         // Enabler opcodes
@@ -274,21 +275,19 @@ void Unit::OnAuraModChanged(uint32 modType)
     case SPELL_AURA_MOD_MOUNTED_FLIGHT_SPEED_ALWAYS:
     case SPELL_AURA_MOD_FLIGHT_SPEED_NOT_STACK:
     case SPELL_AURA_MOD_MINIMUM_SPEED:
-        pendingIndex.push_back(UF_UTYPE_MOVEMENT);
+        pendingIndex[pendingCount++] = UF_UTYPE_MOVEMENT;
         break;
     case SPELL_AURA_MOD_INCREASE_VEHICLE_FLIGHT_SPEED:
     case SPELL_AURA_MOD_VEHICLE_SPEED_ALWAYS:
-        pendingIndex.push_back(255);
+        pendingIndex[pendingCount++] = 255;
         break;
     }
-    if(pendingIndex.empty())
-        return;
-
-    while(pendingIndex.size())
+    for(uint8 i = 0; i < pendingCount; ++i)
     {
-        uint8 index = *pendingIndex.begin();
-        pendingIndex.erase(pendingIndex.begin());
-        m_modQueuedModUpdates[index].push_back(modType);
+        // An aoe refresh touches the same mod type many times, one entry is enough for the recalculation
+        std::vector<uint32> &queued = m_modQueuedModUpdates[pendingIndex[i]];
+        if(std::find(queued.begin(), queued.end(), modType) == queued.end())
+            queued.push_back(modType);
     }
 }
 
@@ -487,11 +486,6 @@ public:
         case SPELL_AURA_MOD_BASE_HEALTH_PCT:
             bonusBaseHP += baseHp * (((float)abs(mod->m_amount))/100.f);
             break;
-        case SPELL_AURA_MOD_INCREASE_HEALTH:
-        case SPELL_AURA_MOD_INCREASE_MAX_HEALTH:
-        case SPELL_AURA_MOD_INCREASE_HEALTH_2:
-            bonusHp += mod->m_amount;
-            break;
         case SPELL_AURA_MOD_INCREASE_HEALTH_PERCENT:
             bonusHp += Hp * (((float)abs(mod->m_amount))/100.f);
             break;
@@ -512,6 +506,10 @@ public:
             stamHp += stam*(HPPerStam->val*unit->GetHealthMod());
         // Set base
         Hp = baseHp + stamHp + unit->GetBonusHealth();
+
+        // Flat bonuses come straight from the running mod totals
+        AuraInterface *auras = &unit->m_AuraInterface;
+        bonusHp = auras->GetModTypeTotal(SPELL_AURA_MOD_INCREASE_HEALTH) + auras->GetModTypeTotal(SPELL_AURA_MOD_INCREASE_MAX_HEALTH) + auras->GetModTypeTotal(SPELL_AURA_MOD_INCREASE_HEALTH_2);
     }
 
     uint32 GetBaseHP() { return baseHp + bonusBaseHP; }
@@ -525,9 +523,6 @@ void Unit::UpdateHealthValues()
     HealthUpdateCallback healthCallback;
     healthCallback.Init(this, baseStats);
     m_AuraInterface.TraverseModMap(SPELL_AURA_MOD_BASE_HEALTH_PCT, &healthCallback);
-    m_AuraInterface.TraverseModMap(SPELL_AURA_MOD_INCREASE_HEALTH, &healthCallback);
-    m_AuraInterface.TraverseModMap(SPELL_AURA_MOD_INCREASE_MAX_HEALTH, &healthCallback);
-    m_AuraInterface.TraverseModMap(SPELL_AURA_MOD_INCREASE_HEALTH_2, &healthCallback);
     m_AuraInterface.TraverseModMap(SPELL_AURA_MOD_INCREASE_HEALTH_PERCENT, &healthCallback);
 
     // Set values from calculated results
@@ -1218,31 +1213,11 @@ void Unit::UpdatePowerCostValues(std::vector<uint32> modMap)
     }
 }
 
-class HoverValueUpdateCallback : public AuraInterface::ModCallback
-{
-public:
-    virtual void operator()(Modifier *mod)
-    {
-        switch(mod->m_type)
-        {
-        case SPELL_AURA_HOVER: { height += mod->m_amount; }break;
-        }
-    }
-
-    void Init() { height = 0.002f; }
-
-    float GetHeight() { return height/2.f; }
-
-    float height;
-};
-
 void Unit::UpdateHoverValues()
 {
-    HoverValueUpdateCallback hoverValueCallback;
-    hoverValueCallback.Init();
-    m_AuraInterface.TraverseModMap(SPELL_AURA_HOVER, &hoverValueCallback);
-
-    SetFloatValue(UNIT_FIELD_HOVERHEIGHT, hoverValueCallback.GetHeight());
+    // Hover height is a flat sum, read it from the running total instead of walking the mods
+    float height = 0.002f + float(m_AuraInterface.GetModTypeTotal(SPELL_AURA_HOVER));
+    SetFloatValue(UNIT_FIELD_HOVERHEIGHT, height/2.f);
 }
 
 class DamageDoneModCallback : public AuraInterface::ModCallback
@@ -2737,6 +2712,8 @@ void Unit::EventAttack( Unit *target, WeaponDamageType attackType )
 void Unit::EventAttackStart(WoWGuid guid)
 {
     m_attackTarget = guid;
+    if(m_mapInstance)
+        m_mapInstance->OnCombatTargetChange(GetGUID());
     addStateFlag(UF_ATTACKING);
     smsg_AttackStart(m_attackTarget);
     Dismount();
@@ -2750,6 +2727,8 @@ void Unit::EventAttackStop()
     clearStateFlag(UF_ATTACKING);
     smsg_AttackStop(m_attackTarget);
     m_attackTarget.Clean();
+    if(m_mapInstance)
+        m_mapInstance->OnCombatTargetChange(GetGUID());
     m_spellInterface.OnChangeSelection(0);
 }
 
@@ -101,6 +101,8 @@ void SpellCastTargets::write( WorldPacket& data )
         data << m_strTarget;
 }
 
+IMPLEMENT_SLAB_ALLOCATION(BaseSpell, sizeof(Spell));
+
 BaseSpell::BaseSpell(Unit* caster, SpellEntry *info, uint8 castNumber, WoWGuid itemGuid) : m_casterGuid(caster->GetGUID()), _unitCaster(caster), m_spellInfo(info), m_castNumber(castNumber), m_itemCaster(itemGuid)
 {
     m_isCasting = false;
@@ -112,6 +112,8 @@ class BaseSpell
 public:
     BaseSpell(Unit* caster, SpellEntry *info, uint8 castNumber, WoWGuid itemGuid);
     ~BaseSpell();
+    // Spells are deleted through us without a virtual destructor, so our pool is sized for Spell
+    DECLARE_SLAB_ALLOCATION();
 
     void _Prepare();
     virtual void Destruct();
@@ -508,6 +508,49 @@ void Spell::_UpdateChanneledSpell(uint32 timeLeft)
     }
 }
 
+uint32 Spell::GetDelayedImpactDelay(MapInstance *instance)
+{
+    if(m_missileSpeed <= 0.f)
+        return 0;
+
+    float distanceSq = 0.f;
+    if(m_isDelayedAOEMissile)
+    {
+        float delta_x = RONIN_UTIL::Diff(m_castPositionX, m_targets.m_dest.x);
+        float delta_y = RONIN_UTIL::Diff(m_castPositionY, m_targets.m_dest.y);
+        float delta_z = RONIN_UTIL::Diff(m_castPositionZ, m_targets.m_dest.z);
+        distanceSq = delta_x*delta_x + delta_y*delta_y + delta_z*delta_z;
+    }
+    else
+    {
+        bool found = false;
+        for(SpellDelayTargets::iterator itr = m_delayTargets.begin(); itr != m_delayTargets.end(); itr++)
+        {
+            WorldObject *target = NULL;
+            if(_unitCaster == NULL || (target = _unitCaster->GetInRangeObject<WorldObject>(*itr)) == NULL)
+            {
+                if(itr->getHigh() == HIGHGUID_TYPE_GAMEOBJECT)
+                    target = instance->GetGameObject(*itr);
+                else target = instance->GetUnit(*itr);
+            }
+
+            // Missing targets are dropped on the next update, do it right away
+            if(target == NULL)
+                return 0;
+
+            float targetDistSq = target->GetDistanceSq(m_castPositionX, m_castPositionY, m_castPositionZ);
+            if(found == false || targetDistSq < distanceSq)
+                distanceSq = targetDistSq;
+            found = true;
+        }
+    }
+
+    uint32 impactTime = float2int32(ceil(sqrtf(distanceSq) / m_missileSpeed));
+    if(impactTime <= m_delayedTimer)
+        return 0;
+    return std::min<uint32>(impactTime - m_delayedTimer, PROJECTILE_RECHECK_INTERVAL);
+}
+
 bool Spell::UpdateDelayedTargetEffects(MapInstance *instance, uint32 difftime)
 {
     m_delayedTimer += difftime;
@@ -522,7 +565,7 @@ bool Spell::UpdateDelayedTargetEffects(MapInstance *instance, uint32 difftime)
         float delta_z = RONIN_UTIL::Diff(m_castPositionZ, m_targets.m_dest.z);
 
         // Wait until we've reached our destination to trigger
-        if(distanceTraveled > (delta_x*delta_x + delta_y*delta_y + delta_z*delta_z))
+        if(distanceTraveled < (delta_x*delta_x + delta_y*delta_y + delta_z*delta_z))
             return false;
 
         // Refill our target map since we're at our destination
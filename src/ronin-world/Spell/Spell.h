@@ -32,6 +32,7 @@ enum SpellEffectTargetFlags
 #define GO_FISHING_BOBBER 35591
 
 #define SPELL_SPELL_CHANNEL_UPDATE_INTERVAL 1000
+#define PROJECTILE_RECHECK_INTERVAL 500
 
 // Spell instance
 class SERVER_DECL Spell : public SpellTargetClass
@@ -61,6 +62,8 @@ public:
     void _UpdateChanneledSpell(uint32 difftime);
     // Updates delayed targets, calls finish() as well
     bool UpdateDelayedTargetEffects(MapInstance *instance, uint32 diffTime);
+    // Milliseconds until the missile reaches its next target or destination, capped so moving targets are rechecked
+    uint32 GetDelayedImpactDelay(MapInstance *instance);
     // Casts the spell
     void cast(bool);
     // Finishes the casted spell
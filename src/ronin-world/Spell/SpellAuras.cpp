@@ -21,6 +21,8 @@
 
 #include "StdAfx.h"
 
+IMPLEMENT_SLAB_ALLOCATION(Aura, sizeof(Aura));
+
 std::map<uint16, Aura::pSpellAura> Aura::m_auraHandlerMap;
 
 void Aura::InitializeAuraHandlerClass()
@@ -2241,7 +2243,7 @@ void Aura::UpdateModAmounts()
             m_modList[i].m_amount = m_modList[i].m_baseAmount+m_modList[i].m_bonusAmount;
         else m_modList[i].m_amount = m_modList[i].m_baseAmount-m_modList[i].m_bonusAmount;
         if(m_stackSizeorProcCharges >= 0) m_modList[i].m_amount *= m_stackSizeorProcCharges;
-        if(m_target) m_target->OnAuraModChanged(m_modList[i].m_type);//m_AuraInterface.SetModMaskBit(m_modList[i].m_type);
+        if(m_target) m_target->m_AuraInterface.OnModifierAmountChanged(GetAuraSlot(), i, &m_modList[i]);
     }
 }
 
@@ -93,6 +93,7 @@ class SERVER_DECL Aura
 public:
     Aura(Unit *target, SpellEntry *proto, uint16 auraFlags, uint8 auraLevel, int16 auraStackCharge, time_t expirationTime, WoWGuid casterGuid);
     ~Aura();
+    DECLARE_SLAB_ALLOCATION();
 
     static void InitializeAuraHandlerClass();
     typedef void(Aura::*pSpellAura)(bool apply);
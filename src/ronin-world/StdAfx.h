@@ -52,6 +52,7 @@
 #include <vector>
 #include <map>
 #include <unordered_set>
+#include <unordered_map>
 #include <sstream>
 #include <string>
 #include <fstream>
@@ -96,6 +97,11 @@
 #include "../ronin-shared/Auth/WowCrypt.h"
 #include "../ronin-shared/Client/AuthCodes.h"
 #include "../ronin-shared/FastQueue.h"
+#include "../ronin-shared/MPSCQueue.h"
+#include "../ronin-shared/LatencyHistogram.h"
+#include "../ronin-shared/FlatGuidSet.h"
+#include "../ronin-shared/SlabAllocator.h"
+#include "../ronin-shared/ProcessMetrics.h"
 #include "../ronin-shared/CircularQueue.h"
 #include "../ronin-shared/startup_getopt.h"
 #include "../ronin-shared/NameTables.h"
@@ -127,6 +133,7 @@ extern size_t __line__;
 #include "UpdateFields.h"
 #include "UpdateMask.h"
 #include "Opcodes.h"
+#include "ServerCounters.h"
 #include "WorldStates.h"
 
 #include "SpellNameHashes.h"
@@ -166,6 +173,7 @@ extern size_t __line__;
 #include "AuctionMgr.h"
 #include "GroupFinder.h"
 #include "MailSystem.h"
+#include "CellPositionIndex.h"
 #include "MapCell.h"
 #include "FactionSystem.h"
 #include "MiscHandler.h"
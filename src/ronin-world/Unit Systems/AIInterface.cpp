@@ -23,7 +23,7 @@
 
 AIInterface::AIInterface(Creature *creature, UnitPathSystem *unitPath, Unit *owner) : m_Creature(creature), m_path(unitPath), m_AISeed(RandomUInt()),
 m_AIState(creature->isAlive() ? AI_STATE_IDLE : AI_STATE_DEAD), // Initialize AI state idle if unit is not dead
-m_AIFlags(AI_FLAG_NONE)
+m_AIFlags(AI_FLAG_NONE), m_aggroFullScan(true), m_aggroRescanTimer(0)
 {
 
 }
@@ -54,6 +54,7 @@ void AIInterface::Update(uint32 msTime, uint32 p_time)
                 {
                     m_Creature->clearStateFlag(UF_EVADING);
                     m_path->EnableAutoPath();
+                    ArmAggroSensor();
                 }
                 return;
             }
@@ -64,7 +65,7 @@ void AIInterface::Update(uint32 msTime, uint32 p_time)
                 return;
             }
 
-            if(FindTarget() == false)
+            if(_CheckAggroSensor(p_time) == false)
             {
                 m_path->EnableAutoPath();
                 return;
@@ -103,6 +104,16 @@ void AIInterface::OnDeath()
 void AIInterface::OnRespawn()
 {
     m_AIState = AI_STATE_IDLE;
+    ArmAggroSensor();
+}
+
+void AIInterface::OnAggroSensorTrigger(WoWGuid guid)
+{
+    // A full search is already pending
+    if(m_aggroFullScan)
+        return;
+    if(std::find(m_aggroCandidates.begin(), m_aggroCandidates.end(), guid) == m_aggroCandidates.end())
+        m_aggroCandidates.push_back(guid);
 }
 
 void AIInterface::OnPathChange()
@@ -132,7 +143,7 @@ void AIInterface::OnTakeDamage(Unit *attacker, uint32 damage)
     }
 }
 
-bool AIInterface::FindTarget()
+bool AIInterface::FindTarget(std::vector<WoWGuid> *candidates)
 {
     if(m_AIFlags & AI_FLAG_DISABLED || !m_Creature->IsInWorld() || m_Creature->hasStateFlag(UF_EVADING))
         return false;
@@ -144,7 +155,10 @@ bool AIInterface::FindTarget()
     uint32 targetTypeMask = (TYPEMASK_TYPE_PLAYER | (m_Creature->IsFactionNPCHostile() ? TYPEMASK_TYPE_UNIT : 0x0000));
 
     float baseAggro = m_Creature->GetAggroRange();
-    if(Unit *target = m_Creature->GetMapInstance()->FindInRangeTarget(m_Creature, baseAggro, targetTypeMask))
+    Unit *target = NULL;
+    if(candidates) target = m_Creature->GetMapInstance()->FindInRangeTarget(m_Creature, baseAggro, targetTypeMask, *candidates);
+    else target = m_Creature->GetMapInstance()->FindInRangeTarget(m_Creature, baseAggro, targetTypeMask);
+    if(target)
     {
         m_targetGuid = target->GetGUID();
         m_Creature->SetInCombat(target);
@@ -153,6 +167,26 @@ bool AIInterface::FindTarget()
     return false;
 }
 
+bool AIInterface::_CheckAggroSensor(uint32 p_time)
+{
+    if(m_aggroRescanTimer > p_time)
+        m_aggroRescanTimer -= p_time;
+    else m_aggroFullScan = true;
+
+    bool result = false;
+    if(m_aggroFullScan)
+    {
+        m_aggroRescanTimer = AGGRO_SENSOR_RESCAN_TIME;
+        result = FindTarget();
+    } // Nothing has come near us since our last check
+    else if(!m_aggroCandidates.empty())
+        result = FindTarget(&m_aggroCandidates);
+
+    m_aggroFullScan = false;
+    m_aggroCandidates.clear();
+    return result;
+}
+
 void AIInterface::_HandleCombatAI()
 {
     bool tooFarFromSpawn = false;
@@ -28,6 +28,13 @@ class UnitPathSystem;
 #define MAX_RANDOM_MOVEMENT_DIST 25.f
 #define MAX_COMBAT_MOVEMENT_DIST 14400.f
 
+// Idle creatures only search for targets once a unit moves within their aggro radius, level differences add up to this much
+#define AGGRO_SENSOR_LEVEL_RANGE 28.f
+// Largest radius without detect range auras or model size, maps widen their sensors past this as bigger creatures show up
+#define AGGRO_SENSOR_BASE_RANGE (20.f + float(ELITE_RARE)*1.25f + AGGRO_SENSOR_LEVEL_RANGE)
+// Full search interval for changes that don't involve movement, like stealth or faction changes
+#define AGGRO_SENSOR_RESCAN_TIME 5000
+
 enum AI_State : uint8
 {
     AI_STATE_DEAD   = 0,
@@ -60,7 +67,11 @@ public:
     void OnPathChange();
     void OnTakeDamage(Unit *attacker, uint32 damage);
 
-    bool FindTarget();
+    bool FindTarget(std::vector<WoWGuid> *candidates = NULL);
+
+    // Aggro sensor, triggered from map movement processing
+    void ArmAggroSensor() { m_aggroFullScan = true; }
+    void OnAggroSensorTrigger(WoWGuid guid);
 
     AI_State GetAIState() { return m_AIState; }
 
@@ -70,6 +81,7 @@ protected:
     uint32 m_AIFlags;
 
     void _HandleCombatAI();
+    bool _CheckAggroSensor(uint32 p_time);
 
 private:
     Creature* m_Creature;
@@ -77,4 +89,8 @@ private:
 
     WoWGuid m_targetGuid;
     std::map<WoWGuid, uint32> m_threatMap;
+
+    bool m_aggroFullScan;
+    uint32 m_aggroRescanTimer;
+    std::vector<WoWGuid> m_aggroCandidates;
 };
@@ -27,6 +27,9 @@ AuraInterface::AuraInterface(Unit *unit) : m_Unit(unit), m_maxPosAuraSlot(0), m_
 {
     for(uint8 i = 0; i < TOTAL_AURAS; i++)
         m_auras[i] = NULL;
+    memset(m_modTypeMask, 0, sizeof(m_modTypeMask));
+    memset(m_modTypeCount, 0, sizeof(m_modTypeCount));
+    memset(m_modTypeTotal, 0, sizeof(m_modTypeTotal));
 }
 
 AuraInterface::~AuraInterface()
@@ -814,6 +817,14 @@ void AuraInterface::UpdateAuraModsWithModType(uint32 modType)
         UpdateSpellGroupModifiers(false, itr->second, true);
         _RecalculateModAmountByType(itr->second);
         UpdateSpellGroupModifiers(true, itr->second, true);
+
+        Loki::AssocVector<uint8, ModifierHolder*>::iterator holderItr;
+        uint8 auraSlot = uint8(itr->first & 0xFF), index = uint8(itr->first >> 8);
+        if((holderItr = m_modifierHolders.find(auraSlot)) != m_modifierHolders.end())
+        {
+            m_modTypeTotal[modType] += itr->second->m_amount - holderItr->second->amount[index];
+            holderItr->second->amount[index] = itr->second->m_amount;
+        }
     }
 }
 
@@ -1522,14 +1533,19 @@ void AuraInterface::UpdateModifier(uint8 auraSlot, uint8 index, Modifier *mod, b
 
         // Do a quick recalc if we need it
         _RecalculateModAmountByType(mod);
+        if(modHolder->mod[index] != NULL)
+            _CountModifier(modHolder, index, modHolder->mod[index], false);
         m_modifiersByModType[mod->m_type].insert(std::make_pair(mod_index, mod));
         modHolder->mod[index] = mod;
+        _CountModifier(modHolder, index, mod, true);
     }
     else if((itr = m_modifierHolders.find(auraSlot)) != m_modifierHolders.end())
     {
         m_modifiersByModType[mod->m_type].erase(mod_index);
 
         ModifierHolder *modHolder = itr->second;
+        if(modHolder->mod[index] != NULL)
+            _CountModifier(modHolder, index, modHolder->mod[index], false);
         modHolder->mod[index] = NULL;
         for(uint8 i=0;i<3;i++)
             if(modHolder->mod[i])
@@ -1542,6 +1558,43 @@ void AuraInterface::UpdateModifier(uint8 auraSlot, uint8 index, Modifier *mod, b
         UpdateSpellGroupModifiers(apply, mod, false);
 }
 
+void AuraInterface::OnModifierAmountChanged(uint8 auraSlot, uint8 index, Modifier *mod)
+{
+    m_Unit->OnAuraModChanged(mod->m_type);
+
+    Guard guard(m_modLock);
+    Loki::AssocVector<uint8, ModifierHolder*>::iterator itr;
+    if(index >= 3 || (itr = m_modifierHolders.find(auraSlot)) == m_modifierHolders.end() || itr->second->mod[index] != mod)
+        return;
+
+    m_modTypeTotal[mod->m_type] += mod->m_amount - itr->second->amount[index];
+    itr->second->amount[index] = mod->m_amount;
+}
+
+void AuraInterface::_CountModifier(ModifierHolder *holder, uint8 index, Modifier *mod, bool apply)
+{
+    uint32 modType = mod->m_type;
+    if(modType >= SPELL_AURA_TOTAL)
+        return;
+
+    if(apply)
+    {
+        holder->amount[index] = mod->m_amount;
+        m_modTypeTotal[modType] += mod->m_amount;
+        if(m_modTypeCount[modType]++ == 0)
+            m_modTypeMask[modType/32] |= uint32(1)<<(modType%32);
+        return;
+    }
+
+    m_modTypeTotal[modType] -= holder->amount[index];
+    holder->amount[index] = 0;
+    if(m_modTypeCount[modType] && --m_modTypeCount[modType] == 0)
+    {
+        m_modTypeMask[modType/32] &= ~(uint32(1)<<(modType%32));
+        m_modTypeTotal[modType] = 0;
+    }
+}
+
 void AuraInterface::UpdateSpellGroupModifiers(bool apply, Modifier *mod, bool silent)
 {
     assert(mod->m_miscValue[0] < SPELL_MODIFIERS);
@@ -183,16 +183,20 @@ private:
 
 public:
     void UpdateModifier(uint8 auraSlot, uint8 index, Modifier *mod, bool apply);
+    // Called when an applied modifier's amount changes in place, keeps the running totals in step
+    void OnModifierAmountChanged(uint8 auraSlot, uint8 index, Modifier *mod);
     static uint16 createModifierIndex(uint8 index1, uint8 index2) { return ((uint16(index2)<<8) | uint16(index1)); }
 
     class ModifierHolder
     {
     public:
-        ModifierHolder(uint32 slot,SpellEntry* info) : auraSlot(slot),spellInfo(info) {for(uint8 i=0;i<3;i++)mod[i]=NULL;};
+        ModifierHolder(uint32 slot,SpellEntry* info) : auraSlot(slot),spellInfo(info) {for(uint8 i=0;i<3;i++){mod[i]=NULL;amount[i]=0;}};
 
         uint32 auraSlot;
         SpellEntry *spellInfo;
         Modifier *mod[3];
+        // Amount each modifier contributed to its type total when last counted
+        int32 amount[3];
     };
 
     struct ModifierType
@@ -208,15 +212,9 @@ public:
     typedef Loki::AssocVector<uint16, Modifier*> modifierMap;
     typedef Loki::AssocVector<uint32, modifierMap > modifierTypeMap;
 
-    bool HasAurasWithModType(uint32 modType)
-    {
-        bool ret = false;
-        m_modLock.Acquire();
-        if(!m_modifiersByModType.empty() && m_modifiersByModType.find(modType) == m_modifiersByModType.end())
-            ret = !m_modifiersByModType[modType].empty();
-        m_modLock.Release();
-        return ret;
-    }
+    bool HasAurasWithModType(uint32 modType) { return modType < SPELL_AURA_TOTAL && (m_modTypeMask[modType/32] & (uint32(1)<<(modType%32))); }
+    // Sum of m_amount over every applied modifier of this type
+    int32 GetModTypeTotal(uint32 modType) { return modType < SPELL_AURA_TOTAL ? m_modTypeTotal[modType] : 0; }
 
     /// !DEPRECATED NOT THREAD SAFE
     modifierMap *GetModMapByModType(uint32 modType) { return NULL; }
@@ -245,6 +243,12 @@ private:
     // Access lock for using mod maps
     Mutex m_modLock;
 
+    // Running count and amount per mod type, maintained on apply and remove so presence checks and flat sums skip the maps
+    uint32 m_modTypeMask[(SPELL_AURA_TOTAL+31)/32];
+    uint16 m_modTypeCount[SPELL_AURA_TOTAL];
+    int32 m_modTypeTotal[SPELL_AURA_TOTAL];
+    void _CountModifier(ModifierHolder *holder, uint8 index, Modifier *mod, bool apply);
+
     static uint32 get32BitOffsetAndGroup(uint32 value, uint8 &group);
     void UpdateSpellGroupModifiers(bool apply, Modifier *mod, bool silent);
 };
@@ -67,10 +67,14 @@ MovementInterface::MovementInterface(Unit *_unit) : m_Unit(_unit), m_movementSta
 
     ClearTransportData();
     m_extra.clear();
+    m_clientDecoder = NULL;
 }
 
 MovementInterface::~MovementInterface()
 {
+    if(m_clientDecoder)
+        delete m_clientDecoder;
+    m_clientDecoder = NULL;
     m_serverLocation = NULL;
 }
 
@@ -1446,7 +1450,7 @@ bool MovementInterface::isSplineMovingActive()
     return m_path.hasDestination();
 }
 
-bool MovementInterface::ReadFromClient(uint16 opcode, ByteBuffer *buffer)
+bool MovementInterface::ReadFromClient(uint16 opcode, ByteBuffer *buffer, const MovementClientDecode *decode)
 {
     m_movementLock.Acquire();
     m_extra.clear();
@@ -1458,7 +1462,13 @@ bool MovementInterface::ReadFromClient(uint16 opcode, ByteBuffer *buffer)
         ClearOptionalMovementData();
         try
         {
-            (this->*(movementPacketHandlers[moveCode].function))(true, *buffer);
+            MovementClientData baseline;
+            if(decode && decode->decoded && (_GetClientData(baseline), baseline == decode->baseline))
+            {
+                // Decoded against the state we're in, skip reading the packet again
+                _SetClientData(decode->result);
+                buffer->rpos(decode->readPos);
+            } else (this->*(movementPacketHandlers[moveCode].function))(true, *buffer);
             res = UpdatePostRead(opcode, moveCode, buffer);
         }
         catch (ByteBufferException &)
@@ -1470,6 +1480,57 @@ bool MovementInterface::ReadFromClient(uint16 opcode, ByteBuffer *buffer)
     return res;
 }
 
+bool MovementInterface::CanDecodeFromClient(uint16 opcode)
+{
+    // Only plain position updates, acknowledgements and the rest touch more than the client data
+    uint16 moveCode = GetInternalMovementCode(opcode);
+    return moveCode >= MOVEMENT_CODE_HEARTBEAT && moveCode <= MOVEMENT_CODE_SET_PITCH;
+}
+
+bool MovementInterface::DecodeFromClient(uint16 opcode, ByteBuffer *buffer, MovementClientDecode &decode, const MovementClientDecode *previous)
+{
+    decode.decoded = false;
+    if(!CanDecodeFromClient(opcode))
+        return false;
+
+    if(previous && previous->decoded)
+    {
+        // Predict the state the previous packet leaves behind once applied
+        decode.baseline = previous->result;
+        decode.baseline.location.o = NormAngle(decode.baseline.location.o);
+        _ClearClientData(decode.baseline, decode.baseline.location);
+    }
+    else
+    {
+        m_movementLock.Acquire();
+        _GetClientData(decode.baseline);
+        _ClearClientData(decode.baseline, *m_serverLocation);
+        m_movementLock.Release();
+    }
+
+    if(m_clientDecoder == NULL)
+        m_clientDecoder = new MovementInterface(m_Unit);
+
+    // The bit reader refills from the next byte, so for a fresh packet the read positions are all we restore
+    size_t startPos = buffer->rpos(), startBitPos = buffer->bitpos();
+    try
+    {
+        m_clientDecoder->_SetClientData(decode.baseline);
+        (m_clientDecoder->*(movementPacketHandlers[GetInternalMovementCode(opcode)].function))(true, *buffer);
+        m_clientDecoder->_GetClientData(decode.result);
+        decode.readPos = buffer->rpos();
+        decode.decoded = true;
+    }
+    catch (ByteBufferException &)
+    {
+        // Left to the map thread, which reports the error
+    }
+
+    buffer->rpos(startPos);
+    buffer->bitpos(8-startBitPos);
+    return decode.decoded;
+}
+
 void MovementInterface::WriteFromServer(uint16 opcode, ByteBuffer *buffer, WoWGuid extra_guid, float extra_float, uint8 extra_byte)
 {
     m_movementLock.Acquire();
@@ -1681,21 +1742,88 @@ void MovementInterface::WriteObjectUpdate(ByteBuffer *bits, ByteBuffer *bytes)
 #undef DO_SEQ_BYTE
 
 void MovementInterface::ClearOptionalMovementData()
+{
+    MovementClientData data;
+    _GetClientData(data);
+    _ClearClientData(data, *m_serverLocation);
+    _SetClientData(data);
+    m_extra.clear();
+}
+
+void MovementInterface::_GetClientData(MovementClientData &data)
+{
+    data.location = m_clientLocation;
+    data.transLocation = m_clientTransLocation;
+    data.guid = m_clientGuid;
+    data.transGuid = m_clientTransGuid;
+    data.clientTime = m_clientTime;
+    data.jumpTime = m_jumpTime;
+    data.transportTime = m_transportTime;
+    data.transportTime2 = m_transportTime2;
+    data.vehicleId = m_vehicleId;
+    data.transportSeatId = m_transportSeatId;
+    memcpy(data.movementFlags, m_movementFlags, 6);
+    data.pitching = pitching;
+    data.splineElevation = splineElevation;
+    data.jumpZSpeed = m_jumpZSpeed;
+    data.jumpXYSpeed = m_jump_XYSpeed;
+    data.jumpSin = m_jump_sin;
+    data.jumpCos = m_jump_cos;
+}
+
+void MovementInterface::_SetClientData(const MovementClientData &data)
+{
+    m_clientLocation = data.location;
+    m_clientTransLocation = data.transLocation;
+    m_clientGuid = data.guid;
+    m_clientTransGuid = data.transGuid;
+    m_clientTime = data.clientTime;
+    m_jumpTime = data.jumpTime;
+    m_transportTime = data.transportTime;
+    m_transportTime2 = data.transportTime2;
+    m_vehicleId = data.vehicleId;
+    m_transportSeatId = data.transportSeatId;
+    memcpy(m_movementFlags, data.movementFlags, 6);
+    pitching = data.pitching;
+    splineElevation = data.splineElevation;
+    m_jumpZSpeed = data.jumpZSpeed;
+    m_jump_XYSpeed = data.jumpXYSpeed;
+    m_jump_sin = data.jumpSin;
+    m_jump_cos = data.jumpCos;
+}
+
+void MovementInterface::_ClearClientData(MovementClientData &data, const LocationVector &serverLocation)
 {
     // Reset client position to server location
-    m_clientLocation = *m_serverLocation;
+    data.location = serverLocation;
 
-    memset(m_movementFlags, 0, 6);
-    m_jumpTime = m_vehicleId = 0;
-    pitching = splineElevation = 0.f;
-    m_jumpZSpeed = m_jump_XYSpeed = m_jump_sin = m_jump_cos = 0.f;
-    m_extra.clear();
+    memset(data.movementFlags, 0, 6);
+    data.jumpTime = data.vehicleId = 0;
+    data.pitching = data.splineElevation = 0.f;
+    data.jumpZSpeed = data.jumpXYSpeed = data.jumpSin = data.jumpCos = 0.f;
 
     if(!m_isTransportLocked)
     {
-        m_clientTransGuid.Clean();
-        m_clientTransLocation.ChangeCoords(0.f, 0.f, 0.f, 0.f);
-        m_transportTime = m_transportTime2 = 0;
-        m_transportSeatId = 0;
+        data.transGuid.Clean();
+        data.transLocation.ChangeCoords(0.f, 0.f, 0.f, 0.f);
+        data.transportTime = data.transportTime2 = 0;
+        data.transportSeatId = 0;
     }
 }
+
+bool MovementClientData::operator==(const MovementClientData &data) const
+{
+    // LocationVector skips orientation when comparing, so check the coordinates ourselves
+    if(location.x != data.location.x || location.y != data.location.y || location.z != data.location.z || location.o != data.location.o)
+        return false;
+    if(transLocation.x != data.transLocation.x || transLocation.y != data.transLocation.y || transLocation.z != data.transLocation.z || transLocation.o != data.transLocation.o)
+        return false;
+    if(!(guid == data.guid) || !(transGuid == data.transGuid))
+        return false;
+    if(clientTime != data.clientTime || jumpTime != data.jumpTime || transportTime != data.transportTime || transportTime2 != data.transportTime2)
+        return false;
+    if(vehicleId != data.vehicleId || transportSeatId != data.transportSeatId || memcmp(movementFlags, data.movementFlags, 6))
+        return false;
+    return pitching == data.pitching && splineElevation == data.splineElevation && jumpZSpeed == data.jumpZSpeed
+        && jumpXYSpeed == data.jumpXYSpeed && jumpSin == data.jumpSin && jumpCos == data.jumpCos;
+}
@@ -286,6 +286,33 @@ enum UnderwaterStates : uint8
 class MovementInterface;
 struct PacketHandler { void (MovementInterface::*function)(bool read, ByteBuffer &buffer); };
 
+// Everything a client movement packet fills in when read
+struct MovementClientData
+{
+    LocationVector location, transLocation;
+    WoWGuid guid, transGuid;
+    uint32 clientTime, jumpTime, transportTime, transportTime2, vehicleId;
+    int8 transportSeatId;
+    uint8 movementFlags[6];
+    float pitching, splineElevation;
+    float jumpZSpeed, jumpXYSpeed, jumpSin, jumpCos;
+
+    bool operator==(const MovementClientData &data) const;
+};
+
+/** A movement packet decoded ahead of the map's session update
+ * Reading depends on the state left behind by the packet before it, so we keep the state
+ * we decoded against, the result is only used if the live state still matches when applied.
+ */
+struct MovementClientDecode
+{
+    MovementClientDecode() : decoded(false), readPos(0) { }
+
+    bool decoded;
+    size_t readPos;
+    MovementClientData baseline, result;
+};
+
 class MovementInterface
 {
 public:
@@ -390,11 +417,15 @@ public:
     void AddUnderwaterStateTimerPresent() { m_underwaterState |= UNDERWATERSTATE_TIMERS_PRESENT; }
 
     // Packet handlers
-    bool ReadFromClient(uint16 opcode, ByteBuffer *buffer);
+    bool ReadFromClient(uint16 opcode, ByteBuffer *buffer, const MovementClientDecode *decode = NULL);
     void WriteFromServer(uint16 opcode, ByteBuffer *buffer, WoWGuid extra_guid = 0, float extra_float = 0.f, uint8 extra_byte = 0);
 
     void DoExtraData(uint16 moveCode, bool read, ByteBuffer *buffer, uint8 sequence = 0);
 
+    // Decodes position updates off the map thread, previous is the last packet decoded in the same batch
+    static bool CanDecodeFromClient(uint16 opcode);
+    bool DecodeFromClient(uint16 opcode, ByteBuffer *buffer, MovementClientDecode &decode, const MovementClientDecode *previous);
+
     // Alternate packet handlers
     void SetActiveMover(WorldPacket *packet);
     void MoveTimeSkipped(WorldPacket *packet);
@@ -626,6 +657,10 @@ private:
 
     void ClearOptionalMovementData();
 
+    void _GetClientData(MovementClientData &data);
+    void _SetClientData(const MovementClientData &data);
+    void _ClearClientData(MovementClientData &data, const LocationVector &serverLocation);
+
 protected: // Movement information
     Mutex m_movementLock;
     // Vector linked to object position
@@ -707,6 +742,9 @@ protected:
 private:
     Unit *m_Unit;
 
+    // Scratch interface the decoder reads into, created on first use
+    MovementInterface *m_clientDecoder;
+
     uint32 m_movementState;
 
     UnitPathSystem m_path;
@@ -88,17 +88,20 @@ void AuctionHouse::UpdateDeletionQueue()
 
 void AuctionHouse::UpdateAuctions()
 {
-    auctionLock.AcquireReadLock();
+    auctionLock.AcquireWriteLock();
     removalLock.Acquire();
 
-    time_t now = UNIXTIME;
-    std::map<uint32, Auction*>::iterator itr = auctions.begin();
+    uint64 now = UNIXTIME;
+    std::map<uint32, Auction*>::iterator itr;
     Auction * auct;
-    for(; itr != auctions.end();)
+    while(!m_expiryQueue.empty() && m_expiryQueue.front().first <= now)
     {
-        auct = itr->second;
-        ++itr;
-        if(auct->expirationTime > now)
+        uint32 auctionId = m_expiryQueue.front().second;
+        std::pop_heap(m_expiryQueue.begin(), m_expiryQueue.end(), std::greater<std::pair<uint64, uint32> >());
+        m_expiryQueue.pop_back();
+
+        // Already removed or queued for removal
+        if((itr = auctions.find(auctionId)) == auctions.end() || (auct = itr->second)->Deleted)
             continue;
 
         if(auct->highestBidder.empty())
@@ -110,7 +113,86 @@ void AuctionHouse::UpdateAuctions()
     }
 
     removalLock.Release();
-    auctionLock.ReleaseReadLock();
+    auctionLock.ReleaseWriteLock();
+}
+
+uint32 AuctionHouse::_NameGram(const std::string &name, size_t offset)
+{
+    return (uint32(uint8(name[offset])) << 16) | (uint32(uint8(name[offset+1])) << 8) | uint32(uint8(name[offset+2]));
+}
+
+void AuctionHouse::_IndexAuction(Auction *auct)
+{
+    m_ownerIndex[auct->owner].insert(auct->Id);
+    if(!auct->highestBidder.empty())
+        m_bidderIndex[auct->highestBidder].insert(auct->Id);
+
+    m_expiryQueue.push_back(std::make_pair(auct->expirationTime, auct->Id));
+    std::push_heap(m_expiryQueue.begin(), m_expiryQueue.end(), std::greater<std::pair<uint64, uint32> >());
+
+    // Auctions without a loaded item can't be searched for
+    ItemPrototype *proto = auct->m_item ? auct->m_item->GetProto() : NULL;
+    if(proto == NULL)
+        return;
+
+    m_categoryIndex[(proto->Class << 8) | (proto->SubClass & 0xFF)].insert(auct->Id);
+    m_inventoryTypeIndex[proto->InventoryType].insert(auct->Id);
+    m_qualityIndex[proto->Quality].insert(auct->Id);
+    m_levelIndex[proto->RequiredLevel].insert(auct->Id);
+    for(size_t i = 0; i + AUCTION_NAME_GRAM_LENGTH <= proto->lowercase_name.length(); ++i)
+        m_nameIndex[_NameGram(proto->lowercase_name, i)].insert(auct->Id);
+}
+
+static void EraseIndexedId(AuctionIndex &index, uint32 key, uint32 auctionId)
+{
+    AuctionIndex::iterator itr;
+    if((itr = index.find(key)) == index.end())
+        return;
+
+    itr->second.erase(auctionId);
+    if(itr->second.empty())
+        index.erase(itr);
+}
+
+static void EraseIndexedId(std::map<WoWGuid, AuctionIdSet> &index, WoWGuid guid, uint32 auctionId)
+{
+    std::map<WoWGuid, AuctionIdSet>::iterator itr;
+    if((itr = index.find(guid)) == index.end())
+        return;
+
+    itr->second.erase(auctionId);
+    if(itr->second.empty())
+        index.erase(itr);
+}
+
+void AuctionHouse::_UnindexAuction(Auction *auct)
+{
+    // The expiry queue entry is dropped lazily once it comes due
+    EraseIndexedId(m_ownerIndex, auct->owner, auct->Id);
+    if(!auct->highestBidder.empty())
+        EraseIndexedId(m_bidderIndex, auct->highestBidder, auct->Id);
+
+    ItemPrototype *proto = auct->m_item ? auct->m_item->GetProto() : NULL;
+    if(proto == NULL)
+        return;
+
+    EraseIndexedId(m_categoryIndex, (proto->Class << 8) | (proto->SubClass & 0xFF), auct->Id);
+    EraseIndexedId(m_inventoryTypeIndex, proto->InventoryType, auct->Id);
+    EraseIndexedId(m_qualityIndex, proto->Quality, auct->Id);
+    EraseIndexedId(m_levelIndex, proto->RequiredLevel, auct->Id);
+    for(size_t i = 0; i + AUCTION_NAME_GRAM_LENGTH <= proto->lowercase_name.length(); ++i)
+        EraseIndexedId(m_nameIndex, _NameGram(proto->lowercase_name, i), auct->Id);
+}
+
+size_t AuctionHouse::_CollectRange(AuctionIndex &index, uint32 low, uint32 high, AuctionIdSources &out)
+{
+    size_t count = 0;
+    for(AuctionIndex::iterator itr = index.lower_bound(low); itr != index.end() && itr->first <= high; ++itr)
+    {
+        out.push_back(&itr->second);
+        count += itr->second.size();
+    }
+    return count;
 }
 
 void AuctionHouse::AddAuction(Auction * auct)
@@ -118,6 +200,7 @@ void AuctionHouse::AddAuction(Auction * auct)
     // add to the map
     auctionLock.AcquireWriteLock();
     auctions.insert( std::map<uint32, Auction*>::value_type( auct->Id , auct ) );
+    _IndexAuction(auct);
     auctionLock.ReleaseWriteLock();
 
     // add the item
@@ -208,6 +291,7 @@ void AuctionHouse::RemoveAuction(Auction * auct)
     itemLock.AcquireWriteLock();
 
     auctions.erase(auct->Id);
+    _UnindexAuction(auct);
     auctionedItems.erase(auct->m_item->GetGUID());
 
     auctionLock.ReleaseWriteLock();
@@ -220,6 +304,18 @@ void AuctionHouse::RemoveAuction(Auction * auct)
     delete auct;
 }
 
+void AuctionHouse::SetHighestBid(Auction * auct, WoWGuid bidder, uint64 bid)
+{
+    auctionLock.AcquireWriteLock();
+    if(!auct->highestBidder.empty())
+        EraseIndexedId(m_bidderIndex, auct->highestBidder, auct->Id);
+    auct->highestBidder = bidder;
+    auct->highestBid = bid;
+    if(!bidder.empty())
+        m_bidderIndex[bidder].insert(auct->Id);
+    auctionLock.ReleaseWriteLock();
+}
+
 void WorldSession::HandleAuctionListBidderItems( WorldPacket & recv_data )
 {
     CHECK_INWORLD_RETURN();
@@ -259,13 +355,14 @@ void AuctionHouse::SendBidListPacket(Player* plr, WorldPacket * packet)
 
     Auction * auct;
     auctionLock.AcquireReadLock();
-    std::map<uint32, Auction*>::iterator itr = auctions.begin();
-    for(; itr != auctions.end(); itr++)
+    std::map<WoWGuid, AuctionIdSet>::iterator bids = m_bidderIndex.find(plr->GetGUID());
+    if(bids != m_bidderIndex.end())
     {
-        auct = itr->second;
-        if(plr->GetGUID() == auct->highestBidder)
+        for(AuctionIdSet::iterator itr = bids->second.begin(); itr != bids->second.end(); ++itr)
         {
-            if(auct->Deleted) continue;
+            auct = auctions.at(*itr);
+            if(auct->Deleted || auct->m_item == NULL)
+                continue;
 
             auct->AddToPacket(data);
             (*(uint32*)&data.contents()[0])++;
@@ -282,20 +379,31 @@ void AuctionHouse::UpdateItemOwnerships(WoWGuid oldGuid, WoWGuid newGuid)
 
     Auction * auct;
     auctionLock.AcquireWriteLock();
-    std::map<uint32, Auction*>::iterator itr = auctions.begin();
-    for(; itr != auctions.end(); itr++)
+    std::map<WoWGuid, AuctionIdSet>::iterator itr;
+    if((itr = m_ownerIndex.find(oldGuid)) != m_ownerIndex.end())
     {
-        auct = itr->second;
-        if(auct->owner == oldGuid)
+        AuctionIdSet owned;
+        owned.swap(itr->second);
+        m_ownerIndex.erase(itr);
+        for(AuctionIdSet::iterator id = owned.begin(); id != owned.end(); ++id)
         {
-            auct->owner = newGuid;
             // Don't save, we take care of this in char rename all at once. Less queries.
+            auctions.at(*id)->owner = newGuid;
+            m_ownerIndex[newGuid].insert(*id);
         }
+    }
 
-        if(auct->highestBidder == oldGuid)
+    if((itr = m_bidderIndex.find(oldGuid)) != m_bidderIndex.end())
+    {
+        AuctionIdSet bids;
+        bids.swap(itr->second);
+        m_bidderIndex.erase(itr);
+        for(AuctionIdSet::iterator id = bids.begin(); id != bids.end(); ++id)
         {
+            auct = auctions.at(*id);
             auct->highestBidder = newGuid;
             auct->UpdateInDB();
+            m_bidderIndex[newGuid].insert(*id);
         }
     }
     auctionLock.ReleaseWriteLock();
@@ -317,13 +425,14 @@ void AuctionHouse::SendOwnerListPacket(Player* plr, WorldPacket * packet)
 
     Auction * auct;
     auctionLock.AcquireReadLock();
-    std::map<uint32, Auction*>::iterator itr = auctions.begin();
-    for(; itr != auctions.end(); itr++)
+    std::map<WoWGuid, AuctionIdSet>::iterator owned = m_ownerIndex.find(plr->GetGUID());
+    if(owned != m_ownerIndex.end())
     {
-        auct = itr->second;
-        if(auct->owner == plr->GetGUID())
+        for(AuctionIdSet::iterator itr = owned->second.begin(); itr != owned->second.end(); ++itr)
         {
-            if(auct->Deleted) continue;
+            auct = auctions.at(*itr);
+            if(auct->Deleted || auct->m_item == NULL)
+                continue;
 
             auct->AddToPacket(data);
             ++count;
@@ -387,8 +496,7 @@ void WorldSession::HandleAuctionPlaceBid( WorldPacket & recv_data )
 
     if(auct->buyoutPrice == price)
     {
-        auct->highestBidder = _player->GetLowGUID();
-        auct->highestBid = price;
+        ah->SetHighestBid(auct, _player->GetLowGUID(), price);
 
         // we used buyout on the item.
         ah->QueueDeletion(auct, AUCTION_REMOVE_WON);
@@ -401,8 +509,7 @@ void WorldSession::HandleAuctionPlaceBid( WorldPacket & recv_data )
     else
     {
         // update most recent bid
-        auct->highestBidder = _player->GetLowGUID();
-        auct->highestBid = price;
+        ah->SetHighestBid(auct, _player->GetLowGUID(), price);
         auct->UpdateInDB();
 
         // send response packet
@@ -538,6 +645,22 @@ void WorldSession::HandleAuctionListOwnerItems( WorldPacket & recv_data )
     pCreature->auctionHouse->SendOwnerListPacket(_player, &recv_data);
 }
 
+static bool SortAuctionsById(Auction *a, Auction *b)
+{
+    return a->Id < b->Id;
+}
+
+static void PickSmallerSource(AuctionIdSources &sources, size_t &sourceCount, bool &indexed, AuctionIdSources &candidate, size_t count)
+{
+    if(!indexed || count < sourceCount)
+    {
+        sources.swap(candidate);
+        sourceCount = count;
+        indexed = true;
+    }
+    candidate.clear();
+}
+
 void AuctionHouse::SendAuctionList(Player* plr, WorldPacket * packet)
 {
     uint32 start_index, current_index = 0;
@@ -559,14 +682,81 @@ void AuctionHouse::SendAuctionList(Player* plr, WorldPacket * packet)
     data << uint32(0);
 
     auctionLock.AcquireReadLock();
-    std::map<uint32, Auction*>::iterator itr = auctions.begin();
-    for(; itr != auctions.end(); itr++)
+
+    // Every usable index narrows the search to the ids under its matching keys, walk the smallest
+    AuctionIdSources sources, candidate;
+    size_t sourceCount = 0, count;
+    bool indexed = false;
+    if(itemclass != -1)
+    {
+        uint32 low = uint32(itemclass) << 8, high = low | 0xFF;
+        if(itemsubclass != -1)
+            low = high = low | (uint32(itemsubclass) & 0xFF);
+        count = _CollectRange(m_categoryIndex, low, high, candidate);
+        PickSmallerSource(sources, sourceCount, indexed, candidate, count);
+    }
+
+    if(inventory_type != -1)
+    {
+        count = _CollectRange(m_inventoryTypeIndex, uint32(inventory_type), uint32(inventory_type), candidate);
+        PickSmallerSource(sources, sourceCount, indexed, candidate, count);
+    }
+
+    if(rarityCheck > 0)
+    {
+        count = _CollectRange(m_qualityIndex, uint32(rarityCheck), 0xFFFFFFFF, candidate);
+        PickSmallerSource(sources, sourceCount, indexed, candidate, count);
+    }
+
+    if(levelRange1 || levelRange2)
+    {
+        count = _CollectRange(m_levelIndex, levelRange1, levelRange2 ? levelRange2 : 0xFFFFFFFF, candidate);
+        PickSmallerSource(sources, sourceCount, indexed, candidate, count);
+    }
+
+    // Any gram of the search string missing from the index means nothing can match
+    for(size_t i = 0; i + AUCTION_NAME_GRAM_LENGTH <= auctionstring.length() && (!indexed || sourceCount); ++i)
+    {
+        AuctionIndex::iterator gram = m_nameIndex.find(_NameGram(auctionstring, i));
+        count = gram == m_nameIndex.end() ? 0 : gram->second.size();
+        if(indexed && count >= sourceCount)
+            continue;
+
+        sources.clear();
+        if(gram != m_nameIndex.end())
+            sources.push_back(&gram->second);
+        sourceCount = count;
+        indexed = true;
+    }
+
+    std::vector<Auction*> candidates;
+    if(indexed)
+    {
+        candidates.reserve(sourceCount);
+        for(AuctionIdSources::iterator set = sources.begin(); set != sources.end(); ++set)
+            for(AuctionIdSet::const_iterator id = (*set)->begin(); id != (*set)->end(); ++id)
+                candidates.push_back(auctions.at(*id));
+
+        // Keep the unindexed listing order when the ids came from several keys
+        if(sources.size() > 1)
+            std::sort(candidates.begin(), candidates.end(), SortAuctionsById);
+    }
+    else
+    {
+        candidates.reserve(auctions.size());
+        for(std::map<uint32, Auction*>::iterator itr = auctions.begin(); itr != auctions.end(); ++itr)
+            if(itr->second->m_item != NULL)
+                candidates.push_back(itr->second);
+    }
+
+    for(std::vector<Auction*>::iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
     {
-        if(itr->second->Deleted)
+        Auction *auct = *itr;
+        if(auct->Deleted)
             continue;
-        ItemPrototype *proto = itr->second->m_item->GetProto();
+        ItemPrototype *proto = auct->m_item->GetProto();
 
-        // Check the auction for parameters
+        // Check the auction for parameters, the picked index only covers one of them
 
         // inventory type
         if(inventory_type != -1 && inventory_type != (int32)proto->InventoryType)
@@ -580,7 +770,7 @@ void AuctionHouse::SendAuctionList(Player* plr, WorldPacket * packet)
         if(itemsubclass != -1 && itemsubclass != (int32)proto->SubClass)
             continue;
 
-        // this is going to hurt. - name
+        // name
         if(auctionstring.length() > 0 && !RONIN_UTIL::FindXinYString(auctionstring, proto->lowercase_name))
             continue;
 
@@ -627,7 +817,7 @@ void AuctionHouse::SendAuctionList(Player* plr, WorldPacket * packet)
         if(start_index && current_index < start_index) continue;
 
         // all checks passed -> add to packet.
-        itr->second->AddToPacket(data);
+        auct->AddToPacket(data);
         (*(uint32*)&data.contents()[0])++;
     }
 
@@ -673,8 +863,10 @@ void AuctionHouse::LoadAuctions()
         auct->depositAmount = fields[8].GetUInt64();
         auct->DeletedReason = 0;
         auct->Deleted = false;
+        auct->m_item = NULL;
 
         auctions.insert( std::make_pair( auct->Id, auct ) );
+        _IndexAuction(auct);
     } while (result->NextRow());
     delete result;
 }
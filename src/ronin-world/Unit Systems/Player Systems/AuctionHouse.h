@@ -21,6 +21,9 @@
 
 #pragma once
 
+// Name searches are matched through an index of every three character run in the lowercase item name
+#define AUCTION_NAME_GRAM_LENGTH 3
+
 enum AuctionRemoveType
 {
     AUCTION_REMOVE_EXPIRED,
@@ -71,6 +74,10 @@ struct Auction
     uint32 DeletedReason;
 };
 
+typedef std::set<uint32> AuctionIdSet;
+typedef std::map<uint32, AuctionIdSet> AuctionIndex;
+typedef std::vector<const AuctionIdSet*> AuctionIdSources;
+
 class AuctionHouse
 {
 public:
@@ -87,6 +94,7 @@ public:
     void AddAuction(Auction * auct);
     Auction * GetAuction(uint32 Id);
     void QueueDeletion(Auction * auct, uint32 Reason);
+    void SetHighestBid(Auction * auct, WoWGuid bidder, uint64 bid);
 
     void SendAuctionHello(WoWGuid guid, Player *plr);
     void SendOwnerListPacket(Player* plr, WorldPacket * packet);
@@ -103,6 +111,22 @@ private:
     RWLock auctionLock;
     std::map<uint32, Auction*> auctions;
 
+    // Secondary indices of auction ids, all guarded by auctionLock
+    void _IndexAuction(Auction *auct);
+    void _UnindexAuction(Auction *auct);
+    size_t _CollectRange(AuctionIndex &index, uint32 low, uint32 high, AuctionIdSources &out);
+    static uint32 _NameGram(const std::string &name, size_t offset);
+
+    AuctionIndex m_categoryIndex;       // Item class << 8 | subclass
+    AuctionIndex m_inventoryTypeIndex;
+    AuctionIndex m_qualityIndex;
+    AuctionIndex m_levelIndex;          // Required level
+    AuctionIndex m_nameIndex;           // Packed name grams
+    std::map<WoWGuid, AuctionIdSet> m_ownerIndex, m_bidderIndex;
+
+    // Min-heap of expiration time and auction id, cancelled auctions are skipped when popped
+    std::vector<std::pair<uint64, uint32> > m_expiryQueue;
+
     Mutex removalLock;
     std::list<Auction*> removalList;
 
@@ -550,6 +550,7 @@ void Group::RemovePlayer(PlayerInfo * info)
 
     m_dirty=true;
     sg->RemovePlayer(info);
+    m_memberStats.erase(info);
     --m_MemberCount;
 
     m_groupLock.Release();
@@ -1094,10 +1095,9 @@ void Group::UpdateOutOfRangePlayer(PlayerInfo *info, uint32 Flags, bool Distribu
             if(m_SubGroups[i]==NULL)
                 continue;
 
-            for(GroupMembersSet::iterator itr = m_SubGroups[i]->GetGroupMembersBegin(); itr != m_SubGroups[i]->GetGroupMembersEnd();)
+            for(GroupMembersSet::iterator itr = m_SubGroups[i]->GetGroupMembersBegin(); itr != m_SubGroups[i]->GetGroupMembersEnd(); ++itr)
             {
                 plr = (*itr)->m_loggedInPlayer;
-                ++itr;
                 if((*itr) == info || plr == NULL)
                     continue;
                 if(plr->IsVisible(info->charGuid))
@@ -1117,38 +1117,67 @@ void Group::UpdateAllOutOfRangePlayersFor(PlayerInfo *info)
     if(m_SubGroupCount>8)
         return;
 
+    m_groupLock.Acquire();
     WorldPacket data; /* tell the other players about us */
     UpdateOutOfRangePlayer(info, GROUP_UPDATE_FULL, true, &data);
 
-    /* tell us any other players we don't know about */
-    Player* plr;
+    // What we just sent is our full block, keep it for the next refresh
+    MemberStatsCache &cache = m_memberStats[info];
+    cache.builtFor = info->m_loggedInPlayer;
+    cache.stale = false;
+    cache.packet = data;
 
-    m_groupLock.Acquire();
-    for(uint32 i = 0; i < m_SubGroupCount; i++)
+    /* tell us any other players we don't know about */
+    if(info->m_loggedInPlayer != NULL)
     {
-        if(m_SubGroups[i]==NULL)
-            continue;
-
-        for(GroupMembersSet::iterator itr = m_SubGroups[i]->GetGroupMembersBegin(); itr != m_SubGroups[i]->GetGroupMembersEnd(); itr++)
+        for(uint32 i = 0; i < m_SubGroupCount; i++)
         {
-            if((*itr) == info || info->m_loggedInPlayer == NULL)
+            if(m_SubGroups[i]==NULL)
                 continue;
 
-            UpdateOutOfRangePlayer((*itr), GROUP_UPDATE_FULL, false, &data);
-            info->m_loggedInPlayer->PushPacket(&data);
+            for(GroupMembersSet::iterator itr = m_SubGroups[i]->GetGroupMembersBegin(); itr != m_SubGroups[i]->GetGroupMembersEnd(); itr++)
+            {
+                if((*itr) == info)
+                    continue;
+
+                GetCachedMemberStats((*itr), &data);
+                info->m_loggedInPlayer->PushPacket(&data);
+            }
         }
     }
 
     m_groupLock.Release();
 }
 
+void Group::GetCachedMemberStats(PlayerInfo *info, WorldPacket *data)
+{
+    Guard guard(m_groupLock);
+    MemberStatsCache &cache = m_memberStats[info];
+    if(cache.stale || cache.builtFor != info->m_loggedInPlayer || cache.packet.size() == 0)
+    {
+        UpdateOutOfRangePlayer(info, GROUP_UPDATE_FULL, false, &cache.packet);
+        cache.builtFor = info->m_loggedInPlayer;
+        cache.stale = false;
+    }
+    *data = cache.packet;
+}
+
+void Group::FlushMemberStats(Player *pPlayer, uint32 Flags)
+{
+    Guard guard(m_groupLock);
+    std::map<PlayerInfo*, MemberStatsCache>::iterator itr;
+    if((itr = m_memberStats.find(pPlayer->getPlayerInfo())) != m_memberStats.end())
+        itr->second.stale = true;
+
+    UpdateOutOfRangePlayer(pPlayer->getPlayerInfo(), Flags, true, NULL);
+}
+
 void Group::HandleUpdateFieldChange(uint32 Index, Player* pPlayer)
 {
     uint32 Flags = 0;
     if( m_dirty )//sth has corrupted this, workaround
         return;
 
-    m_groupLock.Acquire();
     switch(Index)
     {
     case UNIT_FIELD_HEALTH:
@@ -1182,17 +1211,14 @@ void Group::HandleUpdateFieldChange(uint32 Index, Player* pPlayer)
         break;
     }
 
+    // Coalesced on the player and flushed from its update, a raid in combat would otherwise build a packet per change
     if( Flags != 0 )
-        UpdateOutOfRangePlayer( pPlayer->getPlayerInfo(), Flags, true, NULL );
-
-    m_groupLock.Release();
+        pPlayer->AddPartyUpdateFlags(Flags);
 }
 
 void Group::HandlePartialChange(uint32 Type, Player* pPlayer)
 {
     uint32 Flags = 0;
-    m_groupLock.Acquire();
-
     switch(Type)
     {
     case PARTY_UPDATE_FLAG_LOCATION:
@@ -1201,9 +1227,7 @@ void Group::HandlePartialChange(uint32 Type, Player* pPlayer)
     }
 
     if(Flags)
-        UpdateOutOfRangePlayer(pPlayer->getPlayerInfo(), Flags, true, 0);
-
-    m_groupLock.Release();
+        pPlayer->AddPartyUpdateFlags(Flags);
 }
 
 void Group::FillLFDMembers(Loki::AssocVector<PlayerInfo*, uint8> *members)
@@ -1264,7 +1288,7 @@ void WorldSession::HandlePartyMemberStatsOpcode(WorldPacket & recv_data)
         return;
 
     WorldPacket data(200);
-    _player->GetGroup()->UpdateOutOfRangePlayer(plr->getPlayerInfo(), GROUP_UPDATE_FULL, false, &data);
+    _player->GetGroup()->GetCachedMemberStats(plr->getPlayerInfo(), &data);
     data.SetOpcode(SMSG_PARTY_MEMBER_STATS_FULL);
     SendPacket(&data);
 }
@@ -61,6 +61,9 @@ enum MaxGroupCount
     MAX_GROUP_SIZE_RAID     = 40,
 };
 
+// Out of range member stats are coalesced per member and flushed at most this often
+#define GROUP_MEMBER_STATS_INTERVAL 1000
+
 enum QuickGroupUpdateFlags
 {
     PARTY_UPDATE_FLAG_LOCATION          = 1,
@@ -204,6 +207,10 @@ public:
     void UpdateAllOutOfRangePlayersFor(PlayerInfo *info);
     void HandleUpdateFieldChange(uint32 Index, Player* pPlayer);
     void HandlePartialChange(uint32 Type, Player* pPlayer);
+    // Sends the member's coalesced flags to out of range members, called from the member's update
+    void FlushMemberStats(Player *pPlayer, uint32 Flags);
+    // Copies the member's full stats packet into data, rebuilding it only if something changed since the last build
+    void GetCachedMemberStats(PlayerInfo *info, WorldPacket *data);
 
     void FillLFDMembers(Loki::AssocVector<PlayerInfo*, uint8> *members);
 
@@ -254,6 +261,17 @@ protected:
     bool m_updateblock;
     uint8 m_groupFlags;
 
+    // Full SMSG_PARTY_MEMBER_STATS per member, invalidated whenever the member flushes changes
+    struct MemberStatsCache
+    {
+        MemberStatsCache() : builtFor(NULL), stale(true) {}
+
+        Player *builtFor;
+        bool stale;
+        WorldPacket packet;
+    };
+    std::map<PlayerInfo*, MemberStatsCache> m_memberStats;
+
     struct LFDDungeonData
     {
         uint32 dungeonId;
@@ -76,9 +76,12 @@ bool MailMessage::LoadFromDB(Field * fields)
 
 void MailMessage::SaveToDB()
 {
+    if(message_id == 0)
+        message_id = sMailSystem.GenerateMessageId();
+
     std::stringstream ss;
     std::vector< uint64 >::iterator itr;
-    ss << "REPLACE INTO mailbox VALUES("
+    ss << "("
         << message_id << ","
         << message_type << ","
         << player_guid << ","
@@ -99,26 +102,7 @@ void MailMessage::SaveToDB()
         << read_flag << ","
         << deleted_flag << ","
         << returned_flag << ")";
-    if(message_id == 0)
-    {
-        AsyncQuery * q = new AsyncQuery( new SQLClassCallbackP0<MailMessage>(this, &MailMessage::SaveToDBCallBack) );
-        q->AddQuery(ss.str().c_str());
-        q->AddQuery("SELECT LAST_INSERT_ID()");
-        CharacterDatabase.QueueAsyncQuery(q);
-    } else
-    {
-        CharacterDatabase.WaitExecute(ss.str().c_str());
-    }
-}
-
-void MailMessage::SaveToDBCallBack(QueryResultVector & results)
-{
-    QueryResult *result = results[1].result;
-    if(result)
-    {
-        Field *fields = result->Fetch();
-        message_id = fields[0].GetUInt32();
-    }
+    sMailSystem.QueueSave(this, ss.str());
 }
 
 bool MailMessage::Expired()
@@ -142,7 +126,7 @@ void Mailbox::DeleteMessage(MailMessage* Message)
     else
     {
         // delete the message, there are no other references to it.
-        CharacterDatabase.WaitExecute("DELETE FROM mailbox WHERE message_id = %u", Message->message_id);
+        sMailSystem.QueueDelete(Message->message_id);
         Messages.erase(Message->message_id);
     }
 }
@@ -274,7 +258,162 @@ void Mailbox::OnMessageCopyDeleted(uint32 msg_id)
 }
 void MailSystem::StartMailSystem()
 {
+    if(QueryResult *result = CharacterDatabase.Query("SELECT MAX(message_id) FROM mailbox"))
+    {
+        m_hiMessageId = result->Fetch()[0].GetUInt32();
+        delete result;
+    }
+
+    // Seed the expiry index once, every save keeps it current afterwards
+    if(QueryResult *result = CharacterDatabase.Query("SELECT message_id, player_guid, expiry_time FROM mailbox WHERE expiry_time > 0 AND deleted_flag = 0"))
+    {
+        m_mailLock.Acquire();
+        do
+        {
+            Field *fields = result->Fetch();
+            _TrackExpiry(fields[0].GetUInt32(), fields[1].GetUInt32(), fields[2].GetUInt32());
+        } while(result->NextRow());
+        m_mailLock.Release();
+        delete result;
+    }
+}
+
+uint32 MailSystem::GenerateMessageId()
+{
+    m_idLock.Acquire();
+    uint32 id = ++m_hiMessageId;
+    m_idLock.Release();
+    return id;
+}
+
+void MailSystem::_TrackExpiry(uint32 message_id, uint32 player_guid, uint32 expire_time)
+{
+    if(expire_time == 0)
+    {
+        m_expiryTimes.erase(message_id);
+        return;
+    }
+
+    std::map<uint32, std::pair<uint32, uint32> >::iterator itr = m_expiryTimes.find(message_id);
+    if(itr != m_expiryTimes.end() && itr->second.first == expire_time)
+        return;
+
+    m_expiryTimes[message_id] = std::make_pair(expire_time, player_guid);
+    m_expiryQueue.push_back(std::make_pair(expire_time, message_id));
+    std::push_heap(m_expiryQueue.begin(), m_expiryQueue.end(), std::greater<std::pair<uint32, uint32> >());
+}
+
+void MailSystem::QueueSave(MailMessage* message, const std::string &row)
+{
+    m_mailLock.Acquire();
+    m_pendingSaves[message->message_id] = std::make_pair((uint32)message->player_guid, row);
+    m_pendingDeletes.erase(message->message_id);
+    m_expiring.erase(message->message_id);
+    _TrackExpiry(message->message_id, (uint32)message->player_guid, message->deleted_flag ? 0 : message->expire_time);
+    m_mailLock.Release();
+}
 
+void MailSystem::QueueDelete(uint32 message_id)
+{
+    m_mailLock.Acquire();
+    m_pendingSaves.erase(message_id);
+    m_pendingDeletes.insert(message_id);
+    m_expiryTimes.erase(message_id);
+    m_expiring.erase(message_id);
+    m_mailLock.Release();
+}
+
+void MailSystem::DeletePlayerMail(uint32 player_guid)
+{
+    m_mailLock.Acquire();
+    for(std::map<uint32, std::pair<uint32, std::string> >::iterator itr = m_pendingSaves.begin(); itr != m_pendingSaves.end();)
+    {
+        if(itr->second.first == player_guid)
+            m_pendingSaves.erase(itr++);
+        else ++itr;
+    }
+
+    // Stale heap entries are skipped once their message is gone from the index
+    for(std::map<uint32, std::pair<uint32, uint32> >::iterator itr = m_expiryTimes.begin(); itr != m_expiryTimes.end();)
+    {
+        if(itr->second.second == player_guid)
+            m_expiryTimes.erase(itr++);
+        else ++itr;
+    }
+
+    for(std::map<uint32, uint32>::iterator itr = m_expiring.begin(); itr != m_expiring.end();)
+    {
+        if(itr->second == player_guid)
+            m_expiring.erase(itr++);
+        else ++itr;
+    }
+
+    m_pendingPlayerDeletes.insert(player_guid);
+    m_mailLock.Release();
+}
+
+void MailSystem::_BuildIdQueries(std::vector<std::string> &queries, const char *prefix, std::set<uint32> &ids)
+{
+    std::stringstream ss;
+    uint32 count = 0;
+    for(std::set<uint32>::iterator itr = ids.begin(); itr != ids.end(); itr++)
+    {
+        ss << (count ? "," : prefix) << (*itr);
+        if(++count == MAIL_ID_BATCH_SIZE)
+        {
+            ss << ")";
+            queries.push_back(ss.str());
+            ss.str("");
+            count = 0;
+        }
+    }
+    if(count)
+    {
+        ss << ")";
+        queries.push_back(ss.str());
+    }
+}
+
+void MailSystem::FlushWrites(bool wait)
+{
+    std::map<uint32, std::pair<uint32, std::string> > saves;
+    std::set<uint32> deletes, playerDeletes;
+    m_mailLock.Acquire();
+    saves.swap(m_pendingSaves);
+    deletes.swap(m_pendingDeletes);
+    playerDeletes.swap(m_pendingPlayerDeletes);
+    m_mailLock.Release();
+    if(saves.empty() && deletes.empty() && playerDeletes.empty())
+        return;
+
+    std::vector<std::string> queries;
+    std::stringstream ss;
+    uint32 count = 0;
+    for(std::map<uint32, std::pair<uint32, std::string> >::iterator itr = saves.begin(); itr != saves.end(); itr++)
+    {
+        ss << (count ? "," : "REPLACE INTO mailbox VALUES") << itr->second.second;
+        if(++count == MAIL_SAVE_BATCH_SIZE)
+        {
+            queries.push_back(ss.str());
+            ss.str("");
+            count = 0;
+        }
+    }
+    if(count)
+        queries.push_back(ss.str());
+
+    _BuildIdQueries(queries, "DELETE FROM mailbox WHERE message_id IN(", deletes);
+    _BuildIdQueries(queries, "DELETE FROM mailbox WHERE player_guid IN(", playerDeletes);
+
+    // Writes share the query thread's async queue with the expiry reads, so everything reaches the database in the order it was queued
+    AsyncQuery *q = new AsyncQuery(new SQLClassCallbackP0<MailSystem>(this, &MailSystem::_WritesFlushed));
+    for(std::vector<std::string>::iterator itr = queries.begin(); itr != queries.end(); itr++)
+        q->AddQueryStr(*itr);
+    CharacterDatabase.QueueThreadedAsyncQuery(q);
+
+    // Shutdown paths run this after the query thread has stopped, so drain the queue ourselves
+    if(wait)
+        CharacterDatabase.thread_proc_query();
 }
 
 void MailSystem::DeliverMessage(MailMessage* message)
@@ -311,7 +450,7 @@ void MailSystem::ReturnToSender(MailMessage* message)
             message->SaveToDB();
         }
         else
-            CharacterDatabase.WaitExecute("DELETE FROM mailbox WHERE message_id = %u", message->message_id);
+            QueueDelete(message->message_id);
     }
     else plr->m_mailBox->DeleteMessage(message);
 
@@ -362,20 +501,67 @@ void MailSystem::UpdateMessages(uint32 diff)
     if(update_timer > diff)
     {
         update_timer -= diff;
+        FlushWrites(false);
         return;
     }
-    else update_timer = 1200;
+    else update_timer = MAIL_EXPIRY_INTERVAL;
 
-    QueryResult *result = CharacterDatabase.Query("SELECT * FROM mailbox WHERE expiry_time > 0 and expiry_time <= %u and deleted_flag = 0",(uint32)UNIXTIME);
-    if(!result)
+    uint32 now = (uint32)UNIXTIME;
+    std::set<uint32> expired;
+    m_mailLock.Acquire();
+    while(!m_expiryQueue.empty() && m_expiryQueue.front().first <= now)
+    {
+        std::pair<uint32, uint32> entry = m_expiryQueue.front();
+        std::pop_heap(m_expiryQueue.begin(), m_expiryQueue.end(), std::greater<std::pair<uint32, uint32> >());
+        m_expiryQueue.pop_back();
+
+        // Deleted, or the expiry was moved since this entry was queued
+        std::map<uint32, std::pair<uint32, uint32> >::iterator itr = m_expiryTimes.find(entry.second);
+        if(itr == m_expiryTimes.end() || itr->second.first != entry.first)
+            continue;
+
+        // Any write to the message before the read comes back cancels the expiry, the save tracks it again
+        m_expiring[entry.second] = itr->second.second;
+        m_expiryTimes.erase(itr);
+        expired.insert(entry.second);
+    }
+    m_mailLock.Release();
+
+    // The read is queued behind the writes, so it sees every row as it was flushed
+    FlushWrites(false);
+    if(expired.empty())
         return;
 
-    MailMessage msg;
-    do
+    std::vector<std::string> queries;
+    _BuildIdQueries(queries, "SELECT * FROM mailbox WHERE deleted_flag = 0 AND message_id IN(", expired);
+    AsyncQuery *q = new AsyncQuery(new SQLClassCallbackP0<MailSystem>(this, &MailSystem::_ExpireMessages));
+    for(std::vector<std::string>::iterator itr = queries.begin(); itr != queries.end(); itr++)
+        q->AddQueryStr(*itr);
+    CharacterDatabase.QueueDeferredAsyncQuery(q);
+}
+
+void MailSystem::_ExpireMessages(QueryResultVector & results)
+{
+    for(QueryResultVector::iterator itr = results.begin(); itr != results.end(); itr++)
     {
-        if (msg.LoadFromDB(result->Fetch()))
+        QueryResult *result = itr->result;
+        if(result == NULL)
+            continue;
+
+        MailMessage msg;
+        do
         {
-            if (/*msg.Expired() &&*/ msg.items.size() == 0 && msg.money == 0)
+            if (!msg.LoadFromDB(result->Fetch()))
+                continue;
+
+            // Skip messages that were written after the read was queued, the row we have is stale
+            m_mailLock.Acquire();
+            bool current = m_expiring.erase(msg.message_id) != 0;
+            m_mailLock.Release();
+            if(!current)
+                continue;
+
+            if (msg.items.size() == 0 && msg.money == 0)
             {
                 if(msg.copy_made)
                 {
@@ -383,14 +569,13 @@ void MailSystem::UpdateMessages(uint32 diff)
                     msg.SaveToDB();
                 } else
                 {
-                    CharacterDatabase.WaitExecute("DELETE FROM mailbox WHERE message_id = %u", msg.message_id);
+                    QueueDelete(msg.message_id);
                 }
             }
             else
                 ReturnToSender(&msg);
-        }
-    } while(result->NextRow());
-    delete result;
+        } while(result->NextRow());
+    }
 }
 
 void WorldSession::HandleSendMail(WorldPacket & recv_data )
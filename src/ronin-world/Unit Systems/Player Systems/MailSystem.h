@@ -21,6 +21,11 @@
 
 #pragma once
 
+#define MAIL_EXPIRY_INTERVAL 1200
+// Rows per batched REPLACE statement, and ids per batched DELETE or SELECT
+#define MAIL_SAVE_BATCH_SIZE 100
+#define MAIL_ID_BATCH_SIZE 500
+
 enum MailCMD
 {
     MAIL_RES_MAIL_SENT = 0,
@@ -93,7 +98,6 @@ struct MailMessage
     bool returned_flag;
     bool LoadFromDB(Field * fields);
     void SaveToDB();
-    void SaveToDBCallBack(QueryResultVector & results);
     bool Expired();
 };
 
@@ -133,10 +137,20 @@ public:
 class SERVER_DECL MailSystem : public Singleton<MailSystem>
 {
 public:
-    MailSystem() { update_timer = config_flags = 0; };
+    MailSystem() { update_timer = config_flags = 0; m_hiMessageId = 0; };
 
     void StartMailSystem();
     void UpdateMessages(uint32 diff);
+
+    uint32 GenerateMessageId();
+
+    // Mailbox writes are applied in memory and persisted in batches from UpdateMessages
+    void QueueSave(MailMessage* message, const std::string &row);
+    void QueueDelete(uint32 message_id);
+    // Drops everything pending for a deleted character and removes their mailbox rows in order with other writes
+    void DeletePlayerMail(uint32 player_guid);
+    void FlushWrites(bool wait);
+
     void ReturnToSender(MailMessage* message);
     void DeliverMessage(MailMessage* message);
     void DeliverMessage(uint32 type, uint64 sender, uint64 receiver, std::string subject, std::string body, uint32 money, uint32 cod, WoWGuid item_guid, uint32 stationary, bool returned);
@@ -145,8 +159,28 @@ public:
     RONIN_INLINE bool MailOption(uint32 flag) { return (config_flags & flag) ? true : false; }
 
 private:
+    void _TrackExpiry(uint32 message_id, uint32 player_guid, uint32 expire_time);
+    void _BuildIdQueries(std::vector<std::string> &queries, const char *prefix, std::set<uint32> &ids);
+    void _WritesFlushed(QueryResultVector & results) {}
+    void _ExpireMessages(QueryResultVector & results);
+
     uint32 update_timer;
     uint32 config_flags;
+
+    Mutex m_idLock;
+    uint32 m_hiMessageId;
+
+    // Guards the pending writes and the expiry index
+    Mutex m_mailLock;
+    // Pending rows are keyed by message id and keep their owner so a character delete can drop them
+    std::map<uint32, std::pair<uint32, std::string> > m_pendingSaves;
+    std::set<uint32> m_pendingDeletes, m_pendingPlayerDeletes;
+
+    // Current expiry and owner per message plus a min-heap of expiry and message id, entries that no longer match are skipped
+    std::map<uint32, std::pair<uint32, uint32> > m_expiryTimes;
+    std::vector<std::pair<uint32, uint32> > m_expiryQueue;
+    // Messages whose expiry read is on the query thread, keyed to their owner
+    std::map<uint32, uint32> m_expiring;
 };
 
 #define sMailSystem MailSystem::getSingleton()
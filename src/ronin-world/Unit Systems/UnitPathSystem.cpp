@@ -59,10 +59,10 @@ bool UnitPathSystem::Update(uint32 msTime, uint32 uiDiff, bool fromMovement)
         if(msTime <= m_pathStartTime)
             return false;
 
-        while(m_movementPoints.HasItems() && m_movementPoints.at(0).get()->timeStamp < timeWalked)
+        while(!m_movementPoints.empty() && m_movementPoints.at(0).get()->timeStamp < timeWalked)
             m_movementPoints.pop_front();
 
-        if(timeWalked >= m_pathLength || !m_movementPoints.HasItems())
+        if(timeWalked >= m_pathLength || m_movementPoints.empty())
         {
             m_Unit->GetMovementInterface()->MoveClientPosition(_destX,_destY,_destZ,_destO);
             _CleanupPath();
@@ -168,7 +168,7 @@ void UnitPathSystem::SetSpeed(MovementSpeedTypes speedType)
 void UnitPathSystem::_CleanupPath()
 {
     _destX = _destY = fInfinite;
-    m_movementPoints.Clear();
+    m_movementPoints.clear();
 
     lastUpdatePoint.timeStamp = 0; // Clean up our last update point
     lastUpdatePoint.pos.x = lastUpdatePoint.pos.y = lastUpdatePoint.pos.z = fInfinite;
@@ -235,11 +235,11 @@ void UnitPathSystem::MoveToPoint(float x, float y, float z, float o)
                 if(ignoreTerrainHeight && lastCalcPoint > targetZ)
                     targetZ = lastCalcPoint;
 
-                m_movementPoints.Push(std::move(std::shared_ptr<MovementPoint>(new MovementPoint(timeToMove, px, py, targetZ))));
+                m_movementPoints.push_back(std::move(std::shared_ptr<MovementPoint>(new MovementPoint(timeToMove, px, py, targetZ))));
             }
         }
 
-        m_movementPoints.Push(std::move(std::shared_ptr<MovementPoint>(new MovementPoint(m_pathLength, _destX, _destY, _destZ))));
+        m_movementPoints.push_back(std::move(std::shared_ptr<MovementPoint>(new MovementPoint(m_pathLength, _destX, _destY, _destZ))));
     }
 
     BroadcastMovementPacket();
@@ -323,7 +323,7 @@ void UnitPathSystem::StopMoving()
 void UnitPathSystem::BroadcastMovementPacket(uint8 packetSendFlags)
 { 
     // Grab our destination point data
-    MovementPoint *lastPoint = m_movementPoints.HasItems() ? m_movementPoints.at(m_movementPoints.size()-1).get() : NULL;
+    MovementPoint *lastPoint = !m_movementPoints.empty() ? m_movementPoints.at(m_movementPoints.size()-1).get() : NULL;
     if(lastPoint == NULL)
         return;
     // Grab our start point data
@@ -398,7 +398,7 @@ void UnitPathSystem::SendMovementPacket(Player *plr, uint8 packetSendFlags)
 {
     if((m_Unit->GetPositionX() == _destX && m_Unit->GetPositionY() == _destY) || (_destX == fInfinite && _destY == fInfinite) || (lastUpdatePoint.timeStamp >= m_pathLength))
         return;
-    MovementPoint *lastPoint = m_movementPoints.HasItems() ? m_movementPoints.at(m_movementPoints.size()-1).get() : NULL;
+    MovementPoint *lastPoint = !m_movementPoints.empty() ? m_movementPoints.at(m_movementPoints.size()-1).get() : NULL;
     if(lastPoint == NULL)
         return;
 
@@ -472,7 +472,7 @@ void UnitPathSystem::AppendMoveBits(ByteBuffer *buffer, uint32 msTime, std::vect
         finalized = true;
     else if(closeToDestination(msTime))
         finalized = true;
-    MovementPoint *lastPoint = m_movementPoints.HasItems() ? m_movementPoints.at(m_movementPoints.size()-1).get() : NULL;
+    MovementPoint *lastPoint = !m_movementPoints.empty() ? m_movementPoints.at(m_movementPoints.size()-1).get() : NULL;
     if(lastPoint == NULL)
         finalized = true;
     if(!buffer->WriteBit(!finalized))
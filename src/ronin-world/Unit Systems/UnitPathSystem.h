@@ -100,7 +100,7 @@ private:
     MovementPoint srcPoint, lastUpdatePoint;
     float _destX, _destY, _destZ, _destO;
 
-    FastQueue<std::shared_ptr<MovementPoint>, Mutex> m_movementPoints;
+    std::deque<std::shared_ptr<MovementPoint>> m_movementPoints;
 
     uint32 m_lastMSTimeUpdate, m_lastPositionUpdate;
 };
@@ -0,0 +1,919 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BotStdAfx.h"
+
+#define BOT_STATE_TIMEOUT 60000
+#define BOT_HEARTBEAT_INTERVAL 500
+#define BOT_RUN_SPEED 7.0f
+#define BOT_MAX_CREATE_ATTEMPTS 3
+
+#define MOVEFLAG_FORWARD 0x01
+#define LANG_COMMON 7
+
+static const char *chatLines[] =
+{
+    "Anyone up for a dungeon?",
+    "Selling linen cloth, whisper me.",
+    "Where is the flight master?",
+    "LFG, any quest.",
+    "Nice weather in here today."
+};
+
+// Spreads timers out so thousands of bots don't all fire on the same tick
+static uint32 Jitter(uint32 mstime, uint32 interval)
+{
+    return mstime + interval/2 + RandomUInt(interval);
+}
+
+Bot::Bot(uint32 index) : m_index(index), m_state(BOT_STATE_IDLE), m_guid(0)
+{
+    const BotSwarmConfig &config = sBotSwarm.GetConfig();
+    m_accountName = format("%s%u", config.accountPrefix.c_str(), index);
+    RONIN_UTIL::TOUPPER(m_accountName);
+    m_password = config.password;
+
+    m_logonSocket = NULL;
+    m_worldSocket = NULL;
+    m_logonResult = BOT_LOGON_PENDING;
+    memset(m_sessionKey, 0, 40);
+    for(uint32 i = 0; i < BOT_LATENCY_MAX; ++i)
+        m_requestTimes[i].store(0, std::memory_order_relaxed);
+
+    m_lastUpdate = m_stateTimeout = m_nextAttempt = m_nextExpireCheck = 0;
+    m_createAttempts = 0;
+    m_inWorld = false;
+
+    m_mapId = 0;
+    m_x = m_y = m_z = m_o = m_centerX = m_centerY = 0.f;
+    m_pathIndex = m_nextHeartbeat = m_moveResume = 0;
+    m_moving = false;
+
+    m_nextPing = m_nextChat = m_nextCast = m_nextTrade = m_nextWorldport = 0;
+    m_pingSerial = 0;
+    m_castCount = 0;
+}
+
+Bot::~Bot()
+{
+    WorldPacket *packet;
+    while((packet = _recvQueue.Pop()))
+        delete packet;
+}
+
+bool Bot::FinishRequest(BotLatencyType type)
+{
+    uint32 start = m_requestTimes[type].exchange(0, std::memory_order_relaxed);
+    if(start == 0)
+        return false;
+
+    sBotStats.AddSample(type, getMSTimeDiff(getMSTime(), start));
+    return true;
+}
+
+void Bot::OnLogonComplete(uint8 *sessionKey, std::string address)
+{
+    m_lock.Acquire();
+    memcpy(m_sessionKey, sessionKey, 40);
+    m_worldAddress = address;
+    m_logonResult = BOT_LOGON_SUCCESS;
+    m_logonSocket = NULL;
+    m_lock.Release();
+}
+
+void Bot::OnLogonFailed(const char *reason)
+{
+    m_lock.Acquire();
+    m_logonError = reason;
+    m_logonResult = BOT_LOGON_FAILED;
+    m_logonSocket = NULL;
+    m_lock.Release();
+}
+
+void Bot::QueuePacket(WorldPacket *packet)
+{
+    // Responses are timed here on the network thread, before they wait on our update thread
+    switch(packet->GetOpcode())
+    {
+    case WIRE_SMSG_PONG:
+        FinishRequest(BOT_LATENCY_PING);
+        delete packet;
+        return;
+    case WIRE_SMSG_AUTH_RESPONSE:
+        FinishRequest(BOT_LATENCY_AUTH_SESSION);
+        break;
+    case WIRE_SMSG_CHAR_ENUM:
+        FinishRequest(BOT_LATENCY_CHAR_ENUM);
+        break;
+    case WIRE_SMSG_CHAR_CREATE:
+        FinishRequest(BOT_LATENCY_CHAR_CREATE);
+        break;
+    case WIRE_SMSG_LOGIN_VERIFY_WORLD:
+        FinishRequest(BOT_LATENCY_PLAYER_LOGIN);
+        FinishRequest(BOT_LATENCY_FULL_LOGIN);
+        break;
+    case WIRE_SMSG_NEW_WORLD:
+        FinishRequest(BOT_LATENCY_WORLDPORT);
+        break;
+    case WIRE_SMSG_TRADE_STATUS:
+        if(!FinishRequest(BOT_LATENCY_TRADE))
+        {
+            delete packet;
+            return;
+        }
+        break;
+    case WIRE_SMSG_TIME_SYNC_REQ:
+        break;
+    case WIRE_SMSG_MESSAGECHAT:
+    case WIRE_SMSG_GM_MESSAGECHAT:
+        if(HasRequest(BOT_LATENCY_CHAT) && packet->size() >= 13 && packet->read<uint64>(5) == m_guid.load(std::memory_order_relaxed))
+            FinishRequest(BOT_LATENCY_CHAT);
+        delete packet;
+        return;
+    case WIRE_SMSG_SPELL_START:
+    case WIRE_SMSG_SPELL_GO:
+        if(HasRequest(BOT_LATENCY_CAST) && _IsOwnGuid(packet, true))
+            FinishRequest(BOT_LATENCY_CAST);
+        delete packet;
+        return;
+    case WIRE_SMSG_CAST_FAILED:
+        FinishRequest(BOT_LATENCY_CAST);
+        delete packet;
+        return;
+    default:
+        delete packet;
+        return;
+    }
+
+    _recvQueue.Push(packet);
+}
+
+bool Bot::_IsOwnGuid(WorldPacket *packet, bool packed)
+{
+    WoWGuid casterItem, caster;
+    try
+    {
+        // Spell packets lead with the casting item or unit, then the unit itself
+        *packet >> casterItem.asPacked() >> caster.asPacked();
+    }
+    catch(ByteBufferException &)
+    {
+        return false;
+    }
+    return caster == m_guid.load(std::memory_order_relaxed);
+}
+
+void Bot::OnSocketDisconnect(BotSocket *socket)
+{
+    m_lock.Acquire();
+    if(m_worldSocket == socket)
+        m_worldSocket = NULL;
+    m_lock.Release();
+}
+
+void Bot::_SendPacket(WorldPacket *packet)
+{
+    // Never call into the socket while holding our lock, its disconnect path takes the lock too
+    m_lock.Acquire();
+    BotSocket *socket = m_worldSocket;
+    m_lock.Release();
+    if(socket)
+        socket->SendPacket(packet);
+}
+
+void Bot::_Disconnect()
+{
+    m_lock.Acquire();
+    LogonClient *logon = m_logonSocket;
+    BotSocket *world = m_worldSocket;
+    m_logonSocket = NULL;
+    m_worldSocket = NULL;
+    m_lock.Release();
+
+    if(logon)
+    {
+        logon->ClearBot();
+        logon->Disconnect();
+    }
+
+    if(world)
+    {
+        world->ClearBot();
+        world->Disconnect();
+    }
+
+    WorldPacket *packet;
+    while((packet = _recvQueue.Pop()))
+        delete packet;
+    for(uint32 i = 0; i < BOT_LATENCY_MAX; ++i)
+        m_requestTimes[i].store(0, std::memory_order_relaxed);
+
+    if(m_inWorld)
+    {
+        sBotSwarm.RemoveInWorld(m_guid);
+        sBotStats.AddInWorld(-1);
+        m_inWorld = false;
+    }
+    m_moving = false;
+}
+
+void Bot::Stop()
+{
+    _Disconnect();
+    m_state = BOT_STATE_IDLE;
+}
+
+void Bot::_Reconnect(uint32 mstime, BotCounterType reason)
+{
+    sBotStats.Add(reason);
+    _Disconnect();
+    m_state = BOT_STATE_RECONNECT;
+    m_nextAttempt = mstime + sBotSwarm.GetConfig().reconnectDelay;
+}
+
+void Bot::_StartLogon(uint32 mstime)
+{
+    const BotSwarmConfig &config = sBotSwarm.GetConfig();
+
+    m_lock.Acquire();
+    m_logonResult = BOT_LOGON_PENDING;
+    m_logonError.clear();
+    m_lock.Release();
+
+    StartRequest(BOT_LATENCY_FULL_LOGIN);
+    m_state = BOT_STATE_LOGON;
+    m_stateTimeout = mstime + BOT_STATE_TIMEOUT;
+
+    // The socket may fail us from a network thread before we get to store it
+    LogonClient *logon = ConnectBotSocket<LogonClient>(config.logonHost.c_str(), config.logonPort, this);
+    if(logon == NULL)
+    {
+        sLog.Debug("Bot", "%s could not connect to the logon server", m_accountName.c_str());
+        _Reconnect(mstime, BOT_COUNTER_LOGON_FAILURES);
+        return;
+    }
+
+    m_lock.Acquire();
+    if(m_logonResult == BOT_LOGON_PENDING)
+        m_logonSocket = logon;
+    m_lock.Release();
+}
+
+void Bot::_ConnectWorld(uint32 mstime)
+{
+    const BotSwarmConfig &config = sBotSwarm.GetConfig();
+
+    std::string host = m_worldAddress;
+    uint32 port = 8129;
+    std::string::size_type pos = m_worldAddress.rfind(':');
+    if(pos != std::string::npos)
+    {
+        host = m_worldAddress.substr(0, pos);
+        port = atol(m_worldAddress.substr(pos+1).c_str());
+    }
+    if(!config.worldHost.empty())
+        host = config.worldHost;
+
+    m_state = BOT_STATE_WORLD_AUTH;
+    m_stateTimeout = mstime + BOT_STATE_TIMEOUT;
+    m_createAttempts = 0;
+
+    BotSocket *world = ConnectBotSocket<BotSocket>(host.c_str(), port, this);
+    if(world == NULL)
+    {
+        sLog.Debug("Bot", "%s could not connect to the world server at %s:%u", m_accountName.c_str(), host.c_str(), port);
+        _Reconnect(mstime, BOT_COUNTER_WORLD_FAILURES);
+        return;
+    }
+
+    m_lock.Acquire();
+    if(world->IsConnected())
+        m_worldSocket = world;
+    m_lock.Release();
+}
+
+void Bot::_ExpireRequests(uint32 mstime)
+{
+    uint32 timeout = sBotSwarm.GetConfig().requestTimeout;
+    for(uint32 i = 0; i < BOT_LATENCY_MAX; ++i)
+    {
+        uint32 start = m_requestTimes[i].load(std::memory_order_relaxed);
+        if(start == 0 || getMSTimeDiff(mstime, start) < timeout)
+            continue;
+
+        // The response may land between our load and here, only count it if we cleared it
+        if(m_requestTimes[i].compare_exchange_strong(start, 0, std::memory_order_relaxed))
+            sBotStats.Add(BOT_COUNTER_TIMEOUTS);
+    }
+}
+
+void Bot::Update(uint32 mstime)
+{
+    uint32 diff = m_lastUpdate ? getMSTimeDiff(mstime, m_lastUpdate) : 0;
+    m_lastUpdate = mstime;
+
+    switch(m_state)
+    {
+    case BOT_STATE_IDLE:
+    case BOT_STATE_RECONNECT:
+        {
+            if(m_nextAttempt == 0 || mstime >= m_nextAttempt)
+                _StartLogon(mstime);
+        }return;
+    case BOT_STATE_LOGON:
+        {
+            m_lock.Acquire();
+            BotLogonResult result = m_logonResult;
+            std::string error = m_logonError;
+            m_lock.Release();
+
+            if(result == BOT_LOGON_SUCCESS)
+            {
+                _ConnectWorld(mstime);
+                return;
+            }
+
+            if(result == BOT_LOGON_FAILED)
+            {
+                sLog.Debug("Bot", "%s failed logon: %s", m_accountName.c_str(), error.c_str());
+                _Reconnect(mstime, BOT_COUNTER_LOGON_FAILURES);
+            }
+            else if(mstime >= m_stateTimeout)
+                _Reconnect(mstime, BOT_COUNTER_TIMEOUTS);
+        }return;
+    default:
+        break;
+    }
+
+    // Everything past logon needs our world connection
+    m_lock.Acquire();
+    bool connected = m_worldSocket != NULL;
+    m_lock.Release();
+    if(!connected)
+    {
+        _Reconnect(mstime, BOT_COUNTER_DISCONNECTS);
+        return;
+    }
+
+    WorldPacket *packet;
+    while(m_state != BOT_STATE_RECONNECT && (packet = _recvQueue.Pop()))
+    {
+        try
+        {
+            _HandlePacket(packet, mstime);
+        }
+        catch(ByteBufferException &)
+        {
+            sLog.Debug("Bot", "%s received a malformed packet 0x%.4X", m_accountName.c_str(), packet->GetOpcode());
+        }
+        delete packet;
+    }
+
+    switch(m_state)
+    {
+    case BOT_STATE_IN_WORLD:
+        _UpdateMovement(mstime, diff);
+        _UpdateScript(mstime);
+        break;
+    case BOT_STATE_TRANSFERRING:
+        // Our worldport timed out, most likely the account can't use the command
+        if(!HasRequest(BOT_LATENCY_WORLDPORT))
+            m_state = BOT_STATE_IN_WORLD;
+        break;
+    case BOT_STATE_RECONNECT:
+        return;
+    default:
+        if(mstime >= m_stateTimeout)
+            _Reconnect(mstime, BOT_COUNTER_TIMEOUTS);
+        break;
+    }
+
+    if(mstime >= m_nextExpireCheck)
+    {
+        _ExpireRequests(mstime);
+        m_nextExpireCheck = mstime + 1000;
+    }
+}
+
+void Bot::_HandlePacket(WorldPacket *packet, uint32 mstime)
+{
+    switch(packet->GetOpcode())
+    {
+    case WIRE_SMSG_AUTH_RESPONSE:
+        _HandleAuthResponse(packet, mstime);
+        break;
+    case WIRE_SMSG_CHAR_ENUM:
+        _HandleCharEnum(packet, mstime);
+        break;
+    case WIRE_SMSG_CHAR_CREATE:
+        _HandleCharCreate(packet, mstime);
+        break;
+    case WIRE_SMSG_LOGIN_VERIFY_WORLD:
+        _HandleLoginVerifyWorld(packet, mstime);
+        break;
+    case WIRE_SMSG_NEW_WORLD:
+        _HandleNewWorld(packet, mstime);
+        break;
+    case WIRE_SMSG_TIME_SYNC_REQ:
+        _HandleTimeSyncReq(packet);
+        break;
+    case WIRE_SMSG_TRADE_STATUS:
+        {
+            // We only open trades to time them, close it straight away
+            WorldPacket data(WIRE_CMSG_CANCEL_TRADE, 0);
+            _SendPacket(&data);
+        }break;
+    }
+}
+
+void Bot::_HandleAuthResponse(WorldPacket *packet, uint32 mstime)
+{
+    if(m_state != BOT_STATE_WORLD_AUTH)
+        return;
+
+    packet->ReadBit();
+    packet->read_skip(15);
+    uint8 code = packet->read<uint8>();
+    if(code == AUTH_WAIT_QUEUE)
+    {
+        // Still queued, the server sends us another response once we're in
+        m_stateTimeout = mstime + BOT_STATE_TIMEOUT;
+        return;
+    }
+
+    if(code != AUTH_OK)
+    {
+        sLog.Debug("Bot", "%s was refused by the world server with code 0x%.2X", m_accountName.c_str(), code);
+        _Reconnect(mstime, BOT_COUNTER_WORLD_FAILURES);
+        return;
+    }
+
+    m_state = BOT_STATE_CHAR_SELECT;
+    m_stateTimeout = mstime + BOT_STATE_TIMEOUT;
+
+    WorldPacket data(WIRE_CMSG_CHAR_ENUM, 0);
+    StartRequest(BOT_LATENCY_CHAR_ENUM);
+    _SendPacket(&data);
+}
+
+void Bot::_HandleCharEnum(WorldPacket *packet, uint32 mstime)
+{
+    if(m_state != BOT_STATE_CHAR_SELECT)
+        return;
+
+    packet->ReadBits(23);
+    packet->ReadBit();
+    uint32 count = packet->ReadBits(17);
+
+    std::vector<WoWGuid> guids(count), guildGuids(count);
+    std::vector<uint32> nameLengths(count);
+    for(uint32 i = 0; i < count; ++i)
+    {
+        WoWGuid &guid = guids[i], &gguid = guildGuids[i];
+        guid[3] = packet->ReadBit();
+        gguid[1] = packet->ReadBit();
+        gguid[7] = packet->ReadBit();
+        gguid[2] = packet->ReadBit();
+        nameLengths[i] = packet->ReadBits(7);
+        guid[4] = packet->ReadBit();
+        guid[7] = packet->ReadBit();
+        gguid[3] = packet->ReadBit();
+        guid[5] = packet->ReadBit();
+        gguid[6] = packet->ReadBit();
+        guid[1] = packet->ReadBit();
+        gguid[5] = packet->ReadBit();
+        gguid[4] = packet->ReadBit();
+        packet->ReadBit(); // First login
+        guid[0] = packet->ReadBit();
+        guid[2] = packet->ReadBit();
+        guid[6] = packet->ReadBit();
+        gguid[0] = packet->ReadBit();
+    }
+
+    // We only need the guids, but every field has to be walked to find them
+    for(uint32 i = 0; i < count; ++i)
+    {
+        WoWGuid &guid = guids[i], &gguid = guildGuids[i];
+        packet->read_skip<uint8>();
+        packet->read_skip(23 * 9);  // Equipment and bag displays
+        packet->read_skip<uint32>();
+        packet->ReadByteSeq(gguid[2]);
+        packet->read_skip<uint8>();
+        packet->read_skip<uint8>();
+        packet->ReadByteSeq(gguid[3]);
+        packet->read_skip(8);
+        packet->read_skip<uint8>();
+        packet->ReadByteSeq(guid[4]);
+        packet->read_skip<uint32>();
+        packet->ReadByteSeq(gguid[5]);
+        packet->read_skip<float>();
+        packet->ReadByteSeq(gguid[6]);
+        packet->read_skip<uint32>();
+        packet->ReadByteSeq(guid[3]);
+        packet->read_skip<float>();
+        packet->read_skip<uint32>();
+        packet->read_skip<uint8>();
+        packet->ReadByteSeq(guid[7]);
+        packet->read_skip<uint8>();
+        packet->read_skip(nameLengths[i]);
+        packet->read_skip<uint8>();
+        packet->ReadByteSeq(guid[0]);
+        packet->ReadByteSeq(guid[2]);
+        packet->ReadByteSeq(gguid[1]);
+        packet->ReadByteSeq(gguid[7]);
+        packet->read_skip<float>();
+        packet->read_skip(3);
+        packet->ReadByteSeq(guid[6]);
+        packet->ReadByteSeq(gguid[4]);
+        packet->ReadByteSeq(gguid[0]);
+        packet->ReadByteSeq(guid[5]);
+        packet->ReadByteSeq(guid[1]);
+        packet->read_skip<uint32>();
+    }
+
+    if(count == 0)
+    {
+        if(m_createAttempts >= BOT_MAX_CREATE_ATTEMPTS)
+        {
+            _Reconnect(mstime, BOT_COUNTER_WORLD_FAILURES);
+            return;
+        }
+
+        const BotSwarmConfig &config = sBotSwarm.GetConfig();
+        WorldPacket data(WIRE_CMSG_CHAR_CREATE, 32);
+        data << _GetCharacterName();
+        data << uint8(config.race) << uint8(config.classId) << uint8(RandomUInt(1));
+        data << uint32(RandomUInt(4) | (RandomUInt(4) << 8) | (RandomUInt(4) << 16) | (RandomUInt(4) << 24));
+        data << uint8(0) << uint8(0);
+        ++m_createAttempts;
+        StartRequest(BOT_LATENCY_CHAR_CREATE);
+        _SendPacket(&data);
+        return;
+    }
+
+    WoWGuid guid = guids[0];
+    m_guid.store(guid.raw(), std::memory_order_relaxed);
+    m_state = BOT_STATE_LOGGING_IN;
+    m_stateTimeout = mstime + BOT_STATE_TIMEOUT;
+
+    WorldPacket data(WIRE_CMSG_PLAYER_LOGIN, 9);
+    data.WriteGuidBitString(8, guid, 2, 3, 0, 6, 4, 5, 1, 7);
+    data.FlushBits();
+    data.WriteSeqByteString(8, guid, 2, 7, 0, 3, 5, 6, 1, 4);
+    StartRequest(BOT_LATENCY_PLAYER_LOGIN);
+    _SendPacket(&data);
+}
+
+void Bot::_HandleCharCreate(WorldPacket *packet, uint32 mstime)
+{
+    if(m_state != BOT_STATE_CHAR_SELECT)
+        return;
+
+    uint8 code = packet->read<uint8>();
+    if(code != CHAR_CREATE_SUCCESS)
+        sLog.Debug("Bot", "%s failed to create a character with code 0x%.2X", m_accountName.c_str(), code);
+
+    // Either way we go back through the enum, it creates again with a new name if we're still empty
+    WorldPacket data(WIRE_CMSG_CHAR_ENUM, 0);
+    StartRequest(BOT_LATENCY_CHAR_ENUM);
+    _SendPacket(&data);
+}
+
+std::string Bot::_GetCharacterName()
+{
+    // Names are letters only, so spell out our index and retry count in base 26
+    std::string name = sBotSwarm.GetConfig().namePrefix;
+    uint32 value = m_index + m_createAttempts * 7919 * 26 * 26;
+    for(uint32 i = 0; i < 5; ++i)
+    {
+        name += char('a' + (value % 26));
+        value /= 26;
+    }
+    return name;
+}
+
+void Bot::_HandleLoginVerifyWorld(WorldPacket *packet, uint32 mstime)
+{
+    if(m_state != BOT_STATE_LOGGING_IN)
+        return;
+
+    *packet >> m_mapId >> m_x >> m_y >> m_z >> m_o;
+
+    const BotSwarmConfig &config = sBotSwarm.GetConfig();
+    m_state = BOT_STATE_IN_WORLD;
+    m_inWorld = true;
+    sBotStats.AddInWorld(1);
+    sBotSwarm.AddInWorld(m_guid, m_mapId);
+    _BuildPath();
+
+    m_moveResume = mstime + RandomUInt(config.pathPause);
+    m_nextPing = Jitter(mstime, config.pingInterval);
+    m_nextChat = Jitter(mstime, config.chatInterval);
+    m_nextCast = Jitter(mstime, config.castInterval);
+    m_nextTrade = Jitter(mstime, config.tradeInterval);
+    m_nextWorldport = Jitter(mstime, config.worldportInterval);
+}
+
+void Bot::_HandleNewWorld(WorldPacket *packet, uint32 mstime)
+{
+    *packet >> m_x >> m_o >> m_y >> m_mapId >> m_z;
+
+    WorldPacket data(WIRE_MSG_MOVE_WORLDPORT_ACK, 0);
+    _SendPacket(&data);
+
+    sBotSwarm.RemoveInWorld(m_guid);
+    sBotSwarm.AddInWorld(m_guid, m_mapId);
+    _BuildPath();
+    m_state = BOT_STATE_IN_WORLD;
+    m_moveResume = mstime + sBotSwarm.GetConfig().pathPause;
+}
+
+void Bot::_HandleTimeSyncReq(WorldPacket *packet)
+{
+    // The counter has to be echoed back or the server drops us
+    uint32 counter = packet->read<uint32>();
+    WorldPacket data(WIRE_CMSG_TIME_SYNC_RESP, 8);
+    data << counter << getMSTime();
+    _SendPacket(&data);
+}
+
+void Bot::_BuildPath()
+{
+    const BotSwarmConfig &config = sBotSwarm.GetConfig();
+    m_centerX = m_x;
+    m_centerY = m_y;
+    m_path.clear();
+    m_pathIndex = 0;
+    m_moving = false;
+
+    uint32 points = std::max<uint32>(3, config.pathPoints);
+    float phase = RandomFloat(float(M_PI * 2.));
+    for(uint32 i = 0; i < points; ++i)
+    {
+        float angle = phase + float(M_PI * 2.) * float(i) / float(points);
+        m_path.push_back(std::make_pair(m_centerX + cos(angle) * config.pathRadius, m_centerY + sin(angle) * config.pathRadius));
+    }
+}
+
+void Bot::_UpdateMovement(uint32 mstime, uint32 diff)
+{
+    if(m_path.empty())
+        return;
+
+    if(!m_moving)
+    {
+        if(mstime < m_moveResume)
+            return;
+
+        m_o = atan2(m_path[m_pathIndex].second - m_y, m_path[m_pathIndex].first - m_x);
+        m_moving = true;
+        m_nextHeartbeat = mstime + BOT_HEARTBEAT_INTERVAL;
+        _SendMovement(WIRE_MSG_MOVE_START_FORWARD, mstime);
+        return;
+    }
+
+    float travel = BOT_RUN_SPEED * float(diff) / 1000.f;
+    while(travel > 0.f)
+    {
+        float dx = m_path[m_pathIndex].first - m_x, dy = m_path[m_pathIndex].second - m_y;
+        float dist = sqrt(dx*dx + dy*dy);
+        if(dist > travel)
+        {
+            m_x += dx * travel / dist;
+            m_y += dy * travel / dist;
+            break;
+        }
+
+        m_x = m_path[m_pathIndex].first;
+        m_y = m_path[m_pathIndex].second;
+        travel -= dist;
+        if(++m_pathIndex == m_path.size())
+        {
+            // Pause after every lap, that's where we cast
+            m_pathIndex = 0;
+            m_moving = false;
+            m_moveResume = mstime + sBotSwarm.GetConfig().pathPause;
+            _SendMovement(WIRE_MSG_MOVE_STOP, mstime);
+            return;
+        }
+
+        m_o = atan2(m_path[m_pathIndex].second - m_y, m_path[m_pathIndex].first - m_x);
+        m_nextHeartbeat = 0;
+    }
+
+    if(mstime >= m_nextHeartbeat)
+    {
+        m_nextHeartbeat = mstime + BOT_HEARTBEAT_INTERVAL;
+        _SendMovement(WIRE_MSG_MOVE_HEARTBEAT, mstime);
+    }
+}
+
+void Bot::_SendMovement(uint16 opcode, uint32 mstime)
+{
+    // Presence bits for optional fields are inverted, a zero means the field follows
+    WoWGuid guid = m_guid.load(std::memory_order_relaxed);
+    WorldPacket data(opcode, 40);
+    switch(opcode)
+    {
+    case WIRE_MSG_MOVE_START_FORWARD:
+        {
+            data << m_y << m_z << m_x;
+            data.WriteBit(guid[5]);
+            data.WriteBit(guid[2]);
+            data.WriteBit(guid[0]);
+            data.WriteBit(0);
+            data.WriteBit(0); // Has movement flags
+            data.WriteBit(guid[7]);
+            data.WriteBit(guid[3]);
+            data.WriteBit(guid[1]);
+            data.WriteBit(0); // Has orientation
+            data.WriteBit(guid[6]);
+            data.WriteBit(0);
+            data.WriteBit(1);
+            data.WriteBit(guid[4]);
+            data.WriteBit(0);
+            data.WriteBit(0); // Has timestamp
+            data.WriteBit(1);
+            data.WriteBit(1);
+            data.WriteBit(0);
+            data.WriteBits(MOVEFLAG_FORWARD, 30);
+            data.FlushBits();
+            data.WriteSeqByteString(8, guid, 2, 4, 6, 1, 7, 3, 5, 0);
+            data << m_o << mstime;
+        }break;
+    case WIRE_MSG_MOVE_HEARTBEAT:
+        {
+            data << m_z << m_x << m_y;
+            data.WriteBit(1);
+            data.WriteBit(0); // Has timestamp
+            data.WriteBit(0);
+            data.WriteBit(1);
+            data.WriteBit(0);
+            data.WriteBit(guid[7]);
+            data.WriteBit(guid[1]);
+            data.WriteBit(guid[0]);
+            data.WriteBit(guid[4]);
+            data.WriteBit(guid[2]);
+            data.WriteBit(0); // Has orientation
+            data.WriteBit(guid[5]);
+            data.WriteBit(guid[3]);
+            data.WriteBit(1);
+            data.WriteBit(0);
+            data.WriteBit(0);
+            data.WriteBit(guid[6]);
+            data.WriteBit(0); // Has movement flags
+            data.WriteBits(MOVEFLAG_FORWARD, 30);
+            data.FlushBits();
+            data.WriteSeqByteString(8, guid, 3, 6, 1, 7, 2, 5, 0, 4);
+            data << m_o << mstime;
+        }break;
+    case WIRE_MSG_MOVE_STOP:
+        {
+            data << m_x << m_y << m_z;
+            data.WriteBit(guid[3]);
+            data.WriteBit(guid[6]);
+            data.WriteBit(1);
+            data.WriteBit(0);
+            data.WriteBit(0); // Has orientation
+            data.WriteBit(guid[7]);
+            data.WriteBit(1); // No movement flags once stopped
+            data.WriteBit(guid[5]);
+            data.WriteBit(0);
+            data.WriteBit(1);
+            data.WriteBit(0);
+            data.WriteBit(0); // Has timestamp
+            data.WriteBit(guid[4]);
+            data.WriteBit(guid[1]);
+            data.WriteBit(0);
+            data.WriteBit(guid[2]);
+            data.WriteBit(guid[0]);
+            data.WriteBit(1);
+            data.FlushBits();
+            data.WriteSeqByteString(8, guid, 6, 3, 0, 4, 2, 1, 5, 7);
+            data << mstime << m_o;
+        }break;
+    }
+    _SendPacket(&data);
+}
+
+void Bot::_UpdateScript(uint32 mstime)
+{
+    const BotSwarmConfig &config = sBotSwarm.GetConfig();
+    if(config.pingInterval && mstime >= m_nextPing)
+    {
+        m_nextPing = mstime + config.pingInterval;
+        if(!HasRequest(BOT_LATENCY_PING))
+            _SendPing();
+    }
+
+    if(config.chatInterval && mstime >= m_nextChat)
+    {
+        m_nextChat = Jitter(mstime, config.chatInterval);
+        if(!HasRequest(BOT_LATENCY_CHAT))
+            _SendChat(chatLines[RandomUInt(uint32(sizeof(chatLines)/sizeof(chatLines[0])) - 1)]);
+    }
+
+    // Casting on the move just fails, so hold it until we pause
+    if(config.castInterval && mstime >= m_nextCast && !m_moving)
+    {
+        m_nextCast = Jitter(mstime, config.castInterval);
+        if(!HasRequest(BOT_LATENCY_CAST))
+            _SendCast();
+    }
+
+    if(config.tradeInterval && mstime >= m_nextTrade)
+    {
+        m_nextTrade = Jitter(mstime, config.tradeInterval);
+        if(!HasRequest(BOT_LATENCY_TRADE))
+            _SendTrade();
+    }
+
+    if(config.worldportInterval && mstime >= m_nextWorldport && !config.destinations.empty())
+    {
+        m_nextWorldport = Jitter(mstime, config.worldportInterval);
+        _SendWorldport();
+    }
+}
+
+void Bot::_SendPing()
+{
+    WorldPacket data(WIRE_CMSG_PING, 8);
+    data << uint32(0) << ++m_pingSerial;
+    StartRequest(BOT_LATENCY_PING);
+    _SendPacket(&data);
+}
+
+void Bot::_SendChat(std::string message)
+{
+    WorldPacket data(WIRE_CMSG_MESSAGECHAT_SAY, 8 + message.length());
+    data << uint32(LANG_COMMON);
+    data.WriteBits(message.length(), 9);
+    data.FlushBits();
+    data.WriteString(message);
+    if(message[0] != '.')
+        StartRequest(BOT_LATENCY_CHAT);
+    _SendPacket(&data);
+}
+
+void Bot::_SendCast()
+{
+    WorldPacket data(WIRE_CMSG_CAST_SPELL, 14);
+    data << uint8(++m_castCount) << uint32(sBotSwarm.GetConfig().castSpell);
+    data << uint32(0) << uint8(0) << uint32(0); // Self target
+    StartRequest(BOT_LATENCY_CAST);
+    _SendPacket(&data);
+}
+
+void Bot::_SendTrade()
+{
+    WoWGuid partner = sBotSwarm.GetTradePartner(m_guid, m_mapId);
+    if(partner.empty())
+        return;
+
+    WorldPacket data(WIRE_CMSG_INITIATE_TRADE, 9);
+    data.WriteGuidBitString(8, partner, 0, 3, 5, 1, 4, 6, 7, 2);
+    data.FlushBits();
+    data.WriteSeqByteString(8, partner, 7, 4, 3, 5, 1, 2, 6, 0);
+    StartRequest(BOT_LATENCY_TRADE);
+    _SendPacket(&data);
+}
+
+void Bot::_SendWorldport()
+{
+    // Same map ports come back as a teleport rather than a new world, so only pick other maps
+    const std::vector<BotDestination> &destinations = sBotSwarm.GetConfig().destinations;
+    uint32 start = RandomUInt(uint32(destinations.size()) - 1);
+    for(uint32 i = 0; i < destinations.size(); ++i)
+    {
+        const BotDestination &dest = destinations[(start + i) % destinations.size()];
+        if(dest.mapId == m_mapId)
+            continue;
+
+        if(m_moving)
+        {
+            m_moving = false;
+            _SendMovement(WIRE_MSG_MOVE_STOP, getMSTime());
+        }
+
+        _SendChat(format(".worldport %u %f %f %f %f", dest.mapId, dest.x, dest.y, dest.z, dest.o));
+        StartRequest(BOT_LATENCY_WORLDPORT);
+        m_state = BOT_STATE_TRANSFERRING;
+        return;
+    }
+}
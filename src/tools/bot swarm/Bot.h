@@ -0,0 +1,136 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+class LogonClient;
+class BotSocket;
+
+enum BotState
+{
+    BOT_STATE_IDLE,
+    BOT_STATE_LOGON,
+    BOT_STATE_WORLD_AUTH,
+    BOT_STATE_CHAR_SELECT,
+    BOT_STATE_LOGGING_IN,
+    BOT_STATE_IN_WORLD,
+    BOT_STATE_TRANSFERRING,
+    BOT_STATE_RECONNECT
+};
+
+enum BotLogonResult
+{
+    BOT_LOGON_PENDING,
+    BOT_LOGON_SUCCESS,
+    BOT_LOGON_FAILED
+};
+
+/** One scripted client
+ * Everything but latency sampling happens on the update thread that owns us, the network
+ * threads only hand over logon results and queue world packets.
+ */
+class Bot
+{
+public:
+    Bot(uint32 index);
+    ~Bot();
+
+    void Update(uint32 mstime);
+
+    // Drops both connections for good, only called once our update thread has stopped
+    void Stop();
+
+    RONIN_INLINE uint32 GetIndex() { return m_index; }
+    RONIN_INLINE BotState GetState() { return m_state; }
+    RONIN_INLINE std::string GetAccountName() { return m_accountName; }
+    RONIN_INLINE std::string GetPassword() { return m_password; }
+    RONIN_INLINE uint8 *GetSessionKey() { return m_sessionKey; }
+
+    RONIN_INLINE void StartRequest(BotLatencyType type) { m_requestTimes[type].store(std::max<uint32>(1, getMSTime()), std::memory_order_relaxed); }
+    bool FinishRequest(BotLatencyType type);
+    RONIN_INLINE bool HasRequest(BotLatencyType type) { return m_requestTimes[type].load(std::memory_order_relaxed) != 0; }
+
+    // Network thread callbacks
+    void OnLogonComplete(uint8 *sessionKey, std::string address);
+    void OnLogonFailed(const char *reason);
+    void QueuePacket(WorldPacket *packet);
+    void OnSocketDisconnect(BotSocket *socket);
+
+private:
+    void _StartLogon(uint32 mstime);
+    void _ConnectWorld(uint32 mstime);
+    void _Reconnect(uint32 mstime, BotCounterType reason);
+    void _Disconnect();
+    void _ExpireRequests(uint32 mstime);
+    void _SendPacket(WorldPacket *packet);
+
+    void _HandlePacket(WorldPacket *packet, uint32 mstime);
+    void _HandleAuthResponse(WorldPacket *packet, uint32 mstime);
+    void _HandleCharEnum(WorldPacket *packet, uint32 mstime);
+    void _HandleCharCreate(WorldPacket *packet, uint32 mstime);
+    void _HandleLoginVerifyWorld(WorldPacket *packet, uint32 mstime);
+    void _HandleNewWorld(WorldPacket *packet, uint32 mstime);
+    void _HandleTimeSyncReq(WorldPacket *packet);
+
+    // Scripted behaviour while in world
+    void _UpdateScript(uint32 mstime);
+    void _UpdateMovement(uint32 mstime, uint32 diff);
+    void _BuildPath();
+    void _SendMovement(uint16 opcode, uint32 mstime);
+    void _SendPing();
+    void _SendChat(std::string message);
+    void _SendCast();
+    void _SendTrade();
+    void _SendWorldport();
+
+    std::string _GetCharacterName();
+    bool _IsOwnGuid(WorldPacket *packet, bool packed);
+
+    uint32 m_index;
+    BotState m_state;
+    std::string m_accountName, m_password;
+
+    // Guarded by m_lock, filled in from the network threads
+    Mutex m_lock;
+    LogonClient *m_logonSocket;
+    BotSocket *m_worldSocket;
+    BotLogonResult m_logonResult;
+    std::string m_logonError, m_worldAddress;
+    uint8 m_sessionKey[40];
+
+    FastQueue<WorldPacket*, Mutex> _recvQueue;
+    std::atomic<uint32> m_requestTimes[BOT_LATENCY_MAX];
+    std::atomic<uint64> m_guid;
+
+    uint32 m_lastUpdate, m_stateTimeout, m_nextAttempt, m_nextExpireCheck;
+    uint32 m_createAttempts;
+    bool m_inWorld;
+
+    // Position and path, the path circles our login point
+    uint32 m_mapId;
+    float m_x, m_y, m_z, m_o;
+    float m_centerX, m_centerY;
+    std::vector<std::pair<float, float> > m_path;
+    uint32 m_pathIndex, m_nextHeartbeat, m_moveResume;
+    bool m_moving;
+
+    uint32 m_nextPing, m_nextChat, m_nextCast, m_nextTrade, m_nextWorldport;
+    uint32 m_pingSerial;
+    uint8 m_castCount;
+};
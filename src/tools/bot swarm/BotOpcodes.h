@@ -0,0 +1,75 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+enum LogonCommands
+{
+    LOGON_CMD_AUTH_LOGON_CHALLENGE      = 0x00,
+    LOGON_CMD_AUTH_LOGON_PROOF          = 0x01,
+    LOGON_CMD_REALM_LIST                = 0x10,
+};
+
+// Realm flag telling us a build block follows the realm entry
+#define REALM_FLAG_SPECIFYBUILD 0x04
+
+/** Wire values for the 15595 client, as set up in the world server's Opcodes.cpp
+ * We only speak a handful of opcodes, so the bots keep their own table rather than
+ * pulling in the world's opcode manager. Prefixed so they don't collide with OpcodeList.h.
+ */
+enum WireOpcodes
+{
+    WIRE_MSG_VERIFY_CONNECTIVITY        = 0x4F57,
+    WIRE_SMSG_AUTH_CHALLENGE            = 0x4542,
+    WIRE_CMSG_AUTH_SESSION              = 0x0449,
+    WIRE_SMSG_AUTH_RESPONSE             = 0x5DB6,
+    WIRE_CMSG_PING                      = 0x444D,
+    WIRE_SMSG_PONG                      = 0x4D42,
+    WIRE_CMSG_CHAR_ENUM                 = 0x0502,
+    WIRE_SMSG_CHAR_ENUM                 = 0x10B0,
+    WIRE_CMSG_CHAR_CREATE               = 0x4A36,
+    WIRE_SMSG_CHAR_CREATE               = 0x2D05,
+    WIRE_CMSG_PLAYER_LOGIN              = 0x05B1,
+    WIRE_SMSG_LOGIN_VERIFY_WORLD        = 0x2005,
+    WIRE_SMSG_TIME_SYNC_REQ             = 0x3CA4,
+    WIRE_CMSG_TIME_SYNC_RESP            = 0x3B0C,
+    WIRE_MSG_MOVE_START_FORWARD         = 0x7814,
+    WIRE_MSG_MOVE_STOP                  = 0x320A,
+    WIRE_MSG_MOVE_HEARTBEAT             = 0x3914,
+    WIRE_MSG_MOVE_WORLDPORT_ACK         = 0x2411,
+    WIRE_SMSG_NEW_WORLD                 = 0x79B1,
+    WIRE_CMSG_MESSAGECHAT_SAY           = 0x1154,
+    WIRE_SMSG_MESSAGECHAT               = 0x2026,
+    WIRE_SMSG_GM_MESSAGECHAT            = 0x6434,
+    WIRE_CMSG_CAST_SPELL                = 0x4C07,
+    WIRE_SMSG_SPELL_START               = 0x6415,
+    WIRE_SMSG_SPELL_GO                  = 0x6E16,
+    WIRE_SMSG_CAST_FAILED               = 0x4D16,
+    WIRE_CMSG_INITIATE_TRADE            = 0x7916,
+    WIRE_CMSG_CANCEL_TRADE              = 0x731E,
+    WIRE_SMSG_TRADE_STATUS              = 0x5CA3,
+    WIRE_CMSG_LOGOUT_REQUEST            = 0x0A25,
+    WIRE_SMSG_LOGOUT_COMPLETE           = 0x2137,
+};
+
+// The connectivity response is the only client header carrying a full 32bit command
+#define WIRE_MSG_VERIFY_CONNECTIVITY_RESPONSE 0x4C524F57
+#define WIRE_OPCODE_COMPRESSION_MASK 0x8000
+
+#define BOT_CLIENT_BUILD 15595
@@ -0,0 +1,257 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BotStdAfx.h"
+
+BotSocket::BotSocket(SOCKET fd, const sockaddr_in * peer, Bot *bot) : TcpSocket(fd, BOTSOCKET_RECVBUF_SIZE, BOTSOCKET_SENDBUF_SIZE, false, peer), _recvHeader()
+{
+    m_bot = bot;
+    _recvHeaderLength = 0;
+    m_hasHeader = false;
+    mOpcode = mRemaining = 0;
+
+    m_inflateStream = new z_stream();
+    m_inflateStream->zalloc = (alloc_func)NULL;
+    m_inflateStream->zfree = (free_func)NULL;
+    m_inflateStream->opaque = (voidpf)NULL;
+    m_inflateStream->avail_in = 0;
+    m_inflateStream->next_in = NULL;
+    if(inflateInit(m_inflateStream) != Z_OK)
+    {
+        delete m_inflateStream;
+        m_inflateStream = NULL;
+    }
+}
+
+BotSocket::~BotSocket()
+{
+    if(m_inflateStream)
+    {
+        inflateEnd(m_inflateStream);
+        delete m_inflateStream;
+    }
+}
+
+void BotSocket::ClearBot()
+{
+    m_botLock.Acquire();
+    m_bot = NULL;
+    m_botLock.Release();
+}
+
+void BotSocket::OutPacket(uint32 opcode, size_t len, const void* data)
+{
+    if(!IsConnected() || GetWriteBuffer()->GetSpace() < (len+6))
+        return;
+
+    // Client headers are a big endian size covering the command, then a 32bit command
+    uint8 header[6];
+    header[0] = 0xFF & ((len+4) >> 8);
+    header[1] = 0xFF & (len+4);
+    header[2] = 0xFF & opcode;
+    header[3] = 0xFF & (opcode >> 8);
+    header[4] = 0xFF & (opcode >> 16);
+    header[5] = 0xFF & (opcode >> 24);
+
+    LockWriteBuffer();
+    _crypt.EncryptSend(header, 6);
+    bool rv = WriteButHold(header, 6);
+    if(len > 0 && rv)
+        rv = Write((const uint8*)data, (uint32)len);
+    else if(rv) rv = ForceSend();
+    UnlockWriteBuffer();
+
+    if(rv)
+    {
+        sBotStats.Add(BOT_COUNTER_PACKETS_OUT);
+        sBotStats.Add(BOT_COUNTER_BYTES_OUT, len+6);
+    }
+}
+
+bool BotSocket::_ReadHeader()
+{
+    // Large packets flag their first byte and carry a third size byte, so decrypt that one on its own
+    if(_recvHeaderLength == 0)
+    {
+        if(GetReadBuffer()->GetSize() < 1)
+            return false;
+
+        Read(_recvHeader, 1);
+        _crypt.DecryptRecv(_recvHeader, 1);
+        _recvHeaderLength = (_recvHeader[0] & 0x80) ? 5 : 4;
+    }
+
+    if(GetReadBuffer()->GetSize() < size_t(_recvHeaderLength-1))
+        return false;
+
+    Read(&_recvHeader[1], _recvHeaderLength-1);
+    _crypt.DecryptRecv(&_recvHeader[1], _recvHeaderLength-1);
+
+    uint32 size;
+    if(_recvHeaderLength == 5)
+        size = (uint32(_recvHeader[0] & 0x7F) << 16) | (uint32(_recvHeader[1]) << 8) | _recvHeader[2];
+    else size = (uint32(_recvHeader[0]) << 8) | _recvHeader[1];
+    mOpcode = uint32(_recvHeader[_recvHeaderLength-2]) | (uint32(_recvHeader[_recvHeaderLength-1]) << 8);
+    mRemaining = size >= 2 ? size-2 : 0;
+    _recvHeaderLength = 0;
+    m_hasHeader = true;
+    return true;
+}
+
+WorldPacket *BotSocket::_Inflate(WorldPacket *packet)
+{
+    uint32 size = 0;
+    if(m_inflateStream == NULL || packet->size() < 4 || (size = packet->read<uint32>()) == 0 || size > 0x1000000)
+    {
+        delete packet;
+        return NULL;
+    }
+
+    WorldPacket *result = new WorldPacket(packet->GetOpcode() & ~WIRE_OPCODE_COMPRESSION_MASK, size);
+    result->resize(size);
+    m_inflateStream->avail_in = (uInt)(packet->size()-4);
+    m_inflateStream->next_in = (Bytef*)(packet->contents()+4);
+    m_inflateStream->avail_out = (uInt)size;
+    m_inflateStream->next_out = (Bytef*)result->contents();
+    int res = inflate(m_inflateStream, Z_SYNC_FLUSH);
+    delete packet;
+    if((res != Z_OK && res != Z_STREAM_END) || m_inflateStream->avail_out != 0)
+    {
+        delete result;
+        return NULL;
+    }
+    return result;
+}
+
+void BotSocket::_HandleAuthChallenge(WorldPacket *packet)
+{
+    uint32 serverSeed = 0;
+    if(packet->size() >= 36)
+        serverSeed = packet->read<uint32>(32);
+
+    m_botLock.Acquire();
+    if(m_bot == NULL)
+    {
+        m_botLock.Release();
+        return;
+    }
+
+    std::string account = m_bot->GetAccountName();
+    uint8 *sessionKey = m_bot->GetSessionKey();
+    uint32 clientSeed = RandomUInt();
+
+    Sha1Hash sha;
+    uint32 t = 0;
+    sha.UpdateData(account);
+    sha.UpdateData((uint8*)&t, 4);
+    sha.UpdateData((uint8*)&clientSeed, 4);
+    sha.UpdateData((uint8*)&serverSeed, 4);
+    sha.UpdateData(sessionKey, 40);
+    sha.Finalize();
+    uint8 *d = sha.GetDigest();
+
+    // Mirrors the read order in WorldSocket::_HandleAuthSession
+    WorldPacket data(WIRE_CMSG_AUTH_SESSION, 60 + account.length());
+    data << uint32(0) << uint32(0) << uint8(0);
+    data << d[10] << d[18] << d[12] << d[5];
+    data << uint64(0);
+    data << d[15] << d[9] << d[19] << d[4] << d[7] << d[16] << d[3];
+    data << uint16(BOT_CLIENT_BUILD) << d[8];
+    data << uint32(0) << uint8(0);
+    data << d[17] << d[6] << d[0] << d[1] << d[11];
+    data << clientSeed << d[2];
+    data << uint32(0);
+    data << d[14] << d[13];
+    data << uint32(0); // Addon size
+    data.WriteBit(0);
+    data.WriteBits(account.length(), 12);
+    data.FlushBits();
+    data.WriteString(account);
+
+    m_bot->StartRequest(BOT_LATENCY_AUTH_SESSION);
+    SendPacket(&data);
+
+    // Everything after the session packet is encrypted both ways
+    _crypt.InitClient(sessionKey);
+    m_botLock.Release();
+}
+
+void BotSocket::OnRecvData()
+{
+    for(;;)
+    {
+        if(!m_hasHeader && !_ReadHeader())
+            return;
+
+        if(mRemaining > 0 && GetReadBuffer()->GetSize() < mRemaining)
+            return; // We have a fragmented packet. Wait for the complete one before proceeding.
+
+        WorldPacket *packet = new WorldPacket(mOpcode, mRemaining);
+        if(mRemaining > 0)
+        {
+            packet->resize(mRemaining);
+            Read((uint8*)packet->contents(), mRemaining);
+        }
+        sBotStats.Add(BOT_COUNTER_PACKETS_IN);
+        sBotStats.Add(BOT_COUNTER_BYTES_IN, mRemaining + (mRemaining+2 > 0x7FFF ? 5 : 4));
+        m_hasHeader = false;
+        mRemaining = mOpcode = 0;
+
+        if((packet->GetOpcode() & WIRE_OPCODE_COMPRESSION_MASK) && (packet = _Inflate(packet)) == NULL)
+        {
+            Disconnect();
+            return;
+        }
+
+        switch(packet->GetOpcode())
+        {
+        case WIRE_MSG_VERIFY_CONNECTIVITY:
+            {
+                static const char response[] = "D OF WARCRAFT CONNECTION - CLIENT TO SERVER";
+                OutPacket(WIRE_MSG_VERIFY_CONNECTIVITY_RESPONSE, sizeof(response), response);
+            }break;
+        case WIRE_SMSG_AUTH_CHALLENGE:
+            {
+                _HandleAuthChallenge(packet);
+            }break;
+        default:
+            {
+                m_botLock.Acquire();
+                if(m_bot)
+                {
+                    m_bot->QueuePacket(packet);
+                    packet = NULL;
+                }
+                m_botLock.Release();
+            }break;
+        }
+
+        if(packet)
+            delete packet;
+    }
+}
+
+void BotSocket::OnDisconnect()
+{
+    m_botLock.Acquire();
+    if(m_bot)
+        m_bot->OnSocketDisconnect(this);
+    m_bot = NULL;
+    m_botLock.Release();
+}
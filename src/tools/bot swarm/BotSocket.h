@@ -0,0 +1,106 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#define BOTSOCKET_RECVBUF_SIZE 65536
+#define BOTSOCKET_SENDBUF_SIZE 16384
+
+class Bot;
+
+/** Same as ConnectTCPSocket, but hands our bot to the socket before it is added to the engine
+ * The server talks first on both logon and world connections, so the bot has to be in place
+ * before the network threads can call OnRecvData.
+ */
+template<class T>
+T* ConnectBotSocket(const char * hostname, u_short port, Bot *bot)
+{
+    sockaddr_in conn;
+    hostent * host;
+
+    /* resolve the peer */
+    host = gethostbyname(hostname);
+    if(!host)
+        return NULL;
+
+    memset(&conn, 0, sizeof(sockaddr_in));
+    memcpy(&conn.sin_addr.s_addr, host->h_addr_list[0], host->h_length);
+    conn.sin_family = AF_INET;
+    conn.sin_port = ntohs(port);
+
+    SOCKET fd = socket(AF_INET, SOCK_STREAM, 0);
+    if(fd == INVALID_SOCKET)
+        return NULL;
+
+    /* connect in blocking mode, the socket switches itself to nonblocking */
+    u_long arg = 0;
+    ioctlsocket(fd, FIONBIO, &arg);
+    if(connect(fd, (const sockaddr*)&conn, sizeof(sockaddr_in)) < 0)
+    {
+        closesocket(fd);
+        return NULL;
+    }
+
+    T * s = new T(fd, &conn, bot);
+    s->Finalize();
+    return s;
+}
+
+/** Client side of WorldSocket
+ * Handles the connectivity handshake and session authentication itself, everything else
+ * is passed on to the bot as it arrives.
+ */
+class BotSocket : public TcpSocket
+{
+public:
+    BotSocket(SOCKET fd, const sockaddr_in * peer, Bot *bot);
+    ~BotSocket();
+
+    RONIN_INLINE void SendPacket(WorldPacket* packet)
+    {
+        if(packet == NULL)
+            return;
+        OutPacket(packet->GetOpcode(), packet->size(), (packet->size() ? (const void*)packet->contents() : NULL));
+    }
+
+    void OutPacket(uint32 opcode, size_t len, const void* data);
+
+    // Detaches us from our bot, after this no callbacks will reach it
+    void ClearBot();
+
+    void OnRecvData();
+    void OnDisconnect();
+
+private:
+    bool _ReadHeader();
+    WorldPacket *_Inflate(WorldPacket *packet);
+    void _HandleAuthChallenge(WorldPacket *packet);
+
+    Mutex m_botLock;
+    Bot *m_bot;
+
+    WowCrypt _crypt;
+    uint8 _recvHeader[5];
+    uint8 _recvHeaderLength;
+    bool m_hasHeader;
+    uint32 mOpcode, mRemaining;
+
+    // The server keeps one deflate stream per session, so we need a matching inflate stream
+    z_stream *m_inflateStream;
+};
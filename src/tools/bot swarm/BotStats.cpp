@@ -0,0 +1,97 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BotStdAfx.h"
+
+initialiseSingleton( BotStats );
+
+static const char *latencyNames[BOT_LATENCY_MAX] =
+{
+    "AUTH_LOGON_CHALLENGE",
+    "AUTH_LOGON_PROOF",
+    "REALM_LIST",
+    "CMSG_AUTH_SESSION -> SMSG_AUTH_RESPONSE",
+    "CMSG_CHAR_ENUM -> SMSG_CHAR_ENUM",
+    "CMSG_CHAR_CREATE -> SMSG_CHAR_CREATE",
+    "CMSG_PLAYER_LOGIN -> SMSG_LOGIN_VERIFY_WORLD",
+    "CMSG_PING -> SMSG_PONG",
+    "CMSG_MESSAGECHAT_SAY -> SMSG_MESSAGECHAT",
+    "CMSG_CAST_SPELL -> SMSG_SPELL_START",
+    "CMSG_INITIATE_TRADE -> SMSG_TRADE_STATUS",
+    ".worldport -> SMSG_NEW_WORLD",
+    "Full login"
+};
+
+static const char *counterNames[BOT_COUNTER_MAX] =
+{
+    "Packets in",
+    "Packets out",
+    "Bytes in",
+    "Bytes out",
+    "Logon failures",
+    "World failures",
+    "Disconnects",
+    "Timeouts"
+};
+
+BotStats::BotStats() : m_inWorld(0)
+{
+    for(uint32 i = 0; i < BOT_COUNTER_MAX; ++i)
+    {
+        m_counters[i].store(0, std::memory_order_relaxed);
+        m_lastCounters[i] = 0;
+    }
+}
+
+void BotStats::Report(uint32 botCount, uint32 elapsedMS, bool final)
+{
+    LatencyHistogram *histograms = final ? m_total : m_interval;
+    printf("==============================================================================\n");
+    printf("%s: %u bots, %u in world\n", final ? "Run totals" : "Interval", botCount, GetInWorld());
+    printf("%-46s %8s %7s %7s %7s %7s\n", "Request", "Samples", "p50", "p90", "p99", "max");
+    for(uint32 i = 0; i < BOT_LATENCY_MAX; ++i)
+    {
+        uint32 count = histograms[i].GetSampleCount();
+        if(count == 0)
+            continue;
+
+        printf("%-46s %8u %5ums %5ums %5ums %5ums\n", latencyNames[i], count, histograms[i].GetPercentile(50.f),
+            histograms[i].GetPercentile(90.f), histograms[i].GetPercentile(99.f), histograms[i].GetPercentile(100.f));
+        if(!final)
+            histograms[i].Reset();
+    }
+
+    // Counters print as a per second rate for intervals
+    for(uint32 i = 0; i < BOT_COUNTER_MAX; ++i)
+    {
+        uint64 value = Get(BotCounterType(i));
+        if(final)
+            printf("%s: " UI64FMTD "\n", counterNames[i], value);
+        else
+        {
+            printf("%s: " UI64FMTD " (%.1f/s)\n", counterNames[i], value, elapsedMS ? double(value - m_lastCounters[i]) * 1000. / double(elapsedMS) : 0.);
+            m_lastCounters[i] = value;
+        }
+    }
+}
+
+const char *BotStats::GetLatencyName(BotLatencyType type)
+{
+    return type < BOT_LATENCY_MAX ? latencyNames[type] : "Unknown";
+}
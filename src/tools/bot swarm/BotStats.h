@@ -0,0 +1,88 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Request/response pairs we time, each bot has at most one of each in flight
+enum BotLatencyType
+{
+    BOT_LATENCY_LOGON_CHALLENGE,
+    BOT_LATENCY_LOGON_PROOF,
+    BOT_LATENCY_REALMLIST,
+    BOT_LATENCY_AUTH_SESSION,
+    BOT_LATENCY_CHAR_ENUM,
+    BOT_LATENCY_CHAR_CREATE,
+    BOT_LATENCY_PLAYER_LOGIN,
+    BOT_LATENCY_PING,
+    BOT_LATENCY_CHAT,
+    BOT_LATENCY_CAST,
+    BOT_LATENCY_TRADE,
+    BOT_LATENCY_WORLDPORT,
+    BOT_LATENCY_FULL_LOGIN,     // Logon challenge through to the world verifying our position
+    BOT_LATENCY_MAX
+};
+
+enum BotCounterType
+{
+    BOT_COUNTER_PACKETS_IN,
+    BOT_COUNTER_PACKETS_OUT,
+    BOT_COUNTER_BYTES_IN,
+    BOT_COUNTER_BYTES_OUT,
+    BOT_COUNTER_LOGON_FAILURES,
+    BOT_COUNTER_WORLD_FAILURES,
+    BOT_COUNTER_DISCONNECTS,
+    BOT_COUNTER_TIMEOUTS,
+    BOT_COUNTER_MAX
+};
+
+/** Swarm wide latency histograms and counters
+ * Samples are taken on the network threads as responses arrive, so queueing in our own
+ * update threads never shows up as server latency. Each type keeps a histogram for the
+ * whole run and one that is reset every report.
+ */
+class BotStats : public Singleton<BotStats>
+{
+public:
+    BotStats();
+
+    RONIN_INLINE void AddSample(BotLatencyType type, uint32 ms)
+    {
+        m_total[type].AddSample(ms);
+        m_interval[type].AddSample(ms);
+    }
+
+    RONIN_INLINE void Add(BotCounterType type, uint64 amount = 1) { m_counters[type].fetch_add(amount, std::memory_order_relaxed); }
+    RONIN_INLINE uint64 Get(BotCounterType type) { return m_counters[type].load(std::memory_order_relaxed); }
+
+    RONIN_INLINE void AddInWorld(int32 count) { m_inWorld.fetch_add(count, std::memory_order_relaxed); }
+    RONIN_INLINE uint32 GetInWorld() { return m_inWorld.load(std::memory_order_relaxed); }
+
+    // Prints the interval table and resets it, or the whole run's table when final is set
+    void Report(uint32 botCount, uint32 elapsedMS, bool final);
+
+    static const char *GetLatencyName(BotLatencyType type);
+
+private:
+    LatencyHistogram m_total[BOT_LATENCY_MAX], m_interval[BOT_LATENCY_MAX];
+    std::atomic<uint64> m_counters[BOT_COUNTER_MAX];
+    uint64 m_lastCounters[BOT_COUNTER_MAX];
+    std::atomic<int32> m_inWorld;
+};
+
+#define sBotStats BotStats::getSingleton()
@@ -0,0 +1,55 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <list>
+#include <vector>
+#include <map>
+#include <string>
+#include <atomic>
+
+#include "Common.h"
+#include <Network/Network.h>
+
+#include "../../ronin-shared/git_version.h"
+#include "../../ronin-shared/Util.h"
+#include "../../ronin-shared/ByteBuffer.h"
+#include "../../ronin-shared/WorldPacket.h"
+#include "../../ronin-shared/FastQueue.h"
+#include "../../ronin-shared/LatencyHistogram.h"
+#include "../../ronin-shared/Config/IniFiles.h"
+#include <zlib/zlib.h>
+
+#include <threading/Threading.h>
+
+#include "../../ronin-shared/Auth/BigNumber.h"
+#include "../../ronin-shared/Auth/Sha1.h"
+#include "../../ronin-shared/Auth/WowCrypt.h"
+#include "../../ronin-shared/Client/AuthCodes.h"
+#include "../../ronin-logonserver/AuthStructs.h"
+
+#include "BotOpcodes.h"
+#include "BotStats.h"
+#include "BotSwarm.h"
+#include "Bot.h"
+#include "BotSocket.h"
+#include "LogonClient.h"
+#include "ConsoleMonitor.h"
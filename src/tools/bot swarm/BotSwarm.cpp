@@ -0,0 +1,370 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "BotStdAfx.h"
+#include <signal.h>
+#include "../../ronin-shared/startup_getopt.h"
+
+initialiseSingleton( BotSwarm );
+
+#define BOTSWARM_UPDATE_DELAY 50
+
+void _OnSignal(int s);
+
+/** Drives every bot whose index falls on this thread's stripe
+ * Bots never share a thread, so their own state needs no locking.
+ */
+class BotUpdateThread : public ThreadContext
+{
+public:
+    BotUpdateThread(uint32 threadId) : m_threadId(threadId) {}
+
+    bool run()
+    {
+        while(GetThreadState() != THREADSTATE_TERMINATE && sBotSwarm.IsRunning())
+        {
+            uint32 start = getMSTime();
+            sBotSwarm.UpdateBots(m_threadId, start);
+
+            uint32 diff = getMSTimeDiff(getMSTime(), start);
+            if(diff < BOTSWARM_UPDATE_DELAY)
+                Delay(BOTSWARM_UPDATE_DELAY - diff);
+        }
+
+        sBotSwarm.OnUpdateThreadExit();
+        return true;
+    }
+
+private:
+    uint32 m_threadId;
+};
+
+BotSwarm::BotSwarm() : m_startedBots(0), m_activeThreads(0), m_running(false), m_monitor(NULL)
+{
+
+}
+
+BotSwarm::~BotSwarm()
+{
+
+}
+
+#ifdef WIN32
+static const char * default_config_file = "./ronin-botswarm.ini";
+#else
+static const char * default_config_file = (char*)CONFDIR "/ronin-botswarm.ini";
+#endif
+
+bool BotSwarm::LoadConfig()
+{
+    m_config.logonHost = mainIni->ReadString("Logon", "Host", "127.0.0.1");
+    m_config.logonPort = mainIni->ReadInteger("Logon", "Port", 3724);
+    m_config.realmName = mainIni->ReadString("Logon", "Realm", "");
+    m_config.worldHost = mainIni->ReadString("Logon", "WorldHost", "");
+
+    m_config.accountPrefix = mainIni->ReadString("Account", "Prefix", "bot");
+    m_config.password = mainIni->ReadString("Account", "Password", "bot");
+    m_config.namePrefix = mainIni->ReadString("Character", "NamePrefix", "Bot");
+    m_config.race = mainIni->ReadInteger("Character", "Race", 1);
+    m_config.classId = mainIni->ReadInteger("Character", "Class", 1);
+
+    m_config.botCount = mainIni->ReadInteger("Swarm", "Count", 100);
+    m_config.startIndex = mainIni->ReadInteger("Swarm", "StartIndex", 0);
+    m_config.updateThreads = std::max<uint32>(1, mainIni->ReadInteger("Swarm", "UpdateThreads", 4));
+    m_config.rampPerSecond = std::max<uint32>(1, mainIni->ReadInteger("Swarm", "RampPerSecond", 50));
+    m_config.duration = mainIni->ReadInteger("Swarm", "Duration", 0) * 1000;
+    m_config.reportInterval = std::max<uint32>(1, mainIni->ReadInteger("Swarm", "ReportInterval", 10)) * 1000;
+    m_config.reconnectDelay = mainIni->ReadInteger("Swarm", "ReconnectDelay", 5) * 1000;
+    m_config.requestTimeout = std::max<uint32>(1, mainIni->ReadInteger("Swarm", "RequestTimeout", 30)) * 1000;
+
+    m_config.pingInterval = mainIni->ReadInteger("Script", "PingInterval", 30) * 1000;
+    m_config.chatInterval = mainIni->ReadInteger("Script", "ChatInterval", 60) * 1000;
+    m_config.castInterval = mainIni->ReadInteger("Script", "CastInterval", 20) * 1000;
+    m_config.castSpell = mainIni->ReadInteger("Script", "CastSpell", 8936);
+    m_config.tradeInterval = mainIni->ReadInteger("Script", "TradeInterval", 120) * 1000;
+    m_config.worldportInterval = mainIni->ReadInteger("Script", "WorldportInterval", 300) * 1000;
+    m_config.pathRadius = mainIni->ReadFloat("Script", "PathRadius", 20.f);
+    m_config.pathPoints = mainIni->ReadInteger("Script", "PathPoints", 8);
+    m_config.pathPause = mainIni->ReadInteger("Script", "PathPause", 5) * 1000;
+
+    // map x y z o, separated by semicolons
+    std::string destinations = mainIni->ReadString("Script", "Destinations",
+        "0 -8913.23 554.633 93.7944 0;0 -4981.25 -881.542 501.66 0;1 9951.52 2280.32 1341.39 0;530 -3961.64 -13931.2 100.615 0");
+    std::vector<std::string> entries = RONIN_UTIL::StrSplit(destinations, ";");
+    for(std::vector<std::string>::iterator itr = entries.begin(); itr != entries.end(); itr++)
+    {
+        BotDestination dest;
+        if(sscanf(itr->c_str(), "%u %f %f %f %f", &dest.mapId, &dest.x, &dest.y, &dest.z, &dest.o) != 5)
+        {
+            sLog.Error("Config", "Skipping malformed destination \"%s\"", itr->c_str());
+            continue;
+        }
+        m_config.destinations.push_back(dest);
+    }
+
+    m_config.consoleEnabled = mainIni->ReadBoolean("RemoteConsole", "Enabled", false);
+    m_config.consoleHost = mainIni->ReadString("RemoteConsole", "Host", "127.0.0.1");
+    m_config.consolePort = mainIni->ReadInteger("RemoteConsole", "Port", 8092);
+    m_config.consoleUser = mainIni->ReadString("RemoteConsole", "Username", "");
+    m_config.consolePassword = mainIni->ReadString("RemoteConsole", "Password", "");
+
+    if(m_config.botCount > BOT_MAX_PER_PROCESS)
+    {
+        sLog.Warning("Config", "Count of %u is over the %u connections one process can hold, capping. Run more processes with StartIndex to go higher.", m_config.botCount, BOT_MAX_PER_PROCESS);
+        m_config.botCount = BOT_MAX_PER_PROCESS;
+    }
+    return true;
+}
+
+void BotSwarm::UpdateBots(uint32 threadId, uint32 mstime)
+{
+    uint32 started = m_startedBots.load(std::memory_order_acquire);
+    for(uint32 i = threadId; i < started; i += m_config.updateThreads)
+        m_bots[i]->Update(mstime);
+}
+
+void BotSwarm::AddInWorld(uint64 guid, uint32 mapId)
+{
+    m_inWorldLock.Acquire();
+    m_inWorld.push_back(std::make_pair(guid, mapId));
+    m_inWorldLock.Release();
+}
+
+void BotSwarm::RemoveInWorld(uint64 guid)
+{
+    m_inWorldLock.Acquire();
+    for(size_t i = 0; i < m_inWorld.size(); ++i)
+    {
+        if(m_inWorld[i].first != guid)
+            continue;
+
+        m_inWorld[i] = m_inWorld.back();
+        m_inWorld.pop_back();
+        break;
+    }
+    m_inWorldLock.Release();
+}
+
+uint64 BotSwarm::GetTradePartner(uint64 guid, uint32 mapId)
+{
+    // Random probe instead of a scan, partners on other maps are simply a missed trade
+    uint64 partner = 0;
+    m_inWorldLock.Acquire();
+    if(m_inWorld.size() > 1)
+    {
+        std::pair<uint64, uint32> &entry = m_inWorld[RandomUInt(uint32(m_inWorld.size()) - 1)];
+        if(entry.first != guid && entry.second == mapId)
+            partner = entry.first;
+    }
+    m_inWorldLock.Release();
+    return partner;
+}
+
+void BotSwarm::ConnectMonitor()
+{
+    m_monitorLock.Acquire();
+    bool connected = m_monitor != NULL;
+    m_monitorLock.Release();
+    if(connected)
+        return;
+
+    ConsoleMonitor *monitor = ConnectTCPSocket<ConsoleMonitor>(m_config.consoleHost.c_str(), m_config.consolePort);
+    if(monitor == NULL)
+    {
+        sLog.Warning("ConsoleMonitor", "Could not connect to the remote console at %s:%u", m_config.consoleHost.c_str(), m_config.consolePort);
+        return;
+    }
+
+    m_monitorLock.Acquire();
+    if(monitor->IsConnected())
+        m_monitor = monitor;
+    m_monitorLock.Release();
+}
+
+void BotSwarm::OnMonitorDisconnect(ConsoleMonitor *monitor)
+{
+    m_monitorLock.Acquire();
+    if(m_monitor == monitor)
+        m_monitor = NULL;
+    m_monitorLock.Release();
+}
+
+void BotSwarm::Report(uint32 elapsed, bool final)
+{
+    sBotStats.Report(m_startedBots, elapsed, final);
+
+    // Disconnected monitors are only deleted after a while, so the pointer stays good for this report
+    m_monitorLock.Acquire();
+    ConsoleMonitor *monitor = m_monitor;
+    m_monitorLock.Release();
+    if(monitor)
+    {
+        monitor->Report();
+        if(!final)
+            monitor->RequestMetrics();
+    }
+    else if(m_config.consoleEnabled && !final)
+        ConnectMonitor();
+    printf("==============================================================================\n");
+}
+
+void BotSwarm::Run(int argc, char ** argv)
+{
+    UNIXTIME = time(NULL);
+    g_localTime = *localtime(&UNIXTIME);
+    char *config_file = (char*)default_config_file;
+    int do_version = 0;
+
+    struct startup_option longopts[] =
+    {
+        { "version",            startup_no_argument,            &do_version,            1       },
+        { "conf",               startup_required_argument,      NULL,                  'c'      },
+        { 0, 0, 0, 0 }
+    };
+
+    char c;
+    while ((c = startup_getopt_long_only(argc, argv, ":f:", longopts, NULL)) != -1)
+    {
+        switch (c)
+        {
+        case 'c':
+            config_file = new char[strlen(startup_optarg)+1];
+            strcpy(config_file,startup_optarg);
+            break;
+        case 0:
+            break;
+        default:
+            printf("Usage: %s [--conf <filename>] [--version]\n", argv[0]);
+            return;
+        }
+    }
+
+    printf("Sandshroud Ronin(%s::%s) r%u/%s-%s(%s)::Bot Swarm\n", BUILD_TAG, BUILD_HASH_STR, BUILD_REVISION, CONFIG, PLATFORM_TEXT, ARCH);
+    printf("==============================================================================\n");
+    sLog.Line();
+    if(do_version)
+        return;
+
+    mainIni = new CIniFile(config_file);
+    if(!mainIni->ParseError())
+        sLog.Success("Config", "Passed without errors.");
+    else
+    {
+        sLog.Warning("Config", "Encountered one or more errors.");
+        return;
+    }
+
+    InitRandomNumberGenerators();
+    sLog.Init(mainIni->ReadInteger("LogLevel", "Screen", 1));
+    if(!LoadConfig())
+        return;
+
+    new BotStats();
+    CreateSocketEngine(2);
+    sSocketEngine.SpawnThreads();
+
+    signal(SIGINT, _OnSignal);
+    signal(SIGTERM, _OnSignal);
+    signal(SIGABRT, _OnSignal);
+#ifdef _WIN32
+    signal(SIGBREAK, _OnSignal);
+#endif
+
+    m_bots.reserve(m_config.botCount);
+    for(uint32 i = 0; i < m_config.botCount; ++i)
+        m_bots.push_back(new Bot(m_config.startIndex + i));
+
+    m_running = true;
+    for(uint32 i = 0; i < m_config.updateThreads; ++i)
+    {
+        ++m_activeThreads;
+        sThreadManager.ExecuteTask("BotUpdate", new BotUpdateThread(i));
+    }
+
+    if(m_config.consoleEnabled)
+        ConnectMonitor();
+
+    sLog.Notice("BotSwarm", "Starting %u bots against %s:%u, %u per second", m_config.botCount, m_config.logonHost.c_str(), m_config.logonPort, m_config.rampPerSecond);
+    uint32 startTime = getMSTime(), lastSecond = startTime, lastReport = startTime;
+    while(mrunning)
+    {
+        uint32 mstime = getMSTime();
+        if(getMSTimeDiff(mstime, lastSecond) >= 1000)
+        {
+            // Ramp up a second's worth of bots at a time so the logon isn't hit by everyone at once
+            uint32 started = m_startedBots.load(std::memory_order_relaxed);
+            if(started < m_config.botCount)
+                m_startedBots.store(std::min<uint32>(m_config.botCount, started + m_config.rampPerSecond), std::memory_order_release);
+
+            sSocketDeleter.Update();
+            UNIXTIME = time(NULL);
+            g_localTime = *localtime(&UNIXTIME);
+            lastSecond = mstime;
+        }
+
+        if(getMSTimeDiff(mstime, lastReport) >= m_config.reportInterval)
+        {
+            Report(getMSTimeDiff(mstime, lastReport), false);
+            lastReport = mstime;
+        }
+
+        if(m_config.duration && getMSTimeDiff(mstime, startTime) >= m_config.duration)
+            break;
+        Sleep(100);
+    }
+
+    sLog.Notice("BotSwarm", "Shutting down...");
+    signal(SIGINT, 0);
+    signal(SIGTERM, 0);
+    signal(SIGABRT, 0);
+#ifdef _WIN32
+    signal(SIGBREAK, 0);
+#endif
+
+    // Bots can only be stopped once no thread is updating them
+    m_running = false;
+    while(m_activeThreads.load() != 0)
+        Sleep(50);
+    for(std::vector<Bot*>::iterator itr = m_bots.begin(); itr != m_bots.end(); itr++)
+        (*itr)->Stop();
+
+    Report(getMSTimeDiff(getMSTime(), startTime), true);
+
+    m_monitorLock.Acquire();
+    ConsoleMonitor *monitor = m_monitor;
+    m_monitor = NULL;
+    m_monitorLock.Release();
+    if(monitor)
+        monitor->Disconnect();
+
+    sLog.Notice("Network", "Shutting down network subsystem.");
+    sSocketEngine.Shutdown();
+    sThreadManager.Shutdown();
+
+    for(std::vector<Bot*>::iterator itr = m_bots.begin(); itr != m_bots.end(); itr++)
+        delete *itr;
+    m_bots.clear();
+
+    CleanupRandomNumberGenerators();
+    delete BotStats::getSingletonPtr();
+    delete SocketEngine::getSingletonPtr();
+    delete SocketDeleter::getSingletonPtr();
+    sLog.Notice("BotSwarm", "Shutdown complete.\n");
+}
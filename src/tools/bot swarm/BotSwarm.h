@@ -0,0 +1,104 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+class Bot;
+class ConsoleMonitor;
+
+/** The socket engines index their sockets by descriptor in a fixed table, so one process
+ * can only hold so many connections. Swarms larger than this have to be split across
+ * processes using the StartIndex option.
+ */
+#ifdef MAX_DESCRIPTORS
+#define BOT_MAX_PER_PROCESS (MAX_DESCRIPTORS-64)
+#else
+#define BOT_MAX_PER_PROCESS 16384
+#endif
+
+struct BotDestination
+{
+    uint32 mapId;
+    float x, y, z, o;
+};
+
+struct BotSwarmConfig
+{
+    std::string logonHost, worldHost, realmName;
+    uint32 logonPort;
+
+    std::string accountPrefix, password, namePrefix;
+    uint32 race, classId;
+
+    uint32 botCount, startIndex, updateThreads, rampPerSecond, duration;
+    uint32 reportInterval, reconnectDelay, requestTimeout;
+
+    uint32 pingInterval, chatInterval, castInterval, tradeInterval, worldportInterval;
+    uint32 castSpell, pathPoints, pathPause;
+    float pathRadius;
+    std::vector<BotDestination> destinations;
+
+    bool consoleEnabled;
+    std::string consoleHost, consoleUser, consolePassword;
+    uint32 consolePort;
+};
+
+class BotSwarm : public Singleton<BotSwarm>
+{
+public:
+    BotSwarm();
+    ~BotSwarm();
+
+    void Run(int argc, char ** argv);
+
+    RONIN_INLINE const BotSwarmConfig &GetConfig() { return m_config; }
+    RONIN_INLINE std::string GetRealmName() { return m_config.realmName; }
+    RONIN_INLINE bool IsRunning() { return m_running; }
+
+    // Called by each update thread, bots are striped across threads by index
+    void UpdateBots(uint32 threadId, uint32 mstime);
+    void OnUpdateThreadExit() { --m_activeThreads; }
+
+    // Bots currently in world, used to pick trade partners
+    void AddInWorld(uint64 guid, uint32 mapId);
+    void RemoveInWorld(uint64 guid);
+    uint64 GetTradePartner(uint64 guid, uint32 mapId);
+
+    void OnMonitorDisconnect(ConsoleMonitor *monitor);
+
+private:
+    bool LoadConfig();
+    void ConnectMonitor();
+    void Report(uint32 elapsed, bool final);
+
+    BotSwarmConfig m_config;
+    std::vector<Bot*> m_bots;
+    std::atomic<uint32> m_startedBots, m_activeThreads;
+    volatile bool m_running;
+
+    Mutex m_inWorldLock;
+    std::vector<std::pair<uint64, uint32> > m_inWorld;
+
+    Mutex m_monitorLock;
+    ConsoleMonitor *m_monitor;
+};
+
+#define sBotSwarm BotSwarm::getSingleton()
+
+extern bool mrunning;
@@ -0,0 +1,146 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "BotStdAfx.h"
+
+ConsoleMonitor::ConsoleMonitor(SOCKET fd, const sockaddr_in * peer) : TcpSocket(fd, 16384, 1024, false, peer)
+{
+    m_authenticated = m_hasSample = false;
+    m_residentMB = m_peakResidentMB = m_threads = 0;
+    m_cpu = 0.f;
+    m_continentOverruns = m_instanceOverruns = m_packetsIn = m_packetsOut = 0;
+    m_lastContinentOverruns = m_lastInstanceOverruns = 0;
+    m_worldQueue = m_worldQueuePeak = m_characterQueue = m_characterQueuePeak = 0;
+}
+
+ConsoleMonitor::~ConsoleMonitor()
+{
+
+}
+
+void ConsoleMonitor::SendLine(std::string line)
+{
+    line += "\n";
+    LockWriteBuffer();
+    Write(line.c_str(), line.length());
+    UnlockWriteBuffer();
+}
+
+void ConsoleMonitor::OnConnect()
+{
+    // The console reads our name and password a line at a time, no need to wait for its prompts
+    const BotSwarmConfig &config = sBotSwarm.GetConfig();
+    SendLine(config.consoleUser);
+    SendLine(config.consolePassword);
+}
+
+void ConsoleMonitor::OnDisconnect()
+{
+    sBotSwarm.OnMonitorDisconnect(this);
+}
+
+void ConsoleMonitor::RequestMetrics()
+{
+    if(m_authenticated)
+        SendLine("metrics 1");
+}
+
+void ConsoleMonitor::OnRecvData()
+{
+    size_t len = GetReadBuffer()->GetSize();
+    if(len == 0)
+        return;
+
+    std::string data(len, '\0');
+    Read(&data[0], len);
+
+    m_lock.Acquire();
+    for(size_t i = 0; i < data.length(); ++i)
+    {
+        if(data[i] == '\r')
+            continue;
+        if(data[i] != '\n')
+        {
+            m_line += data[i];
+            continue;
+        }
+
+        ParseLine(m_line);
+        m_line.clear();
+    }
+    m_lock.Release();
+}
+
+void ConsoleMonitor::ParseLine(std::string line)
+{
+    if(!m_authenticated)
+    {
+        if(line.find("Authentication passed.") != std::string::npos)
+        {
+            m_authenticated = true;
+            sLog.Notice("ConsoleMonitor", "Logged into the remote console");
+        }
+        else if(line.find("Authentication failed.") != std::string::npos)
+            sLog.Error("ConsoleMonitor", "Remote console refused our login, server metrics will not be reported");
+        return;
+    }
+
+    uint32 resident, peak, virt, dataMB, threads;
+    unsigned long long value;
+    float cpu;
+    if(sscanf(line.c_str(), "Memory: %uMB resident (peak %uMB), %uMB virtual, %uMB data, %u threads", &resident, &peak, &virt, &dataMB, &threads) == 5)
+    {
+        m_residentMB = resident;
+        m_peakResidentMB = peak;
+        m_threads = threads;
+    }
+    else if(sscanf(line.c_str(), "CPU: %f%%", &cpu) == 1)
+        m_cpu = cpu;
+    else if(sscanf(line.c_str(), "Continent overruns: %llu", &value) == 1)
+        m_continentOverruns = value;
+    else if(sscanf(line.c_str(), "Instance overruns: %llu", &value) == 1)
+        m_instanceOverruns = value;
+    else if(sscanf(line.c_str(), "Packets in: %llu", &value) == 1)
+        m_packetsIn = value;
+    else if(sscanf(line.c_str(), "Packets out: %llu", &value) == 1)
+        m_packetsOut = value;
+    else if(sscanf(line.c_str(), "Database queues: World %u (peak %u), Character %u (peak %u)", &m_worldQueue, &m_worldQueuePeak, &m_characterQueue, &m_characterQueuePeak) == 4)
+        m_hasSample = true; // Last line we care about, the sample is complete
+}
+
+void ConsoleMonitor::Report()
+{
+    m_lock.Acquire();
+    if(!m_hasSample)
+    {
+        m_lock.Release();
+        printf("Server: no metrics received yet\n");
+        return;
+    }
+
+    printf("Server: %uMB resident (peak %uMB), %u threads, %.2f%% cpu\n", m_residentMB, m_peakResidentMB, m_threads, m_cpu);
+    printf("Server ticks: " UI64FMTD " continent overruns (+" UI64FMTD "), " UI64FMTD " instance overruns (+" UI64FMTD ")\n",
+        m_continentOverruns, m_continentOverruns - m_lastContinentOverruns, m_instanceOverruns, m_instanceOverruns - m_lastInstanceOverruns);
+    printf("Server traffic: " UI64FMTD " packets in, " UI64FMTD " packets out\n", m_packetsIn, m_packetsOut);
+    printf("Server database queues: World %u (peak %u), Character %u (peak %u)\n", m_worldQueue, m_worldQueuePeak, m_characterQueue, m_characterQueuePeak);
+    m_lastContinentOverruns = m_continentOverruns;
+    m_lastInstanceOverruns = m_instanceOverruns;
+    m_lock.Release();
+}
@@ -0,0 +1,57 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+/** Remote console client used to read the server's side of the run
+ * Logs in with a console account and parses the output of the metrics command, so every
+ * report can show the server's memory, cpu, tick overruns and database backlog next to
+ * the latencies we measured.
+ */
+class ConsoleMonitor : public TcpSocket
+{
+public:
+    ConsoleMonitor(SOCKET fd, const sockaddr_in * peer);
+    ~ConsoleMonitor();
+
+    void OnConnect();
+    void OnRecvData();
+    void OnDisconnect();
+
+    // Asks for a fresh sample, the reply is parsed as it arrives
+    void RequestMetrics();
+
+    // Prints the last sample, overruns are shown as the change since the previous report
+    void Report();
+
+private:
+    void SendLine(std::string line);
+    void ParseLine(std::string line);
+
+    Mutex m_lock;
+    std::string m_line;
+    bool m_authenticated, m_hasSample;
+
+    uint32 m_residentMB, m_peakResidentMB, m_threads;
+    float m_cpu;
+    uint64 m_continentOverruns, m_instanceOverruns, m_packetsIn, m_packetsOut;
+    uint64 m_lastContinentOverruns, m_lastInstanceOverruns;
+    uint32 m_worldQueue, m_worldQueuePeak, m_characterQueue, m_characterQueuePeak;
+};
@@ -0,0 +1,344 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BotStdAfx.h"
+
+LogonClient::LogonClient(SOCKET fd, const sockaddr_in * peer, Bot *bot) : TcpSocket(fd, 4096, 1024, false, peer)
+{
+    m_bot = bot;
+    m_accountName = bot->GetAccountName();
+    m_password = bot->GetPassword();
+    m_state = STATE_NEED_CHALLENGE;
+    memset(m_sessionKey, 0, 40);
+}
+
+LogonClient::~LogonClient()
+{
+
+}
+
+void LogonClient::ClearBot()
+{
+    m_botLock.Acquire();
+    m_bot = NULL;
+    m_botLock.Release();
+}
+
+void LogonClient::CopyPadded(BigNumber &bn, uint8 *dest, int len)
+{
+    memset(dest, 0, len);
+    memcpy(dest, bn.AsByteArray(), std::min<int>(len, bn.GetNumBytes()));
+}
+
+void LogonClient::Fail(const char *reason)
+{
+    m_botLock.Acquire();
+    if(m_bot)
+        m_bot->OnLogonFailed(reason);
+    m_bot = NULL;
+    m_botLock.Release();
+    m_state = STATE_DONE;
+    Disconnect();
+}
+
+void LogonClient::OnConnect()
+{
+    sAuthLogonChallenge_C challenge;
+    memset(&challenge, 0, sizeof(sAuthLogonChallenge_C));
+
+    uint8 nameLen = uint8(std::min<size_t>(m_accountName.length(), sizeof(challenge.I)));
+    challenge.cmd = LOGON_CMD_AUTH_LOGON_CHALLENGE;
+    challenge.error = 8;
+    challenge.size = uint16(sizeof(sAuthLogonChallenge_C) - 4 - sizeof(challenge.I) + nameLen);
+    memcpy(challenge.gamename, "WoW", 4);
+    challenge.version[0] = 4;
+    challenge.version[1] = 3;
+    challenge.version[2] = 4;
+    challenge.build = BOT_CLIENT_BUILD;
+    memcpy(challenge.platform, "68x", 4);
+    memcpy(challenge.os, "niW", 4);
+    memcpy(challenge.country, "SUne", 4);
+    challenge.ip = 0x0100007F;
+    challenge.I_len = nameLen;
+    memcpy(challenge.I, m_accountName.c_str(), nameLen);
+
+    m_botLock.Acquire();
+    if(m_bot)
+        m_bot->StartRequest(BOT_LATENCY_LOGON_CHALLENGE);
+    m_botLock.Release();
+    Send(&challenge, challenge.size + 4);
+}
+
+void LogonClient::OnRecvData()
+{
+    bool res = true;
+    while(res && IsConnected() && GetReadBuffer()->GetSize())
+    {
+        switch(m_state)
+        {
+        case STATE_NEED_CHALLENGE:
+            res = HandleChallenge();
+            break;
+        case STATE_NEED_PROOF:
+            res = HandleProof();
+            break;
+        case STATE_NEED_REALMLIST:
+            res = HandleRealmList();
+            break;
+        default:
+            GetReadBuffer()->Remove(GetReadBuffer()->GetSize());
+            res = false;
+            break;
+        }
+    }
+}
+
+void LogonClient::OnDisconnect()
+{
+    if(m_state != STATE_DONE)
+        Fail("Logon connection lost");
+}
+
+bool LogonClient::HandleChallenge()
+{
+    // Errors are just the command, a zero and the error code
+    uint8 *buffer = (uint8*)GetReadBuffer()->GetBufferOffset();
+    if(GetReadBuffer()->GetSize() < 3)
+        return false;
+    if(buffer[2] != 0)
+    {
+        Fail(format("Logon challenge refused with error %u", buffer[2]).c_str());
+        return false;
+    }
+    if(GetReadBuffer()->GetSize() < 119)
+        return false;
+
+    uint8 response[119];
+    Read(response, 119);
+
+    m_botLock.Acquire();
+    if(m_bot)
+        m_bot->FinishRequest(BOT_LATENCY_LOGON_CHALLENGE);
+    m_botLock.Release();
+
+    uint8 saltBytes[32];
+    memcpy(saltBytes, &response[70], 32);
+    B.SetBinary(&response[3], 32);
+    g.SetBinary(&response[36], 1);
+    N.SetBinary(&response[38], 32);
+    s.SetBinary(saltBytes, 32);
+
+    // x is built from the same uppercase user:pass hash the logon keeps per account
+    std::string userPass = m_accountName + ":" + m_password;
+    RONIN_UTIL::TOUPPER(userPass);
+    Sha1Hash sha;
+    sha.UpdateData(userPass);
+    sha.Finalize();
+    uint8 srpHash[20];
+    memcpy(srpHash, sha.GetDigest(), 20);
+
+    sha.Initialize();
+    sha.UpdateData(saltBytes, 32);
+    sha.UpdateData(srpHash, 20);
+    sha.Finalize();
+    BigNumber x;
+    x.SetBinary(sha.GetDigest(), sha.GetLength());
+
+    BigNumber a;
+    a.SetRand(19 * 8);
+    A = g.ModExp(a, N);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&A, &B, NULL);
+    sha.Finalize();
+    BigNumber u;
+    u.SetBinary(sha.GetDigest(), 20);
+
+    // S = (B - k*g^x)^(a + u*x), k being 3, kept positive by adding N
+    BigNumber k(3);
+    BigNumber v = g.ModExp(x, N);
+    BigNumber base = ((B + N) - ((k * v) % N)) % N;
+    BigNumber S = base.ModExp(a + (u * x), N);
+
+    uint8 t[32], t1[16];
+    CopyPadded(S, t, 32);
+    for(int i = 0; i < 16; i++)
+        t1[i] = t[i*2];
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for(int i = 0; i < 20; i++)
+        m_sessionKey[i*2] = sha.GetDigest()[i];
+    for(int i = 0; i < 16; i++)
+        t1[i] = t[i*2+1];
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for(int i = 0; i < 20; i++)
+        m_sessionKey[i*2+1] = sha.GetDigest()[i];
+    K.SetBinary(m_sessionKey, 40);
+
+    uint8 hash[20];
+    sha.Initialize();
+    sha.UpdateBigNumbers(&N, NULL);
+    sha.Finalize();
+    memcpy(hash, sha.GetDigest(), 20);
+    sha.Initialize();
+    sha.UpdateBigNumbers(&g, NULL);
+    sha.Finalize();
+    for(int i = 0; i < 20; i++)
+        hash[i] ^= sha.GetDigest()[i];
+    BigNumber t3;
+    t3.SetBinary(hash, 20);
+
+    std::string upperName = m_accountName;
+    RONIN_UTIL::TOUPPER(upperName);
+    sha.Initialize();
+    sha.UpdateData(upperName);
+    sha.Finalize();
+    BigNumber t4;
+    t4.SetBinary(sha.GetDigest(), 20);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&t3, &t4, &s, &A, &B, &K, NULL);
+    sha.Finalize();
+    M.SetBinary(sha.GetDigest(), 20);
+
+    sAuthLogonProof_C proof;
+    memset(&proof, 0, sizeof(sAuthLogonProof_C));
+    proof.cmd = LOGON_CMD_AUTH_LOGON_PROOF;
+    CopyPadded(A, proof.A, 32);
+    memcpy(proof.M1, sha.GetDigest(), 20);
+
+    m_state = STATE_NEED_PROOF;
+    m_botLock.Acquire();
+    if(m_bot)
+        m_bot->StartRequest(BOT_LATENCY_LOGON_PROOF);
+    m_botLock.Release();
+    Send(&proof, sizeof(sAuthLogonProof_C));
+    return true;
+}
+
+bool LogonClient::HandleProof()
+{
+    uint8 *buffer = (uint8*)GetReadBuffer()->GetBufferOffset();
+    if(GetReadBuffer()->GetSize() < 2)
+        return false;
+    if(buffer[1] != 0)
+    {
+        Fail(format("Logon proof refused with error %u", buffer[1]).c_str());
+        return false;
+    }
+    if(GetReadBuffer()->GetSize() < 32)
+        return false;
+
+    uint8 response[32];
+    Read(response, 32);
+
+    // Check the server knows our session key as well
+    Sha1Hash sha;
+    sha.UpdateBigNumbers(&A, &M, &K, NULL);
+    sha.Finalize();
+    if(memcmp(&response[2], sha.GetDigest(), 20) != 0)
+    {
+        Fail("Logon proof did not match our session key");
+        return false;
+    }
+
+    sRealmlistChallenge_C request;
+    request.cmd = LOGON_CMD_REALM_LIST;
+    request.size = 0;
+
+    m_state = STATE_NEED_REALMLIST;
+    m_botLock.Acquire();
+    if(m_bot)
+    {
+        m_bot->FinishRequest(BOT_LATENCY_LOGON_PROOF);
+        m_bot->StartRequest(BOT_LATENCY_REALMLIST);
+    }
+    m_botLock.Release();
+    Send(&request, sizeof(sRealmlistChallenge_C));
+    return true;
+}
+
+bool LogonClient::HandleRealmList()
+{
+    uint8 *buffer = (uint8*)GetReadBuffer()->GetBufferOffset();
+    if(GetReadBuffer()->GetSize() < 3)
+        return false;
+
+    uint16 size = uint16(buffer[1]) | (uint16(buffer[2]) << 8);
+    if(GetReadBuffer()->GetSize() < size_t(size+3))
+        return false;
+
+    ByteBuffer data(size+3);
+    data.resize(size+3);
+    Read((uint8*)data.contents(), size+3);
+
+    std::string realmName = sBotSwarm.GetRealmName(), address;
+    try
+    {
+        data.read_skip<uint8>();
+        data.read_skip<uint16>();
+        data.read_skip<uint32>();
+        uint16 count = data.read<uint16>();
+        for(uint16 i = 0; i < count; ++i)
+        {
+            std::string name, realmAddress;
+            data.read_skip<uint8>();
+            data.read_skip<uint8>();
+            uint8 flags = data.read<uint8>();
+            data >> name >> realmAddress;
+            data.read_skip<uint32>();
+            data.read_skip<uint8>();
+            data.read_skip<uint8>();
+            data.read_skip<uint8>();
+            if(flags & REALM_FLAG_SPECIFYBUILD)
+                data.read_skip(5);
+
+            if(address.empty() && (realmName.empty() || name == realmName))
+                address = realmAddress;
+        }
+    }
+    catch(ByteBufferException &)
+    {
+        Fail("Malformed realm list");
+        return false;
+    }
+
+    if(address.empty())
+    {
+        Fail("Realm not found in realm list");
+        return false;
+    }
+
+    m_state = STATE_DONE;
+    m_botLock.Acquire();
+    if(m_bot)
+    {
+        m_bot->FinishRequest(BOT_LATENCY_REALMLIST);
+        m_bot->OnLogonComplete(m_sessionKey, address);
+    }
+    m_bot = NULL;
+    m_botLock.Release();
+
+    // Real clients drop the logon connection once they have picked a realm
+    Disconnect();
+    return false;
+}
@@ -0,0 +1,73 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+class Bot;
+
+/** Client side of AuthSocket
+ * Runs the SRP6 exchange, pulls the realm list and hands the session key and the chosen
+ * realm's address to our bot, then drops the connection like a real client would.
+ */
+class LogonClient : public TcpSocket
+{
+    enum LogonClientState
+    {
+        STATE_NEED_CHALLENGE,
+        STATE_NEED_PROOF,
+        STATE_NEED_REALMLIST,
+        STATE_DONE
+    };
+
+public:
+    LogonClient(SOCKET fd, const sockaddr_in * peer, Bot *bot);
+    ~LogonClient();
+
+    // Detaches us from our bot, after this no callbacks will reach it
+    void ClearBot();
+
+    RONIN_INLINE void Send(const void* data, const uint16 len)
+    {
+        LockWriteBuffer();
+        Write(data, len);
+        UnlockWriteBuffer();
+    }
+
+    void OnConnect();
+    void OnRecvData();
+    void OnDisconnect();
+
+private:
+    bool HandleChallenge();
+    bool HandleProof();
+    bool HandleRealmList();
+    void Fail(const char *reason);
+
+    // BigNumbers are minimal little endian, the wire always wants the full width
+    static void CopyPadded(BigNumber &bn, uint8 *dest, int len);
+
+    Mutex m_botLock;
+    Bot *m_bot;
+
+    std::string m_accountName, m_password;
+    LogonClientState m_state;
+
+    BigNumber N, g, s, B, A, M, K;
+    uint8 m_sessionKey[40];
+};
@@ -0,0 +1,62 @@
+/*
+ * Sandshroud Project Ronin
+ * Copyright (C) 2015-2017 Sandshroud <https://github.com/Sandshroud>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "BotStdAfx.h"
+#include <signal.h>
+
+bool mrunning = true;
+
+void _OnSignal(int s)
+{
+    switch (s)
+    {
+    case SIGINT:
+    case SIGTERM:
+    case SIGABRT:
+#ifdef _WIN32
+    case SIGBREAK:
+#endif
+        mrunning = false;
+        break;
+    }
+
+    signal(s, _OnSignal);
+}
+
+void RunSwarm(int argc, char** argv)
+{
+    new BotSwarm;
+    BotSwarm::getSingleton( ).Run(argc, argv);
+    delete BotSwarm::getSingletonPtr();
+}
+
+int main(int argc, char** argv)
+{
+    THREAD_TRY_EXECUTION
+    {
+        RunSwarm(argc, argv);
+    }
+    THREAD_HANDLE_CRASH
+}
+
+void OnCrash(bool Terminate)
+{
+
+}